@@ -41,30 +41,47 @@
 struct fd_t {
 	struct drv_device *dev;
 	bool is_used;
-	size_t offset;
+	size_t offset;	   // 文件偏移 每个文件描述符独立
+	int16_t next_free; // 空闲链表中的下一个文件描述符 -1表示结束
 };
 
 static struct fd_t fds[FD_MAX_SIZE] = { 0 };
+static int16_t fd_free_head = -1; // 空闲文件描述符链表头
 
 static int alloc_fd(void)
 {
-	for (uint16_t i = RESERVED_FDS; i < FD_MAX_SIZE; i++) {
-		if (!fds[i].is_used) {
-			fds[i].is_used = true;
-			return i;
-		}
-	}
-	return DAL_ERR_OVERFLOW;
+	int fd = fd_free_head;
+	if (fd < 0)
+		return DAL_ERR_OVERFLOW;
+
+	fd_free_head = fds[fd].next_free;
+	fds[fd].is_used = true;
+	fds[fd].offset = 0;
+	return fd;
 }
 
 static void free_fd(int fd)
 {
-	if (fd >= RESERVED_FDS && fd < FD_MAX_SIZE) {
+	if (fd >= RESERVED_FDS && fd < FD_MAX_SIZE && fds[fd].is_used) {
 		fds[fd].is_used = false;
 		fds[fd].dev = NULL;
+		fds[fd].next_free = fd_free_head;
+		fd_free_head = fd;
 	}
 }
 
+// 根据设备大小限制传输长度 防止溢出
+static inline size_t clamp_len(struct drv_device *dev, size_t offset, size_t len)
+{
+	if (dev->dev_size == 0)
+		return len;
+
+	if (offset >= dev->dev_size)
+		return 0;
+
+	return ((dev->dev_size - offset) < len) ? (dev->dev_size - offset) : len;
+}
+
 static int check_fd(int fd, struct drv_device **dev)
 {
 	if (fd < RESERVED_FDS || fd >= FD_MAX_SIZE || !fds[fd].is_used)
@@ -120,42 +137,156 @@ int dal_close(int fd)
 	return DAL_ERR_NONE;
 }
 
-size_t dal_read(int fd, void *buf, size_t len)
+static size_t dal_xfer(int fd, void *buf, size_t len, size_t *offset, bool is_write)
 {
 	struct drv_device *dev;
 	int err = check_fd(fd, &dev);
 	if (err != DAL_ERR_NONE)
 		return err;
 
-	if (!dev->file->opts->read)
+	size_t (*f_xfer)(struct drv_file *, void *, size_t, size_t *) =
+		is_write ? dev->file->opts->write : dev->file->opts->read;
+	if (!f_xfer)
 		return DAL_ERR_EXCEPTION;
 
-	size_t real_len = len;
+	return f_xfer(dev->file, buf, clamp_len(dev, *offset, len), offset);
+}
 
-	// 如果初始化驱动时设置了设备大小，则防止溢出
-	if (dev->dev_size > 0)
-		real_len = ((dev->dev_size - dev->offset) < len) ? (dev->dev_size - dev->offset) : len;
+size_t dal_read(int fd, void *buf, size_t len)
+{
+	if (fd < RESERVED_FDS || fd >= FD_MAX_SIZE)
+		return DAL_ERR_INVALID;
 
-	return dev->file->opts->read(dev->file, buf, real_len, &dev->offset);
+	return dal_xfer(fd, buf, len, &fds[fd].offset, false);
 }
 
 size_t dal_write(int fd, void *buf, size_t len)
+{
+	if (fd < RESERVED_FDS || fd >= FD_MAX_SIZE)
+		return DAL_ERR_INVALID;
+
+	return dal_xfer(fd, buf, len, &fds[fd].offset, true);
+}
+
+size_t dal_pread(int fd, void *buf, size_t len, size_t offset)
+{
+	return dal_xfer(fd, buf, len, &offset, false);
+}
+
+size_t dal_pwrite(int fd, void *buf, size_t len, size_t offset)
+{
+	return dal_xfer(fd, buf, len, &offset, true);
+}
+
+static size_t dal_xferv(int fd, const struct drv_iovec *iov, size_t iovcnt, bool is_write)
 {
 	struct drv_device *dev;
 	int err = check_fd(fd, &dev);
 	if (err != DAL_ERR_NONE)
 		return err;
 
-	if (!dev->file->opts->write)
+	if (!iov || !iovcnt)
+		return 0;
+
+	const struct file_operations *opts = dev->file->opts;
+	size_t (*f_vec)(struct drv_file *, const struct drv_iovec *, size_t, size_t *) = is_write ? opts->writev : opts->readv;
+	size_t (*f_xfer)(struct drv_file *, void *, size_t, size_t *) = is_write ? opts->write : opts->read;
+
+	if (!f_vec && !f_xfer)
 		return DAL_ERR_EXCEPTION;
 
-	size_t real_len = len;
+	size_t total = 0;
+	for (size_t i = 0; i < iovcnt; i++)
+		total += iov[i].len;
+
+	// 未超出设备大小时整体交给驱动 否则逐段传输并截断
+	size_t *offset = &fds[fd].offset;
+	if (f_vec && clamp_len(dev, *offset, total) == total)
+		return f_vec(dev->file, iov, iovcnt, offset);
+
+	if (!f_xfer)
+		return DAL_ERR_EXCEPTION;
+
+	size_t done = 0;
+	for (size_t i = 0; i < iovcnt; i++) {
+		size_t len = clamp_len(dev, *offset, iov[i].len);
+		if (!len)
+			break;
+
+		size_t ret = f_xfer(dev->file, iov[i].base, len, offset);
+		if (ret > len)
+			break; // 驱动返回错误码
+
+		done += ret;
+		if (ret < iov[i].len)
+			break; // 传输不完整
+	}
+
+	return done;
+}
 
-	// 如果初始化驱动时设置了设备大小，则防止溢出
-	if (dev->dev_size > 0)
-		real_len = ((dev->dev_size - dev->offset) < len) ? (dev->dev_size - dev->offset) : len;
+size_t dal_readv(int fd, const struct drv_iovec *iov, size_t iovcnt)
+{
+	return dal_xferv(fd, iov, iovcnt, false);
+}
 
-	return dev->file->opts->write(dev->file, buf, real_len, &dev->offset);
+size_t dal_writev(int fd, const struct drv_iovec *iov, size_t iovcnt)
+{
+	return dal_xferv(fd, iov, iovcnt, true);
+}
+
+static int dal_async_submit(int fd, struct drv_async *req, bool is_write)
+{
+	struct drv_device *dev;
+	int err = check_fd(fd, &dev);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	if (!req || !req->buf)
+		return DAL_ERR_INVALID;
+
+	if (req->status == DRV_ASYNC_PENDING)
+		return DAL_ERR_OCCUPIED;
+
+	const struct file_operations *opts = dev->file->opts;
+	int (*f_async)(struct drv_file *, struct drv_async *) = is_write ? opts->write_async : opts->read_async;
+	size_t (*f_sync)(struct drv_file *, void *, size_t, size_t *) = is_write ? opts->write : opts->read;
+
+	if (!f_async && !f_sync)
+		return DAL_ERR_EXCEPTION;
+
+	size_t *offset = &fds[fd].offset;
+
+	req->len = clamp_len(dev, *offset, req->len);
+	req->offset = *offset;
+	req->actual = 0;
+	req->status = DRV_ASYNC_PENDING;
+
+	// 驱动不支持异步传输时同步完成
+	if (!f_async) {
+		size_t actual = f_sync(dev->file, req->buf, req->len, offset);
+		drv_async_complete(req, actual, DRV_ERR_NONE);
+		return DAL_ERR_NONE;
+	}
+
+	err = f_async(dev->file, req);
+	if (err != DRV_ERR_NONE) {
+		req->status = DRV_ASYNC_IDLE;
+		return err;
+	}
+
+	*offset += req->len;
+	return DAL_ERR_NONE;
+}
+
+int dal_read_async(int fd, struct drv_async *req)
+{
+	return dal_async_submit(fd, req, false);
+}
+
+int dal_write_async(int fd, struct drv_async *req)
+{
+	return dal_async_submit(fd, req, true);
 }
 
 int dal_ioctl(int fd, int cmd, void *arg)
@@ -178,7 +309,7 @@ int dal_lseek(int fd, int offset, enum dal_lseek_whence whence)
 	if (err != DAL_ERR_NONE || dev->dev_size == 0)
 		return err;
 
-	uint32_t cur_offset = dev->offset;
+	uint32_t cur_offset = fds[fd].offset;
 	uint32_t dev_size = dev->dev_size;
 	uint32_t dest_offset = 0;
 
@@ -188,6 +319,8 @@ int dal_lseek(int fd, int offset, enum dal_lseek_whence whence)
 			return DRV_ERR_INVALID;
 
 		dest_offset = (uint32_t)offset;
+		if (dest_offset > dev_size)
+			return DRV_ERR_INVALID;
 		break;
 
 	case DAL_LSEEK_WHENCE_SET:
@@ -207,15 +340,55 @@ int dal_lseek(int fd, int offset, enum dal_lseek_whence whence)
 		return DRV_ERR_INVALID;
 	}
 
-	dev->offset = dest_offset;
+	fds[fd].offset = dest_offset;
 
 	return dest_offset;
 }
 
+// 驱动未实现读写接口时句柄使用的空操作
+static size_t dal_null_xfer(struct drv_file *file, void *buf, size_t len, size_t *offset)
+{
+	(void)file;
+	(void)buf;
+	(void)len;
+	(void)offset;
+	return 0;
+}
+
+int dal_get_handle(int fd, struct dal_handle *handle)
+{
+	struct drv_device *dev;
+	int err = check_fd(fd, &dev);
+	if (err != DAL_ERR_NONE)
+		return err;
+
+	if (!handle || !dev->file || !dev->file->opts)
+		return DAL_ERR_INVALID;
+
+	const struct file_operations *opts = dev->file->opts;
+
+	handle->file = dev->file;
+	handle->f_read = opts->read ? opts->read : dal_null_xfer;
+	handle->f_write = opts->write ? opts->write : dal_null_xfer;
+	handle->offset = &fds[fd].offset;
+	handle->dev_size = dev->dev_size;
+	return DAL_ERR_NONE;
+}
+
 void dal_init(void)
 {
-	for (uint16_t i = 0; i < FD_MAX_SIZE; i++) {
+	fd_free_head = -1;
+
+	// 倒序入链 优先分配小的文件描述符
+	for (int16_t i = FD_MAX_SIZE - 1; i >= 0; i--) {
 		fds[i].is_used = i < RESERVED_FDS ? true : false;
 		fds[i].dev = NULL;
+		fds[i].offset = 0;
+		fds[i].next_free = -1;
+
+		if (i >= RESERVED_FDS) {
+			fds[i].next_free = fd_free_head;
+			fd_free_head = i;
+		}
 	}
 }
\ No newline at end of file
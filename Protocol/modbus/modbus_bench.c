@@ -0,0 +1,311 @@
+/**
+ * @file modbus_bench.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief Modbus主从机回环性能测试
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include "protocol/modbus/modbus.h"
+
+#if MODBUS_BENCH_ENABLE || VIRTUALOS_HOST_BUILD
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/crc.h"
+#include "utils/stimer.h"
+#include "utils/simple_shell.h"
+
+#include "protocol/modbus/modbus_master.h"
+#include "protocol/modbus/modbus_slave.h"
+
+#define MB_BENCH_SLAVE_ADDR (1)
+#define MB_BENCH_POLL_MAX (64)		// 单次事务最多轮询次数 超过视为失败
+#define MB_BENCH_DEFAULT_RUNS (100) // 默认每个用例的事务次数
+
+// 内存回环通道 主机和从机各自的写入即为对方的读取
+struct mb_bench_pipe {
+	uint8_t buf[MODBUS_TCP_FRAME_BYTES_MAX * 2];
+	size_t rd;
+	size_t wr;
+};
+
+// 测试用例
+struct mb_bench_case {
+	const char *name;
+	uint8_t func;
+	uint16_t reg_len;
+};
+
+static const struct mb_bench_case mb_bench_cases[] = {
+	{ "03x1", MODBUS_FUN_RD_REG_MUL, 1 },
+	{ "03x16", MODBUS_FUN_RD_REG_MUL, 16 },
+	{ "03x125", MODBUS_FUN_RD_REG_MUL, MAX_READ_REG_NUM },
+	{ "06x1", MODBUS_FUN_WR_REG, 1 },
+	{ "10x16", MODBUS_FUN_WR_REG_MUL, 16 },
+	{ "10x123", MODBUS_FUN_WR_REG_MUL, MAX_WRITE_REG_NUM },
+	{ "01x255", MODBUS_FUN_RD_COIL, 255 },
+	{ "0Fx255", MODBUS_FUN_WR_COIL_MUL, 255 },
+};
+
+static struct mb_bench_pipe mst_to_slv; // 请求通道
+static struct mb_bench_pipe slv_to_mst; // 响应通道
+static uint16_t bench_wr_data[MAX_READ_REG_NUM];
+static bool bench_done;
+static bool bench_ok;
+
+static size_t pipe_write(struct mb_bench_pipe *pipe, const uint8_t *data, size_t len)
+{
+	if (len > sizeof(pipe->buf) - pipe->wr)
+		len = sizeof(pipe->buf) - pipe->wr;
+
+	memcpy(&pipe->buf[pipe->wr], data, len);
+	pipe->wr += len;
+	return len;
+}
+
+static size_t pipe_read(struct mb_bench_pipe *pipe, uint8_t *data, size_t len)
+{
+	size_t remain = pipe->wr - pipe->rd;
+
+	if (len > remain)
+		len = remain;
+
+	memcpy(data, &pipe->buf[pipe->rd], len);
+	pipe->rd += len;
+	if (pipe->rd == pipe->wr)
+		pipe->rd = pipe->wr = 0;
+	return len;
+}
+
+static bool bench_port_init(void)
+{
+	return true;
+}
+
+static size_t mst_write(uint8_t *p_data, size_t len)
+{
+	return pipe_write(&mst_to_slv, p_data, len);
+}
+
+static size_t mst_read(uint8_t *p_data, size_t len)
+{
+	return pipe_read(&slv_to_mst, p_data, len);
+}
+
+static size_t slv_write(uint8_t *p_data, size_t len)
+{
+	return pipe_write(&slv_to_mst, p_data, len);
+}
+
+static size_t slv_read(uint8_t *p_data, size_t len)
+{
+	return pipe_read(&mst_to_slv, p_data, len);
+}
+
+static struct serial_opts mst_opts = {
+	.f_init = bench_port_init,
+	.f_write = mst_write,
+	.f_read = mst_read,
+};
+
+static struct serial_opts slv_opts = {
+	.f_init = bench_port_init,
+	.f_write = slv_write,
+	.f_read = slv_read,
+};
+
+// 从机响应 读请求原样返回已清零的缓冲 只测量协议栈本身的开销
+static uint8_t bench_slave_resp(uint8_t func, uint16_t reg, uint16_t reg_num, uint16_t *p_in_out)
+{
+	return MODBUS_RESP_ERR_NONE;
+}
+
+static struct mb_slv_work bench_work_table[] = {
+	{ .start = 0, .end = 2000, .resp = bench_slave_resp },
+};
+
+static void bench_master_resp(uint8_t *data, size_t len, uint8_t err_code, bool is_timeout)
+{
+	bench_done = true;
+	bench_ok = !is_timeout && err_code == MODBUS_RESP_ERR_NONE;
+}
+
+// 用例统计
+struct mb_bench_stat {
+	uint32_t total;		// 事务总周期数
+	uint32_t worst;		// 单次事务最大周期数
+	uint32_t slv;		// 从机轮询总周期数 含解析,处理和回复
+	uint32_t slv_bytes; // 从机接收的请求总字节数
+	uint32_t crc;		// 请求帧CRC计算总周期数
+	uint32_t runs;		// 成功的事务次数
+};
+
+/**
+ * @brief 执行一个用例 每次提交一个请求并轮询主从机直到收到响应
+ * 
+ * @param mst 主机句柄
+ * @param slv 从机句柄
+ * @param c 用例
+ * @param runs 事务次数
+ * @param stat 输出 统计结果
+ */
+static void bench_run_case(
+	mb_mst_handle mst, mb_slv_handle slv, const struct mb_bench_case *c, uint32_t runs, struct mb_bench_stat *stat)
+{
+	struct mb_mst_request request = {
+		.timeout_ms = MB_BENCH_POLL_MAX,
+		.resp = bench_master_resp,
+		.slave_addr = MB_BENCH_SLAVE_ADDR,
+		.func = c->func,
+		.reg_addr = 0,
+		.reg_len = c->reg_len,
+	};
+	bool is_write = !MODBUS_FUNC_IS_READ(c->func);
+	uint32_t start, t0, cycles;
+	size_t req_len = 0;
+
+	memset(stat, 0, sizeof(*stat));
+
+	for (uint32_t i = 0; i < runs; i++) {
+		bench_done = false;
+		bench_ok = false;
+		req_len = 0;
+
+		start = stimer_get_cycle();
+		mb_mst_pdu_request(mst, &request, is_write ? bench_wr_data : NULL, is_write ? c->reg_len : 0);
+
+		for (uint32_t n = 0; n < MB_BENCH_POLL_MAX && !bench_done; n++) {
+			mb_mst_poll(mst);
+
+			if (mst_to_slv.wr > mst_to_slv.rd)
+				req_len = mst_to_slv.wr - mst_to_slv.rd;
+
+			t0 = stimer_get_cycle();
+			mb_slv_poll(slv);
+			stat->slv += stimer_get_cycle() - t0;
+		}
+
+		cycles = stimer_get_cycle() - start;
+		if (!bench_done || !bench_ok)
+			continue;
+
+		// 从机读取后请求帧仍保留在通道缓冲起始处 单独测量CRC开销
+		t0 = stimer_get_cycle();
+		crc16_update_bytes(0xFFFF, mst_to_slv.buf, req_len);
+		stat->crc += stimer_get_cycle() - t0;
+		stat->slv_bytes += req_len;
+
+		stat->total += cycles;
+		if (cycles > stat->worst)
+			stat->worst = cycles;
+		stat->runs++;
+	}
+}
+
+// 每字节周期数 保留两位小数
+static int bench_cpb(char *out, size_t size, uint32_t cycles, uint32_t bytes)
+{
+	uint32_t cpb = bytes ? (uint32_t)((uint64_t)cycles * 100 / bytes) : 0;
+
+	return snprintf(out, size, "%5lu.%02lu", (unsigned long)(cpb / 100), (unsigned long)(cpb % 100));
+}
+
+// 主从机内存回环 测量各功能码的事务周期数, 最大延迟, 从机解析和CRC的每字节周期数
+size_t mb_bench_run(uint32_t runs, bool tcp, char *out, size_t size)
+{
+	struct mb_bench_stat stat;
+	mb_mst_handle mst = NULL;
+	mb_slv_handle slv = NULL;
+	char slv_cpb[16], crc_cpb[16];
+	size_t pos = 0;
+	int n;
+
+	if (!out || !size)
+		return 0;
+
+	if (!runs)
+		runs = MB_BENCH_DEFAULT_RUNS;
+
+	if (!stimer_get_cycle())
+		return 0; // 需要调度定时器提供`f_get_cycle`接口
+
+	memset(&mst_to_slv, 0, sizeof(mst_to_slv));
+	memset(&slv_to_mst, 0, sizeof(slv_to_mst));
+
+	mst = tcp ? mb_mst_tcp_init(&mst_opts, 1) : mb_mst_init(&mst_opts, 1);
+	slv = tcp ? mb_slv_tcp_init(&slv_opts, MB_BENCH_SLAVE_ADDR, bench_work_table, 1)
+			  : mb_slv_init(&slv_opts, MB_BENCH_SLAVE_ADDR, bench_work_table, 1);
+	if (!mst || !slv)
+		goto out;
+
+	n = snprintf(out, size, "%-8s %8s %8s %8s %8s %6s\r\n", "case", "cyc/txn", "worst", "slv/B", "crc/B", "ok");
+	if (n < 0 || (size_t)n >= size)
+		goto out;
+	pos = n;
+
+	for (size_t i = 0; i < sizeof(mb_bench_cases) / sizeof(mb_bench_cases[0]); i++) {
+		bench_run_case(mst, slv, &mb_bench_cases[i], runs, &stat);
+
+		bench_cpb(slv_cpb, sizeof(slv_cpb), stat.slv, stat.slv_bytes);
+		bench_cpb(crc_cpb, sizeof(crc_cpb), stat.crc, stat.slv_bytes);
+		n = snprintf(out + pos, size - pos, "%-8s %8lu %8lu %8s %8s %6lu\r\n", mb_bench_cases[i].name,
+			(unsigned long)(stat.runs ? stat.total / stat.runs : 0), (unsigned long)stat.worst, slv_cpb,
+			crc_cpb, (unsigned long)stat.runs);
+		if (n < 0 || (size_t)n >= size - pos)
+			break;
+		pos += n;
+	}
+
+out:
+	mb_slv_destroy(slv);
+	mb_mst_destroy(mst);
+	return pos;
+}
+
+#if MODBUS_BENCH_ENABLE
+// mb_bench [runs] [tcp]
+static void mb_bench_cmd(int argc, char *argv[], uint8_t *out, size_t buf_size, size_t *out_len)
+{
+	uint32_t runs = MB_BENCH_DEFAULT_RUNS;
+	bool tcp = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "tcp"))
+			tcp = true;
+		else
+			runs = (uint32_t)strtoul(argv[i], NULL, 0);
+	}
+
+	*out_len = mb_bench_run(runs, tcp, (char *)out, buf_size);
+}
+SPS_EXPORT_CMD(mb_bench, mb_bench_cmd, "modbus loopback benchmark, `mb_bench [runs] [tcp]`")
+#endif
+
+#endif /* MODBUS_BENCH_ENABLE || VIRTUALOS_HOST_BUILD */
@@ -36,6 +36,7 @@
 #include <string.h>
 
 #include "utils/crc.h"
+#include "utils/list.h"
 #include "utils/queue.h"
 
 #include "core/virtual_os_mm.h"
@@ -74,28 +75,41 @@ enum rx_state {
 // 请求信息
 struct req_info {
 	struct mb_mst_request request; // 请求信息
+	list_item node;				   // 从机请求队列节点
+	struct slave_info *slave;	   // 所属从机
+	uint16_t *wr_data;			   // 写功能码的数据
+
+	uint32_t cur_ctr;	  // 本次发送后经过的时间
+	uint8_t repeat_times; // 已发送次数
+	uint16_t reg_len;	  // 写数据的字数
+	uint16_t tid;		  // 事务标识 仅TCP
+
+	bool valid;	   // 是否正在使用
+	bool grouped;  // 是否合并在当前发送的读请求中
+	bool inflight; // 已发送 正在等待响应
+};
 
-	uint32_t to_timeout;  // 超时时间
-	uint32_t cur_ctr;	  // 当前计数器
-	uint8_t repeat_times; // 重发次数
-	uint8_t reg_len;	  // 写功能码时的寄存器长度
-
-	bool valid; // 是否正在使用
+// 从机调度信息
+struct slave_info {
+	list_item reqs;	  // 待处理的请求队列
+	uint32_t srtt;	  // 平滑响应时间 单位ms 放大8倍
+	uint32_t rttvar;  // 响应时间偏差 单位ms 放大4倍
+	uint32_t backoff; // 剩余退避时间 单位ms 为0时可以调度
+	uint8_t fails;	  // 连续失败次数
+	uint8_t addr;	  // 从机地址
+	bool used;		  // 是否正在使用
+	bool no_merge;	  // 合并读请求曾收到异常响应 不再合并
 };
 
 // 接收数据信息
 struct msg_info {
 	uint8_t r_data[MAX_READ_REG_NUM * 2]; // 读功能码接收的有效数据
 
-	uint8_t rx_queue_buff[RX_BUFF_SIZE]; // 接收队列缓冲
-	struct queue_info rx_q;				 // 接收队列
-
-	uint16_t wr_reg_data[MAX_WRITE_REG_NUM]; // 写功能码发送的有效数据
-	struct queue_info wr_q;					 // 写数据队列 临时存储写功能的数据
+	uint8_t rx_queue_buff[RX_BUFF_SIZE];   // 接收队列缓冲
+	struct queue_info rx_q;				   // 接收队列
+	uint8_t pdu[MODBUS_TCP_PDU_BYTES_MAX]; // TCP响应PDU 从接收队列中拷贝
 
-	struct req_info req_infos[MAX_REQUEST];		   // 请求信息缓冲
-	struct req_info *req_infos_q_buf[MAX_REQUEST]; // 请求信息队列指针缓冲
-	struct queue_info req_info_q;				   // 请求信息队列
+	struct req_info req_infos[MAX_REQUEST]; // 请求信息缓冲
 
 	size_t anchor;	// 滑动左窗口
 	size_t forward; // 滑动右窗口
@@ -113,10 +127,17 @@ struct msg_info {
 
 // 主机句柄
 struct mb_mst {
-	struct serial_opts *opts;  // 用户回调指针
-	struct msg_info msg_state; // 接收信息
-	size_t period_ms;		   // 任务周期
-	uint8_t sem; // 信号量(模拟) 必须确保一收一发或者接收超时后才能继续发送 因为需要切换收发引脚 防止一直在发
+	struct serial_opts *opts;					 // 用户回调指针
+	struct msg_info msg_state;					 // 接收信息
+	struct slave_info slaves[MB_MST_MAX_SLAVES]; // 从机调度信息
+	struct req_info *cur;						 // 正在等待响应的请求 仅RTU 串口同一时间只有一个请求在传输
+	uint16_t grp_addr;							 // 合并读请求的起始寄存器
+	uint8_t grp_len;							 // 合并读请求的寄存器数量 为0时未合并
+	size_t period_ms;							 // 任务周期
+	uint16_t tid;								 // 下一个事务标识 仅TCP
+	uint8_t inflight;							 // 已发送正在等待响应的请求数量
+	uint8_t rr;									 // 轮询调度的起始从机
+	bool tcp;									 // 是否为Modbus TCP
 };
 
 static struct req_info *allow_req_info(mb_mst_handle handle)
@@ -134,7 +155,7 @@ static struct req_info *allow_req_info(mb_mst_handle handle)
 }
 
 static bool _recv_parser(mb_mst_handle handle);		 // 解析数据
-static void _dispatch_rtu_msg(mb_mst_handle handle); // 处理数据
+static void _dispatch_msg(mb_mst_handle handle, struct req_info *req_info_ptr); // 处理数据
 
 // 剩余数据
 static inline size_t check_rx_queue_remain_data(const struct msg_info *p_msg)
@@ -146,7 +167,7 @@ static inline size_t check_rx_queue_remain_data(const struct msg_info *p_msg)
 static inline uint8_t get_rx_queue_remain_data(const struct msg_info *p_msg)
 {
 	uint8_t *p = p_msg->rx_q.buf;
-	return p[p_msg->forward & (p_msg->rx_q.buf_size - 1)];
+	return p[p_msg->forward & p_msg->rx_q.mask];
 }
 
 /**
@@ -208,8 +229,8 @@ static bool _recv_parser(mb_mst_handle handle)
 	uint8_t c;
 
 	struct msg_info *p_msg = &handle->msg_state;
-	struct req_info *req_info = NULL;
-	queue_peek(&handle->msg_state.req_info_q, (uint8_t *)&req_info, 1); // 不出队 只查询
+	struct req_info *req_info = handle->cur;
+	uint8_t func = req_info->request.func;
 
 	while (check_rx_queue_remain_data(p_msg)) {
 		c = get_rx_queue_remain_data(p_msg);
@@ -223,16 +244,17 @@ static bool _recv_parser(mb_mst_handle handle)
 				rebase_parser(p_msg);
 			break;
 		case RX_STATE_FUNC:
-			if (c == MODBUS_FUN_RD_REG_MUL) {
+			if (c == func && MODBUS_FUNC_IS_READ(c)) {
 				p_msg->state = RX_STATE_DATA_LEN;
 				p_msg->cal_crc = crc16_update(p_msg->cal_crc, c);
 
-			} else if (c == MODBUS_FUN_WR_REG_MUL) {
+			} else if (c == func) {
+				// 写功能码 回复地址和数量/写入的值
 				p_msg->pdu_in = 0;
 				p_msg->pdu_len = MODBUS_REG_BYTES_NUM;
 				p_msg->state = RX_STATE_REG;
 				p_msg->cal_crc = crc16_update(p_msg->cal_crc, c);
-			} else if (c & 0x80) {
+			} else if (c == (func | 0x80)) {
 				// 异常响应
 				p_msg->cal_crc = crc16_update(p_msg->cal_crc, c);
 				p_msg->state = RX_STATE_ERR;
@@ -313,91 +335,560 @@ static bool _recv_parser(mb_mst_handle handle)
 }
 
 /**
- * @brief 处理对应功能码
- *
+ * @brief 校验响应PDU 功能码必须与请求一致, 长度必须与功能码一致 与传输方式无关
+ * 
+ * @param handle 主机句柄
+ * @param req_info_ptr 对应的请求
+ * @param pdu 响应PDU 从功能码开始
+ * @param len PDU长度
+ * @return true PDU有效
+ * @return false PDU无效
+ */
+static bool _decode_pdu(mb_mst_handle handle, struct req_info *req_info_ptr, const uint8_t *pdu, size_t len)
+{
+	struct msg_info *p_msg = &handle->msg_state;
+	uint8_t func = pdu[0];
+	size_t pdu_len;
+
+	if (len < MODBUS_FUNC_BYTES_NUM + 1)
+		return false;
+
+	if (func != req_info_ptr->request.func && func != (req_info_ptr->request.func | 0x80))
+		return false;
+
+	if (MODBUS_FUNC_IS_READ(func)) {
+		if (pdu[1] > MAX_READ_REG_NUM * 2)
+			return false;
+		pdu_len = MODBUS_FUNC_BYTES_NUM + 1 + pdu[1]; // 字节数 + 数据
+	} else if (func == req_info_ptr->request.func)
+		pdu_len = MODBUS_FUNC_BYTES_NUM + MODBUS_REG_BYTES_NUM + MODBUS_REG_LEN_BYTES_NUM;
+	else
+		pdu_len = MODBUS_FUNC_BYTES_NUM + 1; // 异常响应 异常码
+
+	if (len != pdu_len)
+		return false;
+
+	if (MODBUS_FUNC_IS_READ(func)) {
+		memset(p_msg->r_data, 0, sizeof(p_msg->r_data));
+		memcpy(p_msg->r_data, &pdu[2], pdu[1]);
+		p_msg->r_data_len = pdu[1];
+	} else if (func & 0x80)
+		p_msg->err_code = pdu[1];
+
+	return true;
+}
+
+/**
+ * @brief 校验按帧间隔分好的一帧响应 帧长度必须与功能码一致 任何错误直接丢弃整帧
+ * 
  * @param handle 主机句柄
+ * @param frame 帧数据
+ * @param len 帧长度
+ * @return true 帧有效
+ * @return false 帧无效
  */
-static void _dispatch_rtu_msg(mb_mst_handle handle)
+static bool _recv_frame(mb_mst_handle handle, const uint8_t *frame, size_t len)
 {
-	if (!handle || is_queue_empty(&handle->msg_state.req_info_q))
+	size_t head = MODBUS_ADDR_BYTES_NUM + MODBUS_FUNC_BYTES_NUM;
+
+	if (len < head + 1 + MODBUS_CRC_BYTES_NUM ||
+		len > MODBUS_FRAME_BYTES_MAX || frame[0] != handle->cur->request.slave_addr)
+		return false;
+
+	if (crc16_update_bytes(0xffff, (uint8_t *)frame, len - MODBUS_CRC_BYTES_NUM) !=
+		COMBINE_U8_TO_U16(frame[len - 1], frame[len - 2]))
+		return false;
+
+	return _decode_pdu(handle, handle->cur, &frame[MODBUS_ADDR_BYTES_NUM],
+		len - MODBUS_ADDR_BYTES_NUM - MODBUS_CRC_BYTES_NUM);
+}
+
+/**
+ * @brief 从接收队列中相对当前解析位置 off 处拷贝数据
+ * 
+ * @param p_msg 接收信息
+ * @param off 偏移
+ * @param dst 目标缓冲
+ * @param len 拷贝长度
+ */
+static void copy_rx_queue(const struct msg_info *p_msg, size_t off, uint8_t *dst, size_t len)
+{
+	const uint8_t *ring = p_msg->rx_q.buf;
+	size_t pos = (p_msg->forward + off) & p_msg->rx_q.mask;
+	size_t first = p_msg->rx_q.buf_size - pos;
+
+	if (first > len)
+		first = len;
+
+	memcpy(dst, ring + pos, first);
+	memcpy(dst + first, ring, len - first);
+}
+
+/**
+ * @brief 解析Modbus TCP响应 按MBAP报文头中的长度划分帧边界, 按事务标识查找对应的请求
+ * 
+ * 找不到对应请求的响应(例如超时后才到达)直接丢弃
+ * 
+ * @param handle 主机句柄
+ * @param valid 输出 响应是否有效 单元标识或PDU与请求不符时为false
+ * @return struct req_info* 响应对应的请求 接收队列中没有完整帧返回NULL
+ */
+static struct req_info *_recv_tcp(mb_mst_handle handle, bool *valid)
+{
+	struct msg_info *p_msg = &handle->msg_state;
+	uint8_t mbap[MODBUS_TCP_MBAP_BYTES_NUM];
+	struct req_info *req_info_ptr;
+	size_t remain;
+	uint16_t len, tid;
+
+	while ((remain = check_rx_queue_remain_data(p_msg)) >= sizeof(mbap)) {
+		copy_rx_queue(p_msg, 0, mbap, sizeof(mbap));
+
+		len = COMBINE_U8_TO_U16(mbap[4], mbap[5]); // 单元标识 + PDU
+		if (mbap[2] || mbap[3] || len < 3 || len > MODBUS_TCP_PDU_BYTES_MAX + 1) {
+			rebase_parser(p_msg); // 协议标识或长度无效 逐字节重新同步
+			continue;
+		}
+
+		if (remain < sizeof(mbap) - 1 + len)
+			return NULL; // 断包 等待剩余数据
+
+		len -= MODBUS_ADDR_BYTES_NUM; // PDU长度
+		copy_rx_queue(p_msg, sizeof(mbap), p_msg->pdu, len);
+		p_msg->forward += sizeof(mbap) + len;
+		flush_parser(p_msg);
+
+		tid = COMBINE_U8_TO_U16(mbap[0], mbap[1]);
+		for (size_t i = 0; i < MAX_REQUEST; i++) {
+			req_info_ptr = &p_msg->req_infos[i];
+			if (!req_info_ptr->inflight || req_info_ptr->tid != tid)
+				continue;
+
+			p_msg->err_code = MODBUS_RESP_ERR_NONE;
+			*valid = (mbap[6] == req_info_ptr->request.slave_addr) && _decode_pdu(handle, req_info_ptr, p_msg->pdu, len);
+			return req_info_ptr;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief 请求结束等待响应
+ * 
+ * @param handle 主机句柄
+ * @param req_info_ptr 请求信息
+ */
+static void release_req(mb_mst_handle handle, struct req_info *req_info_ptr)
+{
+	if (!req_info_ptr->inflight)
 		return;
 
-	struct req_info *req_info_ptr = NULL;
-	queue_get(&handle->msg_state.req_info_q, &req_info_ptr, 1); // 出队
+	req_info_ptr->inflight = false;
+	handle->inflight--;
 
-	uint16_t wr_tmp_buf[MAX_WRITE_REG_NUM] = { 0 };
-	queue_get(&handle->msg_state.wr_q, wr_tmp_buf, req_info_ptr->reg_len); // 出队
+	if (handle->cur == req_info_ptr)
+		handle->cur = NULL;
+}
+
+/**
+ * @brief 释放请求
+ * 
+ * @param req_info_ptr 请求信息
+ */
+static void free_req_info(struct req_info *req_info_ptr)
+{
+	if (req_info_ptr->wr_data)
+		virtual_os_free(req_info_ptr->wr_data);
+
+	memset(req_info_ptr, 0, sizeof(struct req_info));
+}
+
+/**
+ * @brief 结束请求 调用用户回调后释放请求
+ * 
+ * @param handle 主机句柄
+ * @param req_info_ptr 请求信息
+ * @param is_timeout 是否超时
+ */
+static void finish_request(mb_mst_handle handle, struct req_info *req_info_ptr, bool is_timeout)
+{
+	struct msg_info *p_msg = &handle->msg_state;
+
+	release_req(handle, req_info_ptr);
+	list_delete_item(&req_info_ptr->node);
 
-	// 正常用户回调(未超时)
 	if (req_info_ptr->request.resp) {
-		req_info_ptr->request.resp(
-			handle->msg_state.r_data, handle->msg_state.r_data_len, handle->msg_state.err_code, false);
+		if (is_timeout)
+			req_info_ptr->request.resp(p_msg->r_data, 0, MODBUS_RESP_ERR_NONE, true); // 用户回调（超时）
+		else
+			req_info_ptr->request.resp(p_msg->r_data, p_msg->r_data_len, p_msg->err_code, false);
 	}
 
-	// 清空请求信息
-	if (req_info_ptr)
-		memset(req_info_ptr, 0, sizeof(struct req_info));
+	free_req_info(req_info_ptr);
+}
 
-	handle->msg_state.err_code = MODBUS_RESP_ERR_NONE; // 异常响应码清零
+/**
+ * @brief 查找从机调度信息
+ * 
+ * @param handle 主机句柄
+ * @param addr 从机地址
+ * @param create 不存在时是否分配
+ * @return struct slave_info* 失败返回NULL
+ */
+static struct slave_info *get_slave(mb_mst_handle handle, uint8_t addr, bool create)
+{
+	struct slave_info *idle = NULL;
+
+	for (size_t i = 0; i < MB_MST_MAX_SLAVES; i++) {
+		struct slave_info *slave = &handle->slaves[i];
+
+		if (slave->used && slave->addr == addr)
+			return slave;
+
+		// 未使用 或 无请求且不在退避中的从机可以复用
+		if (!idle && (!slave->used || (slave->reqs.next == &slave->reqs && !slave->backoff)))
+			idle = slave;
+	}
+
+	if (!create || !idle)
+		return NULL;
+
+	memset(idle, 0, sizeof(struct slave_info));
+	list_init(&idle->reqs);
+	idle->addr = addr;
+	idle->used = true;
+	return idle;
 }
 
 /**
- * @brief 检查当前请求回复是否超时
+ * @brief 获取请求的超时时间
+ * 
+ * 正常的从机使用请求设置的超时时间, 失败过的从机每次连续失败超时时间减半,
+ * 但不低于根据历史响应时间估计的超时时间和`MB_MST_RTO_MIN_MS`, 减少不响应的从机占用总线的时间
+ * 
+ * @param req_info_ptr 请求信息
+ * @return uint32_t 超时时间 单位ms
+ */
+static uint32_t get_timeout(const struct req_info *req_info_ptr)
+{
+	const struct slave_info *slave = req_info_ptr->slave;
+	uint32_t timeout = req_info_ptr->request.timeout_ms;
+	uint32_t rto;
+
+	if (!slave->fails)
+		return timeout;
+
+	rto = slave->srtt ? (slave->srtt >> 3) + slave->rttvar : 0;
+	if (rto < MB_MST_RTO_MIN_MS)
+		rto = MB_MST_RTO_MIN_MS;
+
+	timeout >>= (slave->fails < 16) ? slave->fails : 16;
+	if (timeout < rto)
+		timeout = rto;
+
+	return (timeout < req_info_ptr->request.timeout_ms) ? timeout : req_info_ptr->request.timeout_ms;
+}
+
+/**
+ * @brief 更新从机响应时间
+ * 
+ * @param slave 从机调度信息
+ * @param rtt 本次响应时间 单位ms
+ */
+static void update_rtt(struct slave_info *slave, uint32_t rtt)
+{
+	int32_t delta;
+
+	if (!slave->srtt) {
+		slave->srtt = (rtt << 3) ? (rtt << 3) : 1;
+		slave->rttvar = rtt << 1;
+		return;
+	}
+
+	delta = (int32_t)rtt - (int32_t)(slave->srtt >> 3);
+	slave->srtt += delta;
+	if (delta < 0)
+		delta = -delta;
+	slave->rttvar += delta - (slave->rttvar >> 2);
+
+	if (!slave->srtt)
+		slave->srtt = 1;
+}
+
+/**
+ * @brief 请求最终失败 从机进入退避, 连续失败过多时清空该从机的待处理请求
  * 
  * @param handle 主机句柄
- * @param request 请求包
- * @return true 超时
- * @return false 未超时
+ * @param slave 从机调度信息
+ */
+static void slave_fail(mb_mst_handle handle, struct slave_info *slave)
+{
+	list_item *pos, *n;
+	uint8_t shift;
+
+	if (slave->fails < UINT8_MAX)
+		slave->fails++;
+
+	shift = (slave->fails - 1 < 16) ? slave->fails - 1 : 16;
+	slave->backoff = MB_MST_BACKOFF_BASE_MS << shift;
+	if (slave->backoff > MB_MST_BACKOFF_MAX_MS)
+		slave->backoff = MB_MST_BACKOFF_MAX_MS;
+
+	if (slave->fails < MB_MST_OFFLINE_FAILS)
+		return;
+
+	// 从机离线 待处理请求直接超时 避免占满请求缓冲
+	list_for_each_safe(pos, n, &slave->reqs)
+	{
+		finish_request(handle, container_of(pos, struct req_info, node), true);
+	}
+}
+
+/**
+ * @brief 取消读请求合并
+ * 
+ * @param handle 主机句柄
+ * @param slave 从机调度信息
  */
-static bool check_timeout(size_t period, struct req_info *req_info_ptr)
+static void ungroup_reads(mb_mst_handle handle, struct slave_info *slave)
 {
-	if (!req_info_ptr)
-		return true;
+	list_item *pos;
+
+	for (pos = slave->reqs.next; pos != &slave->reqs; pos = pos->next)
+		container_of(pos, struct req_info, node)->grouped = false;
+
+	handle->grp_len = 0;
+}
+
+/**
+ * @brief 将同一从机队列中相邻或间隔较小的读寄存器请求与队首请求合并为一个请求
+ * 
+ * 只合并功能码相同的读寄存器请求, 不越过写请求, 合并后不超过`MAX_READ_REG_NUM`
+ * 
+ * @param handle 主机句柄
+ * @param head 即将发送的请求
+ */
+static void group_reads(mb_mst_handle handle, struct req_info *head)
+{
+	struct slave_info *slave = head->slave;
+	uint8_t func = head->request.func;
+	uint32_t lo = head->request.reg_addr;
+	uint32_t hi = lo + head->request.reg_len;
+	uint32_t start, end;
+	list_item *pos;
+	bool grouped = false;
+
+	handle->grp_len = 0;
+
+	if (slave->no_merge || (func != MODBUS_FUN_RD_REG_MUL && func != MODBUS_FUN_RD_INPUT_REG))
+		return;
+
+	for (pos = head->node.next; pos != &slave->reqs; pos = pos->next) {
+		struct req_info *req = container_of(pos, struct req_info, node);
+
+		if (!MODBUS_FUNC_IS_READ(req->request.func))
+			break; // 不越过写请求 保证读写顺序
+
+		if (req->request.func != func)
+			continue;
+
+		start = req->request.reg_addr;
+		end = start + req->request.reg_len;
+		if (start > hi + MB_MST_COALESCE_GAP || end + MB_MST_COALESCE_GAP < lo)
+			continue; // 间隔过大
+
+		if (((end > hi) ? end : hi) - ((start < lo) ? start : lo) > MAX_READ_REG_NUM)
+			continue; // 合并后过长
 
-	req_info_ptr->cur_ctr += period; // 累加超时时间
-	if (req_info_ptr->cur_ctr > req_info_ptr->to_timeout) {
-		req_info_ptr->cur_ctr = 0;	  // 超时后重置计时器
-		req_info_ptr->repeat_times++; // 增加重发次数标志
-		return true;				  // 超时
+		lo = (start < lo) ? start : lo;
+		hi = (end > hi) ? end : hi;
+		req->grouped = true;
+		grouped = true;
 	}
 
-	return false; // 未超时
+	if (!grouped)
+		return;
+
+	head->grouped = true;
+	handle->grp_addr = lo;
+	handle->grp_len = hi - lo;
 }
 
 /**
- * @brief 发送请求
+ * @brief 本次发送没有收到有效响应 还有重发次数时留在队首等待重发
  * 
  * @param handle 主机句柄
- * @param request 请求包
+ * @param req_info_ptr 请求信息
  */
-static void _request_pdu(mb_mst_handle handle, struct req_info *req_info_ptr)
+static void request_fail(mb_mst_handle handle, struct req_info *req_info_ptr)
 {
-	if (!handle || !check_request_valid(&req_info_ptr->request))
+	struct slave_info *slave = req_info_ptr->slave;
+	list_item *pos, *n;
+
+	release_req(handle, req_info_ptr);
+
+	if (!NO_RETRIES && req_info_ptr->repeat_times < MASTER_REPEATS) {
+		ungroup_reads(handle, slave); // 重发时重新合并
 		return;
+	}
 
-	uint8_t temp_buf[256] = { 0 };
-	uint16_t idx = 0;
-	temp_buf[idx++] = req_info_ptr->request.slave_addr;
-	temp_buf[idx++] = req_info_ptr->request.func;
+	if (handle->grp_len) {
+		// 合并的读请求全部超时
+		list_for_each_safe(pos, n, &slave->reqs)
+		{
+			struct req_info *member = container_of(pos, struct req_info, node);
+			if (member->grouped)
+				finish_request(handle, member, true);
+		}
+		handle->grp_len = 0;
+	} else
+		finish_request(handle, req_info_ptr, true);
+
+	slave_fail(handle, slave);
+}
+
+/**
+ * @brief 合并的读请求收到响应 按各自的寄存器范围拆分后分别回调
+ * 
+ * @param handle 主机句柄
+ * @param slave 从机调度信息
+ */
+static void finish_group(mb_mst_handle handle, struct slave_info *slave)
+{
+	struct msg_info *p_msg = &handle->msg_state;
+	list_item *pos, *n;
+
+	list_for_each_safe(pos, n, &slave->reqs)
+	{
+		struct req_info *member = container_of(pos, struct req_info, node);
+		if (!member->grouped)
+			continue;
+
+		list_delete_item(&member->node);
+		if (member->request.resp) {
+			member->request.resp(&p_msg->r_data[(member->request.reg_addr - handle->grp_addr) << 1],
+				member->request.reg_len << 1, MODBUS_RESP_ERR_NONE, false);
+		}
+		free_req_info(member);
+	}
 
-	temp_buf[idx++] = GET_U8_HIGH_FROM_U16(req_info_ptr->request.reg_addr);
-	temp_buf[idx++] = GET_U8_LOW_FROM_U16(req_info_ptr->request.reg_addr);
-	temp_buf[idx++] = GET_U8_HIGH_FROM_U16(req_info_ptr->request.reg_len);
-	temp_buf[idx++] = GET_U8_LOW_FROM_U16(req_info_ptr->request.reg_len);
+	handle->grp_len = 0;
+}
 
-	// 写功能玛
-	if (req_info_ptr->request.func == MODBUS_FUN_WR_REG_MUL) {
-		temp_buf[idx++] = req_info_ptr->request.reg_len << 1;
+/**
+ * @brief 收到有效响应
+ *
+ * @param handle 主机句柄
+ * @param req_info_ptr 响应对应的请求
+ */
+static void _dispatch_msg(mb_mst_handle handle, struct req_info *req_info_ptr)
+{
+	struct slave_info *slave = req_info_ptr->slave;
+
+	if (handle->grp_len) {
+		if (handle->msg_state.err_code != MODBUS_RESP_ERR_NONE) {
+			// 合并范围内可能有从机不支持的寄存器 之后不再合并 本次不计入发送次数 逐个重新发送
+			slave->no_merge = true;
+			req_info_ptr->repeat_times--;
+			release_req(handle, req_info_ptr);
+			ungroup_reads(handle, slave);
+			handle->msg_state.err_code = MODBUS_RESP_ERR_NONE;
+			return;
+		}
 
-		uint16_t wr_tmp_buf[MAX_WRITE_REG_NUM] = { 0 };
-		queue_peek(&handle->msg_state.wr_q, wr_tmp_buf, req_info_ptr->reg_len); // 拷贝写数据内容 这里不一定会出队
+		if (handle->msg_state.r_data_len != (handle->grp_len << 1)) {
+			request_fail(handle, req_info_ptr); // 响应长度与请求不符
+			return;
+		}
+	}
+
+	release_req(handle, req_info_ptr);
+
+	update_rtt(slave, req_info_ptr->cur_ctr);
+	slave->fails = 0;
+	slave->backoff = 0;
+
+	if (handle->grp_len)
+		finish_group(handle, slave);
+	else
+		finish_request(handle, req_info_ptr, false);
 
-		for (uint8_t i = 0; i < req_info_ptr->request.reg_len; i++) {
-			temp_buf[idx++] = GET_U8_HIGH_FROM_U16(wr_tmp_buf[i]);
-			temp_buf[idx++] = GET_U8_LOW_FROM_U16(wr_tmp_buf[i]);
+	handle->msg_state.err_code = MODBUS_RESP_ERR_NONE; // 异常响应码清零
+}
+
+/**
+ * @brief 生成请求PDU 与传输方式无关
+ * 
+ * @param handle 主机句柄
+ * @param req_info_ptr 请求信息
+ * @param pdu 输出 从功能码开始
+ * @return uint16_t PDU长度
+ */
+static uint16_t _build_pdu(mb_mst_handle handle, struct req_info *req_info_ptr, uint8_t *pdu)
+{
+	uint16_t idx = 0;
+	pdu[idx++] = req_info_ptr->request.func;
+
+	// 合并的读请求使用合并后的范围
+	uint16_t reg_addr = handle->grp_len ? handle->grp_addr : req_info_ptr->request.reg_addr;
+	uint16_t reg_len = handle->grp_len ? handle->grp_len : req_info_ptr->request.reg_len;
+
+	pdu[idx++] = GET_U8_HIGH_FROM_U16(reg_addr);
+	pdu[idx++] = GET_U8_LOW_FROM_U16(reg_addr);
+	pdu[idx++] = GET_U8_HIGH_FROM_U16(reg_len);
+	pdu[idx++] = GET_U8_LOW_FROM_U16(reg_len);
+
+	uint8_t func = req_info_ptr->request.func;
+	const uint16_t *wr_tmp_buf = req_info_ptr->wr_data; // 写数据内容
+
+	if (MODBUS_FUNC_IS_SINGLE(func)) {
+		// 写单个线圈/寄存器 数量字段替换为写入的值
+		uint16_t value = wr_tmp_buf[0];
+		if (func == MODBUS_FUN_WR_COIL)
+			value = (value & 1) ? MODBUS_COIL_ON : MODBUS_COIL_OFF;
+
+		idx -= MODBUS_REG_LEN_BYTES_NUM;
+		pdu[idx++] = GET_U8_HIGH_FROM_U16(value);
+		pdu[idx++] = GET_U8_LOW_FROM_U16(value);
+	} else if (func == MODBUS_FUN_WR_COIL_MUL) {
+		// 第i个线圈取自 wr_tmp_buf[i/16] 的 bit(i%16)
+		uint8_t bytes = (req_info_ptr->request.reg_len + 7) >> 3;
+		pdu[idx++] = bytes;
+
+		for (uint8_t i = 0; i < bytes; i++)
+			pdu[idx++] = (wr_tmp_buf[i >> 1] >> ((i & 1) << 3)) & 0xff;
+		if (req_info_ptr->request.reg_len & 7)
+			pdu[idx - 1] &= (1 << (req_info_ptr->request.reg_len & 7)) - 1; // 清除多余的位
+	} else if (func == MODBUS_FUN_WR_REG_MUL) {
+		pdu[idx++] = req_info_ptr->request.reg_len << 1;
+
+		for (uint16_t i = 0; i < req_info_ptr->request.reg_len; i++) {
+			pdu[idx++] = GET_U8_HIGH_FROM_U16(wr_tmp_buf[i]);
+			pdu[idx++] = GET_U8_LOW_FROM_U16(wr_tmp_buf[i]);
 		}
 	}
 
+	return idx;
+}
+
+/**
+ * @brief 发送RTU请求 在请求PDU前加上从机地址, 之后加上CRC
+ * 
+ * @param handle 主机句柄
+ * @param request 请求包
+ */
+static void _request_pdu(mb_mst_handle handle, struct req_info *req_info_ptr)
+{
+	if (!handle || !check_request_valid(&req_info_ptr->request))
+		return;
+
+	uint8_t temp_buf[MODBUS_FRAME_BYTES_MAX] = { 0 };
+	uint16_t idx = 0;
+
+	temp_buf[idx++] = req_info_ptr->request.slave_addr;
+	idx += _build_pdu(handle, req_info_ptr, &temp_buf[idx]);
+
 	uint16_t crc = crc16_update_bytes(0xFFFF, temp_buf, idx);
 
 	temp_buf[idx++] = GET_U8_LOW_FROM_U16(crc);
@@ -409,134 +900,223 @@ static void _request_pdu(mb_mst_handle handle, struct req_info *req_info_ptr)
 }
 
 /**
- * @brief 从发送队列中取出数据, 并发送
+ * @brief 发送TCP请求 在请求PDU前加上MBAP报文头 每次发送使用新的事务标识
  * 
- * @param handle 
+ * @param handle 主机句柄
+ * @param req_info_ptr 请求信息
  */
-static void master_write(mb_mst_handle handle)
+static void _request_tcp(mb_mst_handle handle, struct req_info *req_info_ptr)
 {
-	if (!handle || is_queue_empty(&handle->msg_state.req_info_q))
-		return;
+	uint8_t temp_buf[MODBUS_TCP_FRAME_BYTES_MAX];
+	uint16_t len;
 
-	struct req_info *req_info_ptr = NULL;
-	queue_peek(&handle->msg_state.req_info_q, &req_info_ptr, 1); // 不出队，只查看
+	req_info_ptr->tid = handle->tid++;
+	len = _build_pdu(handle, req_info_ptr, &temp_buf[MODBUS_TCP_MBAP_BYTES_NUM]);
 
-	uint16_t wr_tmp_buf[MAX_WRITE_REG_NUM] = { 0 };
-	queue_peek(&handle->msg_state.wr_q, wr_tmp_buf, req_info_ptr->reg_len); // 拷贝写数据内容 这里不一定会出队
+	temp_buf[0] = GET_U8_HIGH_FROM_U16(req_info_ptr->tid);
+	temp_buf[1] = GET_U8_LOW_FROM_U16(req_info_ptr->tid);
+	temp_buf[2] = 0; // 协议标识
+	temp_buf[3] = 0;
+	temp_buf[4] = GET_U8_HIGH_FROM_U16(len + MODBUS_ADDR_BYTES_NUM);
+	temp_buf[5] = GET_U8_LOW_FROM_U16(len + MODBUS_ADDR_BYTES_NUM);
+	temp_buf[6] = req_info_ptr->request.slave_addr; // 单元标识
 
-	// 不重发
-	if (NO_RETRIES) {
-		// 初始包直接发
-		if (req_info_ptr->cur_ctr == 0 && handle->sem) {
-			handle->sem--;								// 获取信号量
-			req_info_ptr->cur_ctr += handle->period_ms; // 累加超时时间
-			req_info_ptr->repeat_times++;				// 增加重发次数标志
-			_request_pdu(handle, req_info_ptr);			// 发送第一包请求
-			return;
-		} else if (check_timeout(handle->period_ms, req_info_ptr)) {
-			// 超时后从队列中移除
+	handle->opts->f_write(temp_buf, MODBUS_TCP_MBAP_BYTES_NUM + len);
+}
 
-			struct req_info *req_info_ptr = NULL;
-			queue_get(&handle->msg_state.req_info_q, &req_info_ptr, 1);
+/**
+ * @brief 轮询各从机 取出下一个待发送的请求 退避中的从机跳过
+ * 
+ * @param handle 主机句柄
+ * @return struct req_info* 没有待发送的请求返回NULL
+ */
+static struct req_info *pick_request(mb_mst_handle handle)
+{
+	list_item *pos;
 
-			uint16_t wr_tmp_buf[MAX_WRITE_REG_NUM] = { 0 };
-			queue_get(&handle->msg_state.wr_q, wr_tmp_buf, req_info_ptr->reg_len);
+	for (size_t i = 0; i < MB_MST_MAX_SLAVES; i++) {
+		size_t idx = (handle->rr + i) % MB_MST_MAX_SLAVES;
+		struct slave_info *slave = &handle->slaves[idx];
 
-			// 用户回调（超时）
-			if (req_info_ptr->request.resp)
-				req_info_ptr->request.resp(
-					handle->msg_state.r_data, handle->msg_state.r_data_len, MODBUS_RESP_ERR_NONE, true);
+		if (!slave->used || slave->backoff)
+			continue;
 
-			if (req_info_ptr)
-				memset(req_info_ptr, 0, sizeof(struct req_info));
+		// 同一从机的请求按提交顺序发送 TCP下跳过已发送的请求
+		for (pos = slave->reqs.next; pos != &slave->reqs; pos = pos->next) {
+			struct req_info *req_info_ptr = container_of(pos, struct req_info, node);
+			if (req_info_ptr->inflight)
+				continue;
 
-			handle->sem++; // 释放信号量
+			handle->rr = (idx + 1) % MB_MST_MAX_SLAVES;
+			return req_info_ptr;
 		}
-	} else {
-		if (req_info_ptr->repeat_times < MASTER_REPEATS) {
-			// 未重发完
-
-			// 初始包直接发
-			if (req_info_ptr->cur_ctr == 0 && !handle->sem) {
-				handle->sem++;
-				req_info_ptr->cur_ctr += handle->period_ms; // 累加超时时间
-				req_info_ptr->repeat_times++;				// 增加重发次数标志
-				_request_pdu(handle, req_info_ptr);			// 发送第一包请求
-				return;
-			} else {
-				check_timeout(handle->period_ms, req_info_ptr); // 检查超时
-			}
-		} else {
-			// 重发完后 从队列中移除
-			struct req_info *req_info_ptr = NULL;
-			queue_get(&handle->msg_state.req_info_q, &req_info_ptr, 1);
+	}
 
-			uint16_t wr_tmp_buf[MAX_WRITE_REG_NUM] = { 0 };
-			queue_get(&handle->msg_state.wr_q, wr_tmp_buf, req_info_ptr->reg_len);
+	return NULL;
+}
 
-			// 用户回调（超时）
-			if (req_info_ptr->request.resp)
-				req_info_ptr->request.resp(
-					handle->msg_state.r_data, handle->msg_state.r_data_len, MODBUS_RESP_ERR_NONE, true);
+/**
+ * @brief 发送请求 RTU同一时间只有一个请求等待响应, TCP最多`MB_MST_TCP_MAX_INFLIGHT`个
+ * 
+ * @param handle 主机句柄
+ */
+static void master_write(mb_mst_handle handle)
+{
+	struct msg_info *p_msg = &handle->msg_state;
+	uint8_t window = handle->tcp ? MB_MST_TCP_MAX_INFLIGHT : 1;
+	struct req_info *req_info_ptr;
+
+	while (handle->inflight < window) {
+		req_info_ptr = pick_request(handle);
+		if (!req_info_ptr)
+			return;
 
-			if (req_info_ptr)
-				memset(req_info_ptr, 0, sizeof(struct req_info));
+		if (!handle->tcp) {
+			handle->cur = req_info_ptr;
 
-			handle->sem--;
+			// 丢弃之前残留的数据 例如超时后才到达的响应
+			p_msg->rx_q.rd = p_msg->rx_q.wr;
+			p_msg->anchor = p_msg->rx_q.wr;
+			p_msg->forward = p_msg->rx_q.wr;
+			p_msg->state = RX_STATE_ADDR;
+			p_msg->err_code = MODBUS_RESP_ERR_NONE;
+
+			if (MB_MST_COALESCE_ENABLE)
+				group_reads(handle, req_info_ptr);
 		}
+
+		req_info_ptr->inflight = true;
+		handle->inflight++;
+
+		req_info_ptr->cur_ctr = 0;
+		req_info_ptr->repeat_times++;
+		if (handle->tcp)
+			_request_tcp(handle, req_info_ptr);
+		else
+			_request_pdu(handle, req_info_ptr);
+	}
+}
+
+/**
+ * @brief 接收TCP响应 依次处理接收队列中的所有完整帧
+ * 
+ * @param handle 主机句柄
+ */
+static void master_read_tcp(mb_mst_handle handle)
+{
+	struct req_info *req_info_ptr;
+	bool valid;
+
+	queue_fill(&(handle->msg_state.rx_q), handle->opts->f_read, MODBUS_FRAME_BYTES_MAX);
+
+	while ((req_info_ptr = _recv_tcp(handle, &valid))) {
+		if (valid)
+			_dispatch_msg(handle, req_info_ptr); // 处理数据帧, 调用用户回调
+		else
+			request_fail(handle, req_info_ptr); // 已收到该事务的响应 无效响应不必等到超时
 	}
 }
 
+/**
+ * @brief 接收响应
+ * 
+ * @param handle 主机句柄
+ */
 static void master_read(mb_mst_handle handle)
 {
-	if (!handle || is_queue_empty(&handle->msg_state.req_info_q))
+	size_t ptk_len;
+	bool ret_parser;
+
+	if (handle->tcp) {
+		master_read_tcp(handle);
 		return;
+	}
 
-	size_t ptk_len; // 响应长度
+	if (!handle->cur)
+		return;
 
-	uint8_t temp_buf[MODBUS_FRAME_BYTES_MAX] = { 0 };
+	if (handle->opts->f_read_frame) {
+		// 按帧间隔分帧 帧模式下不使用接收队列 直接使用其缓冲区存储一帧
+		uint8_t *frame = handle->msg_state.rx_queue_buff;
 
-	ptk_len = handle->opts->f_read(temp_buf, MODBUS_FRAME_BYTES_MAX);
-	if (!ptk_len) // 无数据
-		return;
+		ptk_len = handle->opts->f_read_frame(frame, RX_BUFF_SIZE);
+		if (!ptk_len)
+			return; // 无完整帧
 
-	size_t ret_q = queue_add(&(handle->msg_state.rx_q), temp_buf, ptk_len);
-	if (ret_q != ptk_len)
-		return; // 空间不足
+		ret_parser = _recv_frame(handle, frame, ptk_len); // 校验数据帧
+		if (!ret_parser) {
+			request_fail(handle, handle->cur); // 帧间隔已确定响应结束 无效帧不必等到超时
+			return;
+		}
+	} else {
+		// 直接读入接收队列
+		ptk_len = queue_fill(&(handle->msg_state.rx_q), handle->opts->f_read, MODBUS_FRAME_BYTES_MAX);
+		if (!ptk_len) // 无数据或空间不足
+			return;
 
-	bool ret_parser = _recv_parser(handle); // 解析数据帧
+		ret_parser = _recv_parser(handle); // 解析数据帧
+		if (!ret_parser)
+			return;
+	}
 
-	if (!ret_parser)
-		return;
+	_dispatch_msg(handle, handle->cur); // 处理数据帧, 调用用户回调
+}
+
+/**
+ * @brief 更新超时和退避计时
+ * 
+ * @param handle 主机句柄
+ */
+static void master_timer(mb_mst_handle handle)
+{
+	for (size_t i = 0; i < MB_MST_MAX_SLAVES; i++) {
+		struct slave_info *slave = &handle->slaves[i];
+		slave->backoff = (slave->backoff > handle->period_ms) ? slave->backoff - handle->period_ms : 0;
+	}
 
-	_dispatch_rtu_msg(handle); // 处理数据帧, 调用用户回调注册表
+	if (!handle->inflight)
+		return;
 
-	handle->sem++; // 释放信号量
+	for (size_t i = 0; i < MAX_REQUEST; i++) {
+		if (handle->msg_state.req_infos[i].inflight)
+			handle->msg_state.req_infos[i].cur_ctr += handle->period_ms;
+	}
 }
 
-/***************************API***************************/
+/**
+ * @brief 检查等待响应的请求是否超时
+ * 
+ * @param handle 主机句柄
+ */
+static void master_check_timeout(mb_mst_handle handle)
+{
+	for (size_t i = 0; i < MAX_REQUEST && handle->inflight; i++) {
+		struct req_info *req_info_ptr = &handle->msg_state.req_infos[i];
+
+		if (req_info_ptr->inflight && req_info_ptr->cur_ctr >= get_timeout(req_info_ptr))
+			request_fail(handle, req_info_ptr);
+	}
+}
 
 /**
- * @brief 主机初始化并申请句柄
+ * @brief 申请主机句柄
  *
  * @param opts 读写等回调函数指针
  * @param period_ms 轮训周期
+ * @param tcp 是否为Modbus TCP
  * @return mb_mst_handle 成功返回句柄,失败返回NULL
  */
-mb_mst_handle mb_mst_init(struct serial_opts *opts, size_t period_ms)
+static mb_mst_handle _mst_create(struct serial_opts *opts, size_t period_ms, bool tcp)
 {
 	bool ret = false;
 
-	if (!opts || !opts->f_init || !opts->f_read || !opts->f_write)
-		return NULL;
-
 	struct mb_mst *handle = virtual_os_calloc(1, sizeof(struct mb_mst));
 	if (!handle)
 		return NULL;
 
 	handle->opts = opts;
 	handle->period_ms = period_ms;
-	handle->sem = 1;
+	handle->tcp = tcp;
 
 	// 接收队列
 	ret = queue_init(&handle->msg_state.rx_q, sizeof(uint8_t), handle->msg_state.rx_queue_buff, RX_BUFF_SIZE);
@@ -545,29 +1125,46 @@ mb_mst_handle mb_mst_init(struct serial_opts *opts, size_t period_ms)
 		return NULL;
 	}
 
-	// 写功能码缓冲区
-	ret = queue_init(&handle->msg_state.wr_q, sizeof(uint16_t), handle->msg_state.wr_reg_data, MAX_WRITE_REG_NUM);
+	// 用户串口初始化
+	ret = opts->f_init();
 	if (!ret) {
 		virtual_os_free(handle);
 		return NULL;
 	}
 
-	// 请求信息缓冲区
-	ret = queue_init(
-		&handle->msg_state.req_info_q, sizeof(struct req_info *), handle->msg_state.req_infos_q_buf, MAX_REQUEST);
-	if (!ret) {
-		virtual_os_free(handle);
+	return handle;
+}
+
+/***************************API***************************/
+
+/**
+ * @brief 主机初始化并申请句柄
+ *
+ * @param opts 读写等回调函数指针
+ * @param period_ms 轮训周期
+ * @return mb_mst_handle 成功返回句柄,失败返回NULL
+ */
+mb_mst_handle mb_mst_init(struct serial_opts *opts, size_t period_ms)
+{
+	if (!opts || !opts->f_init || (!opts->f_read && !opts->f_read_frame) || !opts->f_write)
 		return NULL;
-	}
 
-	// 用户串口初始化
-	ret = opts->f_init();
-	if (!ret) {
-		virtual_os_free(handle);
+	return _mst_create(opts, period_ms, false);
+}
+
+/**
+ * @brief Modbus TCP主机初始化并申请句柄
+ *
+ * @param opts socket收发等回调函数指针 不使用 f_read_frame
+ * @param period_ms 轮训周期
+ * @return mb_mst_handle 成功返回句柄,失败返回NULL
+ */
+mb_mst_handle mb_mst_tcp_init(struct serial_opts *opts, size_t period_ms)
+{
+	if (!opts || !opts->f_init || !opts->f_read || !opts->f_write)
 		return NULL;
-	}
 
-	return handle;
+	return _mst_create(opts, period_ms, true);
 }
 
 /**
@@ -580,6 +1177,11 @@ void mb_mst_destroy(mb_mst_handle handle)
 	if (!handle)
 		return;
 
+	for (size_t i = 0; i < MAX_REQUEST; i++) {
+		if (handle->msg_state.req_infos[i].valid)
+			free_req_info(&handle->msg_state.req_infos[i]);
+	}
+
 	virtual_os_free(handle);
 }
 
@@ -593,9 +1195,13 @@ void mb_mst_poll(mb_mst_handle handle)
 	if (!handle)
 		return;
 
+	master_timer(handle); // 超时和退避计时
+
 	master_read(handle); // 接收处理
 
-	master_write(handle); // 发送处理
+	master_check_timeout(handle); // 超时未响应
+
+	master_write(handle); // 收到响应或超时后立即发送下一个请求
 }
 
 /**
@@ -606,17 +1212,29 @@ void mb_mst_poll(mb_mst_handle handle)
  * @param reg_data 寄存器数据 仅在request的功能码为写请求时有效
  * @param reg_len 寄存器长度 仅在request的功能码为写请求时有效
  */
-void mb_mst_pdu_request(mb_mst_handle handle, struct mb_mst_request *request, uint16_t *reg_data, uint8_t reg_len)
+void mb_mst_pdu_request(mb_mst_handle handle, struct mb_mst_request *request, uint16_t *reg_data, uint16_t reg_len)
 {
 	if (!handle || !check_request_valid(request))
 		return;
 
+	bool is_write = !MODBUS_FUNC_IS_READ(request->func);
+
 	// 写请求时 写的寄存器长度要等于请求的寄存器长度
-	if (request->func == MODBUS_FUN_WR_REG_MUL && reg_len != request->reg_len)
+	if (is_write && reg_len != request->reg_len)
 		return;
 
 	// 写请求时 寄存器数据有效
-	if (request->func == MODBUS_FUN_WR_REG_MUL && (reg_len > MAX_WRITE_REG_NUM || reg_len == 0 || !reg_data))
+	if (is_write && (reg_len == 0 || !reg_data))
+		return;
+
+	// 写多个线圈时 reg_data 按位存放 占用的字数
+	if (request->func == MODBUS_FUN_WR_COIL_MUL)
+		reg_len = (reg_len + 15) >> 4;
+	else if (!is_write)
+		reg_len = 0;
+
+	struct slave_info *slave = get_slave(handle, request->slave_addr, true);
+	if (!slave)
 		return;
 
 	// 申请一个空闲的请求信息
@@ -626,12 +1244,19 @@ void mb_mst_pdu_request(mb_mst_handle handle, struct mb_mst_request *request, ui
 
 	memset(new_req_info, 0, sizeof(struct req_info));
 	memcpy(&new_req_info->request, request, sizeof(struct mb_mst_request));
-	new_req_info->cur_ctr = 0;
-	new_req_info->repeat_times = 0;
-	new_req_info->to_timeout = request->timeout_ms;
+	new_req_info->slave = slave;
 	new_req_info->reg_len = reg_len;
 	new_req_info->valid = true;
 
-	queue_add(&handle->msg_state.req_info_q, &new_req_info, 1); // 保存请求信息
-	queue_add(&handle->msg_state.wr_q, reg_data, reg_len);		// 拷贝写数据内容
+	// 拷贝写数据内容
+	if (reg_len) {
+		new_req_info->wr_data = virtual_os_malloc(reg_len * sizeof(uint16_t));
+		if (!new_req_info->wr_data) {
+			free_req_info(new_req_info);
+			return;
+		}
+		memcpy(new_req_info->wr_data, reg_data, reg_len * sizeof(uint16_t));
+	}
+
+	list_add_tail(&slave->reqs, &new_req_info->node); // 加入从机请求队列
 }
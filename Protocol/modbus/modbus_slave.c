@@ -32,6 +32,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "utils/crc.h"
 #include "utils/log.h"
@@ -49,7 +50,7 @@ enum rx_state {
 	RX_STATE_CRC,	   // CRC校验
 };
 
-// 读数据帧
+// 读数据帧 写单个线圈/寄存器时 num 为写入的值
 struct pdu_read {
 	uint8_t reg_h;
 	uint8_t reg_l;
@@ -78,14 +79,17 @@ struct msg_info {
 		uint8_t data[MODBUS_FRAME_BYTES_MAX];
 	} pdu;					// 数据帧
 	struct queue_info rx_q; // 接收队列
+	const uint8_t *p_pdu;	// 待处理的数据帧 指向接收队列(原地解析)或 pdu
 
 	size_t anchor;	// 滑动左窗口
 	size_t forward; // 滑动右窗口
 
 	uint16_t cal_crc; // 计算的CRC
 
-	uint8_t addr; // 从机地址
-	uint8_t func; // 功能码
+	uint16_t tid;	 // 事务标识 仅TCP
+	uint8_t addr;	 // 从机地址 TCP下为单元标识
+	uint8_t func;	 // 功能码
+	uint8_t req_err; // 请求异常码 仅TCP 帧长度已知, 功能码或长度无效时回复异常响应
 
 	uint8_t pdu_in;	 // 接收索引
 	uint8_t pdu_len; // 接收长度
@@ -95,19 +99,22 @@ struct msg_info {
 
 // 从机
 struct mb_slv {
-	struct msg_info msg_state;						   // 接收信息
-	uint8_t modbus_frame_buff[MODBUS_FRAME_BYTES_MAX]; // 回复缓冲
-	uint16_t data_in_out[MAX_READ_REG_NUM];			   // 用户交互缓冲
+	struct msg_info msg_state;							   // 接收信息
+	uint8_t modbus_frame_buff[MODBUS_TCP_FRAME_BYTES_MAX]; // 回复缓冲
+	uint8_t *pdu_out;									   // 回复的PDU 位于帧头(地址或MBAP报文头)之后
+	uint16_t data_in_out[MAX_READ_REG_NUM];				   // 用户交互缓冲
 
 	struct serial_opts *opts;		// 回调指针
-	struct mb_slv_work *work_table; // 响应处理表
+	struct mb_slv_work *work_table; // 响应处理表 按起始寄存器排序后的副本
 	size_t table_num;				// 响应处理表数量
 
 	uint8_t slave_addr; // 从机地址
+	bool tcp;			// 是否为Modbus TCP
 };
 
 static bool _recv_parser(mb_slv_handle handle);			 // 解析数据
 static uint16_t _dispatch_rtu_msg(mb_slv_handle handle); // 处理数据
+static uint16_t _dispatch_tcp_msg(mb_slv_handle handle); // 处理TCP数据
 
 // 剩余数据
 static inline size_t check_rx_queue_remain_data(const struct msg_info *p_msg)
@@ -119,7 +126,7 @@ static inline size_t check_rx_queue_remain_data(const struct msg_info *p_msg)
 static inline uint8_t get_rx_queue_remain_data(const struct msg_info *p_msg)
 {
 	uint8_t *p = p_msg->rx_q.buf;
-	return p[p_msg->forward & (p_msg->rx_q.buf_size - 1)];
+	return p[p_msg->forward & p_msg->rx_q.mask];
 }
 
 /**
@@ -149,48 +156,212 @@ static void flush_parser(struct msg_info *p_msg)
 	p_msg->anchor = p_msg->rx_q.rd;
 }
 
+// 功能码帧长表 用于在接收队列中直接划分帧边界
+struct func_frame_len {
+	uint8_t info_len; // 信息长度 不含地址,功能码和CRC
+	bool has_data;	  // 信息之后是否还有数据 数据长度由信息中的字节数字段给出
+};
+
+#define FUNC_FRAME_LEN_TABLE_SIZE (MODBUS_FUN_WR_REG_MUL + 1)
+
+static const struct func_frame_len func_frame_len_table[FUNC_FRAME_LEN_TABLE_SIZE] = {
+	[MODBUS_FUN_RD_COIL] = { sizeof(struct pdu_read), false },
+	[MODBUS_FUN_RD_DISC] = { sizeof(struct pdu_read), false },
+	[MODBUS_FUN_RD_REG_MUL] = { sizeof(struct pdu_read), false },
+	[MODBUS_FUN_RD_INPUT_REG] = { sizeof(struct pdu_read), false },
+	[MODBUS_FUN_WR_COIL] = { sizeof(struct pdu_read), false },
+	[MODBUS_FUN_WR_REG] = { sizeof(struct pdu_read), false },
+	[MODBUS_FUN_WR_COIL_MUL] = { sizeof(struct pdu_write), true },
+	[MODBUS_FUN_WR_REG_MUL] = { sizeof(struct pdu_write), true },
+};
+
 // 获取读/写帧的信息长度
-static uint8_t get_pdu_mini_len(uint8_t func)
+static inline uint8_t get_pdu_mini_len(uint8_t func)
 {
-	switch (func) {
-	case MODBUS_FUN_RD_REG_MUL:
-		return sizeof(struct pdu_read);
-	case MODBUS_FUN_WR_REG_MUL:
-		return sizeof(struct pdu_write);
-	default:
-		return 0;
-	}
+	return (func < FUNC_FRAME_LEN_TABLE_SIZE) ? func_frame_len_table[func].info_len : 0;
 }
 
 /**
- * @brief 获取需要接收的数据长度
+ * @brief 获取信息之后需要接收的数据长度
  * 
- * @param p_msg 
- * @return uint8_t 
+ * @param func 功能码
+ * @param info 已接收的信息
+ * @return uint8_t 数据长度 信息无效时返回0
  */
-static uint8_t get_pdu_extern_len(const struct msg_info *p_msg)
+static uint8_t get_pdu_extern_len(uint8_t func, const uint8_t *info)
 {
+	const struct pdu_write *write = (const struct pdu_write *)info;
 	uint16_t len = 0;
 	uint16_t reg_num;
 
-	if (p_msg->func != MODBUS_FUN_RD_REG_MUL) {
-		len += p_msg->pdu.write.len;
-		reg_num = COMBINE_U8_TO_U16(p_msg->pdu.write.num_h, p_msg->pdu.write.num_l);
+	if (func < FUNC_FRAME_LEN_TABLE_SIZE && func_frame_len_table[func].has_data) {
+		len += write->len;
+		reg_num = COMBINE_U8_TO_U16(write->num_h, write->num_l);
 
-		if ((p_msg->pdu.write.len != (reg_num << 1)) || (len > MODBUS_FRAME_BYTES_MAX))
+		if (!reg_num || !CHECK_REG_NUM_VALID(reg_num, func))
+			len = 0;
+		else if (write->len != (MODBUS_FUNC_IS_BIT(func) ? ((reg_num + 7) >> 3) : (reg_num << 1)))
 			len = 0;
 	}
 	return len;
 }
 
+/**
+ * @brief 校验请求PDU的长度 必须与功能码帧长表一致
+ * 
+ * @param func 功能码 必须有效
+ * @param info 功能码之后的数据
+ * @param len 功能码之后的数据长度
+ * @return true 长度有效
+ * @return false 长度无效
+ */
+static bool check_pdu_len(uint8_t func, const uint8_t *info, size_t len)
+{
+	size_t info_len = get_pdu_mini_len(func);
+	size_t ex_len = 0;
+
+	if (len < info_len)
+		return false;
+
+	if (func_frame_len_table[func].has_data) {
+		ex_len = get_pdu_extern_len(func, info);
+		if (!ex_len)
+			return false;
+	}
+
+	return (len == info_len + ex_len);
+}
+
 static uint8_t check_user_err_code(uint8_t err_code)
 {
 	return (err_code <= MODBUS_RESP_ERR_BUSY ? err_code : MODBUS_RESP_ERR_BUSY);
 }
 
+// 整帧解析结果
+enum fast_result {
+	FAST_NONE = 0, // 接收队列中没有完整帧 交给逐字节解析
+	FAST_FRAME,	   // 解析出完整帧
+	FAST_RESYNC,   // 帧头有效但CRC错误 需要重新同步
+};
+
+// 读取接收队列中相对当前解析位置 off 处的字节
+static inline uint8_t peek_rx_queue(const struct msg_info *p_msg, size_t off)
+{
+	const uint8_t *p = p_msg->rx_q.buf;
+	return p[(p_msg->forward + off) & p_msg->rx_q.mask];
+}
+
+/**
+ * @brief 接收队列中已有完整帧时整帧解析
+ * 
+ * 根据功能码帧长表直接得到帧长度, 对整帧做一次CRC计算, 帧在接收队列中连续时原地解析不拷贝
+ * 
+ * @param handle 从机句柄
+ * @return enum fast_result 
+ */
+static enum fast_result _recv_frame_fast(mb_slv_handle handle)
+{
+	struct msg_info *p_msg = &handle->msg_state;
+	size_t remain = check_rx_queue_remain_data(p_msg);
+	size_t head = MODBUS_ADDR_BYTES_NUM + MODBUS_FUNC_BYTES_NUM;
+	uint8_t info[sizeof(struct pdu_write)];
+	uint8_t *ring = p_msg->rx_q.buf;
+	size_t off = p_msg->forward & p_msg->rx_q.mask;
+	size_t frame_len, info_len, first;
+	uint16_t crc;
+	uint8_t func;
+
+	if (remain < head || peek_rx_queue(p_msg, 0) != handle->slave_addr)
+		return FAST_NONE;
+
+	func = peek_rx_queue(p_msg, 1);
+	if (!MODBUS_FUNC_CHECK_VALID(func))
+		return FAST_NONE;
+
+	info_len = get_pdu_mini_len(func);
+	if (remain < head + info_len)
+		return FAST_NONE;
+
+	for (size_t i = 0; i < info_len; i++)
+		info[i] = peek_rx_queue(p_msg, head + i);
+
+	frame_len = head + info_len + MODBUS_CRC_BYTES_NUM;
+	if (func_frame_len_table[func].has_data) {
+		size_t ex_len = get_pdu_extern_len(func, info);
+		if (!ex_len)
+			return FAST_NONE;
+		frame_len += ex_len;
+	}
+
+	if (remain < frame_len)
+		return FAST_NONE;
+
+	if (off + frame_len <= p_msg->rx_q.buf_size) {
+		// 帧在接收队列中连续 原地解析
+		crc = crc16_update_bytes(0xffff, ring + off, frame_len - MODBUS_CRC_BYTES_NUM);
+		p_msg->p_pdu = ring + off + head;
+	} else {
+		// 帧跨越队列末尾 拷贝到 pdu 中
+		off = (off + head) & p_msg->rx_q.mask;
+		first = p_msg->rx_q.buf_size - off;
+		if (first > frame_len - head)
+			first = frame_len - head;
+		memcpy(p_msg->pdu.data, ring + off, first);
+		memcpy(p_msg->pdu.data + first, ring, frame_len - head - first);
+
+		crc = crc16_update(crc16_update(0xffff, handle->slave_addr), func);
+		crc = crc16_update_bytes(crc, p_msg->pdu.data, frame_len - head - MODBUS_CRC_BYTES_NUM);
+		p_msg->p_pdu = p_msg->pdu.data;
+	}
+
+	if (crc != COMBINE_U8_TO_U16(peek_rx_queue(p_msg, frame_len - 1), peek_rx_queue(p_msg, frame_len - 2)))
+		return FAST_RESYNC;
+
+	p_msg->addr = handle->slave_addr;
+	p_msg->func = func;
+	p_msg->forward += frame_len;
+	flush_parser(p_msg);
+	return FAST_FRAME;
+}
+
+/**
+ * @brief 校验按帧间隔分好的一帧数据 帧长度必须与功能码帧长表一致 任何错误直接丢弃整帧
+ * 
+ * @param handle 从机句柄
+ * @param frame 帧数据
+ * @param len 帧长度
+ * @return true 帧有效
+ * @return false 帧无效
+ */
+static bool _recv_frame(mb_slv_handle handle, const uint8_t *frame, size_t len)
+{
+	struct msg_info *p_msg = &handle->msg_state;
+	size_t head = MODBUS_ADDR_BYTES_NUM + MODBUS_FUNC_BYTES_NUM;
+	uint8_t func;
+
+	if (len < head + MODBUS_CRC_BYTES_NUM || len > MODBUS_FRAME_BYTES_MAX || frame[0] != handle->slave_addr)
+		return false;
+
+	func = frame[1];
+	if (!MODBUS_FUNC_CHECK_VALID(func))
+		return false;
+
+	if (!check_pdu_len(func, &frame[head], len - head - MODBUS_CRC_BYTES_NUM) ||
+		crc16_update_bytes(0xffff, (uint8_t *)frame, len - MODBUS_CRC_BYTES_NUM) !=
+			COMBINE_U8_TO_U16(frame[len - 1], frame[len - 2]))
+		return false;
+
+	p_msg->addr = handle->slave_addr;
+	p_msg->func = func;
+	p_msg->p_pdu = &frame[head];
+	return true;
+}
+
 /**
  * @brief 解析协议数据帧, 支持粘包断包处理
  * 
+ * 帧起始处接收队列中已有完整帧时整帧解析, 否则逐字节解析, 逐字节解析用于断包和错误后的重新同步
+ * 
  * @param handle 从机句柄
  * @return true 解析成功
  * @return false 解析失败
@@ -206,6 +377,18 @@ static bool _recv_parser(mb_slv_handle handle)
 	struct msg_info *p_msg = &handle->msg_state;
 
 	while (check_rx_queue_remain_data(p_msg)) {
+		if (p_msg->state == RX_STATE_ADDR) {
+			switch (_recv_frame_fast(handle)) {
+			case FAST_FRAME:
+				return true;
+			case FAST_RESYNC:
+				rebase_parser(p_msg);
+				continue;
+			default:
+				break;
+			}
+		}
+
 		c = get_rx_queue_remain_data(p_msg);
 		++p_msg->forward;
 		switch (p_msg->state) {
@@ -231,12 +414,12 @@ static bool _recv_parser(mb_slv_handle handle)
 			p_msg->pdu.data[p_msg->pdu_in++] = c;
 			p_msg->cal_crc = crc16_update(p_msg->cal_crc, c);
 			if (p_msg->pdu_in >= p_msg->pdu_len) {
-				if (p_msg->func == MODBUS_FUN_RD_REG_MUL) {
+				if (!func_frame_len_table[p_msg->func].has_data) {
 					p_msg->pdu_len += MODBUS_CRC_BYTES_NUM;
 					p_msg->state = RX_STATE_CRC;
 					break;
 				} else {
-					pdu_ex_len = get_pdu_extern_len(p_msg);
+					pdu_ex_len = get_pdu_extern_len(p_msg->func, p_msg->pdu.data);
 					if (!pdu_ex_len)
 						rebase_parser(p_msg);
 					else {
@@ -259,6 +442,7 @@ static bool _recv_parser(mb_slv_handle handle)
 			if (p_msg->pdu_in >= p_msg->pdu_len) {
 				if (p_msg->cal_crc ==
 					COMBINE_U8_TO_U16(p_msg->pdu.data[p_msg->pdu_in - 1], p_msg->pdu.data[p_msg->pdu_in - 2])) {
+					p_msg->p_pdu = p_msg->pdu.data;
 					flush_parser(p_msg);
 					return true;
 				} else
@@ -272,129 +456,381 @@ static bool _recv_parser(mb_slv_handle handle)
 	return false;
 }
 
+/**
+ * @brief 从接收队列中相对当前解析位置 off 处拷贝数据
+ * 
+ * @param p_msg 接收信息
+ * @param off 偏移
+ * @param dst 目标缓冲
+ * @param len 拷贝长度
+ */
+static void copy_rx_queue(const struct msg_info *p_msg, size_t off, uint8_t *dst, size_t len)
+{
+	const uint8_t *ring = p_msg->rx_q.buf;
+	size_t pos = (p_msg->forward + off) & p_msg->rx_q.mask;
+	size_t first = p_msg->rx_q.buf_size - pos;
+
+	if (first > len)
+		first = len;
+
+	memcpy(dst, ring + pos, first);
+	memcpy(dst + first, ring, len - first);
+}
+
+/**
+ * @brief 解析Modbus TCP数据帧 按MBAP报文头中的长度划分帧边界
+ * 
+ * 单元标识与从机地址或`MODBUS_TCP_UNIT_ANY`不符的帧直接丢弃, 功能码或长度无效的帧回复异常响应
+ * 
+ * @param handle 从机句柄
+ * @return true 解析出一帧
+ * @return false 接收队列中没有完整帧
+ */
+static bool _recv_tcp(mb_slv_handle handle)
+{
+	struct msg_info *p_msg = &handle->msg_state;
+	uint8_t mbap[MODBUS_TCP_MBAP_BYTES_NUM + MODBUS_FUNC_BYTES_NUM];
+	size_t remain;
+	uint16_t len;
+
+	while ((remain = check_rx_queue_remain_data(p_msg)) >= sizeof(mbap)) {
+		copy_rx_queue(p_msg, 0, mbap, sizeof(mbap));
+
+		len = COMBINE_U8_TO_U16(mbap[4], mbap[5]); // 单元标识 + PDU
+		if (mbap[2] || mbap[3] || len < 2 || len > MODBUS_TCP_PDU_BYTES_MAX + 1) {
+			rebase_parser(p_msg); // 协议标识或长度无效 逐字节重新同步
+			continue;
+		}
+
+		if (remain < (size_t)(MODBUS_TCP_MBAP_BYTES_NUM - 1 + len))
+			return false; // 断包 等待剩余数据
+
+		len -= MODBUS_ADDR_BYTES_NUM + MODBUS_FUNC_BYTES_NUM; // 功能码之后的数据长度
+		copy_rx_queue(p_msg, sizeof(mbap), p_msg->pdu.data, len);
+		p_msg->forward += sizeof(mbap) + len;
+		flush_parser(p_msg);
+
+		if (mbap[6] != handle->slave_addr && mbap[6] != MODBUS_TCP_UNIT_ANY)
+			continue;
+
+		p_msg->tid = COMBINE_U8_TO_U16(mbap[0], mbap[1]);
+		p_msg->addr = mbap[6];
+		p_msg->func = mbap[7];
+		p_msg->p_pdu = p_msg->pdu.data;
+
+		if (!MODBUS_FUNC_CHECK_VALID(p_msg->func))
+			p_msg->req_err = MODBUS_RESP_ERR_FUNC;
+		else if (!check_pdu_len(p_msg->func, p_msg->pdu.data, len))
+			p_msg->req_err = MODBUS_RESP_ERR_DATA;
+		else
+			p_msg->req_err = MODBUS_RESP_ERR_NONE;
+
+		return true;
+	}
+
+	return false;
+}
+
+// 按起始寄存器排序
+static int work_cmp(const void *a, const void *b)
+{
+	const struct mb_slv_work *wa = a;
+	const struct mb_slv_work *wb = b;
+
+	return (int)wa->start - (int)wb->start;
+}
+
+/**
+ * @brief 拷贝并排序响应处理表 检查区间是否有效及是否重叠
+ * 
+ * @param handle 从机句柄
+ * @param work_table 用户响应处理表
+ * @param table_num 表长
+ * @return true 成功
+ * @return false 区间无效/重叠或内存不足
+ */
+static bool build_work_table(mb_slv_handle handle, const struct mb_slv_work *work_table, uint16_t table_num)
+{
+	struct mb_slv_work *table;
+	size_t num = 0;
+
+	if (!table_num)
+		return true;
+
+	if (!work_table)
+		return false;
+
+	table = virtual_os_calloc(table_num, sizeof(struct mb_slv_work));
+	if (!table)
+		return false;
+
+	for (uint16_t i = 0; i < table_num; i++) {
+		if (!work_table[i].resp && !work_table[i].image)
+			continue; // 无处理函数也无寄存器映像的区间不参与查找
+
+		if (work_table[i].start >= work_table[i].end)
+			goto err;
+
+		table[num++] = work_table[i];
+	}
+
+	qsort(table, num, sizeof(struct mb_slv_work), work_cmp);
+
+	for (size_t i = 1; i < num; i++) {
+		if (table[i].start < table[i - 1].end)
+			goto err; // 区间重叠
+	}
+
+	handle->work_table = table;
+	handle->table_num = num;
+	return true;
+
+err:
+	virtual_os_free(table);
+	return false;
+}
+
+/**
+ * @brief 二分查找包含起始寄存器的区间
+ * 
+ * @param handle 从机句柄
+ * @param reg 起始寄存器
+ * @return struct mb_slv_work* 未找到返回NULL
+ */
+static struct mb_slv_work *find_work(mb_slv_handle handle, uint16_t reg)
+{
+	size_t lo = 0, hi = handle->table_num;
+
+	// 查找最后一个 start <= reg 的区间
+	while (lo < hi) {
+		size_t mid = lo + ((hi - lo) >> 1);
+		if (handle->work_table[mid].start <= reg)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (!lo || reg >= handle->work_table[lo - 1].end)
+		return NULL;
+
+	return &handle->work_table[lo - 1];
+}
+
+/**
+ * @brief 查找请求对应的区间
+ *
+ * @param handle 从机句柄
+ * @param reg 起始寄存器
+ * @param reg_num 寄存器数量
+ * @return struct mb_slv_work* 寄存器范围无效时返回NULL
+ */
+static struct mb_slv_work *_rtu_find_work(mb_slv_handle handle, uint16_t reg, uint16_t reg_num)
+{
+	struct mb_slv_work *work = find_work(handle, reg);
+
+	if (work && MODBUS_CHECK_REG_RANGE(reg, reg_num, work->start, work->end, handle->msg_state.func))
+		return work;
+
+	return NULL;
+}
+
 /**
  * @brief 处理注册回调
  *
  * @param handle 从机句柄
+ * @param work 请求对应的区间
+ * @param reg 起始寄存器
+ * @param reg_num 寄存器数量
  * @return uint8_t 参考头文件响应码
  */
-static uint8_t _rtu_handle(mb_slv_handle handle)
+static uint8_t _rtu_handle(mb_slv_handle handle, struct mb_slv_work *work, uint16_t reg, uint16_t reg_num)
 {
-	if (!handle)
+	if (!work || !work->resp)
 		return MODBUS_RESP_ERR_BUSY;
 
-	struct mb_slv_work *work = NULL; // 注册回调处理
-
-	int res = MODBUS_RESP_ERR_BUSY;
-
-	uint8_t addr = handle->msg_state.addr;
-	uint8_t func = handle->msg_state.func;
-	uint16_t reg = handle->msg_state.pdu.read.reg_h << 8 | handle->msg_state.pdu.read.reg_l;
-	uint16_t reg_num = handle->msg_state.pdu.read.num_h << 8 | handle->msg_state.pdu.read.num_l;
+	return work->resp(handle->msg_state.func, reg, reg_num, handle->data_in_out); // 用户回调处理
+}
 
-	for (uint16_t i = 0; i < handle->table_num; i++) {
-		work = &handle->work_table[i];
-		if (work && work->resp && MODBUS_CHECK_REG_RANGE(reg, reg_num, work->start, work->end, func)) {
-			res = work->resp(func, reg, reg_num, handle->data_in_out); // 用户回调处理
-			break;
+/**
+ * @brief 写入寄存器映像 并通知用户
+ *
+ * @param work 请求对应的区间
+ * @param reg 起始寄存器
+ * @param reg_num 寄存器数量
+ * @param p 写入的数据(大端)
+ */
+static void _image_write(struct mb_slv_work *work, uint16_t reg, uint16_t reg_num, const uint8_t *p)
+{
+	uint16_t *dst = &work->image[reg - work->start];
+	bool changed = false;
+	uint16_t val;
+
+	for (uint16_t i = 0; i < reg_num; i++, p += 2) {
+		val = COMBINE_U8_TO_U16(p[0], p[1]);
+		if (dst[i] != val) {
+			dst[i] = val;
+			changed = true;
 		}
 	}
 
-	return res;
+	if (work->notify)
+		work->notify(reg, reg_num, changed);
 }
 
 /**
- * @brief 处理读功能码
+ * @brief 打包异常响应
  *
  * @param handle 从机句柄
- * @return uint16_t 响应长度
+ * @param usr_err 异常码
+ * @return uint16_t 响应PDU长度
  */
-static uint16_t _packet_ack_read_frame(mb_slv_handle handle)
+static uint16_t _packet_ack_err(mb_slv_handle handle, uint8_t usr_err)
 {
-	if (!handle)
-		return 0;
+	uint8_t *pdata_out = handle->pdu_out;
+
+	pdata_out[0] = handle->msg_state.func | 0x80; // 错误帧
+	pdata_out[1] = usr_err;
+	return 2;
+}
 
+/**
+ * @brief 处理读功能码 读线圈/离散输入/保持寄存器/输入寄存器
+ *
+ * @param handle 从机句柄
+ * @return uint16_t 响应PDU长度
+ */
+static uint16_t _packet_ack_read_frame(mb_slv_handle handle)
+{
 	uint16_t pkt_len = 0;
-	uint16_t crc = 0xffff;
-	uint16_t *p;
+	const uint16_t *p;
 
-	uint16_t reg = COMBINE_U8_TO_U16(handle->msg_state.pdu.read.reg_h, handle->msg_state.pdu.read.reg_l);
-	uint16_t reg_num = COMBINE_U8_TO_U16(handle->msg_state.pdu.read.num_h, handle->msg_state.pdu.read.num_l);
+	const struct pdu_read *read = (const struct pdu_read *)handle->msg_state.p_pdu;
+	uint8_t func = handle->msg_state.func;
+	uint16_t reg = COMBINE_U8_TO_U16(read->reg_h, read->reg_l);
+	uint16_t reg_num = COMBINE_U8_TO_U16(read->num_h, read->num_l);
+	struct mb_slv_work *work = _rtu_find_work(handle, reg, reg_num);
+	bool is_bit = MODBUS_FUNC_IS_BIT(func);
+	uint8_t usr_err;
+	uint8_t bytes;
+
+	uint8_t *pdata_out = handle->pdu_out; // 存储回复的数据
+
+	if (work && work->image) {
+		// 寄存器映像只支持寄存器功能码
+		usr_err = is_bit ? MODBUS_RESP_ERR_FUNC : MODBUS_RESP_ERR_NONE;
+		p = &work->image[reg - work->start]; // 直接从寄存器映像回复
+	} else {
+		if (is_bit)
+			memset(handle->data_in_out, 0, ((reg_num + 15) >> 4) << 1); // 用户按位置1即可
+		usr_err = _rtu_handle(handle, work, reg, reg_num);
+		p = handle->data_in_out; // 用户响应的数据
+	}
 
-	uint8_t *pdata_out = handle->modbus_frame_buff; // 存储回复的数据
+	if (usr_err != MODBUS_RESP_ERR_NONE)
+		return _packet_ack_err(handle, usr_err);
 
-	pdata_out[pkt_len++] = handle->msg_state.addr;
-	uint8_t usr_err = _rtu_handle(handle);
-	if (usr_err == MODBUS_RESP_ERR_NONE) {
-		p = handle->data_in_out; // 用户响应的数据
+	bytes = is_bit ? ((reg_num + 7) >> 3) : (reg_num << 1);
 
-		pdata_out[pkt_len++] = MODBUS_FUN_RD_REG_MUL; // 读功能码
-		pdata_out[pkt_len++] = (reg_num << 1);		  // 数据长度
+	pdata_out[pkt_len++] = func;  // 读功能码
+	pdata_out[pkt_len++] = bytes; // 数据长度
 
+	if (is_bit) {
+		// 第i个线圈对应 p[i/16] 的 bit(i%16), 按低位在前打包
+		for (uint8_t i = 0; i < bytes; i++)
+			pdata_out[pkt_len++] = (p[i >> 1] >> ((i & 1) << 3)) & 0xff;
+		if (reg_num & 7)
+			pdata_out[pkt_len - 1] &= (1 << (reg_num & 7)) - 1; // 清除多余的位
+	} else {
 		for (uint16_t i = 0; i < reg_num; i++, p++) {
 			pdata_out[pkt_len++] = GET_U8_HIGH_FROM_U16(*p);
 			pdata_out[pkt_len++] = GET_U8_LOW_FROM_U16(*p);
 		}
-	} else {
-		pdata_out[pkt_len++] = handle->msg_state.func | 0x80; // 错误帧
-		pdata_out[pkt_len++] = usr_err;
 	}
 
-	crc = crc16_update_bytes(crc, pdata_out, pkt_len);
-
-	pdata_out[pkt_len++] = GET_U8_LOW_FROM_U16(crc);
-	pdata_out[pkt_len++] = GET_U8_HIGH_FROM_U16(crc);
-
 	return pkt_len;
 }
 
 /**
- * @brief 处理写功能码
+ * @brief 处理写功能码 写单个/多个线圈, 写单个/多个寄存器
  *
  * @param handle 从机句柄
- * @return uint16_t 响应长度
+ * @return uint16_t 响应PDU长度
  */
 static uint16_t _packet_ack_write_frame(mb_slv_handle handle)
 {
-	if (!handle)
-		return 0;
-
-	uint16_t pkt_len = 0;
-	uint16_t crc = 0xffff;
-
 	uint8_t usr_err = MODBUS_RESP_ERR_BUSY; // 用户响应结果
 
-	uint16_t reg = COMBINE_U8_TO_U16(handle->msg_state.pdu.write.reg_h, handle->msg_state.pdu.write.reg_l);
-	uint16_t reg_num = COMBINE_U8_TO_U16(handle->msg_state.pdu.write.num_h, handle->msg_state.pdu.write.num_l);
-
-	uint8_t *pdata_out = handle->modbus_frame_buff; // 存储响应数据
-
+	const uint8_t *info = handle->msg_state.p_pdu;
+	const uint8_t *p = &info[sizeof(struct pdu_write)]; // 写入多个时的数据
 	uint8_t func = handle->msg_state.func;
+	uint16_t reg = COMBINE_U8_TO_U16(info[0], info[1]);
+	uint16_t reg_num = COMBINE_U8_TO_U16(info[2], info[3]); // 写单个时为写入的值
+	uint16_t value = reg_num;
+	bool is_bit = MODBUS_FUNC_IS_BIT(func);
+	struct mb_slv_work *work;
+
+	uint8_t *pdata_out = handle->pdu_out; // 存储响应数据
+
+	if (MODBUS_FUNC_IS_SINGLE(func)) {
+		reg_num = 1;
+		p = &info[MODBUS_REG_BYTES_NUM]; // 写入的值
+		if (func == MODBUS_FUN_WR_COIL && value != MODBUS_COIL_ON && value != MODBUS_COIL_OFF)
+			return _packet_ack_err(handle, MODBUS_RESP_ERR_DATA);
+	}
 
-	pdata_out[pkt_len++] = handle->msg_state.addr;
-
-	usr_err = _rtu_handle(handle); // 注册回调处理
-	if (usr_err == MODBUS_RESP_ERR_NONE) {
-		pdata_out[pkt_len++] = MODBUS_FUN_WR_REG_MUL;
-		pdata_out[pkt_len++] = GET_U8_HIGH_FROM_U16(reg);
-		pdata_out[pkt_len++] = GET_U8_LOW_FROM_U16(reg);
+	work = _rtu_find_work(handle, reg, reg_num);
+	if (work && work->image) {
+		if (is_bit)
+			return _packet_ack_err(handle, MODBUS_RESP_ERR_FUNC); // 寄存器映像只支持寄存器功能码
 
-		pdata_out[pkt_len++] = GET_U8_HIGH_FROM_U16(reg_num);
-		pdata_out[pkt_len++] = GET_U8_LOW_FROM_U16(reg_num);
+		_image_write(work, reg, reg_num, p); // 直接写入寄存器映像
+		usr_err = MODBUS_RESP_ERR_NONE;
 	} else {
-		pdata_out[pkt_len++] = handle->msg_state.func | 0x80; // 错误帧
-		pdata_out[pkt_len++] = usr_err;
+		if (func == MODBUS_FUN_WR_COIL) {
+			handle->data_in_out[0] = (value == MODBUS_COIL_ON);
+		} else if (is_bit) {
+			// 第i个线圈存放到 data_in_out[i/16] 的 bit(i%16)
+			uint8_t bytes = (reg_num + 7) >> 3;
+			memset(handle->data_in_out, 0, ((reg_num + 15) >> 4) << 1);
+			for (uint8_t i = 0; i < bytes; i++)
+				handle->data_in_out[i >> 1] |= (uint16_t)p[i] << ((i & 1) << 3);
+		} else {
+			for (uint16_t i = 0; i < reg_num; i++, p += 2)
+				handle->data_in_out[i] = COMBINE_U8_TO_U16(p[0], p[1]);
+		}
+
+		usr_err = _rtu_handle(handle, work, reg, reg_num); // 注册回调处理
 	}
 
-	crc = crc16_update_bytes(crc, pdata_out, pkt_len);
-	pdata_out[pkt_len++] = GET_U8_LOW_FROM_U16(crc);
-	pdata_out[pkt_len++] = GET_U8_HIGH_FROM_U16(crc);
+	if (usr_err != MODBUS_RESP_ERR_NONE)
+		return _packet_ack_err(handle, usr_err);
 
-	return pkt_len;
+	// 写单个时原样返回请求, 写多个时返回起始地址和数量
+	pdata_out[0] = func;
+	memcpy(&pdata_out[1], info, sizeof(struct pdu_read));
+
+	return 1 + sizeof(struct pdu_read);
+}
+
+/**
+ * @brief 处理对应功能码 生成响应PDU 与传输方式无关
+ *
+ * @param handle 从机句柄
+ * @return uint16_t 响应PDU长度 无需回复返回0
+ */
+static uint16_t _dispatch_pdu(mb_slv_handle handle)
+{
+	if (!MODBUS_FUNC_CHECK_VALID(handle->msg_state.func))
+		return 0;
+
+	if (MODBUS_FUNC_IS_READ(handle->msg_state.func))
+		return _packet_ack_read_frame(handle); // 读功能码
+	else
+		return _packet_ack_write_frame(handle); // 写功能码
 }
 
 /**
- * @brief 处理对应功能码
+ * @brief 处理RTU数据帧 在响应PDU前加上从机地址, 之后加上CRC
  *
  * @param handle 从机句柄
  * @return uint16_t 回复响应的数据长度
@@ -404,78 +840,138 @@ static uint16_t _dispatch_rtu_msg(mb_slv_handle handle)
 	if (!handle)
 		return 0;
 
-	uint16_t ptk_len = 0;  // 处理结果长度
-	uint16_t reg, reg_num; // 寄存器地址, 长度
-	uint8_t data_len;
+	uint16_t pkt_len;
+	uint16_t crc;
 
-	const uint8_t *p;
+	pkt_len = _dispatch_pdu(handle);
+	if (!pkt_len)
+		return 0;
 
-	struct msg_info *p_msg = &handle->msg_state; // 接收数据
+	handle->modbus_frame_buff[0] = handle->msg_state.addr;
+	pkt_len += MODBUS_ADDR_BYTES_NUM;
 
-	switch (p_msg->func) {
-	case MODBUS_FUN_RD_REG_MUL:
-		return _packet_ack_read_frame(handle); // 读功能码
+	crc = crc16_update_bytes(0xffff, handle->modbus_frame_buff, pkt_len);
+	handle->modbus_frame_buff[pkt_len++] = GET_U8_LOW_FROM_U16(crc);
+	handle->modbus_frame_buff[pkt_len++] = GET_U8_HIGH_FROM_U16(crc);
 
-	case MODBUS_FUN_WR_REG_MUL:
-		data_len = p_msg->pdu.write.len;
+	return pkt_len;
+}
 
-		// 写入数据
-		p = &p_msg->pdu.data[sizeof(struct pdu_write)];
-		for (uint8_t i = 0, j = 0; i < data_len; i += 2, j++) {
-			handle->data_in_out[j] = (*p++ << 8);
-			handle->data_in_out[j] |= *p++;
-		}
+/**
+ * @brief 处理TCP数据帧 在响应PDU前加上MBAP报文头 事务标识与请求相同
+ *
+ * @param handle 从机句柄
+ * @return uint16_t 回复响应的数据长度
+ */
+static uint16_t _dispatch_tcp_msg(mb_slv_handle handle)
+{
+	struct msg_info *p_msg = &handle->msg_state;
+	uint8_t *mbap = handle->modbus_frame_buff;
+	uint16_t pkt_len;
 
-		return _packet_ack_write_frame(handle); // 写功能码
+	if (p_msg->req_err != MODBUS_RESP_ERR_NONE)
+		pkt_len = _packet_ack_err(handle, p_msg->req_err);
+	else
+		pkt_len = _dispatch_pdu(handle);
 
-	default:
+	if (!pkt_len)
 		return 0;
-	}
-}
 
-/***************************API***************************/
+	mbap[0] = GET_U8_HIGH_FROM_U16(p_msg->tid);
+	mbap[1] = GET_U8_LOW_FROM_U16(p_msg->tid);
+	mbap[2] = 0; // 协议标识
+	mbap[3] = 0;
+	mbap[4] = GET_U8_HIGH_FROM_U16(pkt_len + MODBUS_ADDR_BYTES_NUM);
+	mbap[5] = GET_U8_LOW_FROM_U16(pkt_len + MODBUS_ADDR_BYTES_NUM);
+	mbap[6] = p_msg->addr; // 单元标识
+
+	return MODBUS_TCP_MBAP_BYTES_NUM + pkt_len;
+}
 
 /**
- * @brief 从机初始化并申请句柄
+ * @brief 申请从机句柄
  *
  * @param opts 				读写等回调函数指针
  * @param slv_addr 			从机地址
  * @param table 			任务处理表
  * @param table_num 		表长
+ * @param tcp 				是否为Modbus TCP
  * @return mb_slv_handle 	成功返回句柄，失败返回NULL
  */
-mb_slv_handle mb_slv_init(
-	struct serial_opts *opts, uint8_t slv_addr, struct mb_slv_work *work_table, uint16_t table_num)
+static mb_slv_handle _slv_create(
+	struct serial_opts *opts, uint8_t slv_addr, struct mb_slv_work *work_table, uint16_t table_num, bool tcp)
 {
 	bool ret = false;
 
-	if (!opts || !opts->f_init || !opts->f_read || !opts->f_write)
-		return NULL;
-
 	struct mb_slv *handle = virtual_os_calloc(1, sizeof(struct mb_slv));
 	if (!handle)
 		return NULL;
 
 	handle->opts = opts;
-	handle->work_table = work_table;
-	handle->table_num = table_num;
 	handle->slave_addr = slv_addr;
+	handle->tcp = tcp;
+	handle->pdu_out = &handle->modbus_frame_buff[tcp ? MODBUS_TCP_MBAP_BYTES_NUM : MODBUS_ADDR_BYTES_NUM];
 
-	ret = queue_init(&handle->msg_state.rx_q, sizeof(uint8_t), handle->msg_state.rx_queue_buff, RX_BUFF_SIZE);
+	// 排序并检查响应处理表 区间重叠时初始化失败
+	ret = build_work_table(handle, work_table, table_num);
 	if (!ret) {
 		virtual_os_free(handle);
 		return NULL;
 	}
 
+	ret = queue_init(&handle->msg_state.rx_q, sizeof(uint8_t), handle->msg_state.rx_queue_buff, RX_BUFF_SIZE);
+	if (!ret) {
+		mb_slv_destroy(handle);
+		return NULL;
+	}
+
 	ret = opts->f_init();
 	if (!ret) {
-		virtual_os_free(handle);
+		mb_slv_destroy(handle);
 		return NULL;
 	}
 
 	return handle;
 }
 
+/***************************API***************************/
+
+/**
+ * @brief 从机初始化并申请句柄
+ *
+ * @param opts 				读写等回调函数指针
+ * @param slv_addr 			从机地址
+ * @param table 			任务处理表
+ * @param table_num 		表长
+ * @return mb_slv_handle 	成功返回句柄，失败返回NULL
+ */
+mb_slv_handle mb_slv_init(
+	struct serial_opts *opts, uint8_t slv_addr, struct mb_slv_work *work_table, uint16_t table_num)
+{
+	if (!opts || !opts->f_init || (!opts->f_read && !opts->f_read_frame) || !opts->f_write)
+		return NULL;
+
+	return _slv_create(opts, slv_addr, work_table, table_num, false);
+}
+
+/**
+ * @brief Modbus TCP从机初始化并申请句柄
+ *
+ * @param opts 				socket收发等回调函数指针 不使用 f_read_frame
+ * @param unit_id 			单元标识 同时响应单元标识为`MODBUS_TCP_UNIT_ANY`的请求
+ * @param table 			任务处理表
+ * @param table_num 		表长
+ * @return mb_slv_handle 	成功返回句柄，失败返回NULL
+ */
+mb_slv_handle mb_slv_tcp_init(
+	struct serial_opts *opts, uint8_t unit_id, struct mb_slv_work *work_table, uint16_t table_num)
+{
+	if (!opts || !opts->f_init || !opts->f_read || !opts->f_write)
+		return NULL;
+
+	return _slv_create(opts, unit_id, work_table, table_num, true);
+}
+
 /**
  * @brief 释放从机句柄
  *
@@ -486,6 +982,9 @@ void mb_slv_destroy(mb_slv_handle handle)
 	if (!handle)
 		return;
 
+	if (handle->work_table)
+		virtual_os_free(handle->work_table);
+
 	virtual_os_free(handle);
 }
 
@@ -499,17 +998,41 @@ void mb_slv_poll(mb_slv_handle handle)
 	if (!handle)
 		return;
 
-	size_t ptk_len = handle->opts->f_read(handle->modbus_frame_buff, MODBUS_FRAME_BYTES_MAX);
-	if (!ptk_len) // 无数据
+	size_t ptk_len;
+	bool ret_parser;
+
+	if (handle->tcp) {
+		queue_fill(&(handle->msg_state.rx_q), handle->opts->f_read, MODBUS_FRAME_BYTES_MAX);
+
+		// 主机可以连续发送多个请求 依次处理接收队列中的所有完整帧
+		while (_recv_tcp(handle)) {
+			ptk_len = _dispatch_tcp_msg(handle);
+			if (ptk_len)
+				handle->opts->f_write(handle->modbus_frame_buff, ptk_len);
+		}
 		return;
+	}
+
+	if (handle->opts->f_read_frame) {
+		// 按帧间隔分帧 帧模式下不使用接收队列 直接使用其缓冲区存储一帧
+		uint8_t *frame = handle->msg_state.rx_queue_buff;
 
-	size_t ret_q = queue_add(&(handle->msg_state.rx_q), handle->modbus_frame_buff, ptk_len);
-	if (ret_q != ptk_len)
-		return; // 空间不足
+		ptk_len = handle->opts->f_read_frame(frame, RX_BUFF_SIZE);
+		if (!ptk_len)
+			return; // 无完整帧
+
+		ret_parser = _recv_frame(handle, frame, ptk_len);
+	} else {
+		// 直接读入接收队列
+		ptk_len = queue_fill(&(handle->msg_state.rx_q), handle->opts->f_read, MODBUS_FRAME_BYTES_MAX);
+		if (!ptk_len && !check_rx_queue_remain_data(&handle->msg_state)) // 无新数据且队列中没有待解析的数据
+			return;
+
+		ret_parser = _recv_parser(handle);
+	}
 
-	bool ret_parser = _recv_parser(handle);
 	if (!ret_parser)
-		return; // 无完整帧
+		return; // 无完整帧或帧无效
 
 	ptk_len = _dispatch_rtu_msg(handle);
 	if (!ptk_len)
@@ -0,0 +1,255 @@
+/**
+ * @file bus_core.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 总线管理组件
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include <string.h>
+
+#include "bus/bus_core.h"
+
+static list_item bus_list = { &bus_list, &bus_list }; // 已注册的总线控制器
+
+static inline bool is_list_empty(list_item *head)
+{
+	return head->next == head;
+}
+
+// 事务结束 更新状态并调用完成回调
+static void bus_xfer_finish(struct bus_xfer *xfer)
+{
+	__sync_synchronize(); // 中断中写入的结果先于状态可见
+	xfer->status = (xfer->err == DRV_ERR_NONE) ? DRV_ASYNC_DONE : DRV_ASYNC_ERROR;
+
+	if (xfer->done)
+		xfer->done(xfer);
+}
+
+// 从轮询起始客户端开始 取出第一个有待执行事务的客户端的队首事务
+static struct bus_xfer *bus_pick_next(struct bus_adapter *bus)
+{
+	list_item *start = bus->rr;
+	list_item *pos = start;
+	struct bus_client *client;
+	list_item *item;
+
+	do {
+		if (pos != &(bus->clients)) {
+			client = container_of(pos, struct bus_client, node);
+			if (!is_list_empty(&(client->pending))) {
+				item = client->pending.next;
+				list_delete_item(item);
+				bus->rr = pos->next; // 下一次从后一个客户端开始
+				return container_of(item, struct bus_xfer, node);
+			}
+		}
+		pos = pos->next;
+	} while (pos != start);
+
+	return NULL;
+}
+
+// 总线空闲时启动下一个事务
+static void bus_kick(struct bus_adapter *bus)
+{
+	struct bus_xfer *xfer;
+	int err;
+
+	// 启动失败的回调中可能再次提交 由外层循环统一处理
+	if (bus->kicking)
+		return;
+
+	bus->kicking = true;
+	while (!bus->cur) {
+		xfer = bus_pick_next(bus);
+		if (!xfer)
+			break;
+
+		bus->cur = xfer;
+		err = bus->ops->xfer(bus, xfer);
+		if (err != DRV_ERR_NONE) {
+			bus->cur = NULL;
+			bus->finished = false;
+			xfer->actual = 0;
+			xfer->err = err;
+			bus_xfer_finish(xfer);
+		}
+	}
+	bus->kicking = false;
+}
+
+// 完成事件 先启动下一个事务再调用回调, 回调执行期间总线不空闲
+static void bus_event_task(void *arg)
+{
+	struct bus_adapter *bus = (struct bus_adapter *)arg;
+	struct bus_xfer *xfer = bus->cur;
+
+	if (!xfer || !bus->finished)
+		return;
+
+	bus->finished = false;
+	bus->cur = NULL;
+	bus_kick(bus);
+
+	bus_xfer_finish(xfer);
+}
+
+int bus_adapter_register(struct bus_adapter *bus)
+{
+	if (!bus || !bus->name || !bus->ops || !bus->ops->xfer)
+		return DRV_ERR_INVALID;
+
+	if (bus_adapter_find(bus->name))
+		return DRV_ERR_OCCUPIED;
+
+	list_init(&(bus->clients));
+	bus->rr = &(bus->clients);
+	bus->cur = NULL;
+	bus->evt = NULL;
+	bus->finished = false;
+	bus->kicking = false;
+	list_add_tail(&bus_list, &(bus->node));
+
+	return DRV_ERR_NONE;
+}
+
+struct bus_adapter *bus_adapter_find(const char *name)
+{
+	struct list_item *cur_item, *next_item;
+	struct bus_adapter *bus;
+
+	if (!name)
+		return NULL;
+
+	list_for_each_safe(cur_item, next_item, &bus_list)
+	{
+		bus = container_of(cur_item, struct bus_adapter, node);
+		if (strcmp(bus->name, name) == 0)
+			return bus;
+	}
+
+	return NULL;
+}
+
+int bus_client_attach(struct bus_client *client, const char *bus_name, uint16_t addr)
+{
+	struct bus_adapter *bus;
+
+	if (!client)
+		return DRV_ERR_INVALID;
+
+	bus = bus_adapter_find(bus_name);
+	if (!bus)
+		return DRV_ERR_NOT_EXIST;
+
+	client->bus = bus;
+	client->addr = addr;
+	list_init(&(client->pending));
+	list_add_tail(&(bus->clients), &(client->node));
+
+	return DRV_ERR_NONE;
+}
+
+int bus_client_detach(struct bus_client *client)
+{
+	struct bus_adapter *bus;
+
+	if (!client || !client->bus)
+		return DRV_ERR_INVALID;
+
+	bus = client->bus;
+	if (!is_list_empty(&(client->pending)) || (bus->cur && bus->cur->client == client))
+		return DRV_ERR_OCCUPIED;
+
+	if (bus->rr == &(client->node))
+		bus->rr = client->node.next;
+
+	list_delete_item(&(client->node));
+	client->bus = NULL;
+
+	return DRV_ERR_NONE;
+}
+
+int bus_submit(struct bus_client *client, struct bus_xfer *xfer)
+{
+	struct bus_adapter *bus;
+
+	if (!client || !client->bus || !xfer || !xfer->msgs || !xfer->num)
+		return DRV_ERR_INVALID;
+
+	if (xfer->status == DRV_ASYNC_PENDING)
+		return DRV_ERR_OCCUPIED;
+
+	bus = client->bus;
+
+	// 事件任务依赖调度器 在第一次提交时创建
+	if (!bus->evt) {
+		bus->evt = stimer_event_task_create(bus_event_task, bus);
+		if (!bus->evt)
+			return DRV_ERR_EXCEPTION;
+	}
+
+	xfer->client = client;
+	xfer->actual = 0;
+	xfer->err = DRV_ERR_NONE;
+	xfer->status = DRV_ASYNC_PENDING;
+	list_add_tail(&(client->pending), &(xfer->node));
+
+	bus_kick(bus);
+
+	return DRV_ERR_NONE;
+}
+
+bool bus_cancel(struct bus_xfer *xfer)
+{
+	// 已开始执行的事务已从队列中取出, 节点指针为NULL
+	if (!xfer || xfer->status != DRV_ASYNC_PENDING || !xfer->node.next)
+		return false;
+
+	list_delete_item(&(xfer->node));
+	xfer->status = DRV_ASYNC_IDLE;
+
+	return true;
+}
+
+void bus_xfer_complete(struct bus_adapter *bus, size_t actual, int err)
+{
+	struct bus_xfer *xfer;
+
+	if (!bus || !(xfer = bus->cur))
+		return;
+
+	xfer->actual = actual;
+	xfer->err = err;
+	__sync_synchronize(); // 结果先于完成标志可见
+	bus->finished = true; // 事务状态由事件任务更新 避免轮询方在回调前重新提交
+
+	if (bus->evt)
+		stimer_event_post(bus->evt);
+}
@@ -0,0 +1,377 @@
+/**
+ * @file can_core.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief CAN接收分发组件
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include <string.h>
+
+#include "bus/can_core.h"
+
+// 掩码位数多的排在前面 同掩码按ID升序
+static int handler_cmp(const struct can_handler *a, const struct can_handler *b)
+{
+	int pa = __builtin_popcount(a->mask);
+	int pb = __builtin_popcount(b->mask);
+
+	if (pa != pb)
+		return pb - pa;
+	if (a->mask != b->mask)
+		return (a->mask > b->mask) ? -1 : 1;
+	if (a->id != b->id)
+		return (a->id > b->id) ? 1 : -1;
+	return 0;
+}
+
+// 处理函数表只在初始化时排序一次 数量不大 使用插入排序
+static void handler_sort(struct can_handler *handlers, size_t num)
+{
+	struct can_handler key;
+	size_t j;
+
+	for (size_t i = 1; i < num; i++) {
+		key = handlers[i];
+		for (j = i; j > 0 && handler_cmp(&handlers[j - 1], &key) > 0; j--)
+			handlers[j] = handlers[j - 1];
+		handlers[j] = key;
+	}
+}
+
+// 经典CAN帧与CAN FD帧互相转换
+static inline void can_frame_to_fd(struct canfd_frame *fd, const struct can_frame *frame)
+{
+	uint8_t len = (frame->can_dlc > CAN_MAX_DLEN) ? CAN_MAX_DLEN : frame->can_dlc;
+
+	memcpy(fd->data, frame->data, len);
+	fd->can_id = frame->can_id;
+	fd->len = len;
+	fd->flags = 0;
+}
+
+static inline bool can_fd_to_frame(struct can_frame *frame, const struct canfd_frame *fd)
+{
+	if ((fd->flags & CANFD_FDF) || fd->len > CAN_MAX_DLEN)
+		return false;
+
+	memcpy(frame->data, fd->data, fd->len);
+	frame->can_id = fd->can_id;
+	frame->can_dlc = fd->len;
+	return true;
+}
+
+static void can_core_unmatched(struct can_core *core, const struct canfd_frame *fd, const struct can_frame *frame)
+{
+	struct can_frame cf;
+	struct canfd_frame fdf;
+
+	core->unmatched_cnt++;
+
+	if (core->unmatched_fd) {
+		if (!fd) {
+			can_frame_to_fd(&fdf, frame);
+			fd = &fdf;
+		}
+		core->unmatched_fd(fd, core->unmatched_arg);
+	} else if (core->unmatched) {
+		if (!frame) {
+			if (!can_fd_to_frame(&cf, fd))
+				return;
+			frame = &cf;
+		}
+		core->unmatched(frame, core->unmatched_arg);
+	}
+}
+
+static void can_core_dispatch_classic(struct can_core *core, const struct can_frame *frame)
+{
+	const struct can_handler *h = can_core_lookup(core, frame->can_id);
+	struct canfd_frame fd;
+
+	if (!h) {
+		can_core_unmatched(core, NULL, frame);
+	} else if (h->fd_handler) {
+		can_frame_to_fd(&fd, frame);
+		h->fd_handler(&fd, h->arg);
+	} else {
+		h->handler(frame, h->arg);
+	}
+}
+
+static void can_core_dispatch_fd(struct can_core *core, const struct canfd_frame *fd)
+{
+	const struct can_handler *h = can_core_lookup(core, fd->can_id);
+	struct can_frame frame;
+
+	if (h && h->fd_handler)
+		h->fd_handler(fd, h->arg);
+	else if (h && can_fd_to_frame(&frame, fd))
+		h->handler(&frame, h->arg);
+	else
+		can_core_unmatched(core, fd, NULL);
+}
+
+static void can_core_dispatch(void *arg)
+{
+	struct can_core *core = (struct can_core *)arg;
+	union {
+		struct can_frame classic;
+		struct canfd_frame fd;
+	} f;
+
+	while (evt_queue_get(&(core->rxq), &f)) {
+		if (core->fd)
+			can_core_dispatch_fd(core, &(f.fd));
+		else
+			can_core_dispatch_classic(core, &(f.classic));
+	}
+}
+
+static bool can_core_setup(struct can_core *core, void *rx_buf, size_t frame_bytes, size_t rx_frames,
+	struct can_handler *handlers, size_t num, bool fd)
+{
+	stimer_event_handle evt;
+
+	if (!core || !rx_buf || !rx_frames || (num && !handlers))
+		return false;
+
+	for (size_t i = 0; i < num; i++) {
+		if (!handlers[i].handler && !handlers[i].fd_handler)
+			return false;
+		handlers[i].id &= handlers[i].mask; // 预先去掉不参与匹配的位
+	}
+
+	handler_sort(handlers, num);
+
+	core->groups = 0;
+	for (size_t i = 0; i < num; i++) {
+		if (i && handlers[i].mask == handlers[i - 1].mask) {
+			if (handlers[i].id == handlers[i - 1].id)
+				return false; // 重复项
+			continue;
+		}
+
+		if (core->groups == CAN_CORE_MAX_MASKS)
+			return false;
+		core->group_start[core->groups++] = i;
+	}
+	core->group_start[core->groups] = num;
+
+	core->fd = fd;
+	core->handlers = handlers;
+	core->num = num;
+	core->unmatched = NULL;
+	core->unmatched_fd = NULL;
+	core->unmatched_arg = NULL;
+	core->unmatched_cnt = 0;
+
+	evt = stimer_event_task_create(can_core_dispatch, core);
+	if (!evt)
+		return false;
+
+	return evt_queue_init(&(core->rxq), frame_bytes, rx_buf, rx_frames, evt);
+}
+
+bool can_core_init(
+	struct can_core *core, struct can_frame *rx_buf, size_t rx_frames, struct can_handler *handlers, size_t num)
+{
+	return can_core_setup(core, rx_buf, sizeof(struct can_frame), rx_frames, handlers, num, false);
+}
+
+bool can_core_init_fd(
+	struct can_core *core, struct canfd_frame *rx_buf, size_t rx_frames, struct can_handler *handlers, size_t num)
+{
+	return can_core_setup(core, rx_buf, sizeof(struct canfd_frame), rx_frames, handlers, num, true);
+}
+
+void can_core_set_unmatched(struct can_core *core, can_rx_handler handler, void *arg)
+{
+	if (!core)
+		return;
+
+	core->unmatched = handler;
+	core->unmatched_arg = arg;
+}
+
+void can_core_set_unmatched_fd(struct can_core *core, can_rxfd_handler handler, void *arg)
+{
+	if (!core)
+		return;
+
+	core->unmatched_fd = handler;
+	core->unmatched_arg = arg;
+}
+
+bool can_core_rx_isr(struct can_core *core, const struct can_frame *frame)
+{
+	struct canfd_frame fd;
+
+	if (!core || !frame)
+		return false;
+
+	if (!core->fd)
+		return evt_queue_post(&(core->rxq), frame);
+
+	can_frame_to_fd(&fd, frame);
+	return evt_queue_post(&(core->rxq), &fd);
+}
+
+bool can_core_rx_fd_isr(struct can_core *core, const struct canfd_frame *frame)
+{
+	struct can_frame classic;
+
+	if (!core || !frame)
+		return false;
+
+	if (core->fd)
+		return evt_queue_post(&(core->rxq), frame);
+
+	if (!can_fd_to_frame(&classic, frame))
+		return false;
+
+	return evt_queue_post(&(core->rxq), &classic);
+}
+
+const struct can_handler *can_core_lookup(const struct can_core *core, canid_t can_id)
+{
+	const struct can_handler *h;
+	size_t lo, hi, mid;
+	canid_t mask, key;
+
+	if (!core)
+		return NULL;
+
+	for (size_t g = 0; g < core->groups; g++) {
+		lo = core->group_start[g];
+		hi = core->group_start[g + 1];
+		mask = core->handlers[lo].mask;
+		key = can_id & mask;
+
+		while (lo < hi) {
+			mid = lo + (hi - lo) / 2;
+			h = &(core->handlers[mid]);
+			if (h->id == key)
+				return h;
+			if (h->id < key)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+	}
+
+	return NULL;
+}
+
+// 合并两个过滤器 结果同时覆盖两者
+static inline struct can_hw_filter filter_merge(struct can_hw_filter a, struct can_hw_filter b)
+{
+	struct can_hw_filter m;
+
+	m.mask = a.mask & b.mask & ~(a.id ^ b.id);
+	m.id = a.id & m.mask;
+	return m;
+}
+
+// 合并后损失的掩码位数 越少说明多放行的帧越少
+static inline int filter_cost(struct can_hw_filter a, struct can_hw_filter b)
+{
+	struct can_hw_filter m = filter_merge(a, b);
+
+	return __builtin_popcount(a.mask) + __builtin_popcount(b.mask) - 2 * __builtin_popcount(m.mask);
+}
+
+// a 是否已经覆盖 b
+static inline bool filter_covers(struct can_hw_filter a, struct can_hw_filter b)
+{
+	return ((a.mask & b.mask) == a.mask) && ((b.id & a.mask) == a.id);
+}
+
+size_t can_core_hw_filters(const struct can_core *core, struct can_hw_filter *out, size_t max)
+{
+	struct can_hw_filter f;
+	size_t cnt = 0;
+	size_t bi, bj;
+	int best, cost;
+	bool covered;
+
+	if (!core || !out || !max)
+		return 0;
+
+	for (size_t n = 0; n < core->num; n++) {
+		f.id = core->handlers[n].id;
+		f.mask = core->handlers[n].mask;
+
+		covered = false;
+		for (size_t i = 0; i < cnt && !covered; i++)
+			covered = filter_covers(out[i], f);
+		if (covered)
+			continue;
+
+		if (cnt < max) {
+			out[cnt++] = f;
+			continue;
+		}
+
+		// 过滤器已用完: 在"新表项并入某个过滤器"和"合并两个已有过滤器腾出位置"中选择代价最小的
+		best = -1;
+		bi = bj = 0;
+		for (size_t i = 0; i < cnt; i++) {
+			cost = filter_cost(out[i], f);
+			if (best < 0 || cost < best) {
+				best = cost;
+				bi = i;
+				bj = cnt;
+			}
+			for (size_t j = i + 1; j < cnt; j++) {
+				cost = filter_cost(out[i], out[j]);
+				if (cost < best) {
+					best = cost;
+					bi = i;
+					bj = j;
+				}
+			}
+		}
+
+		if (bj == cnt) {
+			out[bi] = filter_merge(out[bi], f);
+		} else {
+			out[bi] = filter_merge(out[bi], out[bj]);
+			out[bj] = f;
+		}
+	}
+
+	return cnt;
+}
+
+uint32_t can_core_take_drops(struct can_core *core)
+{
+	if (!core)
+		return 0;
+
+	return evt_queue_take_drops(&(core->rxq));
+}
@@ -0,0 +1,435 @@
+/**
+ * @file isotp.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief ISO-TP(ISO 15765-2)传输层
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include <string.h>
+
+#include "bus/isotp.h"
+
+// 协议控制信息(PCI)类型
+#define ISOTP_PCI_SF (0x0) /* 单帧 */
+#define ISOTP_PCI_FF (0x1) /* 首帧 */
+#define ISOTP_PCI_CF (0x2) /* 连续帧 */
+#define ISOTP_PCI_FC (0x3) /* 流控帧 */
+
+// 流控状态
+#define ISOTP_FC_CTS (0x0)	 /* 继续发送 */
+#define ISOTP_FC_WAIT (0x1)	 /* 等待 */
+#define ISOTP_FC_OVFLW (0x2) /* 溢出 */
+
+#define ISOTP_SF_MAX (CAN_MAX_DLEN - 1) /* 单帧最大数据长度 */
+#define ISOTP_FF_DL_12BIT (0xFFF)		/* 12位首帧长度的最大值 更长的报文使用32位长度 */
+
+enum isotp_state {
+	ISOTP_IDLE = 0,	  /* 空闲 */
+	ISOTP_TX_WAIT_FC, /* 等待流控帧 */
+	ISOTP_TX_SEND_CF, /* 发送连续帧 */
+	ISOTP_RX_CF,	  /* 接收连续帧 */
+};
+
+// STmin编码转换为毫秒 微秒级间隔向上取整到一个节拍, 保留值按最大值处理
+static uint32_t isotp_stmin_ms(uint8_t stmin)
+{
+	if (stmin <= 0x7F)
+		return stmin;
+	if (stmin >= 0xF1 && stmin <= 0xF9)
+		return 1;
+	return 0x7F;
+}
+
+static bool isotp_xmit(struct isotp_link *link, struct can_frame *frame, uint8_t len)
+{
+	if (link->cfg.pad && len < CAN_MAX_DLEN) {
+		memset(&(frame->data[len]), ISOTP_PAD_BYTE, CAN_MAX_DLEN - len);
+		len = CAN_MAX_DLEN;
+	}
+
+	frame->can_id = link->cfg.tx_id;
+	frame->can_dlc = len;
+	return link->cfg.send(frame, link->cfg.send_arg);
+}
+
+static void isotp_tx_end(struct isotp_link *link, int err)
+{
+	stimer_timer_stop(link->tx_timer);
+	link->tx_state = ISOTP_IDLE;
+
+	if (link->cfg.tx_done)
+		link->cfg.tx_done(link, err, link->tx_pos);
+}
+
+static void isotp_rx_end(struct isotp_link *link, int err, size_t len)
+{
+	stimer_timer_stop(link->rx_timer);
+	link->rx_state = ISOTP_IDLE;
+
+	if (link->cfg.rx_done)
+		link->cfg.rx_done(link, err, len);
+}
+
+// 发送挂起的流控帧和连续帧
+static void isotp_tx_task(void *arg)
+{
+	struct isotp_link *link = (struct isotp_link *)arg;
+	struct can_frame frame;
+	size_t chunk;
+
+	if (link->fc_pending >= 0) {
+		frame.data[0] = (ISOTP_PCI_FC << 4) | (uint8_t)link->fc_pending;
+		frame.data[1] = link->cfg.bs;
+		frame.data[2] = link->cfg.stmin;
+		if (!isotp_xmit(link, &frame, 3)) {
+			stimer_event_post(link->tx_evt); // 流控帧不能等待定时器 下一轮调度立即重试
+			return;
+		}
+		link->fc_pending = -1;
+	}
+
+	if (link->tx_state != ISOTP_TX_SEND_CF)
+		return;
+
+	// 发送接口空闲通知可以提前结束重试等待, 但不能打断STmin间隔
+	if (stimer_timer_is_active(link->tx_timer)) {
+		if (!link->tx_blocked)
+			return;
+		stimer_timer_stop(link->tx_timer);
+	}
+	link->tx_blocked = false;
+
+	for (uint32_t n = 0; n < ISOTP_BURST_FRAMES; n++) {
+		chunk = link->tx_len - link->tx_pos;
+		if (chunk > ISOTP_SF_MAX)
+			chunk = ISOTP_SF_MAX;
+
+		frame.data[0] = (ISOTP_PCI_CF << 4) | link->tx_sn;
+		memcpy(&(frame.data[1]), link->tx_buf + link->tx_pos, chunk);
+		if (!isotp_xmit(link, &frame, chunk + 1)) {
+			link->tx_blocked = true;
+			stimer_timer_start(link->tx_timer, ISOTP_RETRY_MS);
+			return;
+		}
+
+		link->tx_pos += chunk;
+		link->tx_sn = (link->tx_sn + 1) & 0x0F;
+
+		if (link->tx_pos == link->tx_len) {
+			isotp_tx_end(link, ISOTP_ERR_NONE);
+			return;
+		}
+
+		if (link->tx_bs && ++(link->tx_bs_cnt) == link->tx_bs) {
+			link->tx_state = ISOTP_TX_WAIT_FC;
+			link->tx_wft = 0;
+			stimer_timer_start(link->tx_timer, ISOTP_TIMEOUT_MS);
+			return;
+		}
+
+		if (link->tx_stmin_ms) {
+			stimer_timer_start(link->tx_timer, link->tx_stmin_ms);
+			return;
+		}
+	}
+
+	stimer_event_post(link->tx_evt); // 让出调度器 下一轮继续发送
+}
+
+static void isotp_tx_timer_cb(void *arg)
+{
+	struct isotp_link *link = (struct isotp_link *)arg;
+
+	if (link->tx_state == ISOTP_TX_WAIT_FC)
+		isotp_tx_end(link, ISOTP_ERR_TIMEOUT);
+	else
+		isotp_tx_task(link);
+}
+
+static void isotp_rx_timer_cb(void *arg)
+{
+	struct isotp_link *link = (struct isotp_link *)arg;
+
+	if (link->rx_state == ISOTP_RX_CF)
+		isotp_rx_end(link, ISOTP_ERR_TIMEOUT, link->rx_pos);
+}
+
+static void isotp_send_fc(struct isotp_link *link, uint8_t fs)
+{
+	link->fc_pending = fs;
+	isotp_tx_task(link);
+}
+
+static void isotp_on_sf(struct isotp_link *link, const struct can_frame *frame)
+{
+	size_t len = frame->data[0] & 0x0F;
+
+	if (!len || len > (size_t)(frame->can_dlc - 1))
+		return;
+
+	// 接收过程中收到新的单帧 放弃当前报文
+	if (link->rx_state == ISOTP_RX_CF)
+		isotp_rx_end(link, ISOTP_ERR_UNEXPECTED, link->rx_pos);
+
+	if (!link->rx_buf || len > link->rx_size) {
+		if (link->cfg.rx_done)
+			link->cfg.rx_done(link, ISOTP_ERR_OVERFLOW, len);
+		return;
+	}
+
+	memcpy(link->rx_buf, &(frame->data[1]), len);
+	if (link->cfg.rx_done)
+		link->cfg.rx_done(link, ISOTP_ERR_NONE, len);
+}
+
+static void isotp_on_ff(struct isotp_link *link, const struct can_frame *frame)
+{
+	const uint8_t *d = frame->data;
+	size_t len, head;
+
+	if (frame->can_dlc != CAN_MAX_DLEN)
+		return;
+
+	len = ((size_t)(d[0] & 0x0F) << 8) | d[1];
+	head = 2;
+	if (len == 0) {
+		len = ((size_t)d[2] << 24) | ((size_t)d[3] << 16) | ((size_t)d[4] << 8) | d[5];
+		head = 6;
+	}
+
+	if (len <= ISOTP_SF_MAX)
+		return;
+
+	if (link->rx_state == ISOTP_RX_CF)
+		isotp_rx_end(link, ISOTP_ERR_UNEXPECTED, link->rx_pos);
+
+	if (!link->rx_buf || len > link->rx_size) {
+		isotp_send_fc(link, ISOTP_FC_OVFLW);
+		if (link->cfg.rx_done)
+			link->cfg.rx_done(link, ISOTP_ERR_OVERFLOW, len);
+		return;
+	}
+
+	link->rx_len = len;
+	link->rx_pos = CAN_MAX_DLEN - head;
+	memcpy(link->rx_buf, &(d[head]), link->rx_pos);
+	link->rx_sn = 1;
+	link->rx_bs_cnt = 0;
+	link->rx_state = ISOTP_RX_CF;
+
+	stimer_timer_start(link->rx_timer, ISOTP_TIMEOUT_MS);
+	isotp_send_fc(link, ISOTP_FC_CTS);
+}
+
+static void isotp_on_cf(struct isotp_link *link, const struct can_frame *frame)
+{
+	size_t chunk;
+
+	if (link->rx_state != ISOTP_RX_CF || frame->can_dlc < 2)
+		return;
+
+	if ((frame->data[0] & 0x0F) != link->rx_sn) {
+		isotp_rx_end(link, ISOTP_ERR_WRONG_SN, link->rx_pos);
+		return;
+	}
+
+	// 直接拷贝到调用方的接收缓冲区
+	chunk = link->rx_len - link->rx_pos;
+	if (chunk > (size_t)(frame->can_dlc - 1))
+		chunk = frame->can_dlc - 1;
+	memcpy(link->rx_buf + link->rx_pos, &(frame->data[1]), chunk);
+	link->rx_pos += chunk;
+	link->rx_sn = (link->rx_sn + 1) & 0x0F;
+
+	if (link->rx_pos == link->rx_len) {
+		isotp_rx_end(link, ISOTP_ERR_NONE, link->rx_len);
+		return;
+	}
+
+	stimer_timer_start(link->rx_timer, ISOTP_TIMEOUT_MS);
+
+	if (link->cfg.bs && ++(link->rx_bs_cnt) == link->cfg.bs) {
+		link->rx_bs_cnt = 0;
+		isotp_send_fc(link, ISOTP_FC_CTS);
+	}
+}
+
+static void isotp_on_fc(struct isotp_link *link, const struct can_frame *frame)
+{
+	if (link->tx_state != ISOTP_TX_WAIT_FC || frame->can_dlc < 3)
+		return;
+
+	switch (frame->data[0] & 0x0F) {
+	case ISOTP_FC_CTS:
+		stimer_timer_stop(link->tx_timer);
+		link->tx_bs = frame->data[1];
+		link->tx_stmin_ms = isotp_stmin_ms(frame->data[2]);
+		link->tx_bs_cnt = 0;
+		link->tx_state = ISOTP_TX_SEND_CF;
+		isotp_tx_task(link); // 流控帧后的第一个连续帧不需要等待STmin
+		break;
+
+	case ISOTP_FC_WAIT:
+		if (++(link->tx_wft) > ISOTP_MAX_WFT)
+			isotp_tx_end(link, ISOTP_ERR_UNEXPECTED);
+		else
+			stimer_timer_start(link->tx_timer, ISOTP_TIMEOUT_MS);
+		break;
+
+	case ISOTP_FC_OVFLW:
+		isotp_tx_end(link, ISOTP_ERR_OVERFLOW);
+		break;
+
+	default:
+		isotp_tx_end(link, ISOTP_ERR_UNEXPECTED);
+		break;
+	}
+}
+
+int isotp_init(struct isotp_link *link, const struct isotp_config *cfg)
+{
+	if (!link || !cfg || !cfg->send)
+		return ISOTP_ERR_INVALID;
+
+	memset(link, 0, sizeof(struct isotp_link));
+	link->cfg = *cfg;
+	link->fc_pending = -1;
+
+	link->tx_timer = stimer_timer_create(isotp_tx_timer_cb, link);
+	link->rx_timer = stimer_timer_create(isotp_rx_timer_cb, link);
+	link->tx_evt = stimer_event_task_create(isotp_tx_task, link);
+	if (!link->tx_timer || !link->rx_timer || !link->tx_evt)
+		return ISOTP_ERR_INVALID;
+
+	return ISOTP_ERR_NONE;
+}
+
+void isotp_set_rx_buffer(struct isotp_link *link, void *buf, size_t size)
+{
+	if (!link)
+		return;
+
+	// 接收过程中不允许切换 否则已接收的数据会丢失
+	if (link->rx_state == ISOTP_RX_CF)
+		return;
+
+	link->rx_buf = (uint8_t *)buf;
+	link->rx_size = buf ? size : 0;
+}
+
+int isotp_send(struct isotp_link *link, const void *data, size_t len)
+{
+	struct can_frame frame;
+	size_t head;
+
+	if (!link || !data || !len || len > UINT32_MAX)
+		return ISOTP_ERR_INVALID;
+
+	if (link->tx_state != ISOTP_IDLE)
+		return ISOTP_ERR_BUSY;
+
+	link->tx_buf = (const uint8_t *)data;
+	link->tx_len = len;
+
+	if (len <= ISOTP_SF_MAX) {
+		frame.data[0] = (ISOTP_PCI_SF << 4) | (uint8_t)len;
+		memcpy(&(frame.data[1]), data, len);
+		if (!isotp_xmit(link, &frame, len + 1))
+			return ISOTP_ERR_BUSY;
+
+		link->tx_pos = len;
+		isotp_tx_end(link, ISOTP_ERR_NONE);
+		return ISOTP_ERR_NONE;
+	}
+
+	if (len <= ISOTP_FF_DL_12BIT) {
+		frame.data[0] = (ISOTP_PCI_FF << 4) | (uint8_t)(len >> 8);
+		frame.data[1] = (uint8_t)len;
+		head = 2;
+	} else {
+		frame.data[0] = ISOTP_PCI_FF << 4;
+		frame.data[1] = 0;
+		frame.data[2] = (uint8_t)(len >> 24);
+		frame.data[3] = (uint8_t)(len >> 16);
+		frame.data[4] = (uint8_t)(len >> 8);
+		frame.data[5] = (uint8_t)len;
+		head = 6;
+	}
+
+	memcpy(&(frame.data[head]), data, CAN_MAX_DLEN - head);
+	if (!isotp_xmit(link, &frame, CAN_MAX_DLEN))
+		return ISOTP_ERR_BUSY;
+
+	link->tx_pos = CAN_MAX_DLEN - head;
+	link->tx_sn = 1;
+	link->tx_wft = 0;
+	link->tx_state = ISOTP_TX_WAIT_FC;
+	stimer_timer_start(link->tx_timer, ISOTP_TIMEOUT_MS);
+
+	return ISOTP_ERR_NONE;
+}
+
+void isotp_on_frame(const struct can_frame *frame, void *arg)
+{
+	struct isotp_link *link = (struct isotp_link *)arg;
+
+	if (!link || !frame || frame->can_id != link->cfg.rx_id || !frame->can_dlc)
+		return;
+
+	switch (frame->data[0] >> 4) {
+	case ISOTP_PCI_SF:
+		isotp_on_sf(link, frame);
+		break;
+
+	case ISOTP_PCI_FF:
+		isotp_on_ff(link, frame);
+		break;
+
+	case ISOTP_PCI_CF:
+		isotp_on_cf(link, frame);
+		break;
+
+	case ISOTP_PCI_FC:
+		isotp_on_fc(link, frame);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void isotp_tx_ready(struct isotp_link *link)
+{
+	if (link && link->tx_evt)
+		stimer_event_post(link->tx_evt);
+}
+
+bool isotp_tx_busy(const struct isotp_link *link)
+{
+	return link && link->tx_state != ISOTP_IDLE;
+}
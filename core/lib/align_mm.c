@@ -30,8 +30,8 @@
  * 
  */
 
-#include <stdlib.h>
 #include "core/lib/align_mm.h"
+#include "core/virtual_os_mm.h"
 
 #define IS_POWER_OF_TWO(align) ((align) != 0 && ((align) & ((align) - 1)) == 0)
 #define EXTRA_MEMORY(size, align) ((size) + (align) - 1 + sizeof(void *))
@@ -53,7 +53,7 @@ void *aligned_malloc(size_t size, size_t align)
 		return NULL;
 
 	size_t alloc_size = EXTRA_MEMORY(size, align);
-	void *ptr = malloc(alloc_size);
+	void *ptr = virtual_os_malloc(alloc_size);
 	if (ptr == NULL)
 		return NULL;
 
@@ -77,5 +77,5 @@ void aligned_free(void *ptr)
 		return;
 
 	void *real_ptr = ((void **)ptr)[-1];
-	free(real_ptr);
+	virtual_os_free(real_ptr);
 }
\ No newline at end of file
@@ -515,6 +515,8 @@ static struct bfhead freelist = {     /* List of free buffers */
 #ifdef BufStats
 static bufsize totalloc = 0;	      /* Total space currently allocated */
 static long numget = 0, numrel = 0;   /* Number of bget() and brel() calls */
+static bufsize maxalloc = 0;	      /* Peak of totalloc (VirtualOS) */
+#define UpdatePeak() if (totalloc > maxalloc) maxalloc = totalloc
 #ifdef BECtl
 static long numpblk = 0;	      /* Number of pool blocks */
 static long numpget = 0, numprel = 0; /* Number of block gets and rels */
@@ -639,6 +641,7 @@ void *bget(requested_size)
 #ifdef BufStats
 		    totalloc += size;
 		    numget++;		  /* Increment number of bget() calls */
+		    UpdatePeak();
 #endif
 		    buf = (void *) ((((char *) ba) + sizeof(struct bhead)));
 		    return buf;
@@ -659,6 +662,7 @@ void *bget(requested_size)
 #ifdef BufStats
 		    totalloc += b->bh.bsize;
 		    numget++;		  /* Increment number of bget() calls */
+		    UpdatePeak();
 #endif
 		    /* Negate size to mark buffer allocated. */
 		    b->bh.bsize = -(b->bh.bsize);
@@ -709,6 +713,7 @@ void *bget(requested_size)
 		totalloc += size;
 		numget++;	      /* Increment number of bget() calls */
 		numdget++;	      /* Direct bget() call count */
+		UpdatePeak();
 #endif
 		buf =  (void *) (bdh + 1);
 		return buf;
@@ -736,6 +741,113 @@ void *bget(requested_size)
     return NULL;
 }
 
+/*  BGETA  --  Allocate a buffer whose address is a multiple of align
+	       (VirtualOS).  The buffer is carved from the top of a free
+	       block at an aligned address: the space below it stays in
+	       the free block and any tail large enough to hold a free
+	       block header is split off and returned to the free list,
+	       so no more than one header's worth of space is wasted.
+	       align must be a power of two.  Buffers are released with
+	       brel(). */
+
+void *bgeta(requested_size, align)
+  bufsize requested_size;
+  bufsize align;
+{
+    bufsize size = requested_size;
+    struct bfhead *b;
+
+    assert(size > 0);
+    assert(align > 0 && (align & (align - 1)) == 0);
+
+    if (size < SizeQ) {
+	size = SizeQ;
+    }
+#ifdef SizeQuant
+#if SizeQuant > 1
+    size = (size + (SizeQuant - 1)) & (~(SizeQuant - 1));
+#endif
+#endif
+    size += sizeof(struct bhead);
+
+    for (b = freelist.ql.flink; b != &freelist; b = b->ql.flink) {
+	char *start = (char *) b;
+	char *end = start + b->bh.bsize;
+	char *buf;
+	struct bhead *ba, *bn;
+	struct bfhead *prev;
+	bufsize lead, tail;
+
+	if (b->bh.bsize < size) {
+	    continue;
+	}
+
+	/* Highest aligned buffer address that still fits in this block. */
+	buf = (char *) (((unsigned long) (end - size + sizeof(struct bhead)))
+			& ~((unsigned long) align - 1));
+
+	/* The space left below must be empty or hold a free block. */
+	while (buf - sizeof(struct bhead) > start &&
+	       (bufsize) (buf - sizeof(struct bhead) - start) <
+	       (bufsize) sizeof(struct bfhead)) {
+	    buf -= align;
+	}
+	if (buf - sizeof(struct bhead) < start) {
+	    continue;
+	}
+
+	ba = BH(buf - sizeof(struct bhead));
+	lead = (char *) ba - start;
+	tail = end - ((char *) ba + size);
+	bn = BH(end);
+	assert(bn->prevfree == b->bh.bsize);
+
+	if (tail < (bufsize) sizeof(struct bfhead)) {
+	    size += tail;	      /* Tail too small to be free: keep it */
+	    tail = 0;
+	}
+
+	prev = b->ql.blink;
+	if (lead == 0) {
+	    /* Whole start of the block is used: unlink it. */
+	    assert(b->ql.blink->ql.flink == b);
+	    assert(b->ql.flink->ql.blink == b);
+	    b->ql.blink->ql.flink = b->ql.flink;
+	    b->ql.flink->ql.blink = b->ql.blink;
+	    ba->prevfree = 0;
+	} else {
+	    b->bh.bsize = lead;
+	    ba->prevfree = lead;
+	}
+	ba->bsize = -size;
+
+	if (tail != 0) {
+	    struct bfhead *bt = BFH((char *) ba + size);
+	    struct bfhead *after = (lead == 0) ? prev : b;
+
+	    /* Return the tail to the free list. */
+	    bt->bh.prevfree = 0;
+	    bt->bh.bsize = tail;
+	    bt->ql.flink = after->ql.flink;
+	    bt->ql.blink = after;
+	    after->ql.flink->ql.blink = bt;
+	    after->ql.flink = bt;
+	    bn->prevfree = tail;
+	} else {
+	    bn->prevfree = 0;
+	}
+
+#ifdef BufStats
+	totalloc += size;
+	numget++;		      /* Increment number of bget() calls */
+	UpdatePeak();
+#endif
+	return (void *) buf;
+    }
+
+    return NULL;
+}
+
 /*  BGETZ  --  Allocate a buffer and clear its contents to zero.  We clear
 	       the  entire  contents  of  the buffer to zero, not just the
 	       region requested by the caller. */
@@ -1059,6 +1171,13 @@ void bstats(curalloc, totfree, maxfree, nget, nrel)
     }
 }
 
+/*  BPEAKALLOC  --  Return the peak of the space allocated (VirtualOS).  */
+
+bufsize bpeakalloc()
+{
+    return maxalloc;
+}
+
 #ifdef BECtl
 
 /*  BSTATSE  --  Return extended statistics  */
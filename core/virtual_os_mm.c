@@ -31,14 +31,207 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "core/virtual_os_config.h"
 #include "core/virtual_os_mm.h"
 
 #include "core/lib/bget.h"
+#include "core/lib/align_mm.h"
+
+#define VIRTUALOS_MM_POOL (VIRTUALOS_ENABLE_BGET && VIRTUALOS_MM_POOL_ENABLE)
+#define VIRTUALOS_MM_TRACE (VIRTUALOS_ENABLE_BGET && VIRTUALOS_MM_TRACE_ENABLE)
+#define VIRTUALOS_MM_CMD (VIRTUALOS_ENABLE_BGET && VIRTUALOS_SHELL_ENABLE)
+
+#if VIRTUALOS_MM_TRACE
+// 本文件实现带调用位置的接口 不使用头文件中的替换宏
+#undef virtual_os_malloc
+#undef virtual_os_calloc
+#undef virtual_os_realloc
+#undef virtual_os_aligned_malloc
+#endif
+
+#if VIRTUALOS_MM_CMD
+#include <stdio.h>
+#include "utils/simple_shell.h"
+#endif
+
+#if VIRTUALOS_ENABLE_BGET
+#define MM_REGION_MIN (64)	/* 单段空间的最小大小 */
+#define MM_REGION_ALIGN (8) /* 每段空间的起始地址按此对齐 */
+#define MM_ALIGN (4)		/* BGET返回的地址至少按此对齐 与bget.c中的SizeQuant相同 */
+
+// 堆统计
+static struct {
+	size_t total;	 // 交给BGET管理的空间大小 所有空间之和
+	uint32_t allocs; // 累计分配次数
+	uint32_t frees;	 // 累计释放次数
+	uint32_t failed; // 分配失败次数
+} mm_info;
+#endif
+
+#if VIRTUALOS_MM_TRACE
+static struct virtual_os_mm_trace mm_trace[VIRTUALOS_MM_TRACE_MAX]; // 未释放的内存块 ptr为NULL表示空闲
+static uint32_t mm_trace_lost;										// 记录表已满未能记录的次数
+#endif
+
+#if VIRTUALOS_MM_POOL
+
+#define MM_POOL_ALIGN (sizeof(void *) > 8 ? sizeof(void *) : 8) /* 块地址和块大小按此对齐 */
+
+static const uint16_t pool_sizes[] = VIRTUALOS_MM_POOL_SIZES;
+static const uint16_t pool_counts[] = VIRTUALOS_MM_POOL_COUNTS;
+
+#define MM_POOL_CLASSES (sizeof(pool_sizes) / sizeof(pool_sizes[0]))
+
+_Static_assert(sizeof(pool_sizes) / sizeof(pool_sizes[0]) == sizeof(pool_counts) / sizeof(pool_counts[0]),
+	"VIRTUALOS_MM_POOL_SIZES and VIRTUALOS_MM_POOL_COUNTS must have the same length");
+
+// 空闲块 链表指针存放在块内
+struct mm_block {
+	struct mm_block *next;
+};
+
+// 单档内存池 所有块位于一段连续空间内 通过地址范围判断指针是否属于该档
+struct mm_pool {
+	uint8_t *start;				// 起始地址
+	uint8_t *end;				// 结束地址
+	struct mm_block *free_list; // 空闲块链表
+	size_t block_size;			// 块大小
+	uint16_t used;				// 正在使用的块个数
+	uint16_t peak;				// 同时使用的最大块个数
+	uint32_t allocs;			// 累计分配次数
+	uint32_t fallback;			// 该档用完后由BGET分配的次数
+};
+
+static struct mm_pool mm_pools[MM_POOL_CLASSES];
+
+/**
+ * @brief 从BGET中申请各档内存池并串成空闲链表
+ * 
+ * @return bool BGET空间不足返回false
+ */
+static bool mm_pool_init(void)
+{
+	for (size_t i = 0; i < MM_POOL_CLASSES; i++) {
+		struct mm_pool *pool = &mm_pools[i];
+		size_t block_size = (pool_sizes[i] + MM_POOL_ALIGN - 1) & ~(MM_POOL_ALIGN - 1);
+
+		memset(pool, 0, sizeof(struct mm_pool));
+		pool->block_size = block_size;
+
+		if (!pool_counts[i])
+			continue;
+
+		uint8_t *mem = bgeta(block_size * pool_counts[i], MM_POOL_ALIGN);
+		if (!mem)
+			return false;
+
+		pool->start = mem;
+		pool->end = mem + block_size * pool_counts[i];
+
+		// 从高地址向低地址插入 分配时从低地址开始
+		for (size_t n = pool_counts[i]; n > 0; n--) {
+			struct mm_block *block = (struct mm_block *)(mem + block_size * (n - 1));
+			block->next = pool->free_list;
+			pool->free_list = block;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief 查找指针所属的内存池
+ * 
+ * @param ptr 内存地址
+ * @return struct mm_pool* 不属于任何内存池返回NULL
+ */
+static struct mm_pool *mm_pool_find(void *ptr)
+{
+	for (size_t i = 0; i < MM_POOL_CLASSES; i++) {
+		struct mm_pool *pool = &mm_pools[i];
+
+		if ((uint8_t *)ptr >= pool->start && (uint8_t *)ptr < pool->end)
+			return pool;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief 从能容纳 size 的最小一档中分配 该档用完时不借用更大的档
+ * 
+ * @param size 内存大小
+ * @return void* 超过最大档或该档用完返回NULL
+ */
+static void *mm_pool_alloc(size_t size)
+{
+	if (!size)
+		return NULL;
+
+	for (size_t i = 0; i < MM_POOL_CLASSES; i++) {
+		struct mm_pool *pool = &mm_pools[i];
+
+		if (size > pool->block_size)
+			continue;
+
+		struct mm_block *block = pool->free_list;
+		if (!block) {
+			pool->fallback++;
+			return NULL;
+		}
+
+		pool->free_list = block->next;
+		pool->allocs++;
+		if (++pool->used > pool->peak)
+			pool->peak = pool->used;
+
+		return block;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief 将块归还到内存池
+ * 
+ * @param pool 内存池
+ * @param ptr 内存地址
+ */
+static void mm_pool_free(struct mm_pool *pool, void *ptr)
+{
+	struct mm_block *block = ptr;
+
+	block->next = pool->free_list;
+	pool->free_list = block;
+	pool->used--;
+}
+
+#endif /* VIRTUALOS_MM_POOL */
 
 #if VIRTUALOS_ENABLE_BGET
+/**
+ * @brief 将一段空间交给BGET管理 起始地址按`MM_REGION_ALIGN`对齐
+ * 
+ * @param buf 空间起始地址
+ * @param size 空间大小
+ * @return bool 空间过小返回false
+ */
+static bool mm_add_region(void *buf, size_t size)
+{
+	uintptr_t addr = (uintptr_t)buf;
+	uintptr_t start = (addr + MM_REGION_ALIGN - 1) & ~(uintptr_t)(MM_REGION_ALIGN - 1);
+
+	if (!buf || size < MM_REGION_MIN + (start - addr))
+		return false;
 
+	size -= start - addr;
+	bpool((void *)start, (bufsize)size);
+	mm_info.total += size;
+
+	return true;
+}
 #endif
 
 /**
@@ -56,12 +249,55 @@ bool virtual_os_mm_init(size_t pool_size)
 	if (!p)
 		return false;
 
-	bpool(p, pool_size);
-
+	return virtual_os_mm_init_static(p, pool_size);
+#else
 	return true;
+#endif
+}
+
+/**
+ * @brief 使用调用者提供的空间初始化内存管理 不调用malloc
+ * 
+ * @param buf 空间起始地址
+ * @param size 空间大小
+ * @return true 成功
+ * @return false 失败 未使能`VIRTUALOS_ENABLE_BGET`时总是失败
+ */
+bool virtual_os_mm_init_static(void *buf, size_t size)
+{
+#if VIRTUALOS_ENABLE_BGET
+	if (!mm_add_region(buf, size))
+		return false;
+
+#if VIRTUALOS_MM_POOL
+	return mm_pool_init();
 #else
 	return true;
 #endif
+#else
+	(void)buf;
+	(void)size;
+	return false;
+#endif
+}
+
+/**
+ * @brief 追加一段不连续的空间 在初始化之后调用
+ * 
+ * @param buf 空间起始地址
+ * @param size 空间大小
+ * @return true 成功
+ * @return false 失败 未使能`VIRTUALOS_ENABLE_BGET`时总是失败
+ */
+bool virtual_os_mm_add_region(void *buf, size_t size)
+{
+#if VIRTUALOS_ENABLE_BGET
+	return mm_add_region(buf, size);
+#else
+	(void)buf;
+	(void)size;
+	return false;
+#endif
 }
 
 /**
@@ -70,9 +306,14 @@ bool virtual_os_mm_init(size_t pool_size)
  * @param size 内存大小
  * @return void* 失败返回NULL
  */
-void *virtual_os_malloc(size_t size)
+static void *mm_malloc(size_t size)
 {
 #if VIRTUALOS_ENABLE_BGET
+#if VIRTUALOS_MM_POOL
+	void *ptr = mm_pool_alloc(size);
+	if (ptr)
+		return ptr;
+#endif
 	return bget(size);
 #else
 	return malloc(size);
@@ -86,9 +327,16 @@ void *virtual_os_malloc(size_t size)
  * @param per_size 每个元素的大小
  * @return void* 失败返回NULL
  */
-void *virtual_os_calloc(size_t num, size_t per_size)
+static void *mm_calloc(size_t num, size_t per_size)
 {
 #if VIRTUALOS_ENABLE_BGET
+#if VIRTUALOS_MM_POOL
+	void *ptr = mm_pool_alloc(num * per_size);
+	if (ptr) {
+		memset(ptr, 0, num * per_size);
+		return ptr;
+	}
+#endif
 	return bgetz(num * per_size);
 #else
 	return calloc(num, per_size);
@@ -102,9 +350,25 @@ void *virtual_os_calloc(size_t num, size_t per_size)
  * @param size 新内存大小
  * @return void* 失败返回NULL
  */
-void *virtual_os_realloc(void *old_ptr, size_t size)
+static void *mm_realloc(void *old_ptr, size_t size)
 {
 #if VIRTUALOS_ENABLE_BGET
+#if VIRTUALOS_MM_POOL
+	struct mm_pool *pool = old_ptr ? mm_pool_find(old_ptr) : NULL;
+
+	if (pool) {
+		if (size && size <= pool->block_size)
+			return old_ptr; // 块大小足够 原地使用
+
+		void *ptr = mm_malloc(size);
+		if (ptr || !size) {
+			if (ptr)
+				memcpy(ptr, old_ptr, size < pool->block_size ? size : pool->block_size);
+			mm_pool_free(pool, old_ptr);
+		}
+		return ptr;
+	}
+#endif
 	return bgetr(old_ptr, size);
 #else
 	return realloc(old_ptr, size);
@@ -116,11 +380,448 @@ void *virtual_os_realloc(void *old_ptr, size_t size)
  * 
  * @param ptr 内存地址
  */
-void virtual_os_free(void *ptr)
+static void mm_free(void *ptr)
 {
 #if VIRTUALOS_ENABLE_BGET
+#if VIRTUALOS_MM_POOL
+	struct mm_pool *pool = ptr ? mm_pool_find(ptr) : NULL;
+
+	if (pool) {
+		mm_pool_free(pool, ptr);
+		return;
+	}
+#endif
 	brel(ptr);
 #else
 	free(ptr);
 #endif
 }
+
+/**
+ * @brief 申请对齐的内存 大小向上取整到对齐大小, 避免与其他内存共用缓存行
+ * 
+ * @param size 内存大小
+ * @param align 对齐大小 必须是2的幂
+ * @return void* 失败返回NULL
+ */
+static void *mm_aligned_malloc(size_t size, size_t align)
+{
+	if (!size || !align || (align & (align - 1)))
+		return NULL;
+
+	size = (size + align - 1) & ~(align - 1);
+
+#if VIRTUALOS_ENABLE_BGET
+	if (align <= MM_ALIGN)
+		return mm_malloc(size);
+
+	return bgeta((bufsize)size, (bufsize)align); // 直接在空闲块中切出对齐的块
+#else
+	return aligned_malloc(size, align < sizeof(void *) ? sizeof(void *) : align);
+#endif
+}
+
+/**
+ * @brief 记录一次分配
+ * 
+ * @param ptr 分配到的地址 为NULL表示分配失败
+ * @param size 内存大小
+ * @param file 调用位置所在的文件 可为NULL
+ * @param line 调用位置所在的行号
+ */
+static inline void mm_account(void *ptr, size_t size, const char *file, int line)
+{
+#if VIRTUALOS_ENABLE_BGET
+	if (!ptr) {
+		mm_info.failed++;
+		return;
+	}
+
+	mm_info.allocs++;
+#endif
+
+#if VIRTUALOS_MM_TRACE
+	for (size_t i = 0; i < VIRTUALOS_MM_TRACE_MAX; i++) {
+		if (!mm_trace[i].ptr) {
+			mm_trace[i] = (struct virtual_os_mm_trace){ ptr, size, file, line };
+			return;
+		}
+	}
+
+	mm_trace_lost++;
+#else
+	(void)ptr;
+	(void)size;
+	(void)file;
+	(void)line;
+#endif
+}
+
+/**
+ * @brief 记录一次释放
+ * 
+ * @param ptr 内存地址
+ */
+static inline void mm_unaccount(void *ptr)
+{
+#if VIRTUALOS_ENABLE_BGET
+	mm_info.frees++;
+#endif
+
+#if VIRTUALOS_MM_TRACE
+	for (size_t i = 0; i < VIRTUALOS_MM_TRACE_MAX; i++) {
+		if (mm_trace[i].ptr == ptr) {
+			mm_trace[i].ptr = NULL;
+			return;
+		}
+	}
+#else
+	(void)ptr;
+#endif
+}
+
+#if VIRTUALOS_MM_TRACE
+/**
+ * @brief 申请内存 并记录调用位置
+ * 
+ * @param size 内存大小
+ * @param file 调用位置所在的文件
+ * @param line 调用位置所在的行号
+ * @return void* 失败返回NULL
+ */
+void *virtual_os_malloc_at(size_t size, const char *file, int line)
+{
+	void *ptr = mm_malloc(size);
+
+	mm_account(ptr, size, file, line);
+	return ptr;
+}
+
+/**
+ * @brief 申请内存并初始化为0 并记录调用位置
+ * 
+ * @param num 元素个数
+ * @param per_size 每个元素的大小
+ * @param file 调用位置所在的文件
+ * @param line 调用位置所在的行号
+ * @return void* 失败返回NULL
+ */
+void *virtual_os_calloc_at(size_t num, size_t per_size, const char *file, int line)
+{
+	void *ptr = mm_calloc(num, per_size);
+
+	mm_account(ptr, num * per_size, file, line);
+	return ptr;
+}
+
+/**
+ * @brief 重新分配内存 并记录调用位置
+ * 
+ * @param old_ptr 原内存地址
+ * @param size 新内存大小
+ * @param file 调用位置所在的文件
+ * @param line 调用位置所在的行号
+ * @return void* 失败返回NULL
+ */
+void *virtual_os_realloc_at(void *old_ptr, size_t size, const char *file, int line)
+{
+	void *ptr = mm_realloc(old_ptr, size);
+
+	if (ptr && old_ptr)
+		mm_unaccount(old_ptr); // 记为释放原内存再分配新内存
+	mm_account(ptr, size, file, line);
+	return ptr;
+}
+
+/**
+ * @brief 申请对齐的内存 并记录调用位置
+ * 
+ * @param size 内存大小
+ * @param align 对齐大小
+ * @param file 调用位置所在的文件
+ * @param line 调用位置所在的行号
+ * @return void* 失败返回NULL
+ */
+void *virtual_os_aligned_malloc_at(size_t size, size_t align, const char *file, int line)
+{
+	void *ptr = mm_aligned_malloc(size, align);
+
+	mm_account(ptr, size, file, line);
+	return ptr;
+}
+#endif /* VIRTUALOS_MM_TRACE */
+
+/**
+ * @brief 申请内存
+ * 
+ * @param size 内存大小
+ * @return void* 失败返回NULL
+ */
+void *virtual_os_malloc(size_t size)
+{
+	void *ptr = mm_malloc(size);
+
+	mm_account(ptr, size, NULL, 0);
+	return ptr;
+}
+
+/**
+ * @brief 申请内存并初始化为0
+ * 
+ * @param num 元素个数
+ * @param per_size 每个元素的大小
+ * @return void* 失败返回NULL
+ */
+void *virtual_os_calloc(size_t num, size_t per_size)
+{
+	void *ptr = mm_calloc(num, per_size);
+
+	mm_account(ptr, num * per_size, NULL, 0);
+	return ptr;
+}
+
+/**
+ * @brief 重新分配内存
+ * 
+ * @param old_ptr 原内存地址
+ * @param size 新内存大小
+ * @return void* 失败返回NULL
+ */
+void *virtual_os_realloc(void *old_ptr, size_t size)
+{
+	void *ptr = mm_realloc(old_ptr, size);
+
+	if (ptr && old_ptr)
+		mm_unaccount(old_ptr); // 记为释放原内存再分配新内存
+	mm_account(ptr, size, NULL, 0);
+	return ptr;
+}
+
+/**
+ * @brief 释放内存
+ * 
+ * @param ptr 内存地址
+ */
+void virtual_os_free(void *ptr)
+{
+	if (ptr)
+		mm_unaccount(ptr);
+
+	mm_free(ptr);
+}
+
+/**
+ * @brief 申请对齐的内存 与其他内存共用同一个内存池
+ * 
+ * @param size 内存大小 向上取整到对齐大小
+ * @param align 对齐大小 必须是2的幂
+ * @return void* 失败返回NULL
+ */
+void *virtual_os_aligned_malloc(size_t size, size_t align)
+{
+	void *ptr = mm_aligned_malloc(size, align);
+
+	mm_account(ptr, size, NULL, 0);
+	return ptr;
+}
+
+/**
+ * @brief 释放通过`virtual_os_aligned_malloc`申请的内存
+ * 
+ * @param ptr 内存地址
+ */
+void virtual_os_aligned_free(void *ptr)
+{
+#if VIRTUALOS_ENABLE_BGET
+	virtual_os_free(ptr); // BGET直接管理对齐的块
+#else
+	if (ptr)
+		mm_unaccount(ptr);
+
+	aligned_free(ptr);
+#endif
+}
+
+/**
+ * @brief 获取堆统计信息
+ * 
+ * @param stats 统计信息
+ * @return bool 未使能`VIRTUALOS_ENABLE_BGET`时返回false
+ */
+bool virtual_os_mm_get_stats(struct virtual_os_mm_stats *stats)
+{
+#if VIRTUALOS_ENABLE_BGET
+	if (!stats)
+		return false;
+
+	bufsize curalloc, totfree, maxfree;
+	long nget, nrel;
+
+	bstats(&curalloc, &totfree, &maxfree, &nget, &nrel);
+
+	stats->total = mm_info.total;
+	stats->used = (size_t)curalloc;
+	stats->peak = (size_t)bpeakalloc();
+	stats->free = (size_t)totfree;
+	stats->max_free = maxfree > 0 ? (size_t)maxfree : 0;
+	stats->frag = totfree > 0 ? (uint8_t)(100 - (stats->max_free * 100) / (size_t)totfree) : 0;
+	stats->allocs = mm_info.allocs;
+	stats->frees = mm_info.frees;
+	stats->failed = mm_info.failed;
+
+	return true;
+#else
+	(void)stats;
+	return false;
+#endif
+}
+
+/**
+ * @brief 获取内存池的档数 未使能`VIRTUALOS_MM_POOL_ENABLE`时返回0
+ * 
+ * @return size_t 
+ */
+size_t virtual_os_pool_count(void)
+{
+#if VIRTUALOS_MM_POOL
+	return MM_POOL_CLASSES;
+#else
+	return 0;
+#endif
+}
+
+/**
+ * @brief 获取某一档内存池的统计信息
+ * 
+ * @param idx 档位索引 从0开始
+ * @param stats 统计信息
+ * @return bool 档位不存在返回false
+ */
+bool virtual_os_pool_get_stats(size_t idx, struct virtual_os_pool_stats *stats)
+{
+#if VIRTUALOS_MM_POOL
+	if (idx >= MM_POOL_CLASSES || !stats)
+		return false;
+
+	struct mm_pool *pool = &mm_pools[idx];
+
+	stats->block_size = pool->block_size;
+	stats->total = pool_counts[idx];
+	stats->used = pool->used;
+	stats->peak = pool->peak;
+	stats->allocs = pool->allocs;
+	stats->fallback = pool->fallback;
+
+	return true;
+#else
+	(void)idx;
+	(void)stats;
+	return false;
+#endif
+}
+
+#if VIRTUALOS_MM_TRACE
+/**
+ * @brief 获取未释放的内存块及其调用位置
+ * 
+ * @param buf 输出缓冲区
+ * @param cnt 缓冲区能容纳的记录个数
+ * @param lost 记录表已满未能记录的次数 可为NULL
+ * @return size_t 实际输出的记录个数
+ */
+size_t virtual_os_mm_trace_get(struct virtual_os_mm_trace *buf, size_t cnt, uint32_t *lost)
+{
+	size_t n = 0;
+
+	for (size_t i = 0; i < VIRTUALOS_MM_TRACE_MAX && n < cnt; i++) {
+		if (mm_trace[i].ptr)
+			buf[n++] = mm_trace[i];
+	}
+
+	if (lost)
+		*lost = mm_trace_lost;
+
+	return n;
+}
+#endif /* VIRTUALOS_MM_TRACE */
+
+#if VIRTUALOS_MM_CMD
+
+/* ====================== 内置命令: mem ====================== */
+static void mm_cmd(int argc, char *argv[], uint8_t *out, size_t buf_size, size_t *out_len)
+{
+	struct virtual_os_mm_stats st;
+	uint32_t step = sps_cmd_step(); // 分段输出时为下一条内存块记录的索引 + 1
+	size_t pos = 0;
+	int len;
+
+	*out_len = 0;
+	if (!virtual_os_mm_get_stats(&st))
+		return;
+
+	// 第一段输出堆和内存池统计
+	if (!step) {
+		len = snprintf((char *)out, buf_size,
+			"heap  total %lu used %lu peak %lu free %lu max_free %lu frag %u%%\r\n"
+			"      allocs %lu frees %lu failed %lu\r\n",
+			(unsigned long)st.total, (unsigned long)st.used, (unsigned long)st.peak, (unsigned long)st.free,
+			(unsigned long)st.max_free, st.frag, (unsigned long)st.allocs, (unsigned long)st.frees,
+			(unsigned long)st.failed);
+		if (len < 0 || (size_t)len >= buf_size)
+			return;
+		pos = len;
+
+		for (size_t i = 0; i < virtual_os_pool_count(); i++) {
+			struct virtual_os_pool_stats ps;
+
+			virtual_os_pool_get_stats(i, &ps);
+			len = snprintf((char *)(out + pos), buf_size - pos,
+				"pool  %4lu x %-4u used %-4u peak %-4u fallback %lu\r\n", (unsigned long)ps.block_size, ps.total,
+				ps.used, ps.peak, (unsigned long)ps.fallback);
+			if (len < 0 || (size_t)len >= buf_size - pos)
+				break;
+			pos += len;
+		}
+	}
+
+#if VIRTUALOS_MM_TRACE
+	// mem trace 列出未释放的内存块 超过输出缓冲区时分段输出
+	if (argc == 2 && !strcmp(argv[1], "trace")) {
+		for (size_t i = step ? step - 1 : 0; i < VIRTUALOS_MM_TRACE_MAX; i++) {
+			struct virtual_os_mm_trace *t = &mm_trace[i];
+			const char *file;
+
+			if (!t->ptr)
+				continue;
+
+			file = t->file ? strrchr(t->file, '/') : NULL;
+			file = file ? file + 1 : (t->file ? t->file : "?");
+
+			len = snprintf((char *)(out + pos), buf_size - pos, "%p %6lu %s:%d\r\n", t->ptr,
+				(unsigned long)t->size, file, t->line);
+			if (len < 0)
+				break;
+			if ((size_t)len >= buf_size - pos) {
+				sps_cmd_continue(i + 1);
+				*out_len = pos;
+				return;
+			}
+			pos += len;
+		}
+
+		if (mm_trace_lost) {
+			len = snprintf((char *)(out + pos), buf_size - pos, "untracked %lu\r\n", (unsigned long)mm_trace_lost);
+			if (len > 0 && (size_t)len < buf_size - pos)
+				pos += len;
+		}
+	}
+#else
+	(void)argc;
+	(void)argv;
+#endif
+
+	*out_len = pos;
+}
+SPS_EXPORT_CMD(mem, mm_cmd, "show heap statistics, `mem trace` to list live allocations")
+
+#endif /* VIRTUALOS_MM_CMD */
@@ -79,6 +79,12 @@ void virtual_os_init(struct timer_port *port, size_t poll_size)
 	virtual_os_base_init(port);
 }
 
+void virtual_os_init_static(struct timer_port *port, void *heap, size_t heap_size)
+{
+	virtual_os_mm_init_static(heap, heap_size);
+	virtual_os_base_init(port);
+}
+
 #else
 
 void virtual_os_init(struct timer_port *port)
@@ -42,13 +42,52 @@
 
 static struct hash_table driver_table = { 0 };
 
+#if VIRTUALOS_STATIC_DRIVER
+extern const struct drv_static __start_static_driver[];
+extern const struct drv_static __stop_static_driver[];
+
+// 在按设备名排序的静态表中二分查找
+static const struct drv_static *find_static_driver(const char *name)
+{
+	const struct drv_static *lo = __start_static_driver;
+	const struct drv_static *hi = __stop_static_driver;
+
+	while (lo < hi) {
+		const struct drv_static *mid = lo + (hi - lo) / 2;
+		int cmp = strcmp(name, mid->name);
+
+		if (cmp == 0)
+			return mid;
+		if (cmp < 0)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return NULL;
+}
+
+// 初始化所有静态驱动 初始化失败的设备不可打开
+static void static_driver_probe(void)
+{
+	for (const struct drv_static *drv = __start_static_driver; drv < __stop_static_driver; drv++) {
+		if (drv->drv_init && !drv->drv_init(drv->dev))
+			drv->dev->file = NULL;
+	}
+}
+#endif
+
 /**
  * @brief 初始化驱动管理
  * 
  */
 void driver_manage_init(void)
 {
+#if VIRTUALOS_STATIC_DRIVER
+	// 静态模式下哈希表只在有驱动调用`driver_register`时才创建
+	static_driver_probe();
+#else
 	virtual_os_assert(init_hash_table(&driver_table, VIRTUALOS_MAX_DEV_NUM) == HASH_SUCCESS);
+#endif
 }
 
 /**
@@ -57,13 +96,29 @@ void driver_manage_init(void)
  * @param drv_init 驱动初始化
  * @param file_opts 驱动文件操作
  * @param name 设备名称
+ * @param copy 是否拷贝设备名 不拷贝时哈希表直接引用调用者的字符串
  * @return true 
  * @return false 
  */
-bool driver_register(driver_init drv_init, const struct file_operations *file_opts, const char *name)
+static bool _driver_register(driver_init drv_init, const struct file_operations *file_opts, const char *name, bool copy)
 {
 	enum hash_error err = HASH_POINT_ERROR;
 
+	if (!driver_table.table && init_hash_table(&driver_table, VIRTUALOS_MAX_DEV_NUM) != HASH_SUCCESS)
+		return false;
+
+	// 设备名超过最大长度时截断保存
+	size_t len = strlen(name);
+	if (len > VIRTUALOS_MAX_DEV_NAME_LEN - 1)
+		len = VIRTUALOS_MAX_DEV_NAME_LEN - 1;
+
+	// 同名设备(截断后)已存在时失败 不初始化驱动也不申请内存, 哈希表插入已存在的键会覆盖原有设备
+	char dev_name[VIRTUALOS_MAX_DEV_NAME_LEN];
+	memcpy(dev_name, name, len);
+	dev_name[len] = '\0';
+	if (find_device(dev_name))
+		return false;
+
 	struct drv_device *dev = virtual_os_calloc(1, sizeof(struct drv_device));
 	if (!dev)
 		return false;
@@ -78,22 +133,23 @@ bool driver_register(driver_init drv_init, const struct file_operations *file_op
 		goto free_file;
 
 	char *new_name = (char *)name;
-	if (unlikely(strlen(name) >= VIRTUALOS_MAX_DEV_NAME_LEN - 1)) {
-		new_name = (char *)virtual_os_calloc(1, VIRTUALOS_MAX_DEV_NAME_LEN);
+	if (copy || unlikely(len >= VIRTUALOS_MAX_DEV_NAME_LEN - 1)) {
+		new_name = (char *)virtual_os_malloc(len + 1);
 		if (!new_name)
 			goto free_file;
-		strncpy(new_name, name, VIRTUALOS_MAX_DEV_NAME_LEN - 1);
-		new_name[VIRTUALOS_MAX_DEV_NAME_LEN - 1] = '\0';
+		memcpy(new_name, dev_name, len + 1);
 	}
 
-	err = hash_insert(&driver_table, (const char *)new_name, (void *)dev);
+	// 设备名为调用者保证有效的字符串或上面申请的副本 哈希表直接引用, 不再拷贝
+	err = hash_insert_static(&driver_table, (const char *)new_name, (void *)dev);
 	if (err != HASH_SUCCESS)
 		goto free_name;
 
 	return true;
 
 free_name:
-	virtual_os_free(new_name);
+	if (new_name != name)
+		virtual_os_free(new_name);
 
 free_file:
 	virtual_os_free(dev->file);
@@ -104,6 +160,34 @@ free_dev:
 	return false;
 }
 
+/**
+ * @brief 注册设备 设备名会被拷贝
+ * 
+ * @param drv_init 驱动初始化
+ * @param file_opts 驱动文件操作
+ * @param name 设备名称
+ * @return true 
+ * @return false 
+ */
+bool driver_register(driver_init drv_init, const struct file_operations *file_opts, const char *name)
+{
+	return _driver_register(drv_init, file_opts, name, true);
+}
+
+/**
+ * @brief 注册设备 不拷贝设备名
+ * 
+ * @param drv_init 驱动初始化
+ * @param file_opts 驱动文件操作
+ * @param name 设备名称 在设备的整个生命周期内必须有效, 例如字符串常量
+ * @return true 
+ * @return false 
+ */
+bool driver_register_static(driver_init drv_init, const struct file_operations *file_opts, const char *name)
+{
+	return _driver_register(drv_init, file_opts, name, false);
+}
+
 /**
  * @brief 查找设备
  * 
@@ -114,6 +198,19 @@ struct drv_device *find_device(const char *name)
 {
 	struct drv_device *dev = NULL;
 	enum hash_error err;
+
+	if (!name)
+		return NULL;
+
+#if VIRTUALOS_STATIC_DRIVER
+	const struct drv_static *drv = find_static_driver(name);
+	if (drv)
+		return drv->dev;
+#endif
+
+	if (!driver_table.table)
+		return NULL;
+
 	dev = (struct drv_device *)hash_find(&driver_table, name, &err);
 	if (err == HASH_SUCCESS)
 		return dev;
@@ -131,17 +228,41 @@ void visit_all_device_name(void (*visit)(const char *name))
 	if (!visit)
 		return;
 
-	enum hash_error err = HASH_KEY_NOT_FOUND;
-	char **keys = NULL;
-	size_t num_keys = 0;
-	err = hash_get_all_keys(&driver_table, &keys, &num_keys);
-	if (err == HASH_SUCCESS) {
-		for (size_t i = 0; i < num_keys; i++) {
-			visit(keys[i]);
-			virtual_os_free(keys[i]);
-		}
-		virtual_os_free(keys);
-	}
+#if VIRTUALOS_STATIC_DRIVER
+	for (const struct drv_static *drv = __start_static_driver; drv < __stop_static_driver; drv++)
+		visit(drv->name);
+#endif
+
+	struct hash_iter iter = HASH_ITER_INIT;
+	const char *name;
+
+	while (hash_iter_next(&driver_table, &iter, &name, NULL))
+		visit(name);
+}
+
+/**
+ * @brief 追加一个设备名和换行符`\r\n` 空间不足时不追加
+ * 
+ * @param buf 写入位置 追加后后移
+ * @param len 剩余空间 追加后减少
+ * @param name 设备名
+ * @return bool 空间不足返回false
+ */
+static bool append_device_name(char **buf, size_t *len, const char *name)
+{
+	size_t name_len = strlen(name);
+
+	if (name_len + 3 > *len)
+		return false;
+
+	memcpy(*buf, name, name_len);
+	*buf += name_len;
+	*(*buf)++ = '\r';
+	*(*buf)++ = '\n';
+	**buf = '\0';
+	*len -= name_len + 2;
+
+	return true;
 }
 
 /**
@@ -155,26 +276,21 @@ void fill_all_device_name(char *buf, size_t len)
 	if (!buf || !len)
 		return;
 
-	enum hash_error err = HASH_KEY_NOT_FOUND;
-	char **keys = NULL;
-	size_t num_keys = 0;
-	err = hash_get_all_keys(&driver_table, &keys, &num_keys);
-	if (err == HASH_SUCCESS) {
-		for (size_t i = 0; i < num_keys; i++) {
-			size_t name_len = strlen(keys[i]);
-			if (name_len + 1 > len)
-				break;
-			memcpy(buf, keys[i], name_len);
-			buf += name_len;
-			*buf++ = '\r';
-			*buf++ = '\n';
-			len -= name_len + 2;
-		}
-		if (len > 0)
-			*buf = '\0';
-		for (size_t i = 0; i < num_keys; i++)
-			virtual_os_free(keys[i]);
-		virtual_os_free(keys);
+	*buf = '\0';
+
+#if VIRTUALOS_STATIC_DRIVER
+	for (const struct drv_static *drv = __start_static_driver; drv < __stop_static_driver; drv++) {
+		if (!append_device_name(&buf, &len, drv->name))
+			return;
+	}
+#endif
+
+	struct hash_iter iter = HASH_ITER_INIT;
+	const char *name;
+
+	while (hash_iter_next(&driver_table, &iter, &name, NULL)) {
+		if (!append_device_name(&buf, &len, name))
+			return;
 	}
 }
 
@@ -203,4 +319,17 @@ void *get_dev_private(const char *name)
 	if (!dev || !dev->file)
 		return NULL;
 	return dev->file->private;
-}
\ No newline at end of file
+}
+
+void drv_async_complete(struct drv_async *req, size_t actual, int err)
+{
+	if (!req)
+		return;
+
+	req->actual = actual;
+	__sync_synchronize(); // 长度先于状态可见
+	req->status = (err == DRV_ERR_NONE) ? DRV_ASYNC_DONE : DRV_ASYNC_ERROR;
+
+	if (req->done)
+		req->done(req);
+}
@@ -68,14 +68,9 @@ static void show_device(int argc, char *argv[], uint8_t *out, size_t buf_size, s
 		return;
 	}
 
-	char msg[VIRTUALOS_MAX_DEV_NUM * VIRTUALOS_MAX_DEV_NAME_LEN] = { 0 };
-	fill_all_device_name(msg, VIRTUALOS_MAX_DEV_NUM * VIRTUALOS_MAX_DEV_NAME_LEN);
-	*out_len = strlen(msg);
-	if (*out_len > buf_size) {
-		*out_len = 0;
-		return;
-	}
-	memcpy(out, msg, *out_len);
+	// 直接写入输出缓冲区 不占用栈空间
+	fill_all_device_name((char *)out, buf_size);
+	*out_len = buf_size ? strlen((char *)out) : 0;
 }
 SPS_EXPORT_CMD(show_device, show_device, "list all devices")
 
@@ -0,0 +1,183 @@
+/**
+ * @file bus_core.h
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 总线管理组件
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#ifndef __VIRTUAL_OS_BUS_CORE_H__
+#define __VIRTUAL_OS_BUS_CORE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "driver/virtual_os_driver.h"
+#include "utils/list.h"
+#include "utils/stimer.h"
+#include "bus/iic_bus.h"
+#include "bus/can_bus.h"
+
+/**
+ * @brief 共享总线管理
+ * 
+ * 一条物理总线(I2C/CAN)对应一个`struct bus_adapter`, 由总线控制器驱动实现`xfer`接口并注册
+ * 挂在总线上的每个设备(EEPROM,传感器等)持有一个`struct bus_client`, 每个客户端有独立的事务队列
+ * 
+ * 控制器每次只执行一个事务, 当前事务完成后按轮询顺序从下一个有待执行事务的客户端中取出一个事务启动,
+ * 避免单个设备连续提交时占满总线, 多个设备的事务在总线上依次流水执行, 提交方不需要阻塞等待
+ * 
+ * 事务的提交,取消和完成回调都在调度器上下文中执行, 控制器驱动只在传输完成中断中调用`bus_xfer_complete`
+ */
+
+// 总线类型
+enum bus_type {
+	BUS_TYPE_I2C = 0, /* 事务消息为 struct i2c_msg */
+	BUS_TYPE_CAN,	  /* 事务消息为 struct can_frame */
+};
+
+struct bus_adapter;
+struct bus_client;
+struct bus_xfer;
+
+typedef void (*bus_xfer_cb)(struct bus_xfer *xfer); /* 事务完成回调 在调度器上下文中调用 */
+
+// 总线事务 由调用方分配, 完成前必须保持有效
+struct bus_xfer {
+	void *msgs;				/* 消息数组 I2C为 struct i2c_msg, CAN为 struct can_frame */
+	size_t num;				/* 消息数量 */
+	bus_xfer_cb done;		/* 完成回调 可为NULL, 此时轮询 status */
+	void *arg;				/* 用户参数 */
+	volatile int status;	/* 事务状态 参考`enum drv_async_status` */
+	volatile size_t actual; /* 实际完成的消息数 */
+	volatile int err;		/* 错误码 DRV_ERR_NONE 表示成功 */
+
+	/* 以下为内部使用 */
+	list_item node;			   /* 挂入客户端事务队列 */
+	struct bus_client *client; /* 所属客户端 */
+};
+
+// 总线控制器操作接口
+struct bus_adapter_ops {
+	/**
+	 * @brief 启动一个事务 启动后立即返回, 全部消息完成或出错时调用`bus_xfer_complete`
+	 * 
+	 * I2C控制器应在消息之间使用重复起始条件, 最后一条消息后发送停止条件
+	 * 返回错误码时事务直接以该错误完成
+	 */
+	int (*xfer)(struct bus_adapter *bus, struct bus_xfer *xfer);
+};
+
+// 总线控制器 由控制器驱动分配
+struct bus_adapter {
+	const char *name;				   /* 总线名(必须是全局变量) 例如 "i2c0" */
+	enum bus_type type;				   /* 总线类型 */
+	const struct bus_adapter_ops *ops; /* 操作接口 */
+	void *private;					   /* 控制器私有数据 */
+
+	/* 以下为内部使用 */
+	list_item node;				   /* 挂入总线链表 */
+	list_item clients;			   /* 客户端环 */
+	list_item *rr;				   /* 下一次轮询的起始客户端 */
+	struct bus_xfer *volatile cur; /* 正在执行的事务 */
+	stimer_event_handle evt;	   /* 完成事件 */
+	volatile bool finished;		   /* 当前事务已完成 等待事件任务处理 */
+	bool kicking;				   /* 正在启动事务 防止回调中提交时重入 */
+};
+
+// 总线客户端 一般为一个从设备 由设备驱动分配
+struct bus_client {
+	struct bus_adapter *bus; /* 所属总线 */
+	uint16_t addr;			 /* 从机地址 供设备驱动填充消息使用 */
+	list_item pending;		 /* 待执行事务队列 */
+	list_item node;			 /* 挂入总线客户端环 */
+};
+
+/**
+ * @brief 注册总线控制器 一般在控制器驱动初始化中调用
+ * 
+ * @param bus 总线控制器 需要先填充 name/type/ops
+ * @return int 错误码 参考`DRV_ERR_*`
+ */
+int bus_adapter_register(struct bus_adapter *bus);
+
+/**
+ * @brief 按名称查找总线控制器
+ * 
+ * @param name 总线名
+ * @return struct bus_adapter* 未找到返回NULL
+ */
+struct bus_adapter *bus_adapter_find(const char *name);
+
+/**
+ * @brief 将客户端挂到总线上
+ * 
+ * @param client 客户端
+ * @param bus_name 总线名
+ * @param addr 从机地址
+ * @return int 错误码 参考`DRV_ERR_*`
+ */
+int bus_client_attach(struct bus_client *client, const char *bus_name, uint16_t addr);
+
+/**
+ * @brief 将客户端从总线上移除 客户端还有未完成的事务时失败
+ * 
+ * @param client 客户端
+ * @return int 错误码 参考`DRV_ERR_*`
+ */
+int bus_client_detach(struct bus_client *client);
+
+/**
+ * @brief 提交事务 立即返回, 事务在总线空闲且轮到该客户端时执行
+ * 
+ * 同一客户端的事务按提交顺序执行, 不同客户端之间轮流执行
+ * 
+ * @param client 客户端
+ * @param xfer 事务 需要先填充 msgs/num/done/arg
+ * @return int 错误码 参考`DRV_ERR_*` 事务还未完成时返回`DRV_ERR_OCCUPIED`
+ */
+int bus_submit(struct bus_client *client, struct bus_xfer *xfer);
+
+/**
+ * @brief 取消还未开始执行的事务 被取消的事务不调用完成回调
+ * 
+ * @param xfer 事务
+ * @return bool 成功取消返回true，事务已开始执行或未提交返回false
+ */
+bool bus_cancel(struct bus_xfer *xfer);
+
+/**
+ * @brief 控制器驱动在事务完成时调用 可在中断中调用
+ * 
+ * @param bus 总线控制器
+ * @param actual 实际完成的消息数
+ * @param err 错误码 DRV_ERR_NONE 表示成功
+ */
+void bus_xfer_complete(struct bus_adapter *bus, size_t actual, int err);
+
+#endif /* __VIRTUAL_OS_BUS_CORE_H__ */
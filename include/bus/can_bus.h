@@ -36,6 +36,7 @@
 #include <stdint.h>
 
 #define CAN_MAX_DLEN 8
+#define CANFD_MAX_DLEN 64
 
 /*
  * 控制器局域网 (CAN) 标识符结构
@@ -60,4 +61,46 @@ struct can_frame {
 	uint8_t can_dlc;			// 数据长度
 };
 
+#define CANFD_BRS 0x01 // 数据段切换到高波特率
+#define CANFD_ESI 0x02 // 发送节点处于被动错误状态
+#define CANFD_FDF 0x04 // CAN FD帧 未设置时为经典CAN帧
+
+// CAN FD帧 也可以存放经典CAN帧(flags不含CANFD_FDF)
+struct canfd_frame {
+	uint8_t data[CANFD_MAX_DLEN]; // 数据内容
+	canid_t can_id;				  // CAN ID + 帧类型
+	uint8_t len;				  // 数据长度 0~8,12,16,20,24,32,48,64
+	uint8_t flags;				  // CANFD_BRS/CANFD_ESI/CANFD_FDF
+};
+
+/**
+ * @brief CAN FD 数据长度码转换为数据长度
+ * 
+ * @param dlc 数据长度码 0~15
+ * @return uint8_t 数据长度
+ */
+static inline uint8_t can_fd_dlc2len(uint8_t dlc)
+{
+	static const uint8_t dlc_len[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64 };
+
+	return dlc_len[dlc & 0x0F];
+}
+
+/**
+ * @brief 数据长度转换为 CAN FD 数据长度码 不是有效长度时向上取整, 发送时需要填充到对应长度
+ * 
+ * @param len 数据长度 0~64
+ * @return uint8_t 数据长度码
+ */
+static inline uint8_t can_fd_len2dlc(uint8_t len)
+{
+	static const uint8_t len_dlc[10] = { 9, 10, 11, 12, 13, 13, 14, 14, 14, 14 }; /* 9~48字节 每4字节一档 */
+
+	if (len <= CAN_MAX_DLEN)
+		return len;
+	if (len <= 48)
+		return len_dlc[(len - 9) >> 2];
+	return 15;
+}
+
 #endif /* __VIRTUAL_OS_CAN_BUS_H__ */
\ No newline at end of file
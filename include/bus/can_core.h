@@ -0,0 +1,186 @@
+/**
+ * @file can_core.h
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief CAN接收分发组件
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#ifndef __VIRTUAL_OS_CAN_CORE_H__
+#define __VIRTUAL_OS_CAN_CORE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "bus/can_bus.h"
+#include "utils/evt_queue.h"
+
+/* 接收处理表中允许的不同掩码数量 同一掩码的处理函数按ID排序后二分查找 */
+#define CAN_CORE_MAX_MASKS (4)
+
+/**
+ * @brief CAN接收分发
+ * 
+ * 驱动在接收中断中调用`can_core_rx_isr`把帧写入接收环形缓冲, 事件任务取出后按ID查找处理函数
+ * 
+ * 处理函数按掩码分组, 帧ID满足 (can_id & mask) == (id & mask) 时匹配, 组内按ID排序二分查找,
+ * 查找代价为 O(掩码数 * log(处理函数数)), 与处理函数数量基本无关
+ * 掩码位数多(更精确)的组优先匹配, 每帧只调用第一个匹配的处理函数
+ * 
+ * 掩码作用于整个`canid_t`, 需要区分标准帧/扩展帧或远程帧时在掩码中加上`CAN_EXT_FLAG`/`CAN_RTR_FLAG`
+ * 
+ * 通过`can_core_init_fd`初始化时接收缓冲存放`struct canfd_frame`, 经典CAN帧和CAN FD帧可以混合接收:
+ * 表项设置了`fd_handler`时收到的帧都以CAN FD格式交给它, 只设置`handler`时只接收经典CAN帧
+ */
+
+typedef void (*can_rx_handler)(const struct can_frame *frame, void *arg);	   /* 接收处理函数 在调度器上下文中调用 */
+typedef void (*can_rxfd_handler)(const struct canfd_frame *frame, void *arg); /* CAN FD接收处理函数 */
+
+// 接收处理函数表项
+struct can_handler {
+	canid_t id;					 /* 帧ID 包含帧类型标志 */
+	canid_t mask;				 /* 掩码 为1的位参与匹配 */
+	can_rx_handler handler;		 /* 处理函数 */
+	void *arg;					 /* 用户参数 */
+	can_rxfd_handler fd_handler; /* CAN FD处理函数 可为NULL 设置后优先于 handler */
+};
+
+// 硬件过滤器 掩码模式 格式与`canid_t`相同, 由驱动转换为控制器的寄存器格式
+struct can_hw_filter {
+	canid_t id;	  /* 过滤ID */
+	canid_t mask; /* 过滤掩码 */
+};
+
+// CAN接收分发实例 由用户分配
+struct can_core {
+	struct evt_queue rxq;						/* 接收环形缓冲 */
+	bool fd;									/* 接收缓冲存放 struct canfd_frame */
+	struct can_handler *handlers;				/* 已排序的处理函数表 */
+	size_t num;									/* 处理函数数量 */
+	size_t groups;								/* 掩码分组数 */
+	size_t group_start[CAN_CORE_MAX_MASKS + 1]; /* 每个分组在表中的起始下标 */
+	can_rx_handler unmatched;					/* 没有匹配处理函数时调用 可为NULL */
+	can_rxfd_handler unmatched_fd;				/* 没有匹配处理函数时调用 可为NULL 设置后优先于 unmatched */
+	void *unmatched_arg;						/* 用户参数 */
+	uint32_t unmatched_cnt;						/* 没有匹配处理函数的帧数 */
+};
+
+/**
+ * @brief 初始化CAN接收分发 需要在`stimer_init`之后调用
+ * 
+ * @param core 实例
+ * @param rx_buf 接收环形缓冲
+ * @param rx_frames 接收环形缓冲可存放的帧数
+ * @param handlers 处理函数表 初始化时会被原地排序, 之后必须保持有效且不能修改
+ * @param num 处理函数数量
+ * @return bool 成功返回true，参数无效,掩码种类超过`CAN_CORE_MAX_MASKS`或存在重复项时返回false
+ */
+bool can_core_init(
+	struct can_core *core, struct can_frame *rx_buf, size_t rx_frames, struct can_handler *handlers, size_t num);
+
+/**
+ * @brief 初始化支持CAN FD的接收分发 需要在`stimer_init`之后调用
+ * 
+ * @param core 实例
+ * @param rx_buf 接收环形缓冲
+ * @param rx_frames 接收环形缓冲可存放的帧数
+ * @param handlers 处理函数表 初始化时会被原地排序, 之后必须保持有效且不能修改
+ * @param num 处理函数数量
+ * @return bool 成功返回true，失败返回false
+ */
+bool can_core_init_fd(
+	struct can_core *core, struct canfd_frame *rx_buf, size_t rx_frames, struct can_handler *handlers, size_t num);
+
+/**
+ * @brief 设置没有匹配处理函数时的回调
+ * 
+ * @param core 实例
+ * @param handler 回调 为NULL时直接丢弃
+ * @param arg 用户参数
+ */
+void can_core_set_unmatched(struct can_core *core, can_rx_handler handler, void *arg);
+
+/**
+ * @brief 设置没有匹配处理函数时的CAN FD回调 经典CAN帧也以CAN FD格式传入
+ * 
+ * @param core 实例
+ * @param handler 回调 为NULL时使用`can_core_set_unmatched`设置的回调
+ * @param arg 用户参数 与`can_core_set_unmatched`共用
+ */
+void can_core_set_unmatched_fd(struct can_core *core, can_rxfd_handler handler, void *arg);
+
+/**
+ * @brief 驱动在接收中断中调用 写入接收环形缓冲并触发分发
+ * 
+ * @param core 实例
+ * @param frame 接收到的帧
+ * @return bool 成功返回true，缓冲已满返回false
+ */
+bool can_core_rx_isr(struct can_core *core, const struct can_frame *frame);
+
+/**
+ * @brief CAN FD驱动在接收中断中调用 写入接收环形缓冲并触发分发
+ * 
+ * 实例由`can_core_init`初始化时只接收经典CAN帧(flags不含CANFD_FDF), 其余帧返回false
+ * 
+ * @param core 实例
+ * @param frame 接收到的帧
+ * @return bool 成功返回true，缓冲已满或帧类型不支持返回false
+ */
+bool can_core_rx_fd_isr(struct can_core *core, const struct canfd_frame *frame);
+
+/**
+ * @brief 查找ID对应的处理函数表项
+ * 
+ * @param core 实例
+ * @param can_id 帧ID
+ * @return const struct can_handler* 未找到返回NULL
+ */
+const struct can_handler *can_core_lookup(const struct can_core *core, canid_t can_id);
+
+/**
+ * @brief 计算覆盖所有处理函数的硬件过滤器 用于配置控制器过滤器 使无关帧不进入中断
+ * 
+ * 处理函数数量超过过滤器数量时, 合并掩码最接近的表项, 合并后的过滤器范围更宽, 多出的帧由软件分发丢弃
+ * 
+ * @param core 实例
+ * @param out 输出过滤器
+ * @param max 控制器可用的过滤器数量
+ * @return size_t 实际需要的过滤器数量
+ */
+size_t can_core_hw_filters(const struct can_core *core, struct can_hw_filter *out, size_t max);
+
+/**
+ * @brief 获取并清零因接收缓冲已满丢弃的帧数
+ * 
+ * @param core 实例
+ * @return uint32_t 丢弃的帧数
+ */
+uint32_t can_core_take_drops(struct can_core *core);
+
+#endif /* __VIRTUAL_OS_CAN_CORE_H__ */
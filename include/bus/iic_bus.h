@@ -36,8 +36,9 @@
 #include "stddef.h"
 #include <stdint.h>
 
-#define I2C_FLAG_WRITE (0x00) // 写标志
-#define I2C_FLAG_READ (0x01)  // 读标志
+#define I2C_FLAG_WRITE (0x00)   // 写标志
+#define I2C_FLAG_READ (0x01)    // 读标志
+#define I2C_FLAG_NOSTART (0x02) // 紧接上一条消息传输 不发送重复起始条件和地址 方向必须与上一条消息相同
 
 /**
  * @brief IIC消息结构体
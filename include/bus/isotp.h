@@ -0,0 +1,187 @@
+/**
+ * @file isotp.h
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief ISO-TP(ISO 15765-2)传输层
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#ifndef __VIRTUAL_OS_ISOTP_H__
+#define __VIRTUAL_OS_ISOTP_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "bus/can_bus.h"
+#include "utils/stimer.h"
+
+#define ISOTP_TIMEOUT_MS (1000) /* 等待流控帧(N_Bs)和连续帧(N_Cr)的超时时间 */
+#define ISOTP_MAX_WFT (8)		/* 连续收到等待流控帧的最大次数 超过后放弃发送 */
+#define ISOTP_BURST_FRAMES (16) /* STmin为0时单次调度最多连续发送的帧数 避免长时间占用调度器 */
+#define ISOTP_PAD_BYTE (0xCC)	/* 填充字节 */
+#define ISOTP_RETRY_MS (1)		/* 发送接口忙时的重试间隔 */
+
+#define ISOTP_ERR_NONE (0)		  /* 无错误 */
+#define ISOTP_ERR_TIMEOUT (-1)	  /* 等待流控帧或连续帧超时 */
+#define ISOTP_ERR_WRONG_SN (-2)	  /* 连续帧序号错误 */
+#define ISOTP_ERR_OVERFLOW (-3)	  /* 接收缓冲区不足 或对端报告溢出 */
+#define ISOTP_ERR_UNEXPECTED (-4) /* 意外的帧 或等待流控次数超限 */
+#define ISOTP_ERR_BUSY (-5)		  /* 上一次传输还未完成 */
+#define ISOTP_ERR_INVALID (-6)	  /* 无效参数 */
+
+/**
+ * @brief ISO-TP 传输层 单帧/首帧/连续帧/流控帧, 支持块大小(BS)和最小间隔(STmin)配置
+ * 
+ * 收发都是零拷贝: 发送时直接从调用方缓冲区分段, 接收时连续帧的数据直接写入调用方提供的接收缓冲区
+ * 
+ * 接收帧通过`isotp_on_frame`送入, 它的函数类型与`can_rx_handler`相同, 可以直接注册到`can_core`的处理函数表中:
+ * { rx_id, CAN_EXT_FLAG | CAN_RTR_FLAG | CAN_EXTENDED_ID_MASK, isotp_on_frame, &link }
+ * 
+ * 所有接口和回调都在调度器上下文中执行, 只有`isotp_tx_ready`可以在中断中调用
+ */
+
+struct isotp_link;
+
+/**
+ * @brief 发送一个CAN帧
+ * 
+ * @param frame CAN帧
+ * @param arg 用户参数
+ * @return bool 成功写入发送邮箱/队列返回true，忙返回false(稍后重试)
+ */
+typedef bool (*isotp_send_f)(const struct can_frame *frame, void *arg);
+
+/**
+ * @brief 传输结束回调
+ * 
+ * @param link 连接
+ * @param err 错误码 参考`ISOTP_ERR_*`
+ * @param len 发送时为已发送的字节数, 接收时为报文长度 数据位于接收缓冲区起始处
+ */
+typedef void (*isotp_done_f)(struct isotp_link *link, int err, size_t len);
+
+// 连接配置
+struct isotp_config {
+	canid_t tx_id;		  /* 发送帧ID */
+	canid_t rx_id;		  /* 接收帧ID */
+	isotp_send_f send;	  /* 发送接口 */
+	void *send_arg;		  /* 发送接口参数 */
+	uint8_t bs;			  /* 接收时告知对端的块大小 0:不限制 */
+	uint8_t stmin;		  /* 接收时告知对端的最小帧间隔 按ISO 15765-2编码 */
+	bool pad;			  /* 是否把帧填充到8字节 */
+	isotp_done_f tx_done; /* 发送结束回调 可为NULL */
+	isotp_done_f rx_done; /* 接收结束回调 可为NULL */
+	void *arg;			  /* 用户参数 */
+};
+
+// 连接 由用户分配
+struct isotp_link {
+	struct isotp_config cfg; /* 配置 */
+
+	/* 以下为内部使用 */
+	const uint8_t *tx_buf;		  /* 发送缓冲区 */
+	size_t tx_len;				  /* 发送总长度 */
+	size_t tx_pos;				  /* 已发送长度 */
+	uint8_t tx_state;			  /* 发送状态 */
+	uint8_t tx_sn;				  /* 下一个连续帧序号 */
+	uint8_t tx_bs;				  /* 对端块大小 */
+	uint8_t tx_bs_cnt;			  /* 当前块已发送的连续帧数 */
+	uint32_t tx_stmin_ms;		  /* 对端最小帧间隔 */
+	uint8_t tx_wft;				  /* 连续收到的等待流控数 */
+	bool tx_blocked;			  /* 发送接口忙 正在等待重试 */
+	stimer_timer_handle tx_timer; /* 帧间隔/流控超时/重试定时器 */
+	stimer_event_handle tx_evt;	  /* 继续发送事件 */
+
+	uint8_t *rx_buf;			  /* 接收缓冲区 */
+	size_t rx_size;				  /* 接收缓冲区大小 */
+	size_t rx_len;				  /* 报文长度 */
+	size_t rx_pos;				  /* 已接收长度 */
+	uint8_t rx_state;			  /* 接收状态 */
+	uint8_t rx_sn;				  /* 期望的连续帧序号 */
+	uint8_t rx_bs_cnt;			  /* 当前块已接收的连续帧数 */
+	int8_t fc_pending;			  /* 待发送的流控状态 -1:无 */
+	stimer_timer_handle rx_timer; /* 连续帧超时定时器 */
+};
+
+/**
+ * @brief 初始化连接 需要在`stimer_init`之后调用
+ * 
+ * @param link 连接
+ * @param cfg 配置
+ * @return int 错误码 参考`ISOTP_ERR_*`
+ */
+int isotp_init(struct isotp_link *link, const struct isotp_config *cfg);
+
+/**
+ * @brief 设置接收缓冲区 超过缓冲区大小的报文会回复溢出流控帧
+ * 
+ * 缓冲区在接收期间被直接写入, 接收完成回调返回后可能被下一个报文覆盖,
+ * 需要保留数据时在回调中处理完毕, 或在回调中切换到另一个缓冲区
+ * 
+ * @param link 连接
+ * @param buf 接收缓冲区
+ * @param size 接收缓冲区大小
+ */
+void isotp_set_rx_buffer(struct isotp_link *link, void *buf, size_t size);
+
+/**
+ * @brief 发送报文 立即返回, 结束时调用`tx_done`
+ * 
+ * @param link 连接
+ * @param data 数据 发送结束前必须保持有效
+ * @param len 数据长度
+ * @return int 错误码 参考`ISOTP_ERR_*`
+ */
+int isotp_send(struct isotp_link *link, const void *data, size_t len);
+
+/**
+ * @brief 送入接收到的帧 帧ID不是`rx_id`时忽略
+ * 
+ * @param frame CAN帧
+ * @param arg 连接(struct isotp_link *)
+ */
+void isotp_on_frame(const struct can_frame *frame, void *arg);
+
+/**
+ * @brief 驱动发送邮箱空闲时调用 立即继续被挂起的发送 可在中断中调用
+ * 
+ * 不调用时发送接口忙的情况会在`ISOTP_RETRY_MS`后重试
+ * 
+ * @param link 连接
+ */
+void isotp_tx_ready(struct isotp_link *link);
+
+/**
+ * @brief 是否正在发送
+ * 
+ * @param link 连接
+ * @return bool 
+ */
+bool isotp_tx_busy(const struct isotp_link *link);
+
+#endif /* __VIRTUAL_OS_ISOTP_H__ */
@@ -36,7 +36,8 @@
 #include <stddef.h>
 
 /**
- * @brief 内存对齐分配
+ * @brief 内存对齐分配 通过`virtual_os_malloc`申请 需要额外 align - 1 + sizeof(void *) 字节
+ * 使能BGET时建议使用`virtual_os_aligned_malloc`
  * 
  * @param size 申请大小
  * @param align 对齐大小
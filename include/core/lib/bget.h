@@ -16,6 +16,7 @@ typedef long bufsize;
 void	bpool	    _((void *buffer, bufsize len));
 void   *bget	    _((bufsize size));
 void   *bgetz	    _((bufsize size));
+void   *bgeta	    _((bufsize size, bufsize align));
 void   *bgetr	    _((void *buffer, bufsize newsize));
 void	brel	    _((void *buf));
 void	bectl	    _((int (*compact)(bufsize sizereq, int sequence),
@@ -23,6 +24,7 @@ void	bectl	    _((int (*compact)(bufsize sizereq, int sequence),
 		       void (*release)(void *buf), bufsize pool_incr));
 void	bstats	    _((bufsize *curalloc, bufsize *totfree, bufsize *maxfree,
 		       long *nget, long *nrel));
+bufsize bpeakalloc  _((void));
 void	bstatse     _((bufsize *pool_incr, long *npool, long *npget,
 		       long *nprel, long *ndget, long *ndrel));
 void	bufdump     _((void *buf));
@@ -45,6 +45,11 @@
 #define VIRTUALOS_MAX_DEV_NUM (10)		/* 最大设备数量 同时用于驱动数量以及文件描述符的数量 */
 #define VIRTUALOS_MAX_DEV_NAME_LEN (16) /* 最大设备名长度(包括\0) */
 
+// 静态驱动表 1:使能 0:禁止
+// 使能后`EXPORT_STATIC_DRIVER`导出的驱动在编译期生成设备描述, 链接到`.static_driver`段并按设备名排序
+// 启动时不再申请内存和插入哈希表, 打开设备时在Flash中的有序表上二分查找 需要链接`core/virtual_os.ld`
+#define VIRTUALOS_STATIC_DRIVER (0)
+
 // Shell使能配置
 // 注: 如果框架使用静态库编译则不建议使用此功能，因为Shell与具体的芯片平台串口有强依赖关系，不适用于静态库链接
 // 使用静态库链接时，用户可以通过在应用层单独使用`utils/simple_shell`组件，使用应用层的接口进行注册
@@ -55,4 +60,20 @@
 // BGET组件内存分配等功能高于标准库的malloc
 #define VIRTUALOS_ENABLE_BGET (1) /* 使能动态内存分配功能 1:使能 0:禁止 */
 
+// 定长内存池 1:使能 0:禁止 需要使能BGET
+// 不超过某一档块大小的申请从该档内存池中分配, 申请和释放均为O(1), 该档用完或超过最大档时由BGET分配
+// 各档内存池在`virtual_os_mm_init`时一次性从BGET中申请
+#define VIRTUALOS_MM_POOL_ENABLE (0)
+#define VIRTUALOS_MM_POOL_SIZES { 16, 32, 64 } /* 每档的块大小(字节) 从小到大排列 */
+#define VIRTUALOS_MM_POOL_COUNTS { 32, 16, 8 } /* 每档的块个数 与块大小一一对应 */
+
+// 内存分配追踪 1:使能 0:禁止 需要使能BGET
+// 使能后记录每块未释放内存的申请位置(文件和行号), 通过`virtual_os_mm_trace_get`或`mem trace`命令查看, 用于排查内存泄漏
+#define VIRTUALOS_MM_TRACE_ENABLE (0)
+#define VIRTUALOS_MM_TRACE_MAX (64) /* 最多同时记录的内存块个数 */
+
+// 临界区 1:由移植层实现`virtual_os_enter_critical`/`virtual_os_exit_critical` 0:使用默认实现
+// 默认实现在Cortex-M上读写PRIMASK(ARMv6-M同样可用), 其他平台(例如主机构建)没有中断, 只作为编译器屏障
+#define VIRTUALOS_PORT_CRITICAL (0)
+
 #endif /* __VIRTUAL_OS_CONFIG_H__ */
\ No newline at end of file
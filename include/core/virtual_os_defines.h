@@ -33,6 +33,10 @@
 #ifndef __VIRTUAL_OS_DEFINES_H__
 #define __VIRTUAL_OS_DEFINES_H__
 
+#include <stdint.h>
+
+#include "core/virtual_os_config.h"
+
 /**
  * @brief 断言
  * 
@@ -65,4 +69,43 @@
  */
 #define fallthrough __attribute__((__fallthrough__))
 
+/**
+ * @brief 临界区 进入时关中断并返回进入前的中断状态, 退出时恢复该状态, 可以嵌套
+ * 
+ * 只用于保护几条指令的共享数据更新, 临界区内不要调用耗时的函数
+ * 
+ * uint32_t state = virtual_os_enter_critical();
+ * ... 
+ * virtual_os_exit_critical(state);
+ */
+#if VIRTUALOS_PORT_CRITICAL
+uint32_t virtual_os_enter_critical(void);
+void virtual_os_exit_critical(uint32_t state);
+#elif defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M')
+static inline uint32_t virtual_os_enter_critical(void)
+{
+	uint32_t primask;
+
+	__asm volatile("mrs %0, primask\n\tcpsid i" : "=r"(primask) : : "memory");
+	return primask;
+}
+
+static inline void virtual_os_exit_critical(uint32_t state)
+{
+	__asm volatile("msr primask, %0" : : "r"(state) : "memory");
+}
+#else
+static inline uint32_t virtual_os_enter_critical(void)
+{
+	__asm volatile("" : : : "memory");
+	return 0;
+}
+
+static inline void virtual_os_exit_critical(uint32_t state)
+{
+	(void)state;
+	__asm volatile("" : : : "memory");
+}
+#endif
+
 #endif /* __VIRTUAL_OS_DEFINES_H__ */
\ No newline at end of file
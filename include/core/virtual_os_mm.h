@@ -35,6 +35,9 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+
+#include "core/virtual_os_config.h"
 
 /**
  * @brief 此接口为VirtualOS的内存管理接口，使用BGET组件
@@ -55,6 +58,38 @@
  */
 bool virtual_os_mm_init(size_t pool_size);
 
+/**
+ * @brief 使用调用者提供的空间初始化内存管理 不调用malloc
+ * 与`virtual_os_mm_init`二选一, 可以配合`VIRTUALOS_HEAP_DEFINE`将堆放到指定的RAM中
+ * 
+ * @param buf 空间起始地址
+ * @param size 空间大小
+ * @return true 成功
+ * @return false 失败 未使能`VIRTUALOS_ENABLE_BGET`时总是失败
+ */
+bool virtual_os_mm_init_static(void *buf, size_t size);
+
+/**
+ * @brief 追加一段不连续的空间 在初始化之后调用 可多次调用
+ * 
+ * @param buf 空间起始地址
+ * @param size 空间大小
+ * @return true 成功
+ * @return false 失败 未使能`VIRTUALOS_ENABLE_BGET`时总是失败
+ */
+bool virtual_os_mm_add_region(void *buf, size_t size);
+
+/**
+ * @brief 定义一段堆空间 链接到`.virtual_os_heap`段, 使用`core/virtual_os.ld`时该段启动时不清零
+ * 修改链接脚本中该段的输出区域即可将堆放到CCM/TCM等RAM中
+ * 
+ * @param name 变量名
+ * @param size 空间大小(字节)
+ */
+#define VIRTUALOS_HEAP_DEFINE(name, size)                                                                              \
+	static uint64_t name[((size) + sizeof(uint64_t) - 1) / sizeof(uint64_t)]                                         \
+		__attribute__((section(".virtual_os_heap"), used))
+
 /**
  * @brief 申请内存
  * 
@@ -88,4 +123,101 @@ void *virtual_os_realloc(void *old_ptr, size_t size);
  */
 void virtual_os_free(void *ptr);
 
+/**
+ * @brief 申请对齐的内存 例如DMA缓冲区 与其他内存共用同一个内存池
+ * 使能BGET时直接在空闲块中切出对齐的块, 最多浪费一个块头的空间
+ * 
+ * @param size 内存大小 向上取整到对齐大小, 避免与其他内存共用缓存行
+ * @param align 对齐大小 必须是2的幂
+ * @return void* 失败返回NULL
+ */
+void *virtual_os_aligned_malloc(size_t size, size_t align);
+
+/**
+ * @brief 释放通过`virtual_os_aligned_malloc`申请的内存
+ * 
+ * @param ptr 内存地址
+ */
+void virtual_os_aligned_free(void *ptr);
+
+// 堆统计信息 单位为字节 已分配的空间包含BGET的块头和整个定长内存池
+struct virtual_os_mm_stats {
+	size_t total;	 /* 交给BGET管理的空间大小 所有空间之和 */
+	size_t used;	 /* 已分配 */
+	size_t peak;	 /* 已分配的峰值 */
+	size_t free;	 /* 空闲 */
+	size_t max_free; /* 最大的连续空闲块 */
+	uint8_t frag;	 /* 碎片率(百分比) 空闲空间中不属于最大空闲块的比例 */
+	uint32_t allocs; /* 累计分配次数 */
+	uint32_t frees;	 /* 累计释放次数 */
+	uint32_t failed; /* 分配失败次数 */
+};
+
+/**
+ * @brief 获取堆统计信息 需要遍历BGET的空闲链表
+ * 
+ * @param stats 统计信息
+ * @return bool 未使能`VIRTUALOS_ENABLE_BGET`时返回false
+ */
+bool virtual_os_mm_get_stats(struct virtual_os_mm_stats *stats);
+
+// 单档内存池的统计信息
+struct virtual_os_pool_stats {
+	size_t block_size; /* 块大小 */
+	uint16_t total;	   /* 块个数 */
+	uint16_t used;	   /* 正在使用的块个数 */
+	uint16_t peak;	   /* 同时使用的最大块个数 */
+	uint32_t allocs;   /* 累计分配次数 */
+	uint32_t fallback; /* 该档用完后由BGET分配的次数 */
+};
+
+/**
+ * @brief 获取内存池的档数 未使能`VIRTUALOS_MM_POOL_ENABLE`时返回0
+ * 
+ * @return size_t 
+ */
+size_t virtual_os_pool_count(void);
+
+/**
+ * @brief 获取某一档内存池的统计信息
+ * 
+ * @param idx 档位索引 从0开始
+ * @param stats 统计信息
+ * @return bool 档位不存在返回false
+ */
+bool virtual_os_pool_get_stats(size_t idx, struct virtual_os_pool_stats *stats);
+
+#if VIRTUALOS_ENABLE_BGET && VIRTUALOS_MM_TRACE_ENABLE
+
+// 未释放的内存块
+struct virtual_os_mm_trace {
+	void *ptr;		  /* 内存地址 */
+	size_t size;	  /* 申请的大小 */
+	const char *file; /* 调用位置所在的文件 未通过宏调用时为NULL */
+	int line;		  /* 调用位置所在的行号 */
+};
+
+void *virtual_os_malloc_at(size_t size, const char *file, int line);
+void *virtual_os_calloc_at(size_t num, size_t per_size, const char *file, int line);
+void *virtual_os_realloc_at(void *old_ptr, size_t size, const char *file, int line);
+void *virtual_os_aligned_malloc_at(size_t size, size_t align, const char *file, int line);
+
+/**
+ * @brief 获取未释放的内存块及其调用位置
+ * 
+ * @param buf 输出缓冲区
+ * @param cnt 缓冲区能容纳的记录个数
+ * @param lost 记录表已满未能记录的次数 可为NULL
+ * @return size_t 实际输出的记录个数
+ */
+size_t virtual_os_mm_trace_get(struct virtual_os_mm_trace *buf, size_t cnt, uint32_t *lost);
+
+// 记录调用位置
+#define virtual_os_malloc(size) virtual_os_malloc_at(size, __FILE__, __LINE__)
+#define virtual_os_calloc(num, per_size) virtual_os_calloc_at(num, per_size, __FILE__, __LINE__)
+#define virtual_os_realloc(old_ptr, size) virtual_os_realloc_at(old_ptr, size, __FILE__, __LINE__)
+#define virtual_os_aligned_malloc(size, align) virtual_os_aligned_malloc_at(size, align, __FILE__, __LINE__)
+
+#endif /* VIRTUALOS_ENABLE_BGET && VIRTUALOS_MM_TRACE_ENABLE */
+
 #endif /* __VIRTUAL_OS_MM_H */
\ No newline at end of file
@@ -48,6 +48,16 @@
  */
 void virtual_os_init(struct timer_port *port, size_t poll_size);
 
+/**
+ * @brief 框架调度初始化 使用调用者提供的空间作为内存池, 不调用malloc
+ * 可以在之后通过`virtual_os_mm_add_region`追加不连续的空间
+ * 
+ * @param port 时钟配置 详细参考`utils/stimer.h`
+ * @param heap 内存池起始地址 例如`VIRTUALOS_HEAP_DEFINE`定义的数组
+ * @param heap_size 内存池大小
+ */
+void virtual_os_init_static(struct timer_port *port, void *heap, size_t heap_size);
+
 #else
 
 /**
@@ -35,6 +35,8 @@
 
 #include <stddef.h>
 
+#include "driver/virtual_os_driver.h"
+
 #define RESERVED_FDS (3) /* 前三个文件描述符为内部保留值 */
 
 #define DAL_ERR_NONE (0)		 /* 无错误 */
@@ -62,7 +64,7 @@ int dal_open(const char *file_name);
 int dal_close(int fd);
 
 /**
- * @brief 从文件读取数据，读取成功后将增加文件偏移量
+ * @brief 从文件读取数据，读取成功后将增加文件偏移量 每个文件描述符的偏移量相互独立
  * 
  * @param fd 文件描述符
  * @param buf 读缓冲区
@@ -81,6 +83,28 @@ size_t dal_read(int fd, void *buf, size_t len);
  */
 size_t dal_write(int fd, void *buf, size_t len);
 
+/**
+ * @brief 从指定偏移读取数据，不使用也不修改文件偏移量
+ * 
+ * @param fd 文件描述符
+ * @param buf 读缓冲区
+ * @param len 大小
+ * @param offset 读取的起始偏移
+ * @return size_t 返回实际读取字节数
+ */
+size_t dal_pread(int fd, void *buf, size_t len, size_t offset);
+
+/**
+ * @brief 向指定偏移写入数据，不使用也不修改文件偏移量
+ * 
+ * @param fd 文件描述符
+ * @param buf 写缓冲区
+ * @param len 大小
+ * @param offset 写入的起始偏移
+ * @return size_t 返回实际写入字节数
+ */
+size_t dal_pwrite(int fd, void *buf, size_t len, size_t offset);
+
 /**
  * @brief 设备控制指令，除设备读写以外的操作，cmd参考对应驱动定义
  * 
@@ -91,6 +115,26 @@ size_t dal_write(int fd, void *buf, size_t len);
  */
 int dal_ioctl(int fd, int cmd, void *arg);
 
+/**
+ * @brief 分散读取 依次读入多个数据段，读取成功后将增加文件偏移量
+ * 
+ * @param fd 文件描述符
+ * @param iov 数据段数组
+ * @param iovcnt 数据段个数
+ * @return size_t 返回实际读取的总字节数
+ */
+size_t dal_readv(int fd, const struct drv_iovec *iov, size_t iovcnt);
+
+/**
+ * @brief 聚集写入 依次写入多个数据段，例如帧头+数据+校验，写入成功后将增加文件偏移量
+ * 
+ * @param fd 文件描述符
+ * @param iov 数据段数组
+ * @param iovcnt 数据段个数
+ * @return size_t 返回实际写入的总字节数
+ */
+size_t dal_writev(int fd, const struct drv_iovec *iov, size_t iovcnt);
+
 enum dal_lseek_whence {
 	DAL_LSEEK_WHENCE_HEAD, /* 指向文件头部 */
 	DAL_LSEEK_WHENCE_SET,  /* 指向当前位置 */
@@ -107,4 +151,90 @@ enum dal_lseek_whence {
  */
 int dal_lseek(int fd, int offset, enum dal_lseek_whence whence);
 
+/**
+ * @brief 异步读取 从当前文件偏移开始读取`req->len`字节, 提交成功后文件偏移立即增加请求长度
+ * 
+ * 传输完成后`req->status`变为 DRV_ASYNC_DONE 或 DRV_ASYNC_ERROR, 并调用`req->done`(可能在中断中)
+ * 驱动未实现异步接口时在本函数内同步完成
+ * 
+ * @param fd 文件描述符
+ * @param req 异步传输请求 传输完成前必须保持有效
+ * @return int 参考错误码 请求正在传输中返回 DAL_ERR_OCCUPIED
+ */
+int dal_read_async(int fd, struct drv_async *req);
+
+/**
+ * @brief 异步写入 从当前文件偏移开始写入`req->len`字节, 提交成功后文件偏移立即增加请求长度
+ * 
+ * 传输完成后`req->status`变为 DRV_ASYNC_DONE 或 DRV_ASYNC_ERROR, 并调用`req->done`(可能在中断中)
+ * 驱动未实现异步接口时在本函数内同步完成
+ * 
+ * @param fd 文件描述符
+ * @param req 异步传输请求 传输完成前必须保持有效
+ * @return int 参考错误码 请求正在传输中返回 DAL_ERR_OCCUPIED
+ */
+int dal_write_async(int fd, struct drv_async *req);
+
+/**
+ * @brief 已校验的设备句柄 用于高频读写, 跳过文件描述符检查和接口判空
+ * 
+ * 通过`dal_get_handle`获取, 与文件描述符共享文件偏移, 文件描述符关闭后句柄失效
+ */
+struct dal_handle {
+	struct drv_file *file;											/* 驱动文件 */
+	size_t (*f_read)(struct drv_file *, void *, size_t, size_t *);	/* 读接口 驱动未实现时为空操作 */
+	size_t (*f_write)(struct drv_file *, void *, size_t, size_t *); /* 写接口 驱动未实现时为空操作 */
+	size_t *offset;													/* 文件偏移 */
+	size_t dev_size;												/* 设备大小 0表示不限制 */
+};
+
+/**
+ * @brief 获取已校验的设备句柄
+ * 
+ * @param fd 文件描述符
+ * @param handle 句柄 由调用方分配
+ * @return int 参考错误码
+ */
+int dal_get_handle(int fd, struct dal_handle *handle);
+
+// 根据设备大小限制传输长度
+static inline size_t dal_handle_clamp(const struct dal_handle *handle, size_t len)
+{
+	size_t offset = *handle->offset;
+
+	if (!handle->dev_size)
+		return len;
+
+	if (offset >= handle->dev_size)
+		return 0;
+
+	return ((handle->dev_size - offset) < len) ? (handle->dev_size - offset) : len;
+}
+
+/**
+ * @brief 通过句柄读取数据 行为与`dal_read`相同
+ * 
+ * @param handle 设备句柄
+ * @param buf 读缓冲区
+ * @param len 大小
+ * @return size_t 返回实际读取字节数
+ */
+static inline size_t dal_handle_read(const struct dal_handle *handle, void *buf, size_t len)
+{
+	return handle->f_read(handle->file, buf, dal_handle_clamp(handle, len), handle->offset);
+}
+
+/**
+ * @brief 通过句柄写入数据 行为与`dal_write`相同
+ * 
+ * @param handle 设备句柄
+ * @param buf 写缓冲区
+ * @param len 大小
+ * @return size_t 返回实际写入字节数
+ */
+static inline size_t dal_handle_write(const struct dal_handle *handle, void *buf, size_t len)
+{
+	return handle->f_write(handle->file, buf, dal_handle_clamp(handle, len), handle->offset);
+}
+
 #endif /* __VIRTUAL_OS_DAL_OPT_H__ */
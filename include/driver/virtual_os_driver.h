@@ -37,6 +37,8 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include "core/virtual_os_config.h"
+
 #define DRV_ERR_NONE (0)		 /* 无错误 */
 #define DRV_ERR_INVALID (-1)	 /* 无效参数 */
 #define DRV_ERR_OVERFLOW (-2)	 /* 超过最大设备数量 */
@@ -66,11 +68,47 @@ struct drv_file {
 	void *private;						/* 私有数据 */
 };
 
+// 异步传输状态
+enum drv_async_status {
+	DRV_ASYNC_IDLE = 0, /* 空闲 */
+	DRV_ASYNC_PENDING,	/* 传输中 */
+	DRV_ASYNC_DONE,		/* 传输完成 */
+	DRV_ASYNC_ERROR,	/* 传输出错 */
+};
+
+struct drv_async;
+typedef void (*drv_async_cb)(struct drv_async *req); /* 异步传输完成回调 可能在中断中调用 */
+
+// 异步传输请求 由调用方分配, 传输完成前必须保持有效
+struct drv_async {
+	void *buf;				/* 数据缓冲区 */
+	size_t len;				/* 请求长度 提交时会被限制在设备剩余大小内 */
+	size_t offset;			/* 传输起始偏移 提交时由框架填写 */
+	drv_async_cb done;		/* 完成回调 可为NULL, 此时轮询 status */
+	void *arg;				/* 用户参数 */
+	volatile int status;	/* 传输状态 参考`enum drv_async_status` */
+	volatile size_t actual; /* 实际传输的字节数 */
+};
+
+/**
+ * @brief 驱动在异步传输完成时调用 可在中断中调用
+ * 
+ * @param req 异步传输请求
+ * @param actual 实际传输的字节数
+ * @param err 错误码 DRV_ERR_NONE 表示成功
+ */
+void drv_async_complete(struct drv_async *req, size_t actual, int err);
+
+// 分散/聚集读写的数据段
+struct drv_iovec {
+	void *base; /* 数据段起始地址 */
+	size_t len; /* 数据段长度 */
+};
+
 // 驱动设备
 struct drv_device {
 	struct drv_file *file; // 文件
 	size_t dev_size;	   /* 设备大小 */
-	size_t offset;		   // 文件偏移
 };
 
 /****************************USER API*****************************/
@@ -87,6 +125,16 @@ struct file_operations {
 	int (*ioctl)(struct drv_file *file, int cmd, void *arg); /* 控制命令 返回结果参考错误码 */
 	size_t (*read)(struct drv_file *file, void *buf, size_t len, size_t *offset);  /* 读取数据 */
 	size_t (*write)(struct drv_file *file, void *buf, size_t len, size_t *offset); /* 写入数据 */
+
+	/* 以下为可选接口 启动传输后立即返回, 传输完成时调用`drv_async_complete` 返回结果参考错误码
+	 * 未实现时`dal_read_async`/`dal_write_async`退化为调用 read/write 同步完成 */
+	int (*read_async)(struct drv_file *file, struct drv_async *req);  /* 异步读取 */
+	int (*write_async)(struct drv_file *file, struct drv_async *req); /* 异步写入 */
+
+	/* 以下为可选接口 一次传输多个数据段, 返回实际传输的总字节数
+	 * 未实现时`dal_readv`/`dal_writev`退化为逐段调用 read/write */
+	size_t (*readv)(struct drv_file *file, const struct drv_iovec *iov, size_t iovcnt, size_t *offset);  /* 分散读取 */
+	size_t (*writev)(struct drv_file *file, const struct drv_iovec *iov, size_t iovcnt, size_t *offset); /* 聚集写入 */
 };
 
 /**
@@ -110,17 +158,60 @@ struct file_operations {
  */
 typedef bool (*driver_init)(struct drv_device *dev);
 
+// 静态驱动描述 存放于Flash
+struct drv_static {
+	const char *name;		 /* 设备名称 */
+	struct drv_device *dev;	 /* 设备 */
+	driver_init drv_init;	 /* 驱动初始化 */
+};
+
+/**
+ * @brief 静态驱动导出宏
+ * 
+ * 例如: EXPORT_STATIC_DRIVER("uart1", uart1_driver_init, &uart1_opts);
+ * 设备名必须是字符串常量并且项目中唯一
+ * 
+ * `VIRTUALOS_STATIC_DRIVER`使能时在编译期生成设备, 并将描述链接到按设备名排序的`.static_driver`段
+ * 未使能时等价于通过`EXPORT_DRIVER`在启动时调用`driver_register_static`
+ * 
+ */
+#if VIRTUALOS_STATIC_DRIVER
+#define EXPORT_STATIC_DRIVER(_name, _init, _opts)                                                                      \
+	static struct drv_file _init##_file = { .opts = (_opts) };                                                         \
+	static struct drv_device _init##_dev = { .file = &_init##_file };                                                  \
+	static const struct drv_static _init##_desc                                                                        \
+		__attribute__((section(".static_driver." _name), used, aligned(sizeof(void *)))) = { _name, &_init##_dev, _init };
+#else
+#define EXPORT_STATIC_DRIVER(_name, _init, _opts)                                                                      \
+	EXPORT_DRIVER(_init##_probe)                                                                                       \
+	void _init##_probe(void)                                                                                           \
+	{                                                                                                                  \
+		driver_register_static(_init, _opts, _name);                                                                   \
+	}
+#endif
+
 /**
- * @brief 注册设备
+ * @brief 注册设备 设备名会被拷贝(超过`VIRTUALOS_MAX_DEV_NAME_LEN - 1`时截断), 可以使用栈上或临时拼接的字符串
  * 
  * @param drv_init 驱动初始化
  * @param file_opts 驱动文件操作
  * @param name 设备名称
  * @return true 
- * @return false 
+ * @return false 同名设备已存在或内存不足
  */
 bool driver_register(driver_init drv_init, const struct file_operations *file_opts, const char *name);
 
+/**
+ * @brief 注册设备 不拷贝设备名, 节省一次内存申请
+ * 
+ * @param drv_init 驱动初始化
+ * @param file_opts 驱动文件操作
+ * @param name 设备名称 在设备的整个生命周期内必须有效, 例如字符串常量或静态数组
+ * @return true 
+ * @return false 同名设备已存在或内存不足
+ */
+bool driver_register_static(driver_init drv_init, const struct file_operations *file_opts, const char *name);
+
 /**
  * @brief 遍历所有设备名
  * 
@@ -0,0 +1,62 @@
+/**
+ * @file virtual_os_host.h
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 主机(x86/Linux)平台移植 模拟调度定时器
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#ifndef __VIRTUAL_OS_HOST_H__
+#define __VIRTUAL_OS_HOST_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "utils/stimer.h"
+
+/**
+ * @brief 主机平台模拟调度定时器
+ * 
+ * 以tickless模式工作, 空闲时在`f_sleep`中休眠到下一个到期任务后上报经过的节拍数, 不需要定时器中断
+ * `f_get_cycle`返回单调时钟的纳秒计数
+ * 
+ * virtual_time 为true时使用虚拟时间: 空闲时不休眠, 直接跳到下一个到期任务的节拍, 任务执行本身不消耗节拍
+ * 用于在主机上快速且可重复地运行依赖时间的逻辑
+ * 
+ * @param virtual_time 是否使用虚拟时间
+ * @return struct timer_port* 传给`virtual_os_init`或`stimer_init`
+ */
+struct timer_port *host_timer_port(bool virtual_time);
+
+/**
+ * @brief 获取自调度开始以来经过的节拍数
+ * 
+ * @return uint32_t 节拍数 虚拟时间下为虚拟节拍数
+ */
+uint32_t host_timer_ticks(void);
+
+#endif /* __VIRTUAL_OS_HOST_H__ */
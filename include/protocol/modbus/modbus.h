@@ -33,13 +33,25 @@
 #ifndef __VIRTUAL_OS_MODBUS_H__
 #define __VIRTUAL_OS_MODBUS_H__
 
+// 1:启用 0:不启用
+#define MODBUS_BENCH_ENABLE (0) /* 提供`mb_bench`命令 主从机内存回环性能测试 需要调度定时器提供`f_get_cycle`接口 */
+
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
 
 // 当前支持的功能码
-#define MODBUS_FUN_RD_REG_MUL (0x03) // 读功能码
-#define MODBUS_FUN_WR_REG_MUL (0x10) // 写功能码
+#define MODBUS_FUN_RD_COIL (0x01)	   // 读线圈
+#define MODBUS_FUN_RD_DISC (0x02)	   // 读离散输入
+#define MODBUS_FUN_RD_REG_MUL (0x03)   // 读功能码(保持寄存器)
+#define MODBUS_FUN_RD_INPUT_REG (0x04) // 读输入寄存器
+#define MODBUS_FUN_WR_COIL (0x05)	   // 写单个线圈
+#define MODBUS_FUN_WR_REG (0x06)	   // 写单个寄存器
+#define MODBUS_FUN_WR_COIL_MUL (0x0F)  // 写多个线圈
+#define MODBUS_FUN_WR_REG_MUL (0x10)   // 写功能码(多个寄存器)
+
+#define MODBUS_COIL_ON (0xFF00)	 // 写单个线圈 ON
+#define MODBUS_COIL_OFF (0x0000) // 写单个线圈 OFF
 
 // 错误码
 #define MODBUS_RESP_ERR_NONE (0x00)		// 无错误
@@ -54,16 +66,37 @@
 #define MODBUS_FRAME_BYTES_MAX (256)
 
 // 校验功能码
-#define MODBUS_FUNC_CHECK_VALID(f) (((f) == MODBUS_FUN_RD_REG_MUL) || ((f) == MODBUS_FUN_WR_REG_MUL))
+#define MODBUS_FUNC_CHECK_VALID(f)                                                                                     \
+	((((f) >= MODBUS_FUN_RD_COIL) && ((f) <= MODBUS_FUN_WR_REG)) || ((f) == MODBUS_FUN_WR_COIL_MUL) ||                 \
+		((f) == MODBUS_FUN_WR_REG_MUL))
+
+// 读功能码
+#define MODBUS_FUNC_IS_READ(f) (((f) >= MODBUS_FUN_RD_COIL) && ((f) <= MODBUS_FUN_RD_INPUT_REG))
+
+// 按位访问的功能码(线圈/离散输入)
+#define MODBUS_FUNC_IS_BIT(f)                                                                                          \
+	(((f) == MODBUS_FUN_RD_COIL) || ((f) == MODBUS_FUN_RD_DISC) || ((f) == MODBUS_FUN_WR_COIL) ||                      \
+		((f) == MODBUS_FUN_WR_COIL_MUL))
+
+// 写单个线圈/寄存器的功能码
+#define MODBUS_FUNC_IS_SINGLE(f) (((f) == MODBUS_FUN_WR_COIL) || ((f) == MODBUS_FUN_WR_REG))
 
-#define MAX_READ_REG_NUM (125)	// 最大读寄存器数量
-#define MAX_WRITE_REG_NUM (123) // 最大写寄存器数量
+#define MAX_READ_REG_NUM (125)	  // 最大读寄存器数量
+#define MAX_WRITE_REG_NUM (123)	  // 最大写寄存器数量
+#define MAX_READ_COIL_NUM (2000)  // 最大读线圈/离散输入数量
+#define MAX_WRITE_COIL_NUM (1968) // 最大写线圈数量
 
-// 检查寄存器数量
+// 检查寄存器数量 写单个线圈/寄存器时数量为1
 #define CHECK_REG_NUM_VALID(reg_num, func)                                                                             \
-	(((func) == MODBUS_FUN_RD_REG_MUL)                                                                                 \
-			? ((reg_num) <= MAX_READ_REG_NUM)                                                                          \
-			: (((func) == MODBUS_FUN_WR_REG_MUL) ? ((reg_num) <= MAX_WRITE_REG_NUM) : false))
+	(((func) == MODBUS_FUN_RD_COIL || (func) == MODBUS_FUN_RD_DISC)                                                    \
+			? ((reg_num) <= MAX_READ_COIL_NUM)                                                                         \
+			: ((func) == MODBUS_FUN_RD_REG_MUL || (func) == MODBUS_FUN_RD_INPUT_REG)                                   \
+				? ((reg_num) <= MAX_READ_REG_NUM)                                                                      \
+				: MODBUS_FUNC_IS_SINGLE(func)                                                                          \
+					? ((reg_num) == 1)                                                                                 \
+					: ((func) == MODBUS_FUN_WR_COIL_MUL)                                                               \
+						? ((reg_num) <= MAX_WRITE_COIL_NUM)                                                            \
+						: (((func) == MODBUS_FUN_WR_REG_MUL) ? ((reg_num) <= MAX_WRITE_REG_NUM) : false))
 
 // 校验寄存器范围
 #define MODBUS_CHECK_REG_RANGE(reg, num, from, to, func)                                                               \
@@ -75,6 +108,13 @@
 #define MODBUS_REG_LEN_BYTES_NUM (2) // 寄存器长度字节数
 #define MODBUS_CRC_BYTES_NUM (2)	 // CRC字节数
 
+/* Modbus TCP 使用MBAP报文头替代RTU的地址和CRC: 事务标识(2) 协议标识(2) 长度(2) 单元标识(1)
+ * 长度为单元标识和PDU的字节数, 协议标识固定为0 */
+#define MODBUS_TCP_MBAP_BYTES_NUM (7)	 // MBAP报文头字节数
+#define MODBUS_TCP_PDU_BYTES_MAX (253)	 // PDU最大字节数 功能码+数据
+#define MODBUS_TCP_FRAME_BYTES_MAX (260) // 一帧最大字节数 MBAP报文头+PDU
+#define MODBUS_TCP_UNIT_ANY (0xFF)		 // 单元标识 直连的TCP设备不区分从机地址
+
 #define COMBINE_U8_TO_U16(h, l) ((uint16_t)(h << 8) | (uint16_t)(l))
 #define COMBINE_U16_TO_U32(h, l) ((uint32_t)(h << 16) | (uint32_t)(l))
 #define GET_U8_HIGH_FROM_U16(u) (((u) >> 8) & 0xff)
@@ -123,11 +163,42 @@ typedef size_t (*modbus_serial_read)(uint8_t *p_data, size_t len);
  */
 typedef bool (*modbus_serial_check_over)(void);
 
-// 串口回调
+/**
+ * @brief 按帧读取函数指针 可选
+ * 
+ * 由串口空闲中断(IDLE)或T3.5字符超时确定帧边界, 每次调用取出一帧完整数据
+ * 帧长度超过 len 时只拷贝 len 字节并返回实际帧长度, 协议会直接丢弃该帧
+ *
+ * @param p_data 读入数据指针
+ * @param len 缓冲区长度
+ * @return size_t 帧长度 无完整帧返回0
+ */
+typedef size_t (*modbus_serial_read_frame)(uint8_t *p_data, size_t len);
+
+// T3.5 帧间隔时间(微秒) 波特率大于19200时固定为1750us 每字符按11位计算
+#define MODBUS_T35_US(baud) (((baud) > 19200) ? 1750 : (35 * 11 * 100000UL / (baud)))
+
+/* 串口回调
+ * Modbus TCP 下同样使用此结构体: f_init 建立连接, f_read/f_write 为非阻塞的 socket 收发, 不使用 f_read_frame */
 struct serial_opts {
-	modbus_serial_init f_init;	 // 串口初始化函数指针
-	modbus_serial_write f_write; // 串口写函数指针
-	modbus_serial_read f_read;	 // 串口读函数指针
+	modbus_serial_init f_init;			   // 串口初始化函数指针
+	modbus_serial_write f_write;		   // 串口写函数指针
+	modbus_serial_read f_read;			   // 串口读函数指针
+	modbus_serial_read_frame f_read_frame; // 按帧读取函数指针 可选 设置后按帧间隔分帧 不再使用 f_read
 };
 
+#if MODBUS_BENCH_ENABLE || VIRTUALOS_HOST_BUILD
+/**
+ * @brief 主从机内存回环性能测试 即`mb_bench`命令, 主机构建时不需要启用`MODBUS_BENCH_ENABLE`也可以调用
+ * 需要调度定时器提供`f_get_cycle`接口
+ * 
+ * @param runs 每个用例的事务次数 0为默认次数
+ * @param tcp 是否使用Modbus TCP
+ * @param out 结果表格的输出缓冲区
+ * @param size 输出缓冲区大小
+ * @return size_t 输出长度 未提供`f_get_cycle`接口或初始化失败时返回0
+ */
+size_t mb_bench_run(uint32_t runs, bool tcp, char *out, size_t size);
+#endif
+
 #endif /* __VIRTUAL_OS_MODBUS_H__ */
\ No newline at end of file
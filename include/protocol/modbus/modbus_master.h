@@ -39,6 +39,20 @@
 
 #define MASTER_REPEATS (3) // 重发次数
 
+/* 请求按从机分别排队, 各从机轮流发送, 收到响应或超时后立即发送下一个请求
+ * 请求最终失败后从机进入退避, 退避期间不影响其他从机 */
+#define MB_MST_MAX_SLAVES (8)		 // 同时调度的从机数量
+#define MB_MST_RTO_MIN_MS (20)		 // 失败过的从机超时时间下限 建议不小于两个轮询周期
+#define MB_MST_BACKOFF_BASE_MS (100) // 失败后的初始退避时间 连续失败时每次翻倍
+#define MB_MST_BACKOFF_MAX_MS (5000) // 最大退避时间
+#define MB_MST_OFFLINE_FAILS (3)	 // 连续失败达到此次数后 该从机的待处理请求直接超时
+
+#define MB_MST_TCP_MAX_INFLIGHT (4) // Modbus TCP同时等待响应的请求数量 按事务标识匹配响应
+
+// 1:启用 0:不启用
+#define MB_MST_COALESCE_ENABLE (0) // 合并同一从机队列中相邻的读寄存器请求(03/04)为一次请求
+#define MB_MST_COALESCE_GAP (4)	   // 可合并的两个请求之间最多间隔的寄存器数量 间隔的寄存器会被一并读取
+
 /**
  * @brief 主机接收帧处理
  *
@@ -51,13 +65,13 @@ typedef void (*mb_mst_pdu_resp)(uint8_t *data, size_t len, uint8_t err_code, boo
 
 // 请求报文
 struct mb_mst_request {
-	uint32_t timeout_ms;  // 此报文的超时时间
+	uint32_t timeout_ms;  // 此报文的超时时间 从机连续失败时自适应缩短
 	mb_mst_pdu_resp resp; // 回复处理 不需要处理回复可为空, 如写功能码
 
 	uint8_t slave_addr; // 从机地址
-	uint8_t func;		// 功能玛 读:0x03 写:0x10
+	uint8_t func;		// 功能玛 参考modbus.h中支持的功能码
 	uint16_t reg_addr;	// 寄存器地址
-	uint8_t reg_len;	// 寄存器长度
+	uint16_t reg_len;	// 寄存器(线圈)数量
 };
 
 // 主机句柄
@@ -72,6 +86,18 @@ typedef struct mb_mst *mb_mst_handle;
  */
 mb_mst_handle mb_mst_init(struct serial_opts *opts, size_t period_ms);
 
+/**
+ * @brief Modbus TCP主机初始化并申请句柄
+ *
+ * 与RTU主机共用请求队列和从机调度, 帧格式为MBAP报文头+PDU, 从机地址作为单元标识
+ * 不等待响应连续发送最多`MB_MST_TCP_MAX_INFLIGHT`个请求, 响应按事务标识匹配 读请求合并只用于RTU
+ *
+ * @param opts socket收发等回调函数指针 f_read/f_write 须为非阻塞接口 不使用 f_read_frame
+ * @param period_ms 轮训周期
+ * @return mb_mst_handle 成功返回句柄，失败返回NULL
+ */
+mb_mst_handle mb_mst_tcp_init(struct serial_opts *opts, size_t period_ms);
+
 /**
  * @brief 释放主机句柄
  *
@@ -91,9 +117,13 @@ void mb_mst_poll(mb_mst_handle handle);
  * 
  * @param handle 主机句柄
  * @param request 请求包
+ * 写单个线圈/寄存器时 reg_len 为1, 写线圈时 reg_data[0] 的bit0为线圈状态
+ * 写多个线圈时第i个线圈取自 reg_data[i/16] 的 bit(i%16)
+ * 读线圈/离散输入的响应数据为按位打包的原始字节, 低位在前
+ * 
  * @param reg_data 寄存器数据 仅在request的功能码为写请求时有效
- * @param reg_len 寄存器长度 仅在request的功能码为写请求时有效
+ * @param reg_len 寄存器(线圈)数量 仅在request的功能码为写请求时有效 须与 request->reg_len 相同
  */
-void mb_mst_pdu_request(mb_mst_handle handle, struct mb_mst_request *request, uint16_t *reg_data, uint8_t reg_len);
+void mb_mst_pdu_request(mb_mst_handle handle, struct mb_mst_request *request, uint16_t *reg_data, uint16_t reg_len);
 
 #endif /* __VIRTUAL_OS_MODBUS_MASTER_H__ */
\ No newline at end of file
@@ -38,6 +38,9 @@
 /**
  * @brief 从机接收帧处理
  *
+ * 线圈/离散输入功能码时 p_in_out 按位存储, 第i个线圈对应 p_in_out[i/16] 的 bit(i%16), 读请求时已清零
+ * 写单个线圈/寄存器时 reg_num 为1
+ *
  * @param func 功能码
  * @param reg 寄存器地址
  * @param reg_num 寄存器数量
@@ -47,11 +50,28 @@
  */
 typedef uint8_t (*mb_slv_frame_resp)(uint8_t func, uint16_t reg, uint16_t reg_num, uint16_t *p_in_out);
 
-// 寄存器区间任务处理
+/**
+ * @brief 寄存器映像写入通知
+ *
+ * @param reg 起始寄存器
+ * @param reg_num 寄存器数量
+ * @param changed 写入的数据是否与原值不同
+ */
+typedef void (*mb_slv_write_notify)(uint16_t reg, uint16_t reg_num, bool changed);
+
+/**
+ * @brief 寄存器区间任务处理
+ *
+ * image 不为NULL时为寄存器映像模式: 读请求直接从映像回复, 写请求直接写入映像后调用 notify, 不再调用 resp
+ * 寄存器映像只支持寄存器功能码(0x03/0x04/0x06/0x10), 线圈功能码返回功能码错误
+ * image[0] 对应 start 寄存器, 长度至少为 end - start
+ */
 struct mb_slv_work {
-	uint16_t start;			// 起始寄存器
-	uint16_t end;			// 结束寄存器 = 起始寄存器 + 当前区间寄存器长度
-	mb_slv_frame_resp resp; // 响应处理函数
+	uint16_t start;				// 起始寄存器
+	uint16_t end;				// 结束寄存器 = 起始寄存器 + 当前区间寄存器长度
+	mb_slv_frame_resp resp;		// 响应处理函数
+	uint16_t *image;			// 寄存器映像 可选
+	mb_slv_write_notify notify; // 映像写入通知 可选
 };
 
 // 从机句柄
@@ -60,6 +80,9 @@ typedef struct mb_slv *mb_slv_handle;
 /**
  * @brief 从机初始化并申请句柄
  *
+ * 任务处理表会被拷贝并按起始寄存器排序, 请求时二分查找, 初始化后可以释放原表
+ * 区间无效(start >= end)或相互重叠时初始化失败
+ *
  * @param opts 				读写等回调函数指针
  * @param slv_addr 			从机地址
  * @param table 			任务处理表
@@ -69,6 +92,21 @@ typedef struct mb_slv *mb_slv_handle;
 mb_slv_handle mb_slv_init(
 	struct serial_opts *opts, uint8_t slv_addr, struct mb_slv_work *work_table, uint16_t table_num);
 
+/**
+ * @brief Modbus TCP从机初始化并申请句柄
+ *
+ * 与RTU从机共用任务处理表和功能码处理, 帧格式为MBAP报文头+PDU, 响应的事务标识与请求相同
+ * 主机可以不等待响应连续发送多个请求, 每次轮询依次处理接收到的所有完整帧
+ *
+ * @param opts 				socket收发等回调函数指针 f_read/f_write 须为非阻塞接口 不使用 f_read_frame
+ * @param unit_id 			单元标识 同时响应单元标识为`MODBUS_TCP_UNIT_ANY`的请求
+ * @param table 			任务处理表
+ * @param table_num 		任务处理表数量
+ * @return mb_slv_handle 	成功返回句柄，失败返回NULL
+ */
+mb_slv_handle mb_slv_tcp_init(
+	struct serial_opts *opts, uint8_t unit_id, struct mb_slv_work *work_table, uint16_t table_num);
+
 /**
  * @brief 释放从机句柄
  *
@@ -34,6 +34,9 @@
 #define __VIRTUAL_OS_BUTTON_H__
 
 #include <stdint.h>
+#include <stdbool.h>
+
+#define BTN_GROUP_WORD_BITS (32) // 按键组每次读取的按键数量 即一个GPIO端口或矩阵键盘的一行
 
 typedef struct button *btn_handle;
 
@@ -93,4 +96,90 @@ void button_destroy(btn_handle btn);
  */
 void button_scan(btn_handle btn);
 
+/**************************************按键组**************************************/
+
+typedef struct button_group *btn_group_handle;
+
+typedef void (*btn_group_cb)(uint16_t key, const struct btn_ev_data *ev_data); // 按键组事件回调 key为按键编号
+
+/**
+ * @brief 按键组配置结构体 组内按键共用有效电平和时间参数
+ * 
+ * 按键按`BTN_GROUP_WORD_BITS`个为一组读取, 第 n 组的第 m 位对应编号为 n * BTN_GROUP_WORD_BITS + m 的按键
+ */
+struct btn_group_cfg {
+	uint32_t (*f_io_read)(uint8_t word); /* 读取第word组按键的IO电平 每个位对应一个按键 */
+	uint16_t key_num;					 /* 按键数量 */
+	uint32_t long_min_cnt;				 /* 按下按键切换到长按事件最少维持的周期次数 */
+	uint32_t up_max_cnt;				 /* 按键弹起到再次按下事件最多维持的周期次数 */
+	enum button_level active_lv;		 /* 按下的有效电平 */
+};
+
+/**
+ * @brief 创建按键组实例
+ * 
+ * @param p_cfg 参数配置
+ * @param cb 按键事件回调
+ * @return btn_group_handle 成功返回句柄，失败时返回 NULL
+ */
+btn_group_handle button_group_ctor(const struct btn_group_cfg *p_cfg, btn_group_cb cb);
+
+/**
+ * @brief 销毁按键组实例，释放资源
+ * 
+ * @param grp 按键组句柄
+ */
+void button_group_destroy(btn_group_handle grp);
+
+/**
+ * @brief 对按键组进行扫描，需要由调用方周期性执行，这个周期一般设定为按键的防抖间隔
+ * 
+ * 每组按键只读取一次IO并同时消抖, 只有电平变化或正在计时的按键会执行状态机
+ * 
+ * @param grp 按键组句柄
+ */
+void button_group_scan(btn_group_handle grp);
+
+/**************************************中断唤醒**************************************/
+
+/**
+ * 中断唤醒模式下不需要创建周期扫描任务:
+ * 在按键IO的边沿中断中调用`button_wakeup`/`button_group_wakeup`, 按键组件随后在调度器中以`period_ms`为周期扫描,
+ * 所有按键回到空闲状态且电平稳定后停止扫描, 调度器可以进入休眠直到下一次边沿中断
+ * 
+ * 依赖调度器的事件任务和单次定时器, 需要在`stimer_init`之后、在调度器上下文中使能, 使能后不能在按键事件回调中销毁按键
+ */
+
+/**
+ * @brief 使能按键的中断唤醒模式
+ * 
+ * @param btn 按键句柄
+ * @param period_ms 扫描周期 与`long_min_cnt`/`up_max_cnt`的计数周期相同
+ * @return bool 成功返回true，失败返回false
+ */
+bool button_irq_enable(btn_handle btn, uint32_t period_ms);
+
+/**
+ * @brief 唤醒按键扫描 在按键IO的边沿中断中调用
+ * 
+ * @param btn 按键句柄
+ */
+void button_wakeup(btn_handle btn);
+
+/**
+ * @brief 使能按键组的中断唤醒模式
+ * 
+ * @param grp 按键组句柄
+ * @param period_ms 扫描周期 与`long_min_cnt`/`up_max_cnt`的计数周期相同
+ * @return bool 成功返回true，失败返回false
+ */
+bool button_group_irq_enable(btn_group_handle grp, uint32_t period_ms);
+
+/**
+ * @brief 唤醒按键组扫描 在任意按键IO的边沿中断中调用
+ * 
+ * @param grp 按键组句柄
+ */
+void button_group_wakeup(btn_group_handle grp);
+
 #endif /* __VIRTUAL_OS_BUTTON_H__ */
@@ -38,10 +38,47 @@
 #ifdef VIRTUAL_OS_CRC_EN
 
 #include <stdint.h>
+#include <stddef.h>
+
+/* 软件CRC16每次处理的字节数 1:逐字节查表(512字节表) 4:slicing-by-4(2K字节表) 8:slicing-by-8(4K字节表) */
+#define CRC16_SLICE_BY (4)
+
+/* 数据长度不小于此值时才使用硬件CRC后端 短数据启动硬件的开销大于软件计算 */
+#define CRC16_HW_MIN_LEN (16)
+
+// 1:启用 0:不启用
+#define CRC16_BENCH_ENABLE (0) /* 提供`crc_bench`命令 需要调度定时器提供`f_get_cycle`接口 */
+
+/**
+ * @brief CRC16-MODBUS 硬件计算接口
+ * 
+ * @param crc 初始值 与软件接口相同, 需要继续之前的计算结果
+ * @param data 数据
+ * @param len 数据长度
+ * @return uint16_t 计算结果
+ */
+typedef uint16_t (*crc16_hw_f)(uint16_t crc, const uint8_t *data, uint32_t len);
 
 uint16_t crc16_update(uint16_t crc, uint8_t data);
 uint16_t crc16_update_bytes(uint16_t crc, uint8_t *data, uint32_t len);
 
+/**
+ * @brief 纯软件计算 不使用硬件后端
+ * 
+ * @param crc 初始值
+ * @param data 数据
+ * @param len 数据长度
+ * @return uint16_t 计算结果
+ */
+uint16_t crc16_update_bytes_sw(uint16_t crc, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief 设置硬件CRC后端 之后`crc16_update_bytes`对不短于`CRC16_HW_MIN_LEN`的数据使用硬件计算
+ * 
+ * @param hw 硬件计算接口 为NULL时恢复软件计算
+ */
+void crc16_set_hw(crc16_hw_f hw);
+
 #endif /* VIRTUAL_OS_CRC_EN */
 
 #endif /* __VIRTUAL_OS_CRC_H__ */
\ No newline at end of file
@@ -0,0 +1,128 @@
+/**
+ * @file evt_queue.h
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 中断到任务的事件队列
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#ifndef __VIRTUAL_OS_EVT_QUEUE_H__
+#define __VIRTUAL_OS_EVT_QUEUE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "utils/queue.h"
+#include "utils/stimer.h"
+
+/**
+ * @brief 事件队列 单生产者(一般为中断)单消费者(事件任务)
+ * 
+ * 投递事件后触发绑定的事件任务, 事件任务中循环取出事件处理, 例如驱动状态机:
+ * 
+ * static void fsm_evt_task(void *arg)
+ * {
+ *     struct app_evt e;
+ *     while (evt_queue_get(&app_eq, &e))
+ *         qfsm_dispatch(&app_fsm, (qevent_t *)&e);
+ * }
+ * 
+ * evt_queue_init(&app_eq, sizeof(struct app_evt), evt_buf, EVT_NUM, stimer_event_task_create(fsm_evt_task, NULL));
+ */
+struct evt_queue {
+	struct queue_info q;		/* 事件缓冲 */
+	stimer_event_handle notify; /* 投递后触发的事件任务 可为NULL */
+	volatile uint32_t drops;	/* 队列已满被丢弃的事件数 */
+};
+
+/**
+ * @brief 初始化事件队列
+ * 
+ * @param eq 事件队列实例(由用户分配内存)
+ * @param evt_bytes 单个事件的字节数
+ * @param buf 预分配的缓冲区 大小为 evt_bytes * evts
+ * @param evts 可缓存的事件数
+ * @param notify 投递后触发的事件任务 可为NULL
+ * @return bool 成功返回true，失败返回false
+ */
+bool evt_queue_init(struct evt_queue *eq, size_t evt_bytes, void *buf, size_t evts, stimer_event_handle notify);
+
+/**
+ * @brief 投递事件 可在中断中调用
+ * 
+ * @param eq 事件队列实例
+ * @param evt 事件 长度为初始化时的 evt_bytes
+ * @return bool 成功返回true，队列已满返回false
+ */
+bool evt_queue_post(struct evt_queue *eq, const void *evt);
+
+/**
+ * @brief 投递长度小于 evt_bytes 的事件 只拷贝前 len 字节, 其余清零
+ * 
+ * 在临界区中写入, 可以与另一个上下文(例如中断)中的`evt_queue_post`同时投递到同一个队列
+ * 
+ * @param eq 事件队列实例
+ * @param evt 事件
+ * @param len 事件长度 超过 evt_bytes 时截断
+ * @return bool 成功返回true，队列已满返回false
+ */
+bool evt_queue_post_short(struct evt_queue *eq, const void *evt, size_t len);
+
+/**
+ * @brief 取出事件 在事件任务中调用
+ * 
+ * @param eq 事件队列实例
+ * @param evt 存储事件的缓冲区 长度至少为初始化时的 evt_bytes
+ * @return bool 取到事件返回true，队列为空返回false
+ */
+bool evt_queue_get(struct evt_queue *eq, void *evt);
+
+/**
+ * @brief 获取最早的事件 不拷贝, 处理完后调用`evt_queue_release`释放 在事件任务中调用
+ * 
+ * @param eq 事件队列实例
+ * @return const void* 事件在缓冲区中的地址 队列为空返回NULL
+ */
+const void *evt_queue_peek(struct evt_queue *eq);
+
+/**
+ * @brief 释放通过`evt_queue_peek`获取的事件
+ * 
+ * @param eq 事件队列实例
+ */
+void evt_queue_release(struct evt_queue *eq);
+
+/**
+ * @brief 获取并清零丢弃的事件数
+ * 
+ * @param eq 事件队列实例
+ * @return uint32_t 丢弃的事件数
+ */
+uint32_t evt_queue_take_drops(struct evt_queue *eq);
+
+#endif /* __VIRTUAL_OS_EVT_QUEUE_H__ */
@@ -81,4 +81,22 @@ list_item *list_delete_tail(list_item *head);
  */
 uint8_t list_add_tail(list_item *head, list_item *item);
 
+/**
+ * @brief 插入到指定节点之前
+ * 
+ * @param pos 
+ * @param item 
+ * @return uint8_t 
+ */
+uint8_t list_insert_before(list_item *pos, list_item *item);
+
+/**
+ * @brief 将 list 中的所有节点移动到 head 的尾部, 并重新初始化 list
+ * 
+ * @param head 
+ * @param list 
+ * @return uint8_t 
+ */
+uint8_t list_splice_tail(list_item *head, list_item *list);
+
 #endif /* __VIRTUAL_OS_LIST_H__ */
@@ -37,12 +37,51 @@
 #include <stddef.h>
 #include <stdbool.h>
 
-#define USE_TIME_STAMP 0 /* 日志启用时显示时间,0为关闭,1为启用 开启会编译time.h头文件，将占用大量FLASH空间 */
+#define USE_TIME_STAMP 0									 /* 日志启用时显示时间,0为关闭,1为启用 开启会编译time.h头文件，将占用大量FLASH空间 */
 #define MAX_LOG_LENGTH 256									 /* 每条日志的最大长度 */
 #define TOTAL_FRAME_COUNT (8)								 // 缓冲8条
 #define LOG_BUFFER_SIZE (MAX_LOG_LENGTH * TOTAL_FRAME_COUNT) /* 日志缓冲区总大小 2K */
 
-typedef size_t (*log_write)(uint8_t *buf, size_t len); // 发送接口
+// 1:启用 0:不启用
+#define LOG_DEFERRED_ENABLE (0) /* 延迟格式化 调用处只记录格式串指针、行号和原始参数, 在`syslog_task`中格式化 */
+#define LOG_DEFERRED_RAW (0)	/* 延迟模式下不在本地格式化, 直接输出二进制记录, 由上位机读取ELF中的格式串解码 */
+
+#define LOG_DEFERRED_RECORD_MAX (64)							/* 延迟模式下单条记录的最大字节数 放不下的参数及其后的内容被截断 */
+#define LOG_DEFERRED_STR_MAX (32)								/* 延迟模式下`%s`参数最多拷贝的字节数 */
+#define LOG_DEFERRED_SYNC (0xA5)								/* 二进制记录的帧头 */
+#define LOG_DEFERRED_BUFFER_SIZE (LOG_DEFERRED_RECORD_MAX * 16) /* 延迟记录缓冲区大小 仅本地格式化时使用 */
+
+#define LOG_FLUSH_MAX_BYTES (MAX_LOG_LENGTH) /* 单次调用输出接口的最大字节数 不能超过驱动的发送缓冲区 */
+
+#define LOG_MAX_SINKS (2)		   /* 最多支持的输出端个数 不超过8 */
+#define LOG_DROP_REPORT_MS (1000) /* 丢弃统计的最短上报间隔 */
+
+// 1:启用 0:不启用
+#define LOG_RTT_ENABLE (0) /* RTT输出 日志不经过日志缓冲区直接写入RTT上行缓冲区(非阻塞跳过模式) 需要编译`Component/RTT` */
+
+/* 编译期日志等级 低于该等级的日志调用不参与编译(参数不求值, 格式串不占用FLASH)
+ * 取值与`enum log_level`相同 0:全部 1:DEBUG 2:INFO 3:WARN 4:ERROR 5:关闭 */
+#define LOG_COMPILE_LEVEL (0)
+
+/* 单个模块的编译期日志等级 在源文件包含本头文件之前定义, 覆盖该文件中的`LOG_COMPILE_LEVEL`
+ * 例如: #define LOG_MODULE_LEVEL (5) 移除该文件中的全部日志 */
+#ifndef LOG_MODULE_LEVEL
+#define LOG_MODULE_LEVEL LOG_COMPILE_LEVEL
+#endif
+
+/**
+ * @brief 发送接口 buf 直接指向日志缓冲区, 可能包含多条日志
+ * 		  同步模式下返回已发送(或已拷贝)的字节数, 返回值小于 len 时剩余数据在下次任务中继续发送
+ * 		  异步模式下返回已启动发送的字节数, 发送完成前 buf 保持有效, 完成后调用`syslog_tx_complete`
+ */
+typedef size_t (*log_write)(uint8_t *buf, size_t len);
+
+// 丢弃统计 丢弃后会在对应输出端的日志流中输出一条`syslog`模块的警告日志
+struct syslog_stats {
+	uint32_t dropped; /* 丢弃的日志条数 包括限流丢弃 */
+	uint32_t overrun; /* 缓冲区溢出次数 连续丢弃计为一次 */
+	uint32_t limited; /* 限流丢弃的日志条数 */
+};
 
 enum log_level {
 	LOG_LEVEL_ALL = 0,	 /* 所有日志 */
@@ -53,9 +92,23 @@ enum log_level {
 	LOG_LEVEL_NONE = 5	 /* 关闭日志 */
 };
 
+// 输出端属性
+struct syslog_sink_attr {
+	enum log_level level; /* 输出端的日志等级 低于该等级的日志不输出到该端 */
+	uint32_t module_mask; /* 输出端的模块掩码 0:全部模块 */
+	uint32_t rate;		  /* 限流 每秒最多写入的字节数 0:不限制 */
+	uint32_t burst;		  /* 限流 允许突发写入的字节数 0:等于 rate 应不小于单条日志长度 */
+	uint32_t flush_bytes; /* 每个任务周期最多交给输出接口的字节数 0:不限制 */
+	bool async;			  /* 输出接口为异步模式 */
+};
+
 /**
  * @brief 日志发送 可以通过掩码过滤日志 建议使用宏定义
  * 
+ * 可在任务和多个优先级的中断中同时调用
+ * 
+ * 启用`LOG_DEFERRED_ENABLE`时只记录格式串指针, 因此 format 必须是常量字符串, `%s`参数的内容会被拷贝
+ * 
  * @param mask 模块掩码
  * @param level 日志等级
  * @param line 行号
@@ -71,6 +124,64 @@ void origin_log(uint32_t mask, enum log_level level, int line, const char *forma
  */
 void modify_output(log_write f_write);
 
+/**
+ * @brief 设置0号输出端为异步模式 例如DMA直接从日志缓冲区发送
+ * 
+ * @param async true:异步 false:同步(默认)
+ */
+void syslog_set_async(bool async);
+
+/**
+ * @brief 异步输出完成 在发送完成中断中调用
+ * 
+ * @param len 已发送完成的字节数 即发送接口的返回值
+ */
+void syslog_tx_complete(size_t len);
+
+/**
+ * @brief 添加输出端 在`syslog_init`之后调用 `syslog_init`的输出接口为0号输出端
+ * 		  日志只格式化一次, 写入所有接收该日志的输出端, 每个输出端独立过滤、限流和输出
+ * 
+ * @param f_write 输出接口
+ * @param buf 输出端缓冲区
+ * @param size 输出端缓冲区大小
+ * @param attr 输出端属性 为NULL时接收全部日志且不限流
+ * @return int 输出端编号 失败返回-1
+ */
+int syslog_add_sink(log_write f_write, void *buf, size_t size, const struct syslog_sink_attr *attr);
+
+/**
+ * @brief 输出端异步输出完成 在发送完成中断中调用
+ * 
+ * @param sink 输出端编号
+ * @param len 已发送完成的字节数 即发送接口的返回值
+ */
+void syslog_sink_tx_complete(int sink, size_t len);
+
+/**
+ * @brief 设置输出端的日志等级
+ * 
+ * @param sink 输出端编号
+ * @param level 日志等级
+ */
+void syslog_sink_set_level(int sink, enum log_level level);
+
+/**
+ * @brief 设置输出端的模块掩码
+ * 
+ * @param sink 输出端编号
+ * @param mask 模块掩码 0为全部模块
+ */
+void syslog_sink_set_mask(int sink, uint32_t mask);
+
+/**
+ * @brief 获取输出端的丢弃统计
+ * 
+ * @param sink 输出端编号
+ * @param stats 统计信息
+ */
+void syslog_get_stats(int sink, struct syslog_stats *stats);
+
 /**
  * @brief 填充模块名称数组 按照掩码从小到大排序 模块名的索引就是实际的掩码位
  * 		  结束后 module_buf_size 指向实际填充的模块个数
@@ -109,6 +220,34 @@ void enable_all_mask(void);
  */
 void syslog_init(log_write f_write, uint32_t period_ms);
 
+#if LOG_RTT_ENABLE
+/**
+ * @brief 使用RTT作为日志输出 替代`syslog_init` RTT为0号输出端
+ * 
+ * @param period_ms 任务周期（毫秒）
+ */
+void syslog_init_rtt(uint32_t period_ms);
+
+/**
+ * @brief 添加RTT输出端 在`syslog_init`之后调用
+ * 
+ * @param attr 输出端属性 为NULL时接收全部日志且不限流
+ * @return int 输出端编号 失败返回-1
+ */
+int syslog_add_rtt_sink(const struct syslog_sink_attr *attr);
+
+/**
+ * @brief 将模块的日志输出到指定的RTT上行通道 在`syslog_init_rtt`之后调用
+ * 
+ * @param mask 模块掩码 可以包含多个模块
+ * @param channel RTT上行通道 默认为0
+ * @param buf 通道缓冲区 为NULL时使用已配置的通道(通道0由RTT默认配置)
+ * @param size 通道缓冲区大小
+ * @return bool 成功返回true，失败返回false
+ */
+bool syslog_rtt_channel(uint32_t mask, unsigned channel, void *buf, unsigned size);
+#endif
+
 /**
  * @brief 日志任务
  * 
@@ -125,9 +264,29 @@ uint32_t allocate_log_mask(const char * const module_name);
 
 /* 日志宏定义 */
 // 注意提前通过`allocate_log_mask`获取一个模块掩码
+// 低于`LOG_MODULE_LEVEL`的日志宏展开为空语句
+#if (LOG_MODULE_LEVEL <= 1)
 #define log_d(_mask, format, ...) origin_log(_mask, LOG_LEVEL_DEBUG, __LINE__, format, ##__VA_ARGS__) /* 调试日志 */
-#define log_i(_mask, format, ...) origin_log(_mask, LOG_LEVEL_INFO, __LINE__, format, ##__VA_ARGS__)  /* 信息日志 */
-#define log_w(_mask, format, ...) origin_log(_mask, LOG_LEVEL_WARN, __LINE__, format, ##__VA_ARGS__)  /* 警告日志 */
+#else
+#define log_d(_mask, format, ...) ((void)0)
+#endif
+
+#if (LOG_MODULE_LEVEL <= 2)
+#define log_i(_mask, format, ...) origin_log(_mask, LOG_LEVEL_INFO, __LINE__, format, ##__VA_ARGS__) /* 信息日志 */
+#else
+#define log_i(_mask, format, ...) ((void)0)
+#endif
+
+#if (LOG_MODULE_LEVEL <= 3)
+#define log_w(_mask, format, ...) origin_log(_mask, LOG_LEVEL_WARN, __LINE__, format, ##__VA_ARGS__) /* 警告日志 */
+#else
+#define log_w(_mask, format, ...) ((void)0)
+#endif
+
+#if (LOG_MODULE_LEVEL <= 4)
 #define log_e(_mask, format, ...) origin_log(_mask, LOG_LEVEL_ERROR, __LINE__, format, ##__VA_ARGS__) /* 错误日志 */
+#else
+#define log_e(_mask, format, ...) ((void)0)
+#endif
 
 #endif /* __VIRTUAL_OS_LOG_H__ */
@@ -0,0 +1,133 @@
+/**
+ * @file qactive.h
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 主动对象 层次状态机 + 事件队列 + 定时事件
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#ifndef __VIRTUAL_OS_QACTIVE_H__
+#define __VIRTUAL_OS_QACTIVE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "utils/qfsm.h"
+#include "utils/evt_queue.h"
+#include "utils/stimer.h"
+
+/**
+ * @brief 主动对象 每个主动对象拥有一个层次状态机和一个事件队列
+ * 
+ * 投递的事件先写入事件队列, 由调度器循环中的事件任务逐个取出并分发给状态机,
+ * 每个事件处理完成后才处理下一个(run-to-completion)
+ * 所有主动对象都在调度器上下文中执行, 互相之间不会抢占, 空闲时不占用CPU
+ * 
+ * 用户结构体的第一个成员必须为`struct qactive`, 事件结构体的第一个成员必须为`qevent_t`:
+ * 
+ * struct app {
+ *     struct qactive super;
+ *     struct qtime_evt timeout;
+ * };
+ * 
+ * static struct app_evt app_buf[8];
+ * qactive_init(&app.super, (qstate_handler)app_initial, sizeof(struct app_evt), app_buf, 8);
+ */
+struct qactive {
+	qhsm_t hsm;				 /* 层次状态机 必须为第一个成员 */
+	struct evt_queue eq;	 /* 事件队列 */
+	stimer_event_handle run; /* 分发事件的事件任务 */
+};
+
+/**
+ * @brief 定时事件 到期后投递到所属主动对象的事件队列, 与其他事件一起按投递顺序分发
+ * 
+ * 投递在临界区中完成, 不占用`qactive_post`的单一投递上下文; 队列已满时丢弃并计入`evt_queue_take_drops`
+ * 事件队列中除`qevent_t`外的字节为0
+ */
+struct qtime_evt {
+	qevent_t evt;			   /* 到期时分发的事件 */
+	struct qactive *ao;		   /* 所属主动对象 */
+	stimer_timer_handle timer; /* 单次定时器 */
+	uint32_t interval_ms;	   /* 重复周期 0为单次 */
+};
+
+/**
+ * @brief 初始化主动对象并执行状态机的初始转换 需要在`stimer_init`之后调用
+ * 
+ * 状态的嵌套层数超过`QHSM_MAX_DEPTH`时失败
+ * 
+ * @param ao 主动对象实例(由用户分配内存)
+ * @param f_initial 初始伪状态 必须返回`Q_HSM_TRAN`
+ * @param evt_bytes 单个事件的字节数 不小于`sizeof(qevent_t)`
+ * @param buf 事件缓冲区 大小为 evt_bytes * evts
+ * @param evts 可缓存的事件数
+ * @return bool 成功返回true，失败返回false
+ */
+bool qactive_init(struct qactive *ao, qstate_handler f_initial, size_t evt_bytes, void *buf, size_t evts);
+
+/**
+ * @brief 向主动对象投递事件 事件被拷贝到事件队列中
+ * 
+ * 可在中断中调用, 同一个主动对象的事件只能由一个上下文投递(某一个中断或者调度器上下文), 定时事件不计入
+ * 
+ * @param ao 主动对象实例
+ * @param evt 事件 长度为初始化时的 evt_bytes
+ * @return bool 成功返回true，队列已满返回false
+ */
+bool qactive_post(struct qactive *ao, const void *evt);
+
+/**
+ * @brief 初始化定时事件
+ * 
+ * @param te 定时事件实例(由用户分配内存)
+ * @param ao 所属主动对象
+ * @param sig 到期时分发的信号
+ * @return bool 成功返回true，失败返回false
+ */
+bool qtime_evt_init(struct qtime_evt *te, struct qactive *ao, qsignal_t sig);
+
+/**
+ * @brief 启动定时事件 已启动时重新计时 只能在调度器上下文中调用
+ * 
+ * @param te 定时事件实例
+ * @param ms 指定毫秒后到期
+ * @param interval_ms 之后的重复周期 0为单次
+ * @return bool 成功返回true，失败返回false
+ */
+bool qtime_evt_arm(struct qtime_evt *te, uint32_t ms, uint32_t interval_ms);
+
+/**
+ * @brief 停止定时事件 只能在调度器上下文中调用
+ * 
+ * @param te 定时事件实例
+ * @return bool 定时事件已启动且被停止返回true，否则返回false
+ */
+bool qtime_evt_disarm(struct qtime_evt *te);
+
+#endif /* __VIRTUAL_OS_QACTIVE_H__ */
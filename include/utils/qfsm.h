@@ -34,6 +34,9 @@
 #define __VIRTUAL_OS_QFSM_H__
 
 #include <stdint.h>
+#include <stdbool.h>
+
+#define QHSM_MAX_DEPTH (6) // 层次状态机的最大嵌套层数 不包括顶层状态
 
 typedef uint32_t qsignal_t;
 typedef int qstate;
@@ -54,6 +57,7 @@ enum q_event_result {
 	Q_EVENT_HANDLED = (qstate)0,
 	Q_EVENT_IGNORED,
 	Q_EVENT_TRAN,
+	Q_EVENT_SUPER, /* 事件交给父状态处理 只用于层次状态机 */
 };
 
 #define Q_HANDLED() (Q_EVENT_HANDLED)
@@ -87,4 +91,75 @@ void qfsm_init(qfsm_t *me, qstate_handler f_initial, qevent_t const *e);
  */
 void qfsm_dispatch(qfsm_t * const me, qevent_t const *e);
 
+/**************************************层次状态机**************************************/
+
+/**
+ * @brief 层次状态机
+ * 
+ * 状态处理函数未处理的事件通过`Q_SUPER`交给父状态处理, 最外层状态的父状态为`qhsm_top`
+ * 状态转换使用`Q_HSM_TRAN`, 转换时从当前状态退出到源状态与目标状态的最近公共祖先, 再逐级进入目标状态,
+ * 之后执行目标状态的`Q_INIT_SIG`初始转换直到叶子状态. 状态处理函数必须在default分支中返回`Q_SUPER`:
+ * 
+ * static qstate s_on(struct app *me, qevent_t const *e)
+ * {
+ *     switch (e->sig) {
+ *     case Q_ENTRY_SIG:
+ *         led_on();
+ *         return Q_HANDLED();
+ *     case Q_INIT_SIG:
+ *         return Q_HSM_TRAN(s_on_idle);
+ *     case APP_OFF_SIG:
+ *         return Q_HSM_TRAN(s_off);
+ *     }
+ *     return Q_SUPER(qhsm_top);
+ * }
+ */
+typedef struct qhsmtag qhsm_t;
+
+struct qhsmtag {
+	qstate_handler state; /* 当前所在的叶子状态 */
+	qstate_handler temp;  /* 转换目标或父状态 由`Q_HSM_TRAN`/`Q_SUPER`设置 */
+};
+
+#define Q_SUPER(super_) (((qhsm_t *)me)->temp = (qstate_handler)(super_), Q_EVENT_SUPER)
+#define Q_HSM_TRAN(target_) (((qhsm_t *)me)->temp = (qstate_handler)(target_), Q_EVENT_TRAN)
+
+/**
+ * @brief 顶层状态 忽略所有事件
+ * 
+ * @param me 状态机实例
+ * @param e 事件
+ * @return qstate 
+ */
+qstate qhsm_top(qfsm_t *me, qevent_t const *e);
+
+/**
+ * @brief 层次状态机初始化 执行初始转换并进入到叶子状态
+ * 
+ * 状态的嵌套层数不能超过`QHSM_MAX_DEPTH`, 初始状态超过时返回false, 之后转换到更深的状态时断言
+ * 
+ * @param me 状态机实例
+ * @param f_initial 初始伪状态 必须返回`Q_HSM_TRAN`
+ * @param e 事件
+ * @return bool 成功返回true，初始伪状态未转换或嵌套过深返回false
+ */
+bool qhsm_init(qhsm_t *me, qstate_handler f_initial, qevent_t const *e);
+
+/**
+ * @brief 层次状态机调度 事件处理完成(包括状态转换)后才返回, 不可在状态处理函数中嵌套调度同一个状态机
+ * 
+ * @param me 状态机实例
+ * @param e 事件
+ */
+void qhsm_dispatch(qhsm_t *me, qevent_t const *e);
+
+/**
+ * @brief 当前是否处于指定状态或其子状态
+ * 
+ * @param me 状态机实例
+ * @param state 状态
+ * @return bool 
+ */
+bool qhsm_is_in(qhsm_t *me, qstate_handler state);
+
 #endif /* __VIRTUAL_OS_QFSM_H__ */
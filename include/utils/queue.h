@@ -39,11 +39,16 @@
 
 /**
  * @brief 循环队列结构体
+ * 
+ * 单生产者单消费者时无需加锁, 生产者只调用 queue_add/queue_advance_wr,
+ * 消费者只调用 queue_get/queue_peek/queue_advance_rd, 可用于中断与主循环之间传递数据
+ * 容量为2的幂时使用掩码计算索引, 并且读写索引可以自由回绕, 建议优先使用2的幂容量
  */
 struct queue_info {
 	void *buf;		   /* 缓冲区 */
 	size_t unit_bytes; /* 单元大小(字节数) */
 	size_t buf_size;   /* 缓冲区容量(单位数) */
+	size_t mask;	   /* 容量为2的幂时为索引掩码 否则为0 */
 	size_t rd;		   /* 读索引 */
 	size_t wr;		   /* 写索引 */
 };
@@ -151,4 +156,57 @@ void queue_advance_rd(struct queue_info *q, size_t units);
  */
 void queue_advance_wr(struct queue_info *q, size_t units);
 
+/**
+ * @brief 获取可直接写入的连续空间 写入后调用 queue_commit 提交
+ * 
+ * 空间在缓冲区末尾回绕时只返回到缓冲区末尾的部分, 提交后再次调用可获取回绕后的空间
+ *
+ * @param q   指向队列实例的指针
+ * @param ptr 返回可写入的起始地址
+ * @return size_t 可连续写入的单元数
+ */
+size_t queue_reserve_contig(struct queue_info *q, void **ptr);
+
+/**
+ * @brief 提交通过 queue_reserve_contig 写入的单元
+ *
+ * @param q     指向队列实例的指针
+ * @param units 实际写入的单元数
+ */
+void queue_commit(struct queue_info *q, size_t units);
+
+/**
+ * @brief 获取可直接读取的连续数据 处理完后调用 queue_release 释放
+ * 
+ * 数据在缓冲区末尾回绕时只返回到缓冲区末尾的部分, 释放后再次调用可获取回绕后的数据
+ *
+ * @param q   指向队列实例的指针
+ * @param ptr 返回可读取的起始地址
+ * @return size_t 可连续读取的单元数
+ */
+size_t queue_peek_contig(struct queue_info *q, void **ptr);
+
+/**
+ * @brief 释放通过 queue_peek_contig 读取的单元
+ *
+ * @param q     指向队列实例的指针
+ * @param units 已处理的单元数
+ */
+void queue_release(struct queue_info *q, size_t units);
+
+/**
+ * @brief 读函数 返回实际读取的字节数
+ */
+typedef size_t (*queue_read_f)(uint8_t *buf, size_t len);
+
+/**
+ * @brief 通过读函数直接向队列填充数据, 不经过中间缓冲
+ *
+ * @param q      指向队列实例的指针
+ * @param f_read 读函数 例如串口读
+ * @param units  最多读取的单元数
+ * @return size_t 实际填充的单元数
+ */
+size_t queue_fill(struct queue_info *q, queue_read_f f_read, size_t units);
+
 #endif /* __VIRTUAL_OS_QUEUE_H__ */
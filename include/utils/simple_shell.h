@@ -43,11 +43,33 @@
 #define SPS_CMD_MAX 64	   // 单条命令最大长度
 #define SPS_CMD_MAX_ARGS 4 // 单条命令的最大参数数量
 #define MAX_COMMANDS 16	   // 系统可注册命令的最大数量
-#define MAX_OUT_LEN 512	   // 命令输出缓冲区长度
+#define MAX_OUT_LEN 512	   // 命令单次输出的最大长度 更长的输出使用`sps_cmd_continue`分段输出
 
 // 1:启用 0:不启用
 #define SPS_ENABLE_TAB_COMPLETE (1) // 启用tab自动补全功能
 #define SPS_ENABLE_HISTORY (1)		// 启用历史记录功能 上下箭头可切换历史记录
+#define SPS_ENABLE_BINARY (0)		// 启用二进制命令模式 按命令编号执行命令, 不回显, 帧格式见`docs/Shell/README.md`
+
+// 静态命令表 1:启用 0:不启用
+// 启用后`SPS_EXPORT_CMD`导出的命令链接到按命令名排序的`.shell_cmd`段, 不受`MAX_COMMANDS`限制
+// 启动时不再注册和排序, 查找和补全在Flash中的有序表上二分查找 需要链接`core/virtual_os.ld`
+#define SPS_STATIC_CMD_TABLE (0)
+
+// 二进制命令模式
+#define SPS_BIN_SOF_REQ (0xA5)			  // 请求帧头
+#define SPS_BIN_SOF_RSP (0x5A)			  // 响应帧头
+#define SPS_BIN_ID_LIST (0xFF)			  // 查询命令编号表 按编号顺序返回以'\0'分隔的命令名
+#define SPS_BIN_MAX_PAYLOAD (SPS_CMD_MAX) // 请求帧的最大负载长度 命令编号 + 参数
+#define SPS_BIN_TIMEOUT (4)				  // 字节间超时 连续多次调度没有收到数据时丢弃未收完的请求帧 0为不超时
+
+// 二进制响应状态
+enum sps_bin_status {
+	SPS_BIN_OK = 0,	  // 执行完成
+	SPS_BIN_MORE,	  // 执行中 后续还有响应帧
+	SPS_BIN_NO_CMD,	  // 命令编号不存在
+	SPS_BIN_BAD_CRC,  // 请求帧校验错误
+	SPS_BIN_BAD_ARGS, // 参数过长
+};
 
 /**
  * @brief 命令回调函数
@@ -73,7 +95,7 @@ struct sp_shell_cmd_t {
  */
 struct sp_shell_opts {
 	size_t (*read)(uint8_t *buf, size_t len);  /* 读函数指针 */
-	size_t (*write)(uint8_t *buf, size_t len); /* 写函数指针 */
+	size_t (*write)(uint8_t *buf, size_t len); /* 写函数指针 返回实际写入的字节数 未写完的部分下次调度继续发送 */
 };
 
 /**
@@ -92,7 +114,33 @@ bool simple_shell_init(struct sp_shell_opts *opts, const char *welcome);
  */
 void shell_dispatch(void);
 
-// 命令注册宏
+/**
+ * @brief 流式输出 在命令回调中调用, 本次输出发送后再次调用该命令回调继续输出
+ * 
+ * 输出超过`MAX_OUT_LEN`的命令可以分多次输出, 每次回调通过`sps_cmd_step`获取进度,
+ * 每次调度最多回调一次且发送缓冲空间足够时才会回调, 输出不会被截断或丢弃, 命令执行期间暂停解析输入
+ * 
+ * @param step 进度 由命令自行定义, 例如下一个要输出的表项
+ */
+void sps_cmd_continue(uint32_t step);
+
+/**
+ * @brief 获取流式输出的进度 命令第一次回调时为0
+ * 
+ * @return uint32_t 上次调用`sps_cmd_continue`时设置的进度
+ */
+uint32_t sps_cmd_step(void);
+
+// 命令注册宏 命令名在项目中唯一
+#if SPS_STATIC_CMD_TABLE
+#define SPS_EXPORT_CMD(_name, _callback, _description)                                                                 \
+	const struct sp_shell_cmd_t shell_cmd_##_name                                                                      \
+		__attribute__((section(".shell_cmd." #_name), used, aligned(sizeof(void *)))) = {                              \
+			.name = #_name,                                                                                            \
+			.cb = _callback,                                                                                           \
+			.description = _description,                                                                               \
+		};
+#else
 #define SPS_EXPORT_CMD(_name, _callback, _description)                                                                 \
 	const struct sp_shell_cmd_t shell_cmd_##_name = {                                                                  \
 		.name = #_name,                                                                                                \
@@ -106,5 +154,6 @@ void shell_dispatch(void);
 		if (command_count < MAX_COMMANDS)                                                                              \
 			command_list[command_count++] = (struct sp_shell_cmd_t *)&shell_cmd_##_name;                               \
 	}
+#endif
 
 #endif /* __VIRTUAL_OS_SIMPLE_SHELL_H__ */
\ No newline at end of file
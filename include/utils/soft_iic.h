@@ -34,6 +34,14 @@
 #define __VIRTUAL_OS_SOFT_IIC_H__
 
 #include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "bus/iic_bus.h"
+
+/* 异步模式每次调用`soft_iic_async_poll`推进的半个时钟周期数
+ * 在定时器中断中推进时设置为1, 作为调度任务推进时可以适当增大(每步之间仍有短延时), 例如18约为一个字节 */
+#define SOFT_IIC_ASYNC_STEPS_PER_POLL (1)
 
 enum soft_iic_level {
 	iic_low = 0,
@@ -60,5 +68,55 @@ uint8_t soft_iic_read_bytes(uint8_t addr, uint8_t reg, uint8_t len, uint8_t *buf
 */
 uint8_t soft_iic_init(
 	soft_iic_scl_out_f scl_out_f, soft_iic_sda_out_f sda_out_f, soft_iic_sda_in_f sda_in_f, soft_iic_delay_f delay_f);
-	
+
+/**************************************异步接口**************************************/
+
+/*
+ * 异步接口不阻塞等待, 由状态机每次推进半个时钟周期, 引脚与同步接口共用, 异步传输期间不要调用同步接口
+ * 
+ * 推进方式二选一:
+ * 1. 在周期为半个时钟周期的定时器中断中调用`soft_iic_async_poll`
+ * 2. 创建调度任务周期调用`soft_iic_async_poll`, 并增大`SOFT_IIC_ASYNC_STEPS_PER_POLL`
+ */
+
+/**
+ * @brief 异步传输完成回调 在`soft_iic_async_poll`的调用上下文中执行, 可在回调中启动下一次传输
+ * 
+ * @param err 0:成功 1:从机无应答
+ * @param msgs_done 完整传输的消息数
+ * @param arg 用户参数
+ */
+typedef void (*soft_iic_done_f)(uint8_t err, size_t msgs_done, void *arg);
+
+/**
+ * 异步传输一组消息, 每条消息前发送(重复)起始条件和地址, 最后一条消息后发送停止条件, 成功返回0，忙返回1
+ * @param msgs 消息数组 传输完成前必须保持有效
+ * @param num 消息数量
+ * @param done 完成回调 可为NULL
+ * @param arg 用户参数
+ *
+ * @return 0 or 1
+*/
+uint8_t soft_iic_xfer_async(struct i2c_msg *msgs, size_t num, soft_iic_done_f done, void *arg);
+
+/* 以下接口与同步接口参数一致, 启动成功返回0，忙返回1, 传输结果通过回调返回 */
+uint8_t soft_iic_write_one_byte_async(uint8_t addr, uint8_t reg, uint8_t data, soft_iic_done_f done, void *arg);
+uint8_t soft_iic_write_bytes_async(
+	uint8_t addr, uint8_t reg, uint8_t len, uint8_t *buf, soft_iic_done_f done, void *arg);
+uint8_t soft_iic_read_bytes_async(uint8_t addr, uint8_t reg, uint8_t len, uint8_t *buf, soft_iic_done_f done, void *arg);
+
+/**
+ * 推进异步传输状态机, 返回是否还在传输中
+ *
+ * @return true or false
+*/
+bool soft_iic_async_poll(void);
+
+/**
+ * 是否有异步传输正在进行
+ *
+ * @return true or false
+*/
+bool soft_iic_async_busy(void);
+
 #endif /* __VIRTUAL_OS_SOFT_IIC_H__ */
@@ -34,6 +34,19 @@
 #define __VIRTUAL_OS_STIMER_H__
 
 #define STIMER_PERIOD_PER_TICK_MS (1)
+#define STIMER_TICKLESS_MAX_IDLE_TICKS (0xFFFF) /* tickless模式单次休眠的最大节拍数 受限于硬件定时器位宽 */
+
+/* 分级时间轮配置 每级 2^STIMER_WHEEL_BITS 个槽位, 共覆盖 2^(STIMER_WHEEL_BITS*STIMER_WHEEL_LEVELS) 个节拍
+ * 超出覆盖范围的任务会在最高级时间轮中循环级联, 两者乘积不能超过32 */
+#define STIMER_WHEEL_BITS (5)
+#define STIMER_WHEEL_LEVELS (3)
+
+// 1:启用 0:不启用
+#define STIMER_PROFILE_ENABLE (0) /* 启用任务执行时间统计 需要提供`f_get_cycle`接口 并提供`top`命令 */
+
+/* 单个节拍的执行时间预算 单位为`f_get_cycle`的计数值 0:不限制 需要提供`f_get_cycle`接口
+ * 预算耗尽后, 本节拍剩余的低于`STIMER_PRIO_HIGH`的任务推迟到下一个节拍执行 */
+#define STIMER_TICK_BUDGET_CYCLES (0)
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -43,12 +56,30 @@
 typedef void (*stimer_timeout_process)(void);
 typedef void (*stimer_base_init)(uint32_t period_ms, stimer_timeout_process f_timeout);
 typedef void (*stimer_base_start)(void);
+typedef void (*stimer_base_set_alarm)(uint32_t ticks);
+typedef void (*stimer_base_sleep)(void);
+typedef uint32_t (*stimer_base_get_cycle)(void);
 
 typedef void (*stimer_f)(void);
 
+/**
+ * @brief 调度定时器接口
+ * 
+ * f_init/f_start 为必须实现的接口, 定时器每个节拍调用一次 f_timeout
+ * 
+ * f_set_alarm/f_sleep 为可选接口, 同时提供时启用 tickless 模式:
+ * 调度器空闲时计算最近到期任务的节拍数, 通过 f_set_alarm 设置定时器在 ticks 个节拍后唤醒, 随后调用 f_sleep 休眠
+ * tickless 模式下定时器中断中应调用`stimer_tick_announce`上报实际经过的节拍数, 而不是 f_timeout
+ * f_sleep 建议实现为: 关中断 -> 若`stimer_wakeup_pending`返回false则WFI -> 开中断, 防止丢失唤醒
+ * 
+ * f_get_cycle 为可选接口, 返回自由计数的高精度计数值(例如 DWT->CYCCNT), 用于任务执行时间统计和节拍执行时间预算
+ */
 struct timer_port {
 	volatile stimer_base_init f_init;
 	volatile stimer_base_start f_start;
+	volatile stimer_base_set_alarm f_set_alarm; /* 可选 设置在 ticks 个节拍后产生唤醒中断 */
+	volatile stimer_base_sleep f_sleep;			/* 可选 休眠钩子 例如WFI */
+	volatile stimer_base_get_cycle f_get_cycle; /* 可选 获取高精度计数值 */
 };
 
 /**
@@ -59,8 +90,51 @@ struct timer_port {
  */
 bool stimer_init(struct timer_port *port);
 
+/**
+ * @brief tickless模式下上报经过的节拍数 在定时器中断中调用
+ * 
+ * @param ticks 自上次上报以来经过的节拍数
+ */
+void stimer_tick_announce(uint32_t ticks);
+
+/**
+ * @brief 是否有待处理的节拍 用于休眠钩子中判断能否进入休眠
+ * 
+ * @return bool 有待处理的节拍返回true
+ */
+bool stimer_wakeup_pending(void);
+
+/**
+ * @brief 获取高精度计数值 用于测量代码执行时间
+ * 
+ * @return uint32_t 未提供`f_get_cycle`接口时返回0
+ */
+uint32_t stimer_get_cycle(void);
+
 /**************************************用户可用API**************************************/
 
+typedef struct stimer_task *stimer_task_handle;
+
+// 调度落后于实际节拍时的补偿策略
+enum stimer_catchup {
+	STIMER_CATCHUP_ALL = 0, /* 补齐所有错过的周期 (默认) */
+	STIMER_CATCHUP_SKIP,	/* 只执行一次, 跳过错过的周期, 保持原周期相位 */
+};
+
+// 任务优先级 同一节拍到期的任务按优先级从高到低执行, 同优先级按加入顺序执行
+enum stimer_prio {
+	STIMER_PRIO_LOW = -1,	/* 低 */
+	STIMER_PRIO_NORMAL = 0, /* 普通 (默认) */
+	STIMER_PRIO_HIGH = 1,	/* 高 不受节拍执行时间预算限制 */
+};
+
+// 任务属性
+struct stimer_task_attr {
+	enum stimer_catchup catchup; /* 补偿策略 */
+	const char *name;			 /* 任务名(必须是全局变量) 用于执行时间统计显示 可为NULL */
+	enum stimer_prio prio;		 /* 优先级 */
+};
+
 /**
  * @brief 创建周期任务
  * 
@@ -72,14 +146,110 @@ bool stimer_init(struct timer_port *port);
 bool stimer_task_create(stimer_f init_f, stimer_f task_f, uint32_t period_ms);
 
 /**
- * @brief 运行时创建单次任务
+ * @brief 创建周期任务并指定任务属性
+ * 
+ * @param init_f 初始化函数指针
+ * @param task_f 任务函数指针
+ * @param period_ms 任务周期,单位毫秒
+ * @param attr 任务属性 为NULL时使用默认属性
+ * @return stimer_task_handle 成功返回任务句柄，失败返回NULL
+ */
+stimer_task_handle stimer_task_create_ex(
+	stimer_f init_f, stimer_f task_f, uint32_t period_ms, const struct stimer_task_attr *attr);
+
+/**
+ * @brief 获取任务错过的周期数 即调度落后超过一个周期的累计次数
+ * 
+ * @param task 任务句柄
+ * @return uint32_t 错过的周期数
+ */
+uint32_t stimer_task_get_overrun(stimer_task_handle task);
+
+/**
+ * @brief 创建单次延时任务 执行后自动释放
+ * 
+ * 可在中断中调用(包括多个优先级的中断), 请求先写入队列, 由调度器在下一次调度时挂入时间轮, `stimer_init`之后即可使用
+ * 调度器申请节点失败时请求保留在队列中重试, 返回成功的请求不会丢失
  * 
  * @param task_f 任务函数指针
  * @param ms 指定毫秒后执行
- * @return bool 成功返回true，失败返回false
+ * @return bool 成功返回true，队列已满返回false
  */
 bool defer_task_create(stimer_f task_f, uint32_t ms);
 
+typedef struct stimer_task *stimer_timer_handle;
+typedef void (*stimer_timer_cb)(void *arg);
+
+/* 以下单次定时器接口只能在调度器上下文(任务或定时器回调)中调用, 不可在中断中调用 */
+
+/**
+ * @brief 创建单次定时器 创建后处于停止状态
+ * 
+ * @param cb 到期回调
+ * @param arg 回调参数
+ * @return stimer_timer_handle 成功返回句柄，失败返回NULL
+ */
+stimer_timer_handle stimer_timer_create(stimer_timer_cb cb, void *arg);
+
+/**
+ * @brief 启动单次定时器 已启动时重新计时
+ * 
+ * @param timer 定时器句柄
+ * @param ms 指定毫秒后到期
+ * @return bool 成功返回true，失败返回false
+ */
+bool stimer_timer_start(stimer_timer_handle timer, uint32_t ms);
+
+/**
+ * @brief 停止单次定时器
+ * 
+ * @param timer 定时器句柄
+ * @return bool 定时器已启动且被停止返回true，否则返回false
+ */
+bool stimer_timer_stop(stimer_timer_handle timer);
+
+/**
+ * @brief 单次定时器是否已启动且未到期
+ * 
+ * @param timer 定时器句柄
+ * @return bool 
+ */
+bool stimer_timer_is_active(stimer_timer_handle timer);
+
+/**
+ * @brief 删除单次定时器 未到期时会先停止 可在自身回调中调用
+ * 
+ * @param timer 定时器句柄
+ */
+void stimer_timer_delete(stimer_timer_handle timer);
+
+typedef struct stimer_task *stimer_event_handle;
+
+/**
+ * @brief 创建事件任务 事件任务不按周期执行, 在被`stimer_event_post`触发后的下一次调度循环中执行
+ * 
+ * 多次触发在执行前只会合并为一次执行, 配合`evt_queue`使用时应在任务中取完队列中的所有事件
+ * 
+ * @param task_f 任务函数
+ * @param arg 任务参数
+ * @return stimer_event_handle 成功返回句柄，失败返回NULL
+ */
+stimer_event_handle stimer_event_task_create(stimer_timer_cb task_f, void *arg);
+
+/**
+ * @brief 触发事件任务 可在中断中调用
+ * 
+ * @param event 事件任务句柄
+ */
+void stimer_event_post(stimer_event_handle event);
+
+/**
+ * @brief 删除事件任务 只能在调度器上下文中调用, 可在自身回调中调用, 不可在其他事件任务的回调中调用
+ * 
+ * @param event 事件任务句柄
+ */
+void stimer_event_task_delete(stimer_event_handle event);
+
 /**
  * @brief 开启调度
  * 
@@ -35,7 +35,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
-#include "utils/list.h"
+#include <stdbool.h>
 
 enum hash_error {
 	HASH_KEY_NOT_FOUND = -2, // 键不存在
@@ -43,28 +43,40 @@ enum hash_error {
 	HASH_SUCCESS,			 // 无错误
 };
 
+// 槽位 开放寻址(线性探测), 保存键的哈希值, 查找时只有哈希值相同才比较字符串
 struct string_hash_node {
-	char *key;
-	void *private;
-	list_item list;
+	const char *key; // 键 NULL为空槽位
+	void *private;	 // 存储的数据
+	uint32_t hash;	 // 键的完整哈希值
+	uint8_t state;	 // 槽位状态
+	bool owned;		 // 键由哈希表拷贝, 删除时释放
 };
 
+// 遍历游标 使用`HASH_ITER_INIT`初始化
+struct hash_iter {
+	size_t index; // 下一个检查的槽位
+};
+
+#define HASH_ITER_INIT { 0 }
+
 struct hash_table {
-	list_item *table;
-	size_t table_size;
+	struct string_hash_node *table; // 槽位数组
+	size_t table_size;				// 槽位个数 2的幂
+	size_t count;					// 键的个数
+	size_t used;					// 已使用的槽位个数 包含已删除的槽位
 };
 
 /**
  * @brief 哈希表初始化
  *
  * @param hash_table 一个实例
- * @param table_size 哈希表大小,建议为所有需要哈希处理的键大小的2-3倍
+ * @param table_size 哈希表大小,建议为所有需要哈希处理的键大小的2-3倍 向上取整为2的幂, 使用超过3/4时自动扩容
  * @return enum hash_error 错误码
  */
 enum hash_error init_hash_table(struct hash_table *hash_table, size_t table_size);
 
 /**
- * @brief 哈希插入
+ * @brief 哈希插入 键会被拷贝
  *
  * @param hash_table 表实例
  * @param key 字符串
@@ -73,6 +85,16 @@ enum hash_error init_hash_table(struct hash_table *hash_table, size_t table_size
  */
 enum hash_error hash_insert(struct hash_table *hash_table, const char *key, void *private);
 
+/**
+ * @brief 哈希插入 不拷贝键, 直接引用调用者的字符串
+ *
+ * @param hash_table 表实例
+ * @param key 字符串 在删除之前必须一直有效, 例如常量字符串
+ * @param private 需要存储数据的指针
+ * @return enum hash_error 错误码
+ */
+enum hash_error hash_insert_static(struct hash_table *hash_table, const char *key, void *private);
+
 /**
  * @brief 哈希查找
  *
@@ -93,7 +115,7 @@ void *hash_find(struct hash_table *hash_table, const char *key, enum hash_error
 enum hash_error hash_delete(struct hash_table *hash_table, const char *key);
 
 /**
- * @brief 获取哈希表中所有的键
+ * @brief 获取哈希表中所有的键 每个键都会被拷贝, 使用后需要逐个释放, 只需遍历时建议使用`hash_iter_next`
  *
  * @param hash_table 表实例
  * @param keys 输出参数，用于存储所有的键
@@ -102,6 +124,27 @@ enum hash_error hash_delete(struct hash_table *hash_table, const char *key);
  */
 enum hash_error hash_get_all_keys(struct hash_table *hash_table, char ***keys, size_t *num_keys);
 
+/**
+ * @brief 遍历哈希表 原地返回下一个键, 不申请内存
+ * 遍历期间不能插入或删除键, 顺序与插入顺序无关
+ *
+ * @param hash_table 表实例
+ * @param iter 遍历游标
+ * @param key 输出参数 键 不需要时设为NULL
+ * @param private 输出参数 存储的指针 不需要时设为NULL
+ * @return bool 遍历结束返回false
+ */
+bool hash_iter_next(struct hash_table *hash_table, struct hash_iter *iter, const char **key, void **private);
+
+/**
+ * @brief 调整哈希表大小 重新放置所有键, 不重新计算哈希值
+ *
+ * @param hash_table 表实例
+ * @param table_size 新的大小 向上取整为2的幂, 不能小于键的个数
+ * @return enum hash_error 错误码
+ */
+enum hash_error hash_resize(struct hash_table *hash_table, size_t table_size);
+
 /**
  * @brief 删除表
  *
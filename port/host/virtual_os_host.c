@@ -0,0 +1,136 @@
+/**
+ * @file virtual_os_host.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 主机(x86/Linux)平台移植 模拟调度定时器
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include <time.h>
+
+#include "port/virtual_os_host.h"
+
+static struct {
+	stimer_timeout_process f_timeout; // 节拍回调 tickless模式下不使用
+	uint64_t start_ns;				  // 调度开始时间
+	uint32_t period_ms;				  // 节拍周期
+	uint32_t announced;				  // 已上报的节拍数
+	uint32_t wake;					  // 下一次唤醒的节拍
+	bool virtual_time;				  // 是否使用虚拟时间
+} host_timer;
+
+static uint64_t host_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// 自调度开始以来的实际节拍数
+static uint32_t host_elapsed_ticks(void)
+{
+	return (uint32_t)((host_now_ns() - host_timer.start_ns) / (host_timer.period_ms * 1000000ULL));
+}
+
+static void host_timer_init(uint32_t period_ms, stimer_timeout_process f_timeout)
+{
+	host_timer.period_ms = period_ms ? period_ms : 1;
+	host_timer.f_timeout = f_timeout;
+}
+
+static void host_timer_start(void)
+{
+	host_timer.start_ns = host_now_ns();
+	host_timer.announced = 0;
+	host_timer.wake = 1;
+}
+
+static void host_timer_set_alarm(uint32_t ticks)
+{
+	host_timer.wake = host_timer.announced + (ticks ? ticks : 1);
+}
+
+/**
+ * @brief 休眠到下一个到期任务 之后上报经过的节拍数
+ * 
+ * 实际时间下休眠期间任务执行已经消耗的时间会一并补齐
+ */
+static void host_timer_sleep(void)
+{
+	uint32_t now;
+	uint64_t wake_ns;
+	struct timespec ts;
+
+	if (stimer_wakeup_pending())
+		return;
+
+	if (host_timer.virtual_time) {
+		now = ((int32_t)(host_timer.wake - host_timer.announced) > 0) ? host_timer.wake : host_timer.announced + 1;
+		stimer_tick_announce(now - host_timer.announced);
+		host_timer.announced = now;
+		return;
+	}
+
+	now = host_elapsed_ticks();
+	if ((int32_t)(host_timer.wake - now) > 0) {
+		wake_ns = host_timer.start_ns + (uint64_t)host_timer.wake * host_timer.period_ms * 1000000ULL;
+		ts.tv_sec = wake_ns / 1000000000ULL;
+		ts.tv_nsec = wake_ns % 1000000000ULL;
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+		now = host_elapsed_ticks();
+	}
+
+	if (now != host_timer.announced) {
+		stimer_tick_announce(now - host_timer.announced);
+		host_timer.announced = now;
+	}
+}
+
+static uint32_t host_timer_get_cycle(void)
+{
+	return (uint32_t)host_now_ns();
+}
+
+static struct timer_port host_port = {
+	.f_init = host_timer_init,
+	.f_start = host_timer_start,
+	.f_set_alarm = host_timer_set_alarm,
+	.f_sleep = host_timer_sleep,
+	.f_get_cycle = host_timer_get_cycle,
+};
+
+struct timer_port *host_timer_port(bool virtual_time)
+{
+	host_timer.virtual_time = virtual_time;
+	return &host_port;
+}
+
+uint32_t host_timer_ticks(void)
+{
+	return host_timer.announced;
+}
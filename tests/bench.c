@@ -0,0 +1,203 @@
+/**
+ * @file bench.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 主机性能测试 输出调度、内存分配、队列和Modbus协议栈的耗时, 时间单位均为纳秒
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "core/virtual_os_mm.h"
+#include "port/virtual_os_host.h"
+#include "protocol/modbus/modbus.h"
+#include "utils/queue.h"
+#include "utils/stimer.h"
+
+#define BENCH_HEAP_SIZE (256 * 1024)
+#define BENCH_QUEUE_BYTES (16 * 1024 * 1024) // 队列吞吐测试的总字节数
+#define BENCH_ALLOC_ROUNDS (100000)			 // 内存分配测试的次数
+#define BENCH_TASK_NUM (64)					 // 调度测试的周期任务个数
+#define BENCH_DISPATCH_TICKS (100000)		 // 调度测试的节拍数
+
+// 伪随机数 结果可重复
+static uint32_t bench_rand(void)
+{
+	static uint32_t seed = 2463534242U;
+
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+// 按块写入再读出 单生产者单消费者的典型用法
+static void bench_queue_bulk(size_t chunk)
+{
+	static uint8_t buf[4096];
+	uint8_t data[256], out[256];
+	struct queue_info q;
+	size_t total = 0;
+
+	memset(data, 0x5A, sizeof(data));
+	queue_init(&q, 1, buf, sizeof(buf));
+
+	uint64_t start = test_now_ns();
+	while (total < BENCH_QUEUE_BYTES) {
+		while (queue_remain_space(&q) >= chunk)
+			queue_add(&q, data, chunk);
+		while (queue_get(&q, out, chunk) == chunk)
+			total += chunk;
+	}
+	uint64_t ns = test_now_ns() - start;
+
+	printf("queue  add/get %3zu B     %8.1f MB/s\n", chunk, (double)total * 1000.0 / ns);
+}
+
+// 零拷贝读入和释放
+static void bench_queue_contig(void)
+{
+	static uint8_t buf[4096];
+	struct queue_info q;
+	size_t total = 0;
+	void *ptr;
+	size_t len;
+
+	queue_init(&q, 1, buf, sizeof(buf));
+
+	uint64_t start = test_now_ns();
+	while (total < BENCH_QUEUE_BYTES) {
+		while ((len = queue_reserve_contig(&q, &ptr)) != 0) {
+			memset(ptr, 0x5A, len);
+			queue_commit(&q, len);
+		}
+		while ((len = queue_peek_contig(&q, &ptr)) != 0) {
+			total += len;
+			queue_release(&q, len);
+		}
+	}
+	uint64_t ns = test_now_ns() - start;
+
+	printf("queue  contig          %8.1f MB/s\n", (double)total * 1000.0 / ns);
+}
+
+// 随机大小的申请和乱序释放 统计单次申请的平均和最大耗时
+static void bench_alloc(void)
+{
+	void *slots[64] = { 0 };
+	uint64_t total = 0, worst = 0;
+	uint32_t count = 0, failed = 0;
+
+	for (uint32_t i = 0; i < BENCH_ALLOC_ROUNDS; i++) {
+		uint32_t idx = bench_rand() % 64;
+
+		if (slots[idx]) {
+			virtual_os_free(slots[idx]);
+			slots[idx] = NULL;
+			continue;
+		}
+
+		size_t size = 8 + bench_rand() % 512;
+		uint64_t start = test_now_ns();
+		slots[idx] = virtual_os_malloc(size);
+		uint64_t ns = test_now_ns() - start;
+
+		total += ns;
+		if (ns > worst)
+			worst = ns;
+		if (!slots[idx])
+			failed++;
+		count++;
+	}
+
+	for (int i = 0; i < 64; i++) {
+		if (slots[i])
+			virtual_os_free(slots[i]);
+	}
+
+	printf("malloc avg %6.1f ns worst %6lu ns (%lu allocs, %lu failed)\n", (double)total / (count ? count : 1),
+		(unsigned long)worst, (unsigned long)count, (unsigned long)failed);
+}
+
+static void bench_modbus(void)
+{
+	static char out[2048];
+
+	if (mb_bench_run(1000, false, out, sizeof(out))) {
+		printf("modbus RTU\n%s", out);
+	}
+	if (mb_bench_run(1000, true, out, sizeof(out))) {
+		printf("modbus TCP\n%s", out);
+	}
+}
+
+static volatile uint32_t task_runs;
+static uint64_t dispatch_start;
+
+static void bench_task(void)
+{
+	task_runs++;
+}
+
+// 调度结束 输出每个节拍和每次任务执行的平均耗时
+static void bench_dispatch_done(void *arg)
+{
+	(void)arg;
+
+	uint64_t ns = test_now_ns() - dispatch_start;
+
+	printf("stimer %u tasks, %u ticks: %6.1f ns/tick %6.1f ns/run\n", BENCH_TASK_NUM, BENCH_DISPATCH_TICKS,
+		(double)ns / BENCH_DISPATCH_TICKS, (double)ns / (task_runs ? task_runs : 1));
+	exit(0);
+}
+
+int main(void)
+{
+	if (!virtual_os_mm_init(BENCH_HEAP_SIZE) || !stimer_init(host_timer_port(true)))
+		return 1;
+
+	bench_modbus();
+	bench_queue_bulk(1);
+	bench_queue_bulk(16);
+	bench_queue_bulk(256);
+	bench_queue_contig();
+	bench_alloc();
+
+	// 虚拟时间下每个节拍都有任务到期 耗时只包含调度和空任务本身
+	for (uint32_t i = 0; i < BENCH_TASK_NUM; i++)
+		stimer_task_create(NULL, bench_task, 1 + i % 16);
+
+	stimer_timer_handle done = stimer_timer_create(bench_dispatch_done, NULL);
+	stimer_timer_start(done, BENCH_DISPATCH_TICKS);
+
+	dispatch_start = test_now_ns();
+	stimer_start();
+
+	return 1;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file test.h
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 主机单元测试和性能测试的公共定义
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#ifndef __VIRTUAL_OS_TEST_H__
+#define __VIRTUAL_OS_TEST_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+/**
+ * @brief 每个测试程序只包含一次 检查失败时打印位置并继续执行, `test_result`的返回值作为进程退出码交给ctest
+ * 
+ * int main(void)
+ * {
+ * 	TEST_RUN(test_xxx);
+ * 	return test_result();
+ * }
+ */
+
+static int test_checks;	  // 检查次数
+static int test_failures; // 失败次数
+
+#define TEST_CHECK(cond)                                                                                               \
+	do {                                                                                                               \
+		test_checks++;                                                                                                 \
+		if (!(cond)) {                                                                                                 \
+			test_failures++;                                                                                           \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);                                            \
+		}                                                                                                              \
+	} while (0)
+
+// 比较两个整数 失败时打印两边的值
+#define TEST_CHECK_EQ(a, b)                                                                                            \
+	do {                                                                                                               \
+		long long _a = (long long)(a), _b = (long long)(b);                                                            \
+		test_checks++;                                                                                                 \
+		if (_a != _b) {                                                                                                \
+			test_failures++;                                                                                           \
+			printf("%s:%d: check failed: %s == %s (%lld != %lld)\n", __FILE__, __LINE__, #a, #b, _a, _b);              \
+		}                                                                                                              \
+	} while (0)
+
+// 执行一个测试用例并打印结果
+#define TEST_RUN(fn)                                                                                                   \
+	do {                                                                                                               \
+		int _before = test_failures;                                                                                   \
+		fn();                                                                                                          \
+		printf("[%s] %s\n", test_failures == _before ? " OK " : "FAIL", #fn);                                          \
+	} while (0)
+
+/**
+ * @brief 打印统计结果
+ * 
+ * @return int 有检查失败返回1 否则返回0
+ */
+static inline int test_result(void)
+{
+	printf("%d checks, %d failures\n", test_checks, test_failures);
+	return test_failures ? 1 : 0;
+}
+
+/**
+ * @brief 单调时钟的纳秒计数 用于性能测试
+ * 
+ * @return uint64_t 
+ */
+static inline uint64_t test_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#endif /* __VIRTUAL_OS_TEST_H__ */
@@ -0,0 +1,311 @@
+/**
+ * @file test_button.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 按键单元测试 按键组与单个按键的事件序列一致, 中断唤醒模式空闲后停止扫描
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "core/virtual_os_mm.h"
+#include "port/virtual_os_host.h"
+#include "utils/button.h"
+#include "utils/stimer.h"
+
+#define KEY_NUM	   (45)	  // 两组 第二组只有部分按键
+#define TRACE_LEN  (5000) // 随机电平序列的扫描次数
+#define LONG_CNT   (20)
+#define UP_CNT	   (6)
+#define EVENTS_MAX (8192)
+#define WAKE_KEY   (3)	  // 中断唤醒测试中按下的按键组按键
+#define WAKE_MS	   (10)	  // 中断唤醒模式的扫描周期
+
+struct key_event {
+	uint16_t key;
+	uint8_t type;
+	uint32_t clicks;
+};
+
+struct event_log {
+	struct key_event ev[EVENTS_MAX];
+	uint32_t num;
+};
+
+static struct event_log group_log, single_log;
+
+static bool pressed[KEY_NUM];		// 当前按下的按键
+static enum button_level active_lv; // 当前测试的有效电平
+static uint16_t cur_key;			// 正在扫描的单个按键
+
+static void log_event(struct event_log *log, uint16_t key, const struct btn_ev_data *ev)
+{
+	if (log->num >= EVENTS_MAX)
+		return;
+
+	log->ev[log->num].key = key;
+	log->ev[log->num].type = (uint8_t)ev->ev_type;
+	log->ev[log->num].clicks = ev->clicks;
+	log->num++;
+}
+
+// 按键的IO电平
+static uint8_t key_level(uint16_t key)
+{
+	return pressed[key] == (active_lv == BUTTON_LEVEL_HIGH);
+}
+
+static uint8_t single_read(void)
+{
+	return key_level(cur_key);
+}
+
+static uint32_t group_read(uint8_t word)
+{
+	uint32_t bits = 0;
+
+	for (uint16_t bit = 0; bit < BTN_GROUP_WORD_BITS; bit++) {
+		uint16_t key = word * BTN_GROUP_WORD_BITS + bit;
+		if (key < KEY_NUM && key_level(key))
+			bits |= 1UL << bit;
+	}
+
+	return bits;
+}
+
+static void single_cb(const struct btn_ev_data *ev)
+{
+	log_event(&single_log, cur_key, ev);
+}
+
+static void group_cb(uint16_t key, const struct btn_ev_data *ev)
+{
+	log_event(&group_log, key, ev);
+}
+
+// 同一段随机电平序列分别送入按键组和同样数量的单个按键 两者的事件序列应完全相同
+static void group_equiv(enum button_level lv)
+{
+	static const struct btn_cfg single_cfg_tmpl = { single_read, LONG_CNT, UP_CNT, BUTTON_LEVEL_LOW };
+	struct btn_group_cfg group_cfg = { group_read, KEY_NUM, LONG_CNT, UP_CNT, lv };
+	struct btn_cfg single_cfg = single_cfg_tmpl;
+	btn_handle keys[KEY_NUM];
+	uint32_t hold[KEY_NUM] = { 0 };
+	uint32_t types[USR_BTN_EV_LONG_CLICK + 1] = { 0 };
+
+	active_lv = lv;
+	single_cfg.active_lv = lv;
+	memset(pressed, 0, sizeof(pressed));
+	group_log.num = 0;
+	single_log.num = 0;
+
+	btn_group_handle grp = button_group_ctor(&group_cfg, group_cb);
+	TEST_CHECK(grp != NULL);
+	for (uint16_t i = 0; i < KEY_NUM; i++) {
+		keys[i] = button_ctor(&single_cfg, single_cb);
+		TEST_CHECK(keys[i] != NULL);
+	}
+	if (!grp)
+		return;
+
+	srand(lv + 1);
+	for (uint32_t step = 0; step < TRACE_LEN; step++) {
+		// 每个按键随机保持一段时间后翻转 包含单次扫描的抖动、连击和长按
+		for (uint16_t i = 0; i < KEY_NUM; i++) {
+			if (hold[i]--)
+				continue;
+			pressed[i] = !pressed[i];
+			hold[i] = (rand() % 4 == 0) ? 0 : (uint32_t)(rand() % (LONG_CNT + UP_CNT * 2));
+		}
+
+		button_group_scan(grp);
+		for (cur_key = 0; cur_key < KEY_NUM; cur_key++)
+			button_scan(keys[cur_key]);
+	}
+
+	TEST_CHECK(group_log.num < EVENTS_MAX);
+	TEST_CHECK_EQ(group_log.num, single_log.num);
+	for (uint32_t i = 0; i < group_log.num && i < single_log.num; i++) {
+		const struct key_event *a = &group_log.ev[i];
+		const struct key_event *b = &single_log.ev[i];
+
+		if (a->key != b->key || a->type != b->type || a->clicks != b->clicks) {
+			printf("event %u differs: key %u/%u type %u/%u clicks %u/%u\n", (unsigned)i, a->key, b->key, a->type,
+				b->type, (unsigned)a->clicks, (unsigned)b->clicks);
+			TEST_CHECK(false);
+			break;
+		}
+		types[a->type]++;
+	}
+
+	// 序列覆盖所有事件类型
+	for (uint32_t t = USR_BTN_EV_SINGLE_CLICK; t <= USR_BTN_EV_LONG_CLICK; t++)
+		TEST_CHECK(types[t] > 0);
+
+	button_group_destroy(grp);
+	for (uint16_t i = 0; i < KEY_NUM; i++)
+		button_destroy(keys[i]);
+}
+
+static void test_group_equiv(void)
+{
+	group_equiv(BUTTON_LEVEL_LOW);
+	group_equiv(BUTTON_LEVEL_HIGH);
+}
+
+enum wake_act {
+	WAKE_PRESS,	  // 按下并触发边沿中断
+	WAKE_RELEASE, // 弹起并触发边沿中断
+	WAKE_SNAP,	  // 记录IO读取次数
+	WAKE_FINISH,  // 检查结果并退出
+};
+
+static const struct {
+	uint32_t ms;
+	enum wake_act act;
+} wake_script[] = {
+	{ 50, WAKE_PRESS },	 { 100, WAKE_RELEASE }, { 400, WAKE_SNAP },	 { 590, WAKE_SNAP },
+	{ 600, WAKE_PRESS }, { 650, WAKE_RELEASE }, { 900, WAKE_SNAP },	 { 1000, WAKE_SNAP },
+	{ 1000, WAKE_FINISH },
+};
+
+static btn_handle wake_btn;
+static btn_group_handle wake_grp;
+static stimer_timer_handle wake_timer;
+static uint32_t wake_pos;
+static bool wake_down;
+
+static uint32_t single_reads, group_reads;	 // IO读取次数 即扫描次数
+static uint32_t single_clicks, group_clicks; // 单击事件次数
+static uint32_t single_snap[4], group_snap[4];
+static uint32_t snap_num;
+
+static uint8_t wake_single_read(void)
+{
+	single_reads++;
+	return wake_down ? 0 : 1;
+}
+
+static uint32_t wake_group_read(uint8_t word)
+{
+	(void)word;
+
+	group_reads++;
+	return wake_down ? ~(1UL << WAKE_KEY) : UINT32_MAX;
+}
+
+static void wake_single_cb(const struct btn_ev_data *ev)
+{
+	if (ev->ev_type == USR_BTN_EV_SINGLE_CLICK)
+		single_clicks++;
+}
+
+static void wake_group_cb(uint16_t key, const struct btn_ev_data *ev)
+{
+	if (key == WAKE_KEY && ev->ev_type == USR_BTN_EV_SINGLE_CLICK)
+		group_clicks++;
+}
+
+static void wake_check(void)
+{
+	// 使能时扫描一次 所有按键空闲后停止扫描
+	TEST_CHECK(single_snap[0] > 0);
+	TEST_CHECK(group_snap[0] > 0);
+	TEST_CHECK_EQ(single_snap[1], single_snap[0]);
+	TEST_CHECK_EQ(group_snap[1], group_snap[0]);
+
+	// 边沿中断重新开始扫描 单击判定结束后再次停止
+	TEST_CHECK(single_snap[2] > single_snap[1]);
+	TEST_CHECK(group_snap[2] > group_snap[1]);
+	TEST_CHECK(single_snap[2] - single_snap[1] < 300 / WAKE_MS);
+	TEST_CHECK(group_snap[2] - group_snap[1] < 300 / WAKE_MS);
+	TEST_CHECK_EQ(single_snap[3], single_snap[2]);
+	TEST_CHECK_EQ(group_snap[3], group_snap[2]);
+
+	TEST_CHECK_EQ(single_clicks, 2);
+	TEST_CHECK_EQ(group_clicks, 2);
+}
+
+static void wake_step(void *arg)
+{
+	(void)arg;
+
+	switch (wake_script[wake_pos].act) {
+	case WAKE_PRESS:
+	case WAKE_RELEASE:
+		wake_down = wake_script[wake_pos].act == WAKE_PRESS;
+		button_wakeup(wake_btn);
+		button_group_wakeup(wake_grp);
+		break;
+	case WAKE_SNAP:
+		single_snap[snap_num] = single_reads;
+		group_snap[snap_num] = group_reads;
+		snap_num++;
+		break;
+	case WAKE_FINISH: {
+		int before = test_failures;
+		wake_check();
+		printf("[%s] test_wake\n", test_failures == before ? " OK " : "FAIL");
+		exit(test_result());
+	}
+	}
+
+	wake_pos++;
+	TEST_CHECK(stimer_timer_start(wake_timer, wake_script[wake_pos].ms - wake_script[wake_pos - 1].ms));
+}
+
+// 中断唤醒模式 按键空闲后不再重新启动扫描定时器, 边沿中断后恢复扫描
+static void test_wake(void)
+{
+	static const struct btn_cfg single_cfg = { wake_single_read, LONG_CNT, UP_CNT, BUTTON_LEVEL_LOW };
+	static const struct btn_group_cfg group_cfg = { wake_group_read, 8, LONG_CNT, UP_CNT, BUTTON_LEVEL_LOW };
+
+	TEST_CHECK(stimer_init(host_timer_port(true)));
+
+	wake_btn = button_ctor(&single_cfg, wake_single_cb);
+	wake_grp = button_group_ctor(&group_cfg, wake_group_cb);
+	TEST_CHECK(button_irq_enable(wake_btn, WAKE_MS));
+	TEST_CHECK(button_group_irq_enable(wake_grp, WAKE_MS));
+
+	wake_timer = stimer_timer_create(wake_step, NULL);
+	TEST_CHECK(wake_timer != NULL);
+	TEST_CHECK(stimer_timer_start(wake_timer, wake_script[0].ms));
+
+	stimer_start();
+}
+
+int main(void)
+{
+	TEST_CHECK(virtual_os_mm_init(64 * 1024));
+
+	TEST_RUN(test_group_equiv);
+	test_wake();
+
+	return 1;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file test_driver.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 设备注册单元测试 设备名拷贝、同名设备和超长设备名
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include <string.h>
+
+#include "test.h"
+#include "core/virtual_os_mm.h"
+#include "driver/virtual_os_driver.h"
+
+static const struct file_operations dummy_opts = { 0 };
+static int init_calls;
+
+static bool dummy_init(struct drv_device *dev)
+{
+	(void)dev;
+
+	init_calls++;
+	return true;
+}
+
+static struct virtual_os_mm_stats stats_get(void)
+{
+	struct virtual_os_mm_stats stats = { 0 };
+
+	TEST_CHECK(virtual_os_mm_get_stats(&stats));
+	return stats;
+}
+
+static void test_copy_name(void)
+{
+	char name[VIRTUALOS_MAX_DEV_NAME_LEN] = "uart1";
+
+	TEST_CHECK(driver_register(dummy_init, &dummy_opts, name));
+
+	// 设备名被拷贝 调用者的缓冲区可以复用
+	strcpy(name, "other");
+	TEST_CHECK(find_device("uart1") != NULL);
+	TEST_CHECK(find_device("other") == NULL);
+}
+
+static void test_duplicate(void)
+{
+	struct drv_device *dev = find_device("uart1");
+	struct virtual_os_mm_stats before = stats_get();
+	int calls = init_calls;
+
+	// 同名设备注册失败 不调用驱动初始化, 不泄漏内存, 原有设备不变
+	TEST_CHECK(!driver_register(dummy_init, &dummy_opts, "uart1"));
+	TEST_CHECK(!driver_register_static(dummy_init, &dummy_opts, "uart1"));
+	TEST_CHECK_EQ(init_calls, calls);
+	TEST_CHECK_EQ(stats_get().used, before.used);
+	TEST_CHECK(find_device("uart1") == dev);
+}
+
+static void test_long_name(void)
+{
+	char prefix[VIRTUALOS_MAX_DEV_NAME_LEN];
+
+	// 超长设备名截断保存 截断后相同的设备名视为同名
+	TEST_CHECK(driver_register_static(dummy_init, &dummy_opts, "a_very_long_device_name_1"));
+	TEST_CHECK(!driver_register(dummy_init, &dummy_opts, "a_very_long_device_name_2"));
+
+	memcpy(prefix, "a_very_long_device_name_1", sizeof(prefix) - 1);
+	prefix[sizeof(prefix) - 1] = '\0';
+	TEST_CHECK(find_device(prefix) != NULL);
+}
+
+int main(void)
+{
+	TEST_CHECK(virtual_os_mm_init(16 * 1024));
+
+	TEST_RUN(test_copy_name);
+	TEST_RUN(test_duplicate);
+	TEST_RUN(test_long_name);
+
+	return test_result();
+}
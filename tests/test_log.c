@@ -0,0 +1,230 @@
+/**
+ * @file test_log.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 日志管道单元测试
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include <string.h>
+
+#include "test.h"
+#include "utils/log.h"
+
+#define TASK_PERIOD_MS (10)
+
+// 输出端的接收缓冲
+struct capture {
+	char buf[8 * 1024];
+	size_t len;
+	size_t limit; // 每次写入最多接收的字节数 0:不限制
+};
+
+static struct capture out0, out1;
+
+static size_t capture_write(struct capture *c, uint8_t *buf, size_t len)
+{
+	if (c->limit && len > c->limit)
+		len = c->limit;
+	if (len > sizeof(c->buf) - 1 - c->len)
+		len = sizeof(c->buf) - 1 - c->len;
+
+	memcpy(c->buf + c->len, buf, len);
+	c->len += len;
+	c->buf[c->len] = '\0';
+	return len;
+}
+
+static size_t write0(uint8_t *buf, size_t len)
+{
+	return capture_write(&out0, buf, len);
+}
+
+static size_t write1(uint8_t *buf, size_t len)
+{
+	return capture_write(&out1, buf, len);
+}
+
+static void capture_reset(void)
+{
+	out0.len = out1.len = 0;
+	out0.buf[0] = out1.buf[0] = '\0';
+}
+
+// 运行日志任务直到输出结束
+static void run_task(int times)
+{
+	for (int i = 0; i < times; i++)
+		syslog_task();
+}
+
+// 统计子串出现的次数
+static int count_of(const char *s, const char *sub)
+{
+	int n = 0;
+
+	while ((s = strstr(s, sub)) != NULL) {
+		n++;
+		s += strlen(sub);
+	}
+
+	return n;
+}
+
+static const char app_name[] = "app";
+static const char net_name[] = "net";
+static uint32_t app_mask, net_mask;
+static int sink1;
+
+static void test_format(void)
+{
+	capture_reset();
+	log_i(app_mask, "hello %d %s\n", 42, "world");
+	TEST_CHECK_EQ(out0.len, 0); // 日志在任务中输出
+
+	run_task(1);
+	TEST_CHECK(strstr(out0.buf, "[INFO ] [app") != NULL);
+	TEST_CHECK(strstr(out0.buf, "hello 42 world\n") != NULL);
+}
+
+static void test_filter(void)
+{
+	capture_reset();
+
+	syslog_set_level(LOG_LEVEL_WARN);
+	log_i(app_mask, "filtered info\n");
+	log_w(app_mask, "kept warn\n");
+	syslog_set_level(LOG_LEVEL_ALL);
+
+	set_log_module_mask(net_mask);
+	log_e(app_mask, "filtered module\n");
+	log_e(net_mask, "kept module\n");
+	enable_all_mask();
+
+	run_task(1);
+	TEST_CHECK(strstr(out0.buf, "filtered") == NULL);
+	TEST_CHECK(strstr(out0.buf, "kept warn") != NULL);
+	TEST_CHECK(strstr(out0.buf, "kept module") != NULL);
+}
+
+static void test_partial_write(void)
+{
+	capture_reset();
+	out0.limit = 5;
+
+	for (int i = 0; i < 4; i++)
+		log_i(app_mask, "partial %d\n", i);
+
+	// 输出接口每次只接收5个字节 剩余数据保留到下次任务
+	run_task(1);
+	TEST_CHECK(out0.len < 4 * 5 * 10);
+	run_task(200);
+	TEST_CHECK(strstr(out0.buf, "partial 0\n") != NULL);
+	TEST_CHECK(strstr(out0.buf, "partial 3\n") != NULL);
+	out0.limit = 0;
+}
+
+static void test_overflow(void)
+{
+	struct syslog_stats before, after;
+
+	run_task(LOG_DROP_REPORT_MS / TASK_PERIOD_MS); // 先清空上报间隔
+	capture_reset();
+	syslog_get_stats(0, &before);
+
+	// 任务运行前连续写满缓冲区 多出的日志被丢弃, 连续丢弃只计一次溢出
+	int total = LOG_BUFFER_SIZE / 32 + 20;
+	for (int i = 0; i < total; i++)
+		log_i(app_mask, "overflow %02d ..........\n", i);
+
+	syslog_get_stats(0, &after);
+	TEST_CHECK(after.dropped > before.dropped);
+	TEST_CHECK_EQ(after.overrun, before.overrun + 1);
+
+	run_task(LOG_DROP_REPORT_MS / TASK_PERIOD_MS + 1);
+	TEST_CHECK_EQ(count_of(out0.buf, "overflow"), total - (int)(after.dropped - before.dropped));
+	TEST_CHECK(strstr(out0.buf, "logs dropped") != NULL);
+
+	// 没有新的丢弃时不重复上报
+	capture_reset();
+	run_task(LOG_DROP_REPORT_MS / TASK_PERIOD_MS + 1);
+	TEST_CHECK(strstr(out0.buf, "logs dropped") == NULL);
+}
+
+static void test_sinks(void)
+{
+	capture_reset();
+
+	// 1号输出端只接收错误日志
+	log_i(app_mask, "sink info\n");
+	log_e(app_mask, "sink error\n");
+	run_task(1);
+
+	TEST_CHECK(strstr(out0.buf, "sink info") != NULL);
+	TEST_CHECK(strstr(out0.buf, "sink error") != NULL);
+	TEST_CHECK(strstr(out1.buf, "sink info") == NULL);
+	TEST_CHECK(strstr(out1.buf, "sink error") != NULL);
+
+	// 限流 突发额度用完后丢弃, 不影响其他输出端
+	struct syslog_stats before, after;
+	syslog_get_stats(sink1, &before);
+	capture_reset();
+	for (int i = 0; i < 10; i++)
+		log_e(app_mask, "burst %d\n", i);
+	run_task(1);
+
+	syslog_get_stats(sink1, &after);
+	TEST_CHECK_EQ(count_of(out0.buf, "burst"), 10);
+	TEST_CHECK(count_of(out1.buf, "burst") < 10);
+	TEST_CHECK_EQ(after.limited - before.limited, 10 - count_of(out1.buf, "burst"));
+}
+
+int main(void)
+{
+	static uint8_t sink1_buf[1024];
+	struct syslog_sink_attr attr = {
+		.level = LOG_LEVEL_ERROR,
+		.rate = 400,
+		.burst = 200,
+	};
+
+	syslog_init(write0, TASK_PERIOD_MS);
+	app_mask = allocate_log_mask(app_name);
+	net_mask = allocate_log_mask(net_name);
+	TEST_CHECK(app_mask && net_mask && app_mask != net_mask);
+
+	sink1 = syslog_add_sink(write1, sink1_buf, sizeof(sink1_buf), &attr);
+	TEST_CHECK_EQ(sink1, 1);
+
+	TEST_RUN(test_format);
+	TEST_RUN(test_filter);
+	TEST_RUN(test_partial_write);
+	TEST_RUN(test_overflow);
+	TEST_RUN(test_sinks);
+
+	return test_result();
+}
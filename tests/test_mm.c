@@ -0,0 +1,154 @@
+/**
+ * @file test_mm.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief BGET内存管理单元测试
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include <string.h>
+
+#include "test.h"
+#include "core/virtual_os_mm.h"
+
+#define TEST_HEAP_SIZE (32 * 1024)
+
+static struct virtual_os_mm_stats stats_get(void)
+{
+	struct virtual_os_mm_stats stats = { 0 };
+
+	TEST_CHECK(virtual_os_mm_get_stats(&stats));
+	return stats;
+}
+
+static void test_alloc_free(void)
+{
+	struct virtual_os_mm_stats base = stats_get();
+	void *ptrs[32];
+
+	for (int i = 0; i < 32; i++) {
+		ptrs[i] = virtual_os_malloc(16 + i * 8);
+		TEST_CHECK(ptrs[i] != NULL);
+		memset(ptrs[i], i, 16 + i * 8);
+	}
+
+	struct virtual_os_mm_stats used = stats_get();
+	TEST_CHECK(used.used > base.used);
+	TEST_CHECK_EQ(used.allocs - base.allocs, 32);
+
+	// 内容互不覆盖
+	for (int i = 0; i < 32; i++) {
+		uint8_t *p = ptrs[i];
+		TEST_CHECK(p[0] == i && p[16 + i * 8 - 1] == i);
+	}
+
+	for (int i = 0; i < 32; i += 2)
+		virtual_os_free(ptrs[i]);
+	for (int i = 1; i < 32; i += 2)
+		virtual_os_free(ptrs[i]);
+
+	// 全部释放后空闲块合并
+	struct virtual_os_mm_stats after = stats_get();
+	TEST_CHECK_EQ(after.used, base.used);
+	TEST_CHECK_EQ(after.max_free, base.max_free);
+	TEST_CHECK(after.peak >= used.used);
+}
+
+static void test_calloc_realloc(void)
+{
+	uint8_t *p = virtual_os_calloc(64, 1);
+
+	TEST_CHECK(p != NULL);
+	for (int i = 0; i < 64; i++)
+		TEST_CHECK_EQ(p[i], 0);
+
+	for (int i = 0; i < 64; i++)
+		p[i] = (uint8_t)i;
+
+	// 扩大后保留原内容
+	p = virtual_os_realloc(p, 1024);
+	TEST_CHECK(p != NULL);
+	for (int i = 0; i < 64; i++)
+		TEST_CHECK_EQ(p[i], i);
+
+	virtual_os_free(p);
+}
+
+static void test_aligned(void)
+{
+	for (size_t align = 8; align <= 256; align <<= 1) {
+		void *p = virtual_os_aligned_malloc(40, align);
+
+		TEST_CHECK(p != NULL);
+		TEST_CHECK_EQ((uintptr_t)p & (align - 1), 0);
+		memset(p, 0xAA, 40);
+		virtual_os_aligned_free(p);
+	}
+}
+
+static void test_exhaust(void)
+{
+	struct virtual_os_mm_stats base = stats_get();
+	void *ptrs[64];
+	int n = 0;
+
+	// 超过内存池的申请失败并计数
+	TEST_CHECK(virtual_os_malloc(TEST_HEAP_SIZE * 2) == NULL);
+	TEST_CHECK_EQ(stats_get().failed, base.failed + 1);
+
+	while (n < 64 && (ptrs[n] = virtual_os_malloc(1024)) != NULL)
+		n++;
+	TEST_CHECK(n > 0 && n < 32);
+
+	// 内存池用完后追加的区域可以继续分配
+	static uint64_t region[8 * 1024 / sizeof(uint64_t)];
+	TEST_CHECK(virtual_os_mm_add_region(region, sizeof(region)));
+	TEST_CHECK_EQ(stats_get().total, base.total + sizeof(region));
+
+	int more = n;
+	while (more < 64 && (ptrs[more] = virtual_os_malloc(1024)) != NULL) {
+		uint8_t *p = ptrs[more++];
+		TEST_CHECK(p >= (uint8_t *)region && p < (uint8_t *)region + sizeof(region));
+	}
+	TEST_CHECK(more - n >= 6);
+
+	for (int i = 0; i < more; i++)
+		virtual_os_free(ptrs[i]);
+	TEST_CHECK_EQ(stats_get().used, base.used);
+}
+
+int main(void)
+{
+	TEST_CHECK(virtual_os_mm_init(TEST_HEAP_SIZE));
+
+	TEST_RUN(test_alloc_free);
+	TEST_RUN(test_calloc_realloc);
+	TEST_RUN(test_aligned);
+	TEST_RUN(test_exhaust);
+
+	return test_result();
+}
@@ -0,0 +1,200 @@
+/**
+ * @file test_qactive.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 主动对象单元测试 定时事件按投递顺序分发, 层次状态机嵌套层数检查
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include <stdlib.h>
+
+#include "test.h"
+#include "core/virtual_os_mm.h"
+#include "port/virtual_os_host.h"
+#include "utils/qactive.h"
+
+enum {
+	SIG_A = Q_APP_EVENT_TIMEOUT + 1,
+	SIG_B,
+	SIG_TICK,
+};
+
+struct app_evt {
+	qevent_t super;
+	uint32_t data;
+};
+
+struct app {
+	struct qactive super;
+	struct qtime_evt timeout;
+	struct qtime_evt tick;
+};
+
+static struct app app;
+static struct app_evt app_buf[4];
+
+static qsignal_t order[8];
+static uint32_t order_len;
+static bool timeout_fired_first; // 投递A时定时事件是否已经到期
+static uint32_t ticks, tick_last;
+static bool tick_jitter;
+
+static qstate app_run(struct app *me, qevent_t const *e)
+{
+	switch (e->sig) {
+	case SIG_A:
+	case SIG_B:
+	case Q_APP_EVENT_TIMEOUT:
+		if (order_len < 8)
+			order[order_len++] = e->sig;
+		return Q_HANDLED();
+	case SIG_TICK:
+		if (ticks++ && host_timer_ticks() - tick_last != 20)
+			tick_jitter = true;
+		tick_last = host_timer_ticks();
+		TEST_CHECK_EQ(((const struct app_evt *)e)->data, 0); // 未拷贝的部分为0
+		return Q_HANDLED();
+	default:
+		return Q_SUPER(qhsm_top);
+	}
+}
+
+static qstate app_initial(struct app *me, qevent_t const *e)
+{
+	(void)e;
+	return Q_HSM_TRAN(app_run);
+}
+
+// 与定时事件在同一个节拍投递 分发顺序与投递顺序一致
+static void post_ab(void *arg)
+{
+	(void)arg;
+
+	struct app_evt a = { { SIG_A }, 1 };
+	struct app_evt b = { { SIG_B }, 2 };
+
+	timeout_fired_first = !stimer_timer_is_active(app.timeout.timer);
+	TEST_CHECK(qactive_post(&app.super, &a));
+	TEST_CHECK(qactive_post(&app.super, &b));
+	TEST_CHECK_EQ(order_len, 0); // 定时器回调中只投递不分发
+}
+
+/* 嵌套层数测试 depth_N的父状态为depth_(N-1) */
+static uint32_t depth_entries;
+
+#define DEPTH_STATE(_n, _super)                                                                                        \
+	static qstate depth_##_n(qhsm_t *me, qevent_t const *e)                                                            \
+	{                                                                                                                  \
+		if (e->sig == Q_ENTRY_SIG) {                                                                                   \
+			depth_entries++;                                                                                           \
+			return Q_HANDLED();                                                                                        \
+		}                                                                                                              \
+		return Q_SUPER(_super);                                                                                        \
+	}
+
+DEPTH_STATE(1, qhsm_top)
+DEPTH_STATE(2, depth_1)
+DEPTH_STATE(3, depth_2)
+DEPTH_STATE(4, depth_3)
+DEPTH_STATE(5, depth_4)
+DEPTH_STATE(6, depth_5)
+DEPTH_STATE(7, depth_6)
+
+static qstate_handler depth_target;
+
+static qstate depth_initial(qhsm_t *me, qevent_t const *e)
+{
+	(void)e;
+	return Q_HSM_TRAN(depth_target);
+}
+
+static void test_depth(void)
+{
+	static const qevent_t init_evt = { (qsignal_t)Q_INIT_SIG };
+	qhsm_t hsm;
+
+	depth_target = (qstate_handler)depth_6;
+	depth_entries = 0;
+	TEST_CHECK(qhsm_init(&hsm, (qstate_handler)depth_initial, &init_evt));
+	TEST_CHECK_EQ(depth_entries, QHSM_MAX_DEPTH);
+	TEST_CHECK(qhsm_is_in(&hsm, (qstate_handler)depth_1));
+
+	// 超过最大层数时不进入任何状态
+	depth_target = (qstate_handler)depth_7;
+	depth_entries = 0;
+	TEST_CHECK(!qhsm_init(&hsm, (qstate_handler)depth_initial, &init_evt));
+	TEST_CHECK_EQ(depth_entries, 0);
+}
+
+static void finish(void *arg)
+{
+	(void)arg;
+
+	TEST_CHECK_EQ(order_len, 3);
+	if (timeout_fired_first) {
+		TEST_CHECK_EQ(order[0], Q_APP_EVENT_TIMEOUT);
+		TEST_CHECK_EQ(order[1], SIG_A);
+		TEST_CHECK_EQ(order[2], SIG_B);
+	} else {
+		TEST_CHECK_EQ(order[0], SIG_A);
+		TEST_CHECK_EQ(order[1], SIG_B);
+		TEST_CHECK_EQ(order[2], Q_APP_EVENT_TIMEOUT);
+	}
+
+	TEST_CHECK_EQ(ticks, (1000 - 20) / 20 + 1);
+	TEST_CHECK(!tick_jitter);
+	TEST_CHECK_EQ(evt_queue_take_drops(&app.super.eq), 0);
+
+	printf("[%s] test_qactive\n", test_failures ? "FAIL" : " OK ");
+	exit(test_result());
+}
+
+int main(void)
+{
+	TEST_CHECK(virtual_os_mm_init(64 * 1024));
+	TEST_CHECK(stimer_init(host_timer_port(true)));
+
+	test_depth();
+
+	TEST_CHECK(qactive_init(&app.super, (qstate_handler)app_initial, sizeof(struct app_evt), app_buf, 4));
+	TEST_CHECK(qtime_evt_init(&app.timeout, &app.super, Q_APP_EVENT_TIMEOUT));
+	TEST_CHECK(qtime_evt_init(&app.tick, &app.super, SIG_TICK));
+
+	stimer_timer_handle post = stimer_timer_create(post_ab, NULL);
+	TEST_CHECK(post != NULL);
+	TEST_CHECK(stimer_timer_start(post, 10));
+	TEST_CHECK(qtime_evt_arm(&app.timeout, 10, 0));
+	TEST_CHECK(qtime_evt_arm(&app.tick, 20, 20));
+
+	stimer_timer_handle done = stimer_timer_create(finish, NULL);
+	TEST_CHECK(done != NULL);
+	TEST_CHECK(stimer_timer_start(done, 1000 + 5));
+
+	stimer_start();
+
+	return 1;
+}
@@ -0,0 +1,204 @@
+/**
+ * @file test_queue.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 循环队列单元测试
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include <string.h>
+
+#include "test.h"
+#include "utils/queue.h"
+
+// 容量为2的幂和非2的幂时 读写和回绕结果一致
+static void check_wrap(size_t units)
+{
+	uint8_t buf[16];
+	uint8_t in[16], out[16];
+	struct queue_info q;
+
+	TEST_CHECK(queue_init(&q, 1, buf, units));
+	TEST_CHECK_EQ(q.mask, ((units & (units - 1)) == 0) ? units - 1 : 0);
+
+	for (int round = 0; round < 50; round++) {
+		size_t len = (size_t)(round % (int)units) + 1;
+
+		for (size_t i = 0; i < len; i++)
+			in[i] = (uint8_t)(round * 7 + i);
+
+		TEST_CHECK_EQ(queue_add(&q, in, len), len);
+		TEST_CHECK_EQ(queue_used(&q), len);
+		TEST_CHECK_EQ(queue_remain_space(&q), units - len);
+		TEST_CHECK_EQ(queue_peek(&q, out, len), len);
+		TEST_CHECK(memcmp(in, out, len) == 0);
+
+		memset(out, 0, sizeof(out));
+		TEST_CHECK_EQ(queue_get(&q, out, len), len);
+		TEST_CHECK(memcmp(in, out, len) == 0);
+		TEST_CHECK(is_queue_empty(&q));
+	}
+}
+
+static void test_wrap_pow2(void)
+{
+	check_wrap(16);
+}
+
+static void test_wrap_non_pow2(void)
+{
+	check_wrap(10);
+}
+
+static void test_full_and_partial(void)
+{
+	uint8_t buf[8], data[12];
+	struct queue_info q;
+
+	for (size_t i = 0; i < sizeof(data); i++)
+		data[i] = (uint8_t)i;
+
+	queue_init(&q, 1, buf, sizeof(buf));
+
+	// 空间不足时只写入剩余空间
+	TEST_CHECK_EQ(queue_add(&q, data, sizeof(data)), 8);
+	TEST_CHECK(is_queue_full(&q));
+	TEST_CHECK_EQ(queue_add(&q, data, 1), 0);
+
+	uint8_t out[12];
+	TEST_CHECK_EQ(queue_get(&q, out, sizeof(out)), 8);
+	TEST_CHECK(memcmp(out, data, 8) == 0);
+	TEST_CHECK_EQ(queue_get(&q, out, 1), 0);
+
+	// 参数错误
+	TEST_CHECK(!queue_init(&q, 1, NULL, 8));
+	TEST_CHECK(!queue_init(&q, 0, buf, 8));
+	TEST_CHECK_EQ(queue_add(NULL, data, 1), 0);
+}
+
+static void test_multi_byte_units(void)
+{
+	uint32_t buf[5], out[3];
+	uint32_t in[3] = { 0x11111111, 0x22222222, 0x33333333 };
+	struct queue_info q;
+
+	queue_init(&q, sizeof(uint32_t), buf, 5);
+
+	for (int i = 0; i < 10; i++) {
+		TEST_CHECK_EQ(queue_add(&q, in, 3), 3);
+		TEST_CHECK_EQ(queue_get(&q, out, 3), 3);
+		TEST_CHECK(memcmp(in, out, sizeof(in)) == 0);
+	}
+}
+
+static void test_contig(void)
+{
+	uint8_t buf[8];
+	struct queue_info q;
+	void *ptr;
+
+	queue_init(&q, 1, buf, sizeof(buf));
+
+	// 写索引在6时 连续可写空间只到缓冲区末尾
+	queue_advance_wr(&q, 6);
+	queue_advance_rd(&q, 6);
+	TEST_CHECK_EQ(queue_reserve_contig(&q, &ptr), 2);
+	TEST_CHECK(ptr == &buf[6]);
+
+	memcpy(ptr, "ab", 2);
+	queue_commit(&q, 2);
+	TEST_CHECK_EQ(queue_reserve_contig(&q, &ptr), 6);
+	TEST_CHECK(ptr == &buf[0]);
+	memcpy(ptr, "cd", 2);
+	queue_commit(&q, 2);
+
+	TEST_CHECK_EQ(queue_peek_contig(&q, &ptr), 2);
+	TEST_CHECK(memcmp(ptr, "ab", 2) == 0);
+	queue_release(&q, 2);
+	TEST_CHECK_EQ(queue_peek_contig(&q, &ptr), 2);
+	TEST_CHECK(memcmp(ptr, "cd", 2) == 0);
+	queue_release(&q, 2);
+	TEST_CHECK(is_queue_empty(&q));
+
+	// 提交和释放不会超过可用的空间
+	queue_commit(&q, 100);
+	TEST_CHECK_EQ(queue_used(&q), 8);
+	queue_release(&q, 100);
+	TEST_CHECK_EQ(queue_used(&q), 0);
+}
+
+static const uint8_t *fill_src;
+static size_t fill_left;
+
+static size_t fill_read(uint8_t *buf, size_t len)
+{
+	if (len > fill_left)
+		len = fill_left;
+
+	memcpy(buf, fill_src, len);
+	fill_src += len;
+	fill_left -= len;
+	return len;
+}
+
+static void test_fill(void)
+{
+	static const uint8_t src[] = "0123456789abcdef";
+	uint8_t buf[8], out[8];
+	struct queue_info q;
+
+	queue_init(&q, 1, buf, sizeof(buf));
+	queue_advance_wr(&q, 5);
+	queue_advance_rd(&q, 5);
+
+	// 跨越缓冲区末尾时分两段读入
+	fill_src = src;
+	fill_left = 16;
+	TEST_CHECK_EQ(queue_fill(&q, fill_read, 16), 8);
+	TEST_CHECK_EQ(fill_left, 8);
+	TEST_CHECK_EQ(queue_get(&q, out, 8), 8);
+	TEST_CHECK(memcmp(out, src, 8) == 0);
+
+	// 数据源不足时提前结束
+	TEST_CHECK_EQ(queue_fill(&q, fill_read, 4), 4);
+	TEST_CHECK_EQ(queue_fill(&q, fill_read, 8), 4);
+	TEST_CHECK_EQ(queue_fill(&q, fill_read, 8), 0);
+	TEST_CHECK_EQ(queue_get(&q, out, 8), 8);
+	TEST_CHECK(memcmp(out, src + 8, 8) == 0);
+}
+
+int main(void)
+{
+	TEST_RUN(test_wrap_pow2);
+	TEST_RUN(test_wrap_non_pow2);
+	TEST_RUN(test_full_and_partial);
+	TEST_RUN(test_multi_byte_units);
+	TEST_RUN(test_contig);
+	TEST_RUN(test_fill);
+
+	return test_result();
+}
@@ -0,0 +1,291 @@
+/**
+ * @file test_shell.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief Shell解析和分段输出单元测试
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include <string.h>
+
+#include "test.h"
+#include "utils/simple_shell.h"
+
+static const uint8_t *rx_data;
+static size_t rx_len;
+
+static char tx_buf[16 * 1024];
+static size_t tx_len;
+static size_t tx_limit; // 每次写入最多接收的字节数 模拟输出接口忙
+
+static size_t rx_endless_reads; // 非0时读函数总是返回数据 模拟持续输入
+
+static size_t shell_read(uint8_t *buf, size_t len)
+{
+	if (rx_endless_reads) {
+		rx_endless_reads += len;
+		memset(buf, '\r', len);
+		return len;
+	}
+
+	if (len > rx_len)
+		len = rx_len;
+
+	memcpy(buf, rx_data, len);
+	rx_data += len;
+	rx_len -= len;
+	return len;
+}
+
+static size_t shell_write(uint8_t *buf, size_t len)
+{
+	if (tx_limit && len > tx_limit)
+		len = tx_limit;
+	if (len > sizeof(tx_buf) - 1 - tx_len)
+		len = sizeof(tx_buf) - 1 - tx_len;
+
+	memcpy(tx_buf + tx_len, buf, len);
+	tx_len += len;
+	tx_buf[tx_len] = '\0';
+	return len;
+}
+
+static struct sp_shell_opts opts = {
+	.read = shell_read,
+	.write = shell_write,
+};
+
+// 输入一段数据并调度到输出结束
+static const char *shell_input(const char *input)
+{
+	rx_data = (const uint8_t *)input;
+	rx_len = strlen(input);
+	tx_len = 0;
+	tx_buf[0] = '\0';
+
+	for (int i = 0; i < 4096; i++)
+		shell_dispatch();
+
+	return tx_buf;
+}
+
+static int args_argc;
+static char args_argv[SPS_CMD_MAX_ARGS][SPS_CMD_MAX];
+static int args_calls;
+
+static void args_cmd(int argc, char *argv[], uint8_t *out, size_t buf_size, size_t *out_len)
+{
+	(void)out;
+	(void)buf_size;
+
+	args_calls++;
+	args_argc = argc;
+	for (int i = 0; i < argc && i < SPS_CMD_MAX_ARGS; i++)
+		strcpy(args_argv[i], argv[i]);
+
+	*out_len = 0;
+}
+SPS_EXPORT_CMD(args, args_cmd, "record arguments")
+
+#define LINES_NUM (300)
+
+// 分多次输出 每次最多输出缓冲区能容纳的行数
+static void lines_cmd(int argc, char *argv[], uint8_t *out, size_t buf_size, size_t *out_len)
+{
+	(void)argc;
+	(void)argv;
+
+	uint32_t i = sps_cmd_step();
+	size_t pos = 0;
+
+	for (; i < LINES_NUM; i++) {
+		if (pos + 12 > buf_size) {
+			sps_cmd_continue(i);
+			break;
+		}
+		pos += snprintf((char *)out + pos, buf_size - pos, "line %04u\r\n", (unsigned)i);
+	}
+
+	*out_len = pos;
+}
+SPS_EXPORT_CMD(lines, lines_cmd, "print many lines")
+
+static void test_welcome(void)
+{
+	tx_len = 0;
+	TEST_CHECK(simple_shell_init(&opts, NULL));
+	shell_input("");
+	TEST_CHECK(strstr(tx_buf, "Welcome") != NULL);
+}
+
+static void test_args(void)
+{
+	args_calls = 0;
+	shell_input("args  \"two three\" one\r");
+
+	// 引号内的空格属于同一个参数 连续的空格被跳过
+	TEST_CHECK_EQ(args_calls, 1);
+	TEST_CHECK_EQ(args_argc, 3);
+	TEST_CHECK(strcmp(args_argv[0], "args") == 0);
+	TEST_CHECK(strcmp(args_argv[1], "two three") == 0);
+	TEST_CHECK(strcmp(args_argv[2], "one") == 0);
+
+	shell_input("args a\\tb\r");
+	TEST_CHECK_EQ(args_argc, 2);
+	TEST_CHECK(strcmp(args_argv[1], "a\tb") == 0);
+}
+
+static void test_not_found(void)
+{
+	const char *out = shell_input("nosuch\r");
+
+	TEST_CHECK(strstr(out, "command not found") != NULL);
+
+	// 空行只输出提示符
+	out = shell_input("\r");
+	TEST_CHECK(strstr(out, "not found") == NULL);
+	TEST_CHECK(strstr(out, "$ ") != NULL);
+}
+
+static void test_backspace(void)
+{
+	args_calls = 0;
+	shell_input("arx\x7fgs\r");
+	TEST_CHECK_EQ(args_calls, 1);
+	TEST_CHECK_EQ(args_argc, 1);
+}
+
+static void test_tab_complete(void)
+{
+	args_calls = 0;
+	shell_input("li\t");
+	TEST_CHECK(strstr(tx_buf, "lines") != NULL || strstr(tx_buf, "list") != NULL);
+
+	// 唯一前缀补全后直接执行
+	shell_input("\x7f\x7f\x7f\x7f\x7f" "ar\t\r");
+	TEST_CHECK_EQ(args_calls, 1);
+}
+
+static void test_history(void)
+{
+	args_calls = 0;
+	shell_input("args h1\r");
+	TEST_CHECK_EQ(args_calls, 1);
+
+	// 上箭头调出上一条命令
+	shell_input("\x1b[A\r");
+	TEST_CHECK_EQ(args_calls, 2);
+	TEST_CHECK(strcmp(args_argv[1], "h1") == 0);
+
+	const char *out = shell_input("history\r");
+	TEST_CHECK(strstr(out, "args h1") != NULL);
+}
+
+// 检查输出中包含完整且有序的所有行
+static void check_lines(const char *out)
+{
+	char expect[16];
+	const char *p = out;
+
+	for (int i = 0; i < LINES_NUM; i++) {
+		snprintf(expect, sizeof(expect), "line %04d\r\n", i);
+		p = strstr(p, expect);
+		TEST_CHECK(p != NULL);
+		if (!p)
+			return;
+		p += strlen(expect);
+	}
+
+	TEST_CHECK(strstr(p, "$ ") != NULL);
+}
+
+static void test_stream(void)
+{
+	tx_limit = 0;
+	check_lines(shell_input("lines\r"));
+
+	// 输出接口每次只接收7个字节 输出不丢失
+	tx_limit = 7;
+	check_lines(shell_input("lines\r"));
+
+	// 命令执行期间的输入在命令结束后处理
+	args_calls = 0;
+	check_lines(shell_input("lines\rargs after\r"));
+	TEST_CHECK_EQ(args_calls, 1);
+	tx_limit = 0;
+}
+
+// 输出接口总是立即接收全部数据时 长输出仍然分多次调度完成
+static void test_stream_yield(void)
+{
+	static const char input[] = "lines\r";
+	int dispatches = 0;
+
+	tx_limit = 0;
+	rx_data = (const uint8_t *)input;
+	rx_len = sizeof(input) - 1;
+	tx_len = 0;
+	tx_buf[0] = '\0';
+
+	while (!strstr(tx_buf, "$ ") && dispatches < 4096) {
+		shell_dispatch();
+		dispatches++;
+	}
+
+	TEST_CHECK(dispatches > 1);
+	TEST_CHECK(dispatches <= LINES_NUM);
+	check_lines(tx_buf);
+}
+
+// 持续输入时一次调度只读取有限的数据 调度可以返回
+static void test_endless_input(void)
+{
+	rx_endless_reads = 1;
+	tx_len = 0;
+	shell_dispatch();
+
+	TEST_CHECK(rx_endless_reads > 1);
+	TEST_CHECK(rx_endless_reads - 1 <= 2 * SPS_CMD_MAX);
+
+	rx_endless_reads = 0;
+	shell_input("");
+}
+
+int main(void)
+{
+	TEST_RUN(test_welcome);
+	TEST_RUN(test_args);
+	TEST_RUN(test_not_found);
+	TEST_RUN(test_backspace);
+	TEST_RUN(test_tab_complete);
+	TEST_RUN(test_history);
+	TEST_RUN(test_stream);
+	TEST_RUN(test_stream_yield);
+	TEST_RUN(test_endless_input);
+
+	return test_result();
+}
@@ -0,0 +1,218 @@
+/**
+ * @file test_stimer.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 调度器时间轮单元测试 使用主机虚拟时间
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include <stdlib.h>
+
+#include "test.h"
+#include "core/virtual_os_mm.h"
+#include "port/virtual_os_host.h"
+#include "utils/stimer.h"
+
+#define TEST_END_TICK (100000) // 超过时间轮直接表示的范围 覆盖最高级的循环级联
+
+static uint32_t fast_runs, slow_runs;
+static uint32_t fast_last;
+static bool fast_jitter;
+
+// 周期任务每次都在周期的整数倍执行
+static void fast_task(void)
+{
+	uint32_t now = host_timer_ticks();
+
+	if (now - fast_last != 7)
+		fast_jitter = true;
+
+	fast_last = now;
+	fast_runs++;
+}
+
+static void slow_task(void)
+{
+	slow_runs++;
+}
+
+// 不同时间轮级别的单次定时器 记录实际到期的节拍
+static const uint32_t timer_delays[] = { 1, 31, 32, 33, 1023, 1024, 1025, 32767, 40000, 70000 };
+#define TIMER_NUM (sizeof(timer_delays) / sizeof(timer_delays[0]))
+
+static uint32_t timer_fired[TIMER_NUM];
+
+static void timer_cb(void *arg)
+{
+	uint32_t *fired = arg;
+
+	*fired = host_timer_ticks();
+}
+
+static stimer_timer_handle stopped_timer;
+static uint32_t stopped_fired;
+
+static stimer_timer_handle restart_timer;
+static uint32_t restart_fired;
+
+static void restart_cb(void *arg)
+{
+	(void)arg;
+	restart_fired = host_timer_ticks();
+}
+
+// 在定时器的旧到期时间之前重新启动
+static void restart_task(void *arg)
+{
+	(void)arg;
+	stimer_timer_start(restart_timer, 500);
+}
+
+static uint32_t defer_fired;
+
+static void defer_cb(void)
+{
+	defer_fired = host_timer_ticks();
+}
+
+static uint32_t event_runs;
+static uint32_t event_tick;
+
+static void event_cb(void *arg)
+{
+	(void)arg;
+	event_runs++;
+	event_tick = host_timer_ticks();
+}
+
+static stimer_event_handle event;
+
+// 多次触发在执行前合并为一次
+static void event_trigger(void *arg)
+{
+	(void)arg;
+	stimer_event_post(event);
+	stimer_event_post(event);
+	stimer_event_post(event);
+}
+
+// 同一节拍到期的任务按优先级执行
+static char prio_order[4];
+static int prio_pos;
+
+static void prio_low(void)
+{
+	if (host_timer_ticks() == 50 && prio_pos < 3)
+		prio_order[prio_pos++] = 'L';
+}
+
+static void prio_normal(void)
+{
+	if (host_timer_ticks() == 50 && prio_pos < 3)
+		prio_order[prio_pos++] = 'N';
+}
+
+static void prio_high(void)
+{
+	if (host_timer_ticks() == 50 && prio_pos < 3)
+		prio_order[prio_pos++] = 'H';
+}
+
+static void finish(void *arg)
+{
+	(void)arg;
+
+	TEST_CHECK_EQ(host_timer_ticks(), TEST_END_TICK);
+
+	TEST_CHECK_EQ(fast_runs, TEST_END_TICK / 7);
+	TEST_CHECK_EQ(slow_runs, TEST_END_TICK / 1000);
+	TEST_CHECK(!fast_jitter);
+
+	for (size_t i = 0; i < TIMER_NUM; i++)
+		TEST_CHECK_EQ(timer_fired[i], timer_delays[i]);
+
+	TEST_CHECK_EQ(stopped_fired, 0);
+	TEST_CHECK(!stimer_timer_is_active(stopped_timer));
+	TEST_CHECK_EQ(restart_fired, 100 + 500);
+	TEST_CHECK_EQ(defer_fired, 250);
+
+	TEST_CHECK_EQ(event_runs, 1);
+	TEST_CHECK_EQ(event_tick, 300);
+
+	TEST_CHECK(prio_order[0] == 'H' && prio_order[1] == 'N' && prio_order[2] == 'L');
+
+	printf("[%s] test_stimer\n", test_failures ? "FAIL" : " OK ");
+	exit(test_result());
+}
+
+static stimer_timer_handle timer_at(uint32_t ms, stimer_timer_cb cb, void *arg)
+{
+	stimer_timer_handle timer = stimer_timer_create(cb, arg);
+
+	TEST_CHECK(timer != NULL);
+	TEST_CHECK(stimer_timer_start(timer, ms));
+	return timer;
+}
+
+int main(void)
+{
+	TEST_CHECK(virtual_os_mm_init(64 * 1024));
+	TEST_CHECK(stimer_init(host_timer_port(true)));
+
+	TEST_CHECK(stimer_task_create(NULL, fast_task, 7));
+	TEST_CHECK(stimer_task_create(NULL, slow_task, 1000));
+
+	for (size_t i = 0; i < TIMER_NUM; i++)
+		timer_at(timer_delays[i], timer_cb, &timer_fired[i]);
+
+	stopped_timer = timer_at(200, timer_cb, &stopped_fired);
+	TEST_CHECK(stimer_timer_stop(stopped_timer));
+	TEST_CHECK(!stimer_timer_stop(stopped_timer));
+
+	restart_timer = timer_at(150, restart_cb, NULL);
+	timer_at(100, restart_task, NULL);
+
+	TEST_CHECK(defer_task_create(defer_cb, 250));
+
+	event = stimer_event_task_create(event_cb, NULL);
+	TEST_CHECK(event != NULL);
+	timer_at(300, event_trigger, NULL);
+
+	// 按低到高的顺序创建 执行顺序与创建顺序相反
+	struct stimer_task_attr attr = { .prio = STIMER_PRIO_LOW };
+	TEST_CHECK(stimer_task_create_ex(NULL, prio_low, 50, &attr));
+	attr.prio = STIMER_PRIO_NORMAL;
+	TEST_CHECK(stimer_task_create_ex(NULL, prio_normal, 50, &attr));
+	attr.prio = STIMER_PRIO_HIGH;
+	TEST_CHECK(stimer_task_create_ex(NULL, prio_high, 50, &attr));
+
+	timer_at(TEST_END_TICK, finish, NULL);
+
+	stimer_start();
+
+	return 1;
+}
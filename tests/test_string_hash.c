@@ -0,0 +1,198 @@
+/**
+ * @file test_string_hash.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 字符串哈希表单元测试
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "core/virtual_os_mm.h"
+#include "utils/string_hash.h"
+
+#define TEST_KEYS (200)
+
+static char keys[TEST_KEYS][16];
+static int values[TEST_KEYS];
+
+static void test_insert_find(void)
+{
+	struct hash_table table;
+	enum hash_error err;
+
+	TEST_CHECK_EQ(init_hash_table(&table, 4), HASH_SUCCESS);
+
+	// 插入过程中多次自动扩容
+	for (int i = 0; i < TEST_KEYS; i++) {
+		snprintf(keys[i], sizeof(keys[i]), "key_%d", i);
+		values[i] = i;
+		TEST_CHECK_EQ(hash_insert(&table, keys[i], &values[i]), HASH_SUCCESS);
+	}
+
+	TEST_CHECK_EQ(table.count, TEST_KEYS);
+	TEST_CHECK(table.used * 4 <= table.table_size * 3);
+
+	for (int i = 0; i < TEST_KEYS; i++)
+		TEST_CHECK(hash_find(&table, keys[i], &err) == &values[i] && err == HASH_SUCCESS);
+
+	TEST_CHECK(hash_find(&table, "missing", &err) == NULL);
+	TEST_CHECK_EQ(err, HASH_KEY_NOT_FOUND);
+
+	// 键已存在时更新数据 不增加个数
+	TEST_CHECK_EQ(hash_insert(&table, keys[0], &values[1]), HASH_SUCCESS);
+	TEST_CHECK(hash_find(&table, keys[0], NULL) == &values[1]);
+	TEST_CHECK_EQ(table.count, TEST_KEYS);
+
+	destroy_hash_table(&table);
+}
+
+static void test_delete(void)
+{
+	struct hash_table table;
+
+	init_hash_table(&table, 16);
+
+	for (int i = 0; i < TEST_KEYS; i++)
+		hash_insert(&table, keys[i], &values[i]);
+
+	// 删除偶数键后 奇数键仍能越过已删除的槽位找到
+	for (int i = 0; i < TEST_KEYS; i += 2)
+		TEST_CHECK_EQ(hash_delete(&table, keys[i]), HASH_SUCCESS);
+
+	TEST_CHECK_EQ(hash_delete(&table, keys[0]), HASH_KEY_NOT_FOUND);
+	TEST_CHECK_EQ(table.count, TEST_KEYS / 2);
+
+	for (int i = 0; i < TEST_KEYS; i++)
+		TEST_CHECK(hash_find(&table, keys[i], NULL) == ((i & 1) ? &values[i] : NULL));
+
+	// 反复插入删除不会耗尽空槽位
+	for (int round = 0; round < 1000; round++) {
+		TEST_CHECK_EQ(hash_insert(&table, "tmp", &values[0]), HASH_SUCCESS);
+		TEST_CHECK_EQ(hash_delete(&table, "tmp"), HASH_SUCCESS);
+	}
+	TEST_CHECK_EQ(table.count, TEST_KEYS / 2);
+
+	destroy_hash_table(&table);
+}
+
+static void test_static_key(void)
+{
+	struct hash_table table;
+	char key[] = "static";
+	const char *found = NULL;
+
+	init_hash_table(&table, 8);
+	TEST_CHECK_EQ(hash_insert_static(&table, key, &values[3]), HASH_SUCCESS);
+
+	// 不拷贝键 表中保存的就是调用者的字符串
+	struct hash_iter iter = HASH_ITER_INIT;
+	TEST_CHECK(hash_iter_next(&table, &iter, &found, NULL));
+	TEST_CHECK(found == key);
+	TEST_CHECK_EQ(hash_delete(&table, "static"), HASH_SUCCESS);
+
+	destroy_hash_table(&table);
+}
+
+static void test_iterate(void)
+{
+	struct hash_table table;
+	struct hash_iter iter = HASH_ITER_INIT;
+	const char *key;
+	void *private;
+	int seen[TEST_KEYS] = { 0 };
+	int total = 0;
+
+	init_hash_table(&table, 8);
+
+	for (int i = 0; i < TEST_KEYS; i++)
+		hash_insert(&table, keys[i], &values[i]);
+	hash_delete(&table, keys[5]);
+
+	while (hash_iter_next(&table, &iter, &key, &private)) {
+		int idx = (int *)private - values;
+
+		TEST_CHECK(idx >= 0 && idx < TEST_KEYS);
+		TEST_CHECK(strcmp(key, keys[idx]) == 0);
+		seen[idx]++;
+		total++;
+	}
+
+	TEST_CHECK_EQ(total, TEST_KEYS - 1);
+	TEST_CHECK_EQ(seen[5], 0);
+	TEST_CHECK_EQ(seen[6], 1);
+
+	char **all;
+	size_t num;
+	TEST_CHECK_EQ(hash_get_all_keys(&table, &all, &num), HASH_SUCCESS);
+	TEST_CHECK_EQ(num, TEST_KEYS - 1);
+	for (size_t i = 0; i < num; i++)
+		virtual_os_free(all[i]);
+	virtual_os_free(all);
+
+	destroy_hash_table(&table);
+}
+
+static void test_resize(void)
+{
+	struct hash_table table;
+
+	init_hash_table(&table, 512);
+
+	for (int i = 0; i < 10; i++)
+		hash_insert(&table, keys[i], &values[i]);
+
+	// 缩小后所有键仍然可以找到 不能小于键的个数
+	TEST_CHECK_EQ(hash_resize(&table, 16), HASH_SUCCESS);
+	TEST_CHECK_EQ(table.table_size, 16);
+	TEST_CHECK_EQ(hash_resize(&table, 8), HASH_POINT_ERROR);
+
+	for (int i = 0; i < 10; i++)
+		TEST_CHECK(hash_find(&table, keys[i], NULL) == &values[i]);
+
+	destroy_hash_table(&table);
+}
+
+int main(void)
+{
+	TEST_CHECK(virtual_os_mm_init(64 * 1024));
+
+	TEST_RUN(test_insert_find);
+	TEST_RUN(test_delete);
+	TEST_RUN(test_static_key);
+	TEST_RUN(test_iterate);
+	TEST_RUN(test_resize);
+
+	// 所有表删除后内存全部归还
+	struct virtual_os_mm_stats stats;
+	TEST_CHECK(virtual_os_mm_get_stats(&stats));
+	TEST_CHECK_EQ(stats.allocs, stats.frees);
+
+	return test_result();
+}
@@ -32,8 +32,10 @@
 
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdbool.h>
 
 #include "utils/button.h"
+#include "utils/stimer.h"
 #include "core/virtual_os_mm.h"
 
 struct button_jitter {
@@ -46,7 +48,10 @@ enum btn_io_event {
 	BTN_IO_EVENT_DOWN, // 按键按下
 };
 
-typedef enum usr_btn_ev (*on_state_handler)(btn_handle handle, enum btn_io_event io_ev);
+struct button_state;
+
+typedef enum usr_btn_ev (*on_state_handler)(
+	struct button_state *st, const struct btn_cfg *cfg, enum btn_io_event io_ev);
 
 struct button_state {
 	on_state_handler state;	  // 当前状态
@@ -55,18 +60,53 @@ struct button_state {
 	uint32_t counter;		  // 状态计数器
 };
 
+// 中断唤醒模式 边沿中断触发后由单次定时器周期扫描 所有按键空闲后停止
+struct button_wake {
+	stimer_event_handle event; // 边沿中断触发的事件任务
+	stimer_timer_handle timer; // 扫描定时器
+	uint32_t period_ms;		   // 扫描周期
+	void (*f_scan)(void *obj); // 扫描一次
+	bool (*f_idle)(void *obj); // 是否所有按键都已空闲
+	void *obj;				   // 按键或按键组句柄
+};
+
 struct button {
 	struct btn_cfg cfg;		   // 按键配置
 	struct button_state state; // 按键状态
 	btn_usr_cb f_ev_cb;		   // 按键事件回调
+	struct button_wake *wake;  // 中断唤醒模式 未使能时为NULL
+};
+
+// 一组按键的消抖状态 每个位对应一个按键 1表示按下
+struct button_word {
+	uint32_t previous; // 上次读取的电平
+	uint32_t asserted; // 消抖后的电平
+	uint32_t level;	   // 上次送入状态机的电平
+	uint32_t timing;   // 正在计时的按键 每个周期都需要执行状态机
+};
+
+struct button_group {
+	struct btn_group_cfg cfg;  // 按键组配置
+	struct btn_cfg key_cfg;	   // 组内按键共用的时间参数
+	btn_group_cb f_ev_cb;	   // 按键事件回调
+	struct button_state *keys; // 每个按键的状态
+	struct button_word *words; // 每组按键的消抖状态
+	struct button_wake *wake;  // 中断唤醒模式 未使能时为NULL
+	uint8_t word_num;		   // 组数
 };
 
-static enum usr_btn_ev on_idle_handler(btn_handle handle, enum btn_io_event io_ev);		   // 空闲状态
-static enum usr_btn_ev on_up_handler(btn_handle handle, enum btn_io_event io_ev);		   // 弹起状态
-static enum usr_btn_ev on_down_handler(btn_handle handle, enum btn_io_event io_ev);		   // 按下状态
-static enum usr_btn_ev on_up_suspense_handler(btn_handle handle, enum btn_io_event io_ev); // 悬挂等待状态
-static enum usr_btn_ev on_down_short_handler(btn_handle handle, enum btn_io_event io_ev);  // 短按状态
-static enum usr_btn_ev on_down_long_handler(btn_handle handle, enum btn_io_event io_ev);   // 长按状态
+static enum usr_btn_ev on_idle_handler(
+	struct button_state *st, const struct btn_cfg *cfg, enum btn_io_event io_ev); // 空闲状态
+static enum usr_btn_ev on_up_handler(
+	struct button_state *st, const struct btn_cfg *cfg, enum btn_io_event io_ev); // 弹起状态
+static enum usr_btn_ev on_down_handler(
+	struct button_state *st, const struct btn_cfg *cfg, enum btn_io_event io_ev); // 按下状态
+static enum usr_btn_ev on_up_suspense_handler(
+	struct button_state *st, const struct btn_cfg *cfg, enum btn_io_event io_ev); // 悬挂等待状态
+static enum usr_btn_ev on_down_short_handler(
+	struct button_state *st, const struct btn_cfg *cfg, enum btn_io_event io_ev); // 短按状态
+static enum usr_btn_ev on_down_long_handler(
+	struct button_state *st, const struct btn_cfg *cfg, enum btn_io_event io_ev); // 长按状态
 
 /**
  * @brief 分发点击类型事件，根据点击次数返回相应的按键事件
@@ -89,32 +129,32 @@ static inline enum usr_btn_ev dispatch_click_type(uint32_t click_cnt)
 }
 
 // 空闲状态
-static enum usr_btn_ev on_idle_handler(btn_handle handle, enum btn_io_event io_ev)
+static enum usr_btn_ev on_idle_handler(struct button_state *st, const struct btn_cfg *cfg, enum btn_io_event io_ev)
 {
 	if (io_ev == BTN_IO_EVENT_DOWN) {
-		handle->state.counter = 0;
-		handle->state.click_cnt = 1;
-		handle->state.state = on_down_handler; // 被按下
+		st->counter = 0;
+		st->click_cnt = 1;
+		st->state = on_down_handler; // 被按下
 	}
 
 	return USR_BTN_EV_NONE;
 }
 
 // 按下状态
-static enum usr_btn_ev on_down_handler(btn_handle handle, enum btn_io_event io_ev)
+static enum usr_btn_ev on_down_handler(struct button_state *st, const struct btn_cfg *cfg, enum btn_io_event io_ev)
 {
 	enum usr_btn_ev ev = USR_BTN_EV_NONE;
 
 	if (io_ev == BTN_IO_EVENT_UP) {
 		ev = USR_BTN_EV_POPUP;
-		handle->state.counter = 0;
-		handle->state.state = on_up_suspense_handler; // 等待判断后续是否还有点击事件
+		st->counter = 0;
+		st->state = on_up_suspense_handler; // 等待判断后续是否还有点击事件
 	} else {
-		if (++handle->state.counter >= handle->cfg.long_min_cnt) {
+		if (++st->counter >= cfg->long_min_cnt) {
 			// 按下超过最大长按时间
 			ev = USR_BTN_EV_LONG_CLICK;
-			handle->state.counter = 0;
-			handle->state.state = on_down_long_handler;
+			st->counter = 0;
+			st->state = on_down_long_handler;
 		}
 	}
 
@@ -122,61 +162,63 @@ static enum usr_btn_ev on_down_handler(btn_handle handle, enum btn_io_event io_e
 }
 
 // 悬挂等待状态
-static enum usr_btn_ev on_up_suspense_handler(btn_handle handle, enum btn_io_event io_ev)
+static enum usr_btn_ev on_up_suspense_handler(
+	struct button_state *st, const struct btn_cfg *cfg, enum btn_io_event io_ev)
 {
 	enum usr_btn_ev ev = USR_BTN_EV_NONE;
 
 	// 弹起
 	if (io_ev == BTN_IO_EVENT_UP) {
-		if (++handle->state.counter >= handle->cfg.up_max_cnt) {
+		if (++st->counter >= cfg->up_max_cnt) {
 			// 弹起一定时间后不再按下
-			handle->state.counter = 0;
-			ev = dispatch_click_type(handle->state.click_cnt);
-			handle->state.state = on_up_handler;
+			st->counter = 0;
+			ev = dispatch_click_type(st->click_cnt);
+			st->state = on_up_handler;
 		}
 	} else {
-		handle->state.counter = 0;
-		++handle->state.click_cnt;
-		handle->state.state = on_down_short_handler; // 又继续按下
+		st->counter = 0;
+		++st->click_cnt;
+		st->state = on_down_short_handler; // 又继续按下
 	}
 
 	return ev;
 }
 
 // 弹起状态
-static enum usr_btn_ev on_up_handler(btn_handle handle, enum btn_io_event io_ev)
+static enum usr_btn_ev on_up_handler(struct button_state *st, const struct btn_cfg *cfg, enum btn_io_event io_ev)
 {
 	if (io_ev == BTN_IO_EVENT_DOWN) {
-		handle->state.counter = 0;
-		handle->state.click_cnt = 1;
-		handle->state.state = on_down_handler;
+		st->counter = 0;
+		st->click_cnt = 1;
+		st->state = on_down_handler;
 	}
 
 	return USR_BTN_EV_NONE;
 }
 
 // 短按状态
-static enum usr_btn_ev on_down_short_handler(btn_handle handle, enum btn_io_event io_ev)
+static enum usr_btn_ev on_down_short_handler(
+	struct button_state *st, const struct btn_cfg *cfg, enum btn_io_event io_ev)
 {
 	enum usr_btn_ev ev = USR_BTN_EV_NONE;
 
 	if (io_ev == BTN_IO_EVENT_UP) {
 		ev = USR_BTN_EV_POPUP;
-		handle->state.counter = 0;
-		handle->state.state = on_up_suspense_handler; // 又弹起了，等待判断后续是否还有点击事件
+		st->counter = 0;
+		st->state = on_up_suspense_handler; // 又弹起了，等待判断后续是否还有点击事件
 	}
 
 	return ev;
 }
 
 // 长按状态
-static enum usr_btn_ev on_down_long_handler(btn_handle handle, enum btn_io_event io_ev)
+static enum usr_btn_ev on_down_long_handler(struct button_state *st, const struct btn_cfg *cfg, enum btn_io_event io_ev)
 {
 	enum usr_btn_ev ev = USR_BTN_EV_NONE;
 
 	if (io_ev == BTN_IO_EVENT_UP) {
 		ev = USR_BTN_EV_POPUP;
-		handle->state.state = on_up_handler;
+		st->state = on_up_handler;
 	}
 	return ev;
 }
@@ -194,6 +236,68 @@ static inline uint8_t button_debounce(btn_handle handle)
 	return handle->state.jit.asserted;
 }
 
+// 扫描一次 仍有按键未空闲时继续计时
+static void button_wake_scan(struct button_wake *wake)
+{
+	wake->f_scan(wake->obj);
+
+	if (!wake->f_idle(wake->obj))
+		stimer_timer_start(wake->timer, wake->period_ms);
+}
+
+// 扫描定时器到期
+static void button_wake_timer_cb(void *arg)
+{
+	button_wake_scan(arg);
+}
+
+// 边沿中断触发 正在扫描时等待定时器即可
+static void button_wake_event_cb(void *arg)
+{
+	struct button_wake *wake = arg;
+
+	if (!stimer_timer_is_active(wake->timer))
+		button_wake_scan(wake);
+}
+
+// 释放中断唤醒模式的资源
+static void button_wake_destroy(struct button_wake *wake)
+{
+	if (!wake)
+		return;
+
+	stimer_timer_delete(wake->timer);
+	stimer_event_task_delete(wake->event);
+	virtual_os_free(wake);
+}
+
+// 创建中断唤醒模式 创建后立即扫描一次
+static struct button_wake *button_wake_create(
+	void *obj, void (*f_scan)(void *obj), bool (*f_idle)(void *obj), uint32_t period_ms)
+{
+	if (!period_ms)
+		return NULL;
+
+	struct button_wake *wake = virtual_os_calloc(1, sizeof(struct button_wake));
+	if (!wake)
+		return NULL;
+
+	wake->period_ms = period_ms;
+	wake->f_scan = f_scan;
+	wake->f_idle = f_idle;
+	wake->obj = obj;
+	wake->timer = stimer_timer_create(button_wake_timer_cb, wake);
+	wake->event = stimer_event_task_create(button_wake_event_cb, wake);
+
+	if (!wake->timer || !wake->event) {
+		button_wake_destroy(wake);
+		return NULL;
+	}
+
+	stimer_event_post(wake->event); // 使能时按键可能已被按下
+	return wake;
+}
+
 // 按键初始化
 btn_handle button_ctor(const struct btn_cfg *p_cfg, btn_usr_cb cb)
 {
@@ -207,6 +311,7 @@ btn_handle button_ctor(const struct btn_cfg *p_cfg, btn_usr_cb cb)
 
 	handle->cfg = *p_cfg;
 	handle->f_ev_cb = cb;
+	handle->wake = NULL;
 
 	handle->state.jit.previous = (p_cfg->active_lv == BUTTON_LEVEL_HIGH) ? 0 : 1;
 	handle->state.jit.asserted = handle->state.jit.previous;
@@ -224,6 +329,7 @@ btn_handle button_ctor(const struct btn_cfg *p_cfg, btn_usr_cb cb)
 void button_destroy(btn_handle handle)
 {
 	if (handle) {
+		button_wake_destroy(handle->wake);
 		virtual_os_free(handle); // 释放动态分配的按键结构体内存
 	}
 }
@@ -241,9 +347,9 @@ void button_scan(btn_handle handle)
 	uint8_t cur_level = button_debounce(handle); // 当前有效电平
 
 	if (cur_level == (handle->cfg.active_lv == BUTTON_LEVEL_HIGH ? 1 : 0))
-		ev.ev_type = handle->state.state(handle, BTN_IO_EVENT_DOWN);
+		ev.ev_type = handle->state.state(&handle->state, &handle->cfg, BTN_IO_EVENT_DOWN);
 	else
-		ev.ev_type = handle->state.state(handle, BTN_IO_EVENT_UP);
+		ev.ev_type = handle->state.state(&handle->state, &handle->cfg, BTN_IO_EVENT_UP);
 
 	if (ev.ev_type != USR_BTN_EV_NONE && ev.ev_type != USR_BTN_EV_POPUP && handle->f_ev_cb) {
 		ev.clicks = handle->state.click_cnt;
@@ -252,3 +358,166 @@ void button_scan(btn_handle handle)
 
 	return;
 }
+
+// 是否为需要每个周期计数的状态 其余状态只响应电平变化
+static inline bool button_is_timing(const struct button_state *st)
+{
+	return st->state == on_down_handler || st->state == on_up_suspense_handler;
+}
+
+// 按键组初始化
+btn_group_handle button_group_ctor(const struct btn_group_cfg *p_cfg, btn_group_cb cb)
+{
+	if (!p_cfg || !p_cfg->f_io_read || !p_cfg->key_num)
+		return NULL;
+
+	size_t word_num = (p_cfg->key_num + BTN_GROUP_WORD_BITS - 1) / BTN_GROUP_WORD_BITS;
+	if (word_num > UINT8_MAX)
+		return NULL;
+
+	// 句柄 按键状态 消抖状态一次申请
+	size_t size = sizeof(struct button_group) + p_cfg->key_num * sizeof(struct button_state) +
+				  word_num * sizeof(struct button_word);
+	btn_group_handle grp = virtual_os_calloc(1, size);
+	if (!grp)
+		return NULL;
+
+	grp->cfg = *p_cfg;
+	grp->key_cfg.long_min_cnt = p_cfg->long_min_cnt;
+	grp->key_cfg.up_max_cnt = p_cfg->up_max_cnt;
+	grp->key_cfg.active_lv = p_cfg->active_lv;
+	grp->f_ev_cb = cb;
+	grp->keys = (struct button_state *)(grp + 1);
+	grp->words = (struct button_word *)(grp->keys + p_cfg->key_num);
+	grp->word_num = (uint8_t)word_num;
+
+	for (uint16_t i = 0; i < p_cfg->key_num; i++)
+		grp->keys[i].state = on_idle_handler;
+
+	return grp;
+}
+
+// 释放按键组句柄
+void button_group_destroy(btn_group_handle grp)
+{
+	if (grp) {
+		button_wake_destroy(grp->wake);
+		virtual_os_free(grp);
+	}
+}
+
+// 按键组扫描
+void button_group_scan(btn_group_handle grp)
+{
+	if (!grp)
+		return;
+
+	uint32_t invert = (grp->cfg.active_lv == BUTTON_LEVEL_HIGH) ? 0 : UINT32_MAX;
+
+	for (uint8_t w = 0; w < grp->word_num; w++) {
+		struct button_word *word = &grp->words[w];
+		uint16_t base = (uint16_t)(w * BTN_GROUP_WORD_BITS);
+		uint16_t cnt = grp->cfg.key_num - base;
+		uint32_t valid = cnt >= BTN_GROUP_WORD_BITS ? UINT32_MAX : ((1UL << cnt) - 1);
+
+		// 转换为按下为1 整组同时消抖
+		uint32_t cur = (grp->cfg.f_io_read(w) ^ invert) & valid;
+
+		word->asserted |= (word->previous & cur);
+		word->asserted &= (word->previous | cur);
+		word->previous = cur;
+
+		uint32_t run = (word->asserted ^ word->level) | word->timing;
+		word->level = word->asserted;
+
+		while (run) {
+			uint8_t bit = (uint8_t)__builtin_ctz(run);
+			uint32_t mask = 1UL << bit;
+			struct button_state *st = &grp->keys[base + bit];
+
+			run &= run - 1;
+
+			struct btn_ev_data ev;
+			ev.ev_type = st->state(st, &grp->key_cfg, (word->asserted & mask) ? BTN_IO_EVENT_DOWN : BTN_IO_EVENT_UP);
+			ev.clicks = 0;
+
+			if (button_is_timing(st))
+				word->timing |= mask;
+			else
+				word->timing &= ~mask;
+
+			if (ev.ev_type != USR_BTN_EV_NONE && ev.ev_type != USR_BTN_EV_POPUP && grp->f_ev_cb) {
+				ev.clicks = st->click_cnt;
+				grp->f_ev_cb(base + bit, &ev);
+			}
+		}
+	}
+}
+
+// 单个按键扫描
+static void button_wake_scan_btn(void *obj)
+{
+	button_scan(obj);
+}
+
+// 单个按键回到空闲状态且电平稳定
+static bool button_wake_idle_btn(void *obj)
+{
+	btn_handle handle = obj;
+	uint8_t idle_lv = (handle->cfg.active_lv == BUTTON_LEVEL_HIGH) ? 0 : 1;
+
+	if (handle->state.state != on_idle_handler && handle->state.state != on_up_handler)
+		return false;
+
+	return handle->state.jit.previous == idle_lv && handle->state.jit.asserted == idle_lv;
+}
+
+// 按键组扫描
+static void button_wake_scan_group(void *obj)
+{
+	button_group_scan(obj);
+}
+
+// 按键组所有按键都已弹起且不在计时
+static bool button_wake_idle_group(void *obj)
+{
+	btn_group_handle grp = obj;
+
+	for (uint8_t w = 0; w < grp->word_num; w++) {
+		const struct button_word *word = &grp->words[w];
+		if (word->previous | word->asserted | word->timing)
+			return false;
+	}
+
+	return true;
+}
+
+bool button_irq_enable(btn_handle btn, uint32_t period_ms)
+{
+	if (!btn || btn->wake)
+		return false;
+
+	btn->wake = button_wake_create(btn, button_wake_scan_btn, button_wake_idle_btn, period_ms);
+	return btn->wake != NULL;
+}
+
+void button_wakeup(btn_handle btn)
+{
+	if (btn && btn->wake)
+		stimer_event_post(btn->wake->event);
+}
+
+bool button_group_irq_enable(btn_group_handle grp, uint32_t period_ms)
+{
+	if (!grp || grp->wake)
+		return false;
+
+	grp->wake = button_wake_create(grp, button_wake_scan_group, button_wake_idle_group, period_ms);
+	return grp->wake != NULL;
+}
+
+void button_group_wakeup(btn_group_handle grp)
+{
+	if (grp && grp->wake)
+		stimer_event_post(grp->wake->event);
+}
@@ -0,0 +1,130 @@
+/**
+ * @file evt_queue.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 中断到任务的事件队列
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include <string.h>
+
+#include "utils/evt_queue.h"
+#include "core/virtual_os_defines.h"
+
+bool evt_queue_init(struct evt_queue *eq, size_t evt_bytes, void *buf, size_t evts, stimer_event_handle notify)
+{
+	if (!eq || !queue_init(&(eq->q), evt_bytes, buf, evts))
+		return false;
+
+	eq->notify = notify;
+	eq->drops = 0;
+	return true;
+}
+
+bool evt_queue_post(struct evt_queue *eq, const void *evt)
+{
+	if (!eq || !evt)
+		return false;
+
+	if (queue_add(&(eq->q), (void *)evt, 1) != 1) {
+		eq->drops++;
+		return false;
+	}
+
+	if (eq->notify)
+		stimer_event_post(eq->notify);
+
+	return true;
+}
+
+bool evt_queue_post_short(struct evt_queue *eq, const void *evt, size_t len)
+{
+	void *slot;
+
+	if (!eq || !evt)
+		return false;
+
+	if (len > eq->q.unit_bytes)
+		len = eq->q.unit_bytes;
+
+	// 临界区中不会被另一个生产者打断 预留、写入和提交一次完成
+	uint32_t state = virtual_os_enter_critical();
+
+	bool ret = queue_reserve_contig(&(eq->q), &slot) != 0;
+	if (ret) {
+		memcpy(slot, evt, len);
+		memset((uint8_t *)slot + len, 0, eq->q.unit_bytes - len);
+		queue_commit(&(eq->q), 1);
+	} else {
+		eq->drops++;
+	}
+
+	virtual_os_exit_critical(state);
+
+	if (ret && eq->notify)
+		stimer_event_post(eq->notify);
+
+	return ret;
+}
+
+bool evt_queue_get(struct evt_queue *eq, void *evt)
+{
+	if (!eq || !evt)
+		return false;
+
+	return queue_get(&(eq->q), evt, 1) == 1;
+}
+
+const void *evt_queue_peek(struct evt_queue *eq)
+{
+	void *evt;
+
+	if (!eq || !queue_peek_contig(&(eq->q), &evt))
+		return NULL;
+
+	return evt;
+}
+
+void evt_queue_release(struct evt_queue *eq)
+{
+	if (eq)
+		queue_release(&(eq->q), 1);
+}
+
+uint32_t evt_queue_take_drops(struct evt_queue *eq)
+{
+	if (!eq)
+		return 0;
+
+	// 生产者可能在中断中累加 读取和清零在同一个临界区中完成
+	uint32_t state = virtual_os_enter_critical();
+	uint32_t drops = eq->drops;
+	eq->drops = 0;
+	virtual_os_exit_critical(state);
+
+	return drops;
+}
@@ -99,3 +99,28 @@ uint8_t list_add_tail(list_item *head, list_item *item)
 	list_insert(item, head->pre, head);
 	return 0;
 }
+
+uint8_t list_insert_before(list_item *pos, list_item *item)
+{
+	if (!is_head_valid(pos) || !item)
+		return 1;
+
+	list_insert(item, pos->pre, pos);
+	return 0;
+}
+
+uint8_t list_splice_tail(list_item *head, list_item *list)
+{
+	if (!is_head_valid(head) || !is_head_valid(list))
+		return 1;
+
+	if (list->next == list)
+		return 0;
+
+	list->next->pre = head->pre;
+	head->pre->next = list->next;
+	list->pre->next = head;
+	head->pre = list->pre;
+	list_init(list);
+	return 0;
+}
@@ -37,6 +37,7 @@
 #include <stdarg.h>
 #include <stdbool.h>
 
+#include "core/virtual_os_defines.h"
 #include "utils/log.h"
 #include "utils/queue.h"
 
@@ -44,6 +45,27 @@
 #include <time.h>
 #endif
 
+#if LOG_RTT_ENABLE
+#include "SEGGER_RTT.h"
+#endif
+
+#if LOG_DEFERRED_ENABLE
+#include <stddef.h>
+
+#if (LOG_DEFERRED_RECORD_MAX > MAX_LOG_LENGTH) || (LOG_DEFERRED_RECORD_MAX > 255)
+#error "LOG_DEFERRED_RECORD_MAX must not exceed MAX_LOG_LENGTH or 255"
+#endif
+#endif
+
+#define LOG_LOCAL_FORMAT (!LOG_DEFERRED_ENABLE || !LOG_DEFERRED_RAW) /* 是否在本地格式化 */
+#define LOG_RECORD_QUEUE (LOG_DEFERRED_ENABLE && !LOG_DEFERRED_RAW)	 /* 是否使用延迟记录队列 */
+#define LOG_INTERNAL_MODULE (0xFF)									 /* 内部日志的模块索引 */
+#define LOG_RECORD_HEAD (LOG_DEFERRED_RAW ? 2 : 3)					 /* 延迟记录的帧头长度 */
+
+#if (LOG_MAX_SINKS > 8) || (LOG_MAX_SINKS < 1)
+#error "LOG_MAX_SINKS must be between 1 and 8"
+#endif
+
 #define LOG_LEVEL_STR(level)                                                                                           \
 	((level) == LOG_LEVEL_DEBUG			 ? "DEBUG"                                                                     \
 			: (level) == LOG_LEVEL_INFO	 ? "INFO"                                                                      \
@@ -51,14 +73,57 @@
 			: (level) == LOG_LEVEL_ERROR ? "ERROR"                                                                     \
 										 : "XXXXX")
 
-static uint8_t log_buffer[LOG_BUFFER_SIZE]; /* 日志缓冲区 */
+static uint8_t log_buffer[LOG_BUFFER_SIZE]; /* 日志缓冲区 第一个输出端使用 */
+
+#if LOG_RECORD_QUEUE
+static uint8_t record_buffer[LOG_DEFERRED_BUFFER_SIZE]; /* 延迟记录缓冲区 */
+#endif
+
+static const char syslog_module[] = "syslog"; /* 丢弃统计等内部日志的模块名 */
+
+/* 多个中断优先级写入同一个缓冲区的状态 生产者在临界区内预留空间, 在临界区外拷贝, 最外层的生产者写完后统一发布写索引
+ * 被打断的生产者总是在嵌套的生产者返回后才继续执行, 因此只适用于单核 */
+struct log_ring {
+	volatile size_t head; // 预留索引 已预留但未发布的数据位于 wr ~ head 之间
+	uint32_t writers;	  // 正在写入的生产者个数 只在临界区内修改
+};
+
+// 输出端
+struct syslog_sink {
+	log_write f_write;		 // 输出接口 RTT输出端为NULL
+	struct queue_info queue; // 输出端缓冲区 存放可直接输出的内容
+	struct log_ring ring;	 // 输出端缓冲区的写入状态
+	enum log_level level;	 // 输出端日志等级
+	uint32_t module_mask;	 // 输出端模块掩码 0为全部模块
+	uint32_t rate;			 // 每秒最多输出的字节数 0为不限制
+	uint32_t burst;			 // 令牌桶容量
+	uint32_t tokens;		 // 当前令牌数(字节) 只在临界区内修改
+	uint32_t token_frac;	 // 补充令牌的余数
+	uint32_t flush_bytes;	 // 每个任务周期最多输出的字节数 0为不限制
+	volatile bool tx_busy;	 // 异步输出进行中
+	bool async;				 // 输出接口为异步模式
+	bool rtt;				 // RTT输出端
+	bool dropping;			 // 正在连续丢弃 只在临界区内修改
+	uint32_t dropped;		 // 丢弃的日志条数 只在临界区内修改
+	uint32_t overrun;		 // 缓冲区溢出次数 只在临界区内修改
+	uint32_t limited;		 // 限流丢弃的日志条数 只在临界区内修改
+	uint32_t reported;		 // 已上报的丢弃条数
+};
 
 struct syslog_instance {
-	log_write f_write;				  // 输出接口
-	struct queue_info log_queue;	  // 日志队列
+	struct syslog_sink sinks[LOG_MAX_SINKS]; // 输出端
+	uint8_t sink_cnt;						 // 输出端个数
+#if LOG_RECORD_QUEUE
+	struct queue_info record_queue; // 延迟记录队列 存放待格式化的记录
+	struct log_ring record_ring;	// 延迟记录队列的写入状态
+#endif
+#if LOG_RTT_ENABLE
+	uint8_t rtt_channel[32]; // 每个模块的RTT上行通道
+#endif
 	uint32_t timestamp;				  // 时间戳
 	uint32_t pre_time;				  // 时间戳计数
 	uint32_t period_md;				  // 任务周期
+	uint32_t report_time;			  // 距上次上报丢弃的时间
 	bool initialized;				  // 是否初始化
 	enum log_level current_log_level; // 当前日志等级
 	uint32_t module_mask;			  // 模块掩码 用于过滤日志
@@ -67,19 +132,496 @@ struct syslog_instance {
 
 static const char *module_info[32] = { 0 }; // 所有模块信息
 
+// 最低置位的索引 掩码为0时返回32(无效模块)
 static inline uint8_t mask_idx(uint32_t mask)
 {
-	uint8_t idx = 0;
-	while (mask) {
-		if (mask & 1)
-			return idx;
-		mask >>= 1;
-		idx++;
-	}
+	return mask ? (uint8_t)__builtin_ctz(mask) : 32;
 }
 
 static struct syslog_instance syslog = { 0 };
 
+#if LOG_LOCAL_FORMAT
+/**
+ * @brief 计算追加 n 个字节后的长度 超出缓冲区时截断
+ * 
+ * @param len 当前长度
+ * @param n 追加的长度 snprintf 的返回值
+ * @param size 缓冲区大小
+ * @return size_t 
+ */
+static size_t append_len(size_t len, int n, size_t size)
+{
+	if (n < 0)
+		return len;
+
+	return (len + (size_t)n >= size) ? size - 1 : len + (size_t)n;
+}
+
+#endif
+
+#if USE_TIME_STAMP && LOG_LOCAL_FORMAT
+/**
+ * @brief 格式化时间戳前缀
+ * 
+ * @param timestamp 时间戳
+ * @param buf 输出缓冲区
+ * @param size 缓冲区大小
+ * @return size_t 前缀长度
+ */
+static size_t time_prefix(uint32_t timestamp, char *buf, size_t size)
+{
+	time_t raw_time = (time_t)timestamp;
+	struct tm time_info;
+	size_t len = 0;
+
+	if (localtime_r(&raw_time, &time_info) != NULL)
+		len = strftime(buf, size, "[%Y-%m-%d %H:%M:%S]", &time_info);
+
+	if (len == 0) {
+		int n = snprintf(buf, size, "[NO_TIME]");
+		len = (n < 0) ? 0 : ((size_t)n >= size ? size - 1 : (size_t)n);
+	}
+
+	return len;
+}
+#endif
+
+#if LOG_DEFERRED_ENABLE
+
+// 参数类型 决定记录时以何种类型取出参数
+enum log_arg_type {
+	LOG_ARG_NONE = 0, /* 无法识别的说明符 */
+	LOG_ARG_PERCENT,  /* %% 不消耗参数 */
+	LOG_ARG_INT,	  /* int (含 hh h 以及 %c) */
+	LOG_ARG_LONG,	  /* long */
+	LOG_ARG_LLONG,	  /* long long */
+	LOG_ARG_SIZE,	  /* size_t */
+	LOG_ARG_INTMAX,	  /* intmax_t */
+	LOG_ARG_PTRDIFF,  /* ptrdiff_t */
+	LOG_ARG_DOUBLE,	  /* double (float 被提升为 double) */
+	LOG_ARG_LDOUBLE,  /* long double */
+	LOG_ARG_PTR,	  /* 指针 */
+	LOG_ARG_STR,	  /* 字符串 拷贝内容 */
+};
+
+static const uint8_t arg_size[] = {
+	[LOG_ARG_INT] = sizeof(int),
+	[LOG_ARG_LONG] = sizeof(long),
+	[LOG_ARG_LLONG] = sizeof(long long),
+	[LOG_ARG_SIZE] = sizeof(size_t),
+	[LOG_ARG_INTMAX] = sizeof(intmax_t),
+	[LOG_ARG_PTRDIFF] = sizeof(ptrdiff_t),
+	[LOG_ARG_DOUBLE] = sizeof(double),
+	[LOG_ARG_LDOUBLE] = sizeof(long double),
+	[LOG_ARG_PTR] = sizeof(void *),
+};
+
+union log_arg {
+	int i;
+	long l;
+	long long ll;
+	size_t z;
+	intmax_t j;
+	ptrdiff_t t;
+	double d;
+	long double ld;
+	void *p;
+};
+
+// 转换说明符
+struct log_spec {
+	enum log_arg_type type; // 参数类型
+	uint8_t stars;			// 宽度/精度中'*'的个数 每个'*'额外消耗一个int参数
+};
+
+/**
+ * @brief 延迟记录头 记录内容为 记录头 + 按格式串顺序紧凑排列的参数
+ * 		  整型/浮点/指针按原类型大小存放, 字符串为 1字节长度 + 内容(不含'\0')
+ */
+struct log_record {
+	const char *format; // 格式串
+	const char *module; // 模块名
+	uint16_t line;		// 行号
+	uint8_t level;		// 日志等级
+	uint8_t argc;		// 已记录的转换说明符个数
+#if USE_TIME_STAMP
+	uint32_t timestamp; // 时间戳
+#endif
+};
+
+/**
+ * @brief 解析一个转换说明符
+ * 
+ * @param p 指向'%'之后的字符
+ * @param spec 解析结果
+ * @return const char* 说明符之后的字符
+ */
+static const char *parse_spec(const char *p, struct log_spec *spec)
+{
+	char length = 0;
+
+	spec->stars = 0;
+
+	while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0')
+		p++;
+
+	if (*p == '*') {
+		spec->stars++;
+		p++;
+	} else {
+		while (*p >= '0' && *p <= '9')
+			p++;
+	}
+
+	if (*p == '.') {
+		p++;
+		if (*p == '*') {
+			spec->stars++;
+			p++;
+		} else {
+			while (*p >= '0' && *p <= '9')
+				p++;
+		}
+	}
+
+	switch (*p) {
+	case 'h':
+		p += (p[1] == 'h') ? 2 : 1;
+		break;
+	case 'l':
+		if (p[1] == 'l') {
+			length = 'L';
+			p += 2;
+		} else {
+			length = 'l';
+			p++;
+		}
+		break;
+	case 'z':
+	case 'j':
+	case 't':
+		length = *p++;
+		break;
+	case 'L':
+		length = 'D';
+		p++;
+		break;
+	default:
+		break;
+	}
+
+	switch (*p) {
+	case 'd':
+	case 'i':
+	case 'u':
+	case 'x':
+	case 'X':
+	case 'o':
+		spec->type = length == 'l'	 ? LOG_ARG_LONG
+					 : length == 'L' ? LOG_ARG_LLONG
+					 : length == 'z' ? LOG_ARG_SIZE
+					 : length == 'j' ? LOG_ARG_INTMAX
+					 : length == 't' ? LOG_ARG_PTRDIFF
+									 : LOG_ARG_INT;
+		break;
+	case 'c':
+		spec->type = LOG_ARG_INT;
+		break;
+	case 'f':
+	case 'F':
+	case 'e':
+	case 'E':
+	case 'g':
+	case 'G':
+	case 'a':
+	case 'A':
+		spec->type = length == 'D' ? LOG_ARG_LDOUBLE : LOG_ARG_DOUBLE;
+		break;
+	case 'p':
+		spec->type = LOG_ARG_PTR;
+		break;
+	case 's':
+		spec->type = LOG_ARG_STR;
+		break;
+	case '%':
+		spec->type = LOG_ARG_PERCENT;
+		break;
+	default:
+		spec->type = LOG_ARG_NONE; /* 包括 %n 和不完整的说明符 */
+		return p;
+	}
+
+	return p + 1;
+}
+
+/**
+ * @brief 按参数类型取出参数
+ * 
+ * @param type 参数类型
+ * @param args 可变参数
+ * @param arg 取出的参数
+ */
+static void fetch_arg(enum log_arg_type type, va_list *args, union log_arg *arg)
+{
+	switch (type) {
+	case LOG_ARG_INT:
+		arg->i = va_arg(*args, int);
+		break;
+	case LOG_ARG_LONG:
+		arg->l = va_arg(*args, long);
+		break;
+	case LOG_ARG_LLONG:
+		arg->ll = va_arg(*args, long long);
+		break;
+	case LOG_ARG_SIZE:
+		arg->z = va_arg(*args, size_t);
+		break;
+	case LOG_ARG_INTMAX:
+		arg->j = va_arg(*args, intmax_t);
+		break;
+	case LOG_ARG_PTRDIFF:
+		arg->t = va_arg(*args, ptrdiff_t);
+		break;
+	case LOG_ARG_DOUBLE:
+		arg->d = va_arg(*args, double);
+		break;
+	case LOG_ARG_LDOUBLE:
+		arg->ld = va_arg(*args, long double);
+		break;
+	case LOG_ARG_PTR:
+	case LOG_ARG_STR:
+		arg->p = va_arg(*args, void *);
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * @brief 将日志编码为延迟记录 只记录格式串指针和原始参数, 不做格式化
+ * 
+ * @param record 记录缓冲区 大小为`LOG_DEFERRED_RECORD_MAX`
+ * @param head 记录头
+ * @param args 可变参数
+ * @return size_t 记录长度
+ */
+static size_t encode_record(uint8_t *record, struct log_record *head, va_list *args)
+{
+	size_t pos = sizeof(struct log_record);
+	const char *p = head->format;
+
+	head->argc = 0;
+
+	while ((p = strchr(p, '%')) != NULL) {
+		struct log_spec spec;
+		p = parse_spec(p + 1, &spec);
+
+		if (spec.type == LOG_ARG_PERCENT)
+			continue;
+
+		if (spec.type == LOG_ARG_NONE)
+			break;
+
+		size_t need = spec.stars * sizeof(int) + (spec.type == LOG_ARG_STR ? 1 : arg_size[spec.type]);
+		if (pos + need > LOG_DEFERRED_RECORD_MAX)
+			break; // 记录已满 剩余参数不再记录
+
+		for (uint8_t i = 0; i < spec.stars; i++) {
+			int star = va_arg(*args, int);
+			memcpy(&record[pos], &star, sizeof(int));
+			pos += sizeof(int);
+		}
+
+		union log_arg arg = { 0 };
+		fetch_arg(spec.type, args, &arg);
+
+		if (spec.type == LOG_ARG_STR) {
+			const char *str = arg.p ? (const char *)arg.p : "(null)";
+			size_t len = 0;
+			size_t limit = LOG_DEFERRED_RECORD_MAX - pos - 1;
+
+			if (limit > LOG_DEFERRED_STR_MAX)
+				limit = LOG_DEFERRED_STR_MAX;
+
+			while (len < limit && str[len])
+				len++;
+
+			record[pos++] = (uint8_t)len;
+			memcpy(&record[pos], str, len);
+			pos += len;
+		} else {
+			memcpy(&record[pos], &arg, arg_size[spec.type]);
+			pos += arg_size[spec.type];
+		}
+
+		head->argc++;
+	}
+
+	memcpy(record, head, sizeof(struct log_record));
+
+	return pos;
+}
+
+#if !LOG_DEFERRED_RAW
+/**
+ * @brief 将延迟记录格式化为文本
+ * 
+ * @param record 记录内容
+ * @param record_len 记录长度
+ * @param out 输出缓冲区
+ * @param size 输出缓冲区大小
+ * @return size_t 文本长度
+ */
+static size_t format_record(const uint8_t *record, size_t record_len, char *out, size_t size)
+{
+	struct log_record head;
+	const uint8_t *arg = record + sizeof(struct log_record);
+	const uint8_t *end = record + record_len;
+	size_t len = 0;
+
+	if (record_len < sizeof(struct log_record))
+		return 0;
+
+	memcpy(&head, record, sizeof(struct log_record));
+
+#if USE_TIME_STAMP
+	len = time_prefix(head.timestamp, out, size);
+	len = append_len(len, snprintf(out + len, size - len, " "), size);
+#endif
+
+	len = append_len(len,
+		snprintf(out + len, size - len, "[%-5s] [%-10s] [%-4d] : ", LOG_LEVEL_STR(head.level), head.module,
+			head.line),
+		size);
+
+	const char *p = head.format;
+	bool truncated = false;
+
+	while (*p && len < size - 1) {
+		const char *start = strchr(p, '%');
+		size_t literal = start ? (size_t)(start - p) : strlen(p);
+
+		if (literal > size - 1 - len)
+			literal = size - 1 - len;
+		memcpy(out + len, p, literal);
+		len += literal;
+
+		if (!start)
+			break;
+
+		struct log_spec spec;
+		const char *next = parse_spec(start + 1, &spec);
+
+		if (spec.type == LOG_ARG_PERCENT) {
+			len = append_len(len, snprintf(out + len, size - len, "%%"), size);
+			p = next;
+			continue;
+		}
+
+		if (spec.type == LOG_ARG_NONE || head.argc == 0) {
+			truncated = true; // 无法识别或参数未被记录 截断
+			break;
+		}
+
+		head.argc--;
+
+		// 复制说明符 '*'替换为记录的数值
+		char fmt[24];
+		size_t fmt_len = 0;
+		for (const char *c = start; c < next && fmt_len < sizeof(fmt) - 1; c++) {
+			if (*c != '*') {
+				fmt[fmt_len++] = *c;
+				continue;
+			}
+
+			int star = 0;
+			if (arg + sizeof(int) > end) {
+				truncated = true;
+				break;
+			}
+			memcpy(&star, arg, sizeof(int));
+			arg += sizeof(int);
+			fmt_len = append_len(fmt_len, snprintf(fmt + fmt_len, sizeof(fmt) - fmt_len, "%d", star), sizeof(fmt));
+		}
+		fmt[fmt_len] = '\0';
+
+		if (truncated)
+			break;
+
+		union log_arg value = { 0 };
+		int n = 0;
+
+		if (spec.type == LOG_ARG_STR) {
+			char str[LOG_DEFERRED_STR_MAX + 1];
+			size_t str_len = (arg < end) ? *arg++ : 0;
+
+			if (str_len > LOG_DEFERRED_STR_MAX || arg + str_len > end) {
+				truncated = true;
+				break;
+			}
+			memcpy(str, arg, str_len);
+			str[str_len] = '\0';
+			arg += str_len;
+			n = snprintf(out + len, size - len, fmt, str);
+		} else {
+			if (arg + arg_size[spec.type] > end) {
+				truncated = true;
+				break;
+			}
+			memcpy(&value, arg, arg_size[spec.type]);
+			arg += arg_size[spec.type];
+
+			switch (spec.type) {
+			case LOG_ARG_INT:
+				n = snprintf(out + len, size - len, fmt, value.i);
+				break;
+			case LOG_ARG_LONG:
+				n = snprintf(out + len, size - len, fmt, value.l);
+				break;
+			case LOG_ARG_LLONG:
+				n = snprintf(out + len, size - len, fmt, value.ll);
+				break;
+			case LOG_ARG_SIZE:
+				n = snprintf(out + len, size - len, fmt, value.z);
+				break;
+			case LOG_ARG_INTMAX:
+				n = snprintf(out + len, size - len, fmt, value.j);
+				break;
+			case LOG_ARG_PTRDIFF:
+				n = snprintf(out + len, size - len, fmt, value.t);
+				break;
+			case LOG_ARG_DOUBLE:
+				n = snprintf(out + len, size - len, fmt, value.d);
+				break;
+			case LOG_ARG_LDOUBLE:
+				n = snprintf(out + len, size - len, fmt, value.ld);
+				break;
+			case LOG_ARG_PTR:
+				n = snprintf(out + len, size - len, fmt, value.p);
+				break;
+			default:
+				break;
+			}
+		}
+
+		len = append_len(len, n, size);
+		p = next;
+	}
+
+	// 截断时保留格式串结尾的换行
+	size_t format_len = strlen(head.format);
+	if (truncated && format_len && head.format[format_len - 1] == '\n' && len && out[len - 1] != '\n') {
+		if (len >= size - 1)
+			len = size - 2;
+		out[len++] = '\n';
+	}
+
+	return len;
+}
+#endif /* !LOG_DEFERRED_RAW */
+
+#endif /* LOG_DEFERRED_ENABLE */
+
 /**
  * @brief 检查日志实例是否有效
  * 
@@ -89,69 +631,498 @@ static struct syslog_instance syslog = { 0 };
  */
 static bool check_instance(struct syslog_instance *instance)
 {
-	return instance && instance->initialized && instance->f_write;
+	return instance && instance->initialized && instance->sink_cnt;
+}
+
+/**
+ * @brief 输出端是否接收该日志
+ * 
+ * @param sink 输出端
+ * @param level 日志等级
+ * @param module_idx 模块索引
+ * @return bool
+ */
+static inline bool sink_accept(struct syslog_sink *sink, enum log_level level, uint8_t module_idx)
+{
+	if (level < sink->level)
+		return false;
+
+	return !sink->module_mask || (module_idx < 32 && (sink->module_mask & (1UL << module_idx)));
 }
 
 /**
- * @brief 向日志队列中写入日志
+ * @brief 获取接收该日志的输出端
  * 
  * @param instance 日志实例
- * @param buf 日志内容缓冲区
- * @param len 日志内容长度
- * @param mask 模块掩码
- * @return size_t 实际写入的字节数
+ * @param level 日志等级
+ * @param module_idx 模块索引
+ * @return uint8_t 输出端位图
  */
-static size_t syslog_write(struct syslog_instance *instance, uint8_t *buf, size_t len, uint32_t mask)
+static uint8_t syslog_targets(struct syslog_instance *instance, enum log_level level, uint8_t module_idx)
 {
-	if (!check_instance(instance))
-		return 0;
+	uint8_t targets = 0;
 
-#if USE_TIME_STAMP
-	char time_buffer[64] = "NO_TIME";
+	for (uint8_t i = 0; i < instance->sink_cnt; i++) {
+		if (sink_accept(&instance->sinks[i], level, module_idx))
+			targets |= 1U << i;
+	}
 
-	time_t raw_time = (time_t)instance->timestamp;
-	struct tm time_info;
+	return targets;
+}
 
-	if (localtime_r(&raw_time, &time_info) != NULL) {
-		strftime(time_buffer, sizeof(time_buffer), "[%Y-%m-%d %H:%M:%S]", &time_info);
-	} else {
-		snprintf(time_buffer, sizeof(time_buffer), "[NO_TIME]");
+/**
+ * @brief 开始一次写入 在队列中预留一段空间 空间不足时不预留
+ * 
+ * @param q 队列
+ * @param ring 写入状态
+ * @param len 预留长度
+ * @param index 预留空间的起始索引
+ * @return bool 空间不足返回false
+ */
+static bool log_ring_reserve(struct queue_info *q, struct log_ring *ring, size_t len, size_t *index)
+{
+	bool ret = false;
+	uint32_t state = virtual_os_enter_critical();
+
+	ring->writers++; // 预留失败也计入 由最外层的生产者发布嵌套生产者写入的数据
+	if (q->buf_size - (ring->head - q->rd) >= len) {
+		*index = ring->head;
+		ring->head += len;
+		ret = true;
 	}
 
-	char new_buf[MAX_LOG_LENGTH];
-	size_t new_len = snprintf(new_buf, sizeof(new_buf), "%s %.*s", time_buffer, (int)len, buf);
+	virtual_os_exit_critical(state);
+	return ret;
+}
+
+/**
+ * @brief 结束一次写入 最外层的生产者发布所有已写完的数据
+ * 
+ * @param q 队列
+ * @param ring 写入状态
+ */
+static void log_ring_commit(struct queue_info *q, struct log_ring *ring)
+{
+	uint32_t state = virtual_os_enter_critical();
+
+	if (--ring->writers == 0)
+		queue_advance_wr(q, ring->head - q->wr); // 内部保证数据先于写索引可见
 
-	if (new_len >= MAX_LOG_LENGTH) {
-		// 如果日志长度超过最大长度，截断
-		new_len = MAX_LOG_LENGTH - 1;
-		// 移除手动添加 '\0'
+	virtual_os_exit_critical(state);
+}
+
+/**
+ * @brief 向队列中写入一条完整的记录 空间不足时不写入 可在多个中断优先级中调用
+ * 
+ * @param q 队列
+ * @param ring 写入状态
+ * @param buf 记录内容
+ * @param len 记录长度
+ * @return bool 空间不足返回false
+ */
+static bool syslog_enqueue(struct queue_info *q, struct log_ring *ring, void *buf, size_t len)
+{
+	size_t index;
+
+	bool ret = log_ring_reserve(q, ring, len, &index);
+	if (ret) {
+		size_t pos = q->mask ? (index & q->mask) : (index % q->buf_size);
+		size_t tail = q->buf_size - pos;
+
+		if (tail >= len) {
+			memcpy((uint8_t *)q->buf + pos, buf, len);
+		} else {
+			memcpy((uint8_t *)q->buf + pos, buf, tail);
+			memcpy(q->buf, (uint8_t *)buf + tail, len - tail);
+		}
 	}
 
-	// 使用 new_buf 作为要发送的日志内容
-	buf = (uint8_t *)new_buf;
-	len = new_len;
+	log_ring_commit(q, ring);
+	return ret;
+}
+
+#if LOG_RTT_ENABLE
+// 模块对应的RTT上行通道
+static inline unsigned rtt_channel(struct syslog_instance *instance, uint8_t module_idx)
+{
+	return module_idx < 32 ? instance->rtt_channel[module_idx] : 0;
+}
 #endif
 
-	size_t total_len = len + sizeof(size_t) + sizeof(uint32_t); // 日志长度信息占用 4 字节 掩码信息占用 4 字节
-	size_t remain_space = queue_remain_space(&instance->log_queue);
+/**
+ * @brief 向输出端写入一条可直接输出的日志 RTT输出端直接写入RTT上行缓冲区, 否则写入输出端缓冲区
+ * 
+ * @param instance 日志实例
+ * @param sink 输出端
+ * @param module_idx 模块索引
+ * @param buf 日志内容
+ * @param len 日志长度
+ * @return bool 空间不足返回false
+ */
+static bool sink_output(
+	struct syslog_instance *instance, struct syslog_sink *sink, uint8_t module_idx, void *buf, size_t len)
+{
+#if LOG_RTT_ENABLE
+	// 非阻塞跳过模式 空间不足时整条丢弃
+	if (sink->rtt)
+		return SEGGER_RTT_Write(rtt_channel(instance, module_idx), buf, len) == len;
+#endif
+	return syslog_enqueue(&sink->queue, &sink->ring, buf, len);
+}
 
-	if (remain_space < total_len)
-		return 0;
+/**
+ * @brief 获取输出端的剩余空间
+ * 
+ * @param instance 日志实例
+ * @param sink 输出端
+ * @param module_idx 模块索引
+ * @return size_t
+ */
+static inline size_t sink_space(struct syslog_instance *instance, struct syslog_sink *sink, uint8_t module_idx)
+{
+#if LOG_RTT_ENABLE
+	if (sink->rtt)
+		return SEGGER_RTT_GetAvailWriteSpace(rtt_channel(instance, module_idx));
+#endif
+	return sink->queue.buf_size - (sink->ring.head - sink->queue.rd);
+}
 
-	// 长度信息
-	if (queue_add(&instance->log_queue, (uint8_t *)&len, sizeof(size_t)) != sizeof(size_t))
-		return 0;
+/**
+ * @brief 记录一次丢弃 连续丢弃只计一次溢出
+ * 
+ * @param sink 输出端
+ * @param limited 是否因限流丢弃
+ */
+static void sink_drop(struct syslog_sink *sink, bool limited)
+{
+	uint32_t state = virtual_os_enter_critical();
 
-	// 掩码信息
-	if (queue_add(&instance->log_queue, (uint8_t *)&mask, sizeof(uint32_t)) != sizeof(uint32_t))
-		return 0;
+	sink->dropped++;
+	if (limited) {
+		sink->limited++;
+	} else if (!sink->dropping) {
+		sink->dropping = true;
+		sink->overrun++;
+	}
 
-	// 日志内容
-	if (queue_add(&instance->log_queue, buf, len) != len)
-		return 0;
+	virtual_os_exit_critical(state);
+}
+
+/**
+ * @brief 消耗令牌 令牌不足时不消耗
+ * 
+ * @param sink 输出端
+ * @param len 日志长度
+ * @return bool 令牌不足返回false
+ */
+static bool sink_take_tokens(struct syslog_sink *sink, size_t len)
+{
+	bool ret = false;
+	uint32_t state = virtual_os_enter_critical();
+
+	if (sink->tokens >= len) {
+		sink->tokens -= len;
+		ret = true;
+	}
+
+	virtual_os_exit_critical(state);
+	return ret;
+}
+
+/**
+ * @brief 归还未使用的令牌
+ * 
+ * @param sink 输出端
+ * @param len 日志长度
+ */
+static void sink_return_tokens(struct syslog_sink *sink, size_t len)
+{
+	uint32_t state = virtual_os_enter_critical();
+	sink->tokens += len;
+	virtual_os_exit_critical(state);
+}
+
+/**
+ * @brief 补充令牌 每个任务周期调用一次
+ * 
+ * @param sink 输出端
+ * @param period_ms 任务周期
+ */
+static void sink_refill(struct syslog_sink *sink, uint32_t period_ms)
+{
+	if (!sink->rate)
+		return;
+
+	uint32_t add = sink->rate * period_ms + sink->token_frac;
+
+	sink->token_frac = add % 1000;
+
+	// 生产者可能在中断中同时消耗令牌
+	uint32_t state = virtual_os_enter_critical();
+
+	uint32_t refill = sink->tokens + add / 1000;
+	sink->tokens = refill > sink->burst ? sink->burst : refill;
+
+	virtual_os_exit_critical(state);
+}
+
+/**
+ * @brief 将一条可直接输出的日志分发到目标输出端 日志只生成一次, 每个输出端独立限流和统计丢弃
+ * 		  内部日志不限流也不计入丢弃
+ * 
+ * @param instance 日志实例
+ * @param targets 目标输出端位图
+ * @param module_idx 模块索引
+ * @param buf 日志内容
+ * @param len 日志长度
+ * @return uint8_t 成功写入的输出端位图
+ */
+static uint8_t syslog_fanout(
+	struct syslog_instance *instance, uint8_t targets, uint8_t module_idx, void *buf, size_t len)
+{
+	bool internal = module_idx == LOG_INTERNAL_MODULE;
+	uint8_t done = 0;
+
+	for (uint8_t i = 0; i < instance->sink_cnt; i++) {
+		struct syslog_sink *sink = &instance->sinks[i];
+
+		if (!(targets & (1U << i)))
+			continue;
+
+		bool limit = !internal && sink->rate;
+
+		if (limit && !sink_take_tokens(sink, len)) {
+			sink_drop(sink, true); // 令牌不足 限流丢弃
+			continue;
+		}
+
+		if (!sink_output(instance, sink, module_idx, buf, len)) {
+			if (limit)
+				sink_return_tokens(sink, len); // 未输出 归还令牌
+			if (!internal)
+				sink_drop(sink, false);
+			continue;
+		}
+
+		sink->dropping = false; // 单字节写入 无需临界区
+		done |= 1U << i;
+	}
+
+	return done;
+}
+
+#if !LOG_DEFERRED_ENABLE
+/**
+ * @brief 将日志格式化为文本
+ * 
+ * @param instance 日志实例
+ * @param out 输出缓冲区
+ * @param size 输出缓冲区大小
+ * @param module 模块名
+ * @param level 日志等级
+ * @param line 行号
+ * @param format 日志格式
+ * @param args 可变参数
+ * @return size_t 文本长度
+ */
+static size_t format_text(struct syslog_instance *instance, char *out, size_t size, const char *module,
+	enum log_level level, int line, const char *format, va_list *args)
+{
+	size_t len = 0;
+
+#if USE_TIME_STAMP
+	len = time_prefix(instance->timestamp, out, size);
+	len = append_len(len, snprintf(out + len, size - len, " "), size);
+#endif
+
+	len = append_len(
+		len, snprintf(out + len, size - len, "[%-5s] [%-10s] [%-4d] : ", LOG_LEVEL_STR(level), module, line), size);
+
+	if (len < size - 1)
+		len = append_len(len, vsnprintf(out + len, size - len, format, *args), size);
 
 	return len;
 }
+#endif /* !LOG_DEFERRED_ENABLE */
+
+/**
+ * @brief 生成一条日志并分发到目标输出端 文本模式下直接格式化, 延迟模式下编码为记录
+ * 
+ * @param instance 日志实例
+ * @param targets 目标输出端位图
+ * @param module_idx 模块索引 内部日志为`LOG_INTERNAL_MODULE`
+ * @param level 日志等级
+ * @param line 行号
+ * @param format 日志格式
+ * @param args 可变参数
+ * @return uint8_t 成功写入的输出端位图
+ */
+static uint8_t syslog_emit(struct syslog_instance *instance, uint8_t targets, uint8_t module_idx, enum log_level level,
+	int line, const char *format, va_list *args)
+{
+	const char *module = module_idx < 32 ? module_info[module_idx] : syslog_module;
+
+#if LOG_DEFERRED_ENABLE
+	// 只记录格式串指针和原始参数 格式化推迟到`syslog_task`或上位机
+	uint8_t frame[LOG_DEFERRED_RECORD_MAX + LOG_RECORD_HEAD];
+	struct log_record head = {
+		.format = format,
+		.module = module,
+		.line = (uint16_t)line,
+		.level = (uint8_t)level,
+#if USE_TIME_STAMP
+		.timestamp = instance->timestamp,
+#endif
+	};
+
+	size_t len = encode_record(&frame[LOG_RECORD_HEAD], &head, args);
+
+#if LOG_DEFERRED_RAW
+	// 帧头 + 1字节长度 + 记录 可直接输出
+	frame[0] = LOG_DEFERRED_SYNC;
+	frame[1] = (uint8_t)len;
+	return syslog_fanout(instance, targets, module_idx, frame, len + LOG_RECORD_HEAD);
+#else
+	// 1字节长度 + 1字节模块索引 + 1字节目标输出端 + 记录
+	frame[0] = (uint8_t)len;
+	frame[1] = module_idx;
+	frame[2] = targets;
+	if (syslog_enqueue(&instance->record_queue, &instance->record_ring, frame, len + LOG_RECORD_HEAD))
+		return targets;
+
+	for (uint8_t i = 0; i < instance->sink_cnt && module_idx != LOG_INTERNAL_MODULE; i++) {
+		if (targets & (1U << i))
+			sink_drop(&instance->sinks[i], false);
+	}
+
+	return 0;
+#endif
+#else
+	char buffer[MAX_LOG_LENGTH];
+	size_t len = format_text(instance, buffer, sizeof(buffer), module, level, line, format, args);
+
+	return syslog_fanout(instance, targets, module_idx, buffer, len);
+#endif
+}
+
+/**
+ * @brief 生成一条内部日志 不受等级、掩码和限流的限制
+ * 
+ * @param instance 日志实例
+ * @param targets 目标输出端位图
+ * @param level 日志等级
+ * @param line 行号
+ * @param format 日志格式
+ * @param ... 可变参数
+ * @return uint8_t 成功写入的输出端位图
+ */
+static uint8_t syslog_notice(
+	struct syslog_instance *instance, uint8_t targets, enum log_level level, int line, const char *format, ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	uint8_t ret = syslog_emit(instance, targets, LOG_INTERNAL_MODULE, level, line, format, &args);
+	va_end(args);
+
+	return ret;
+}
+
+/**
+ * @brief 上报各输出端新增的丢弃条数 写入对应输出端的日志流中
+ * 
+ * @param instance 日志实例
+ */
+static void syslog_report_drop(struct syslog_instance *instance)
+{
+	for (uint8_t i = 0; i < instance->sink_cnt; i++) {
+		struct syslog_sink *sink = &instance->sinks[i];
+		uint32_t dropped = sink->dropped;
+
+		if (dropped == sink->reported)
+			continue;
+
+		if (syslog_notice(instance, 1U << i, LOG_LEVEL_WARN, __LINE__,
+				"%lu logs dropped (total %lu, overrun %lu, limited %lu)\n", (unsigned long)(dropped - sink->reported),
+				(unsigned long)dropped, (unsigned long)sink->overrun, (unsigned long)sink->limited))
+			sink->reported = dropped;
+	}
+}
+
+#if LOG_RECORD_QUEUE
+/**
+ * @brief 将延迟记录格式化一次后分发到目标输出端
+ * 		  目标输出端空间不足时保留记录等待下次处理, 记录队列使用超过一半后不再等待, 避免慢速输出端阻塞其他输出端
+ * 
+ * @param instance 日志实例
+ */
+static void syslog_format_records(struct syslog_instance *instance)
+{
+	uint8_t record[LOG_DEFERRED_RECORD_MAX + LOG_RECORD_HEAD];
+	char text[MAX_LOG_LENGTH];
+
+	while (queue_peek(&instance->record_queue, record, LOG_RECORD_HEAD) == LOG_RECORD_HEAD) {
+		size_t len = record[0];
+		uint8_t module_idx = record[1];
+		uint8_t targets = record[2];
+
+		queue_peek(&instance->record_queue, record, len + LOG_RECORD_HEAD);
+
+		size_t text_len = format_record(&record[LOG_RECORD_HEAD], len, text, sizeof(text));
+
+		if (queue_used(&instance->record_queue) < LOG_DEFERRED_BUFFER_SIZE / 2) {
+			for (uint8_t i = 0; i < instance->sink_cnt; i++) {
+				if ((targets & (1U << i)) && sink_space(instance, &instance->sinks[i], module_idx) < text_len)
+					return;
+			}
+		}
+
+		syslog_fanout(instance, targets, module_idx, text, text_len);
+		queue_advance_rd(&instance->record_queue, len + LOG_RECORD_HEAD);
+	}
+}
+#endif /* LOG_RECORD_QUEUE */
+
+/**
+ * @brief 将输出端缓冲区中的内容直接交给输出接口 每次提交环形缓冲区中的一段连续空间, 可包含多条日志
+ * 
+ * @param sink 输出端
+ */
+static void sink_flush(struct syslog_sink *sink)
+{
+	size_t budget = sink->flush_bytes ? sink->flush_bytes : SIZE_MAX;
+	void *ptr;
+	size_t len;
+
+	if (sink->rtt)
+		return;
+
+	while (budget && !sink->tx_busy && (len = queue_peek_contig(&sink->queue, &ptr)) != 0) {
+		if (len > LOG_FLUSH_MAX_BYTES)
+			len = LOG_FLUSH_MAX_BYTES;
+
+		if (len > budget)
+			len = budget;
+
+		if (sink->async) {
+			// 数据在发送完成之前保留在缓冲区中
+			sink->tx_busy = true;
+			if (!sink->f_write(ptr, len))
+				sink->tx_busy = false;
+			return;
+		}
+
+		size_t sent = sink->f_write(ptr, len);
+		if (sent > len)
+			sent = len;
+
+		queue_release(&sink->queue, sent);
+		budget -= sent;
+
+		if (sent < len)
+			return; // 输出接口忙 下次继续
+	}
+}
 
 /**
  * @brief 日志显示
@@ -172,31 +1143,28 @@ static void syslog_show(struct syslog_instance *instance)
 	}
 #endif
 
-	while (!is_queue_empty(&instance->log_queue)) {
-		// 日志长度信息
-		size_t flush_len = 0;
-		queue_get(&instance->log_queue, (uint8_t *)&flush_len, sizeof(size_t));
+	for (uint8_t i = 0; i < instance->sink_cnt; i++)
+		sink_refill(&instance->sinks[i], instance->period_md);
 
-		if (flush_len == 0 || flush_len > MAX_LOG_LENGTH)
-			return;
+	instance->report_time += instance->period_md;
+	if (instance->report_time >= LOG_DROP_REPORT_MS) {
+		instance->report_time = 0;
+		syslog_report_drop(instance);
+	}
 
-		// 掩码信息
-		uint32_t mask = 0;
-		queue_get(&instance->log_queue, (uint8_t *)&mask, sizeof(uint32_t));
+#if LOG_RECORD_QUEUE
+	syslog_format_records(instance);
+#endif
 
-		// 取出日志
-		uint8_t tmp_buf[MAX_LOG_LENGTH];
-		queue_get(&instance->log_queue, tmp_buf, flush_len);
-		if (syslog.module_mask & mask)
-			instance->f_write(tmp_buf, flush_len); // 过滤掩码
-	}
+	for (uint8_t i = 0; i < instance->sink_cnt; i++)
+		sink_flush(&instance->sinks[i]);
 }
 
 /**
  * @brief 填充模块名称数组 按照掩码从小到大排序 模块名的索引就是实际的掩码位
  * 		  结束后 module_buf_size 指向实际填充的模块个数
- * @param module_buf 
- * @param module_buf_size 
+ * @param module_buf
+ * @param module_buf_size
  */
 void fill_module_names(char *module_buf[], uint8_t *module_buf_size)
 {
@@ -223,41 +1191,22 @@ void origin_log(uint32_t mask, enum log_level level, int line, const char *forma
 	if (level < syslog.current_log_level)
 		return;
 
-	char buffer[MAX_LOG_LENGTH] = { 0 };
-	int len;
-	va_list args;
-
-	va_start(args, format);
+	if (!(syslog.module_mask & mask))
+		return; // 过滤掩码
 
 	uint8_t module_idx = mask_idx(mask);
 	if (module_idx >= syslog.module_cnt)
 		return;
 
-	len = snprintf(
-		buffer, sizeof(buffer), "[%-5s] [%-10s] [%-4d] : ", LOG_LEVEL_STR(level), module_info[module_idx], line);
-
-	if (len < 0) {
-		// snprintf 出错
-		va_end(args);
+	uint8_t targets = syslog_targets(&syslog, level, module_idx);
+	if (!targets)
 		return;
-	}
-
-	int remaining_space = MAX_LOG_LENGTH - len;
 
-	if (remaining_space > 1) {
-		int formatted_len = vsnprintf(buffer + len, remaining_space, format, args);
-		if (formatted_len < 0)
-			len = MAX_LOG_LENGTH - 1;
-		else if (formatted_len >= remaining_space)
-			len = MAX_LOG_LENGTH - 1;
-		else
-			len += formatted_len;
-	} else
-		len = MAX_LOG_LENGTH - 1;
+	va_list args;
 
+	va_start(args, format);
+	syslog_emit(&syslog, targets, module_idx, level, line, format, &args);
 	va_end(args);
-
-	syslog_write(&syslog, (uint8_t *)buffer, len, mask);
 }
 
 // 设置日志模块掩码
@@ -309,9 +1258,180 @@ uint32_t syslog_get_time(void)
 
 void modify_output(log_write f_write)
 {
-	syslog.f_write = f_write;
+	if (syslog.sink_cnt && !syslog.sinks[0].rtt && f_write)
+		syslog.sinks[0].f_write = f_write;
+}
+
+// 有效的输出端
+static struct syslog_sink *get_sink(int sink)
+{
+	if (sink < 0 || sink >= syslog.sink_cnt)
+		return NULL;
+
+	return &syslog.sinks[sink];
+}
+
+/**
+ * @brief 设置输出接口为异步模式
+ * 
+ * @param async true:异步 false:同步(默认)
+ */
+void syslog_set_async(bool async)
+{
+	struct syslog_sink *sink = get_sink(0);
+
+	if (sink)
+		sink->async = async;
+}
+
+/**
+ * @brief 输出端异步输出完成 释放已发送的数据
+ * 
+ * @param sink 输出端编号
+ * @param len 已发送完成的字节数
+ */
+void syslog_sink_tx_complete(int sink, size_t len)
+{
+	struct syslog_sink *s = get_sink(sink);
+
+	if (!s || !s->tx_busy)
+		return;
+
+	queue_release(&s->queue, len);
+	s->tx_busy = false;
+}
+
+/**
+ * @brief 异步输出完成 释放已发送的数据
+ * 
+ * @param len 已发送完成的字节数
+ */
+void syslog_tx_complete(size_t len)
+{
+	syslog_sink_tx_complete(0, len);
+}
+
+/**
+ * @brief 设置输出端的日志等级
+ * 
+ * @param sink 输出端编号
+ * @param level 日志等级
+ */
+void syslog_sink_set_level(int sink, enum log_level level)
+{
+	struct syslog_sink *s = get_sink(sink);
+
+	if (s)
+		s->level = level;
+}
+
+/**
+ * @brief 设置输出端的模块掩码
+ * 
+ * @param sink 输出端编号
+ * @param mask 模块掩码 0为全部模块
+ */
+void syslog_sink_set_mask(int sink, uint32_t mask)
+{
+	struct syslog_sink *s = get_sink(sink);
+
+	if (s)
+		s->module_mask = mask;
+}
+
+/**
+ * @brief 获取输出端的丢弃统计
+ * 
+ * @param sink 输出端编号
+ * @param stats 统计信息
+ */
+void syslog_get_stats(int sink, struct syslog_stats *stats)
+{
+	struct syslog_sink *s = get_sink(sink);
+
+	if (!s || !stats)
+		return;
+
+	uint32_t state = virtual_os_enter_critical(); // 三个计数保持一致
+
+	stats->dropped = s->dropped;
+	stats->overrun = s->overrun;
+	stats->limited = s->limited;
+
+	virtual_os_exit_critical(state);
+}
+
+/**
+ * @brief 日志实例初始化 会清空已添加的输出端
+ * 
+ * @param period_ms 任务周期（毫秒）
+ */
+static void syslog_setup(uint32_t period_ms)
+{
+	syslog.sink_cnt = 0;
+	syslog.period_md = period_ms;
+	syslog.current_log_level = LOG_LEVEL_INFO; // 默认日志等级为INFO
+
+#if LOG_RECORD_QUEUE
+	queue_init(&syslog.record_queue, sizeof(uint8_t), record_buffer, LOG_DEFERRED_BUFFER_SIZE);
+	memset(&syslog.record_ring, 0, sizeof(struct log_ring));
+#endif
+
+	syslog.initialized = true;
+}
+
+/**
+ * @brief 添加输出端
+ * 
+ * @param f_write 输出接口 RTT输出端为NULL
+ * @param rtt 是否为RTT输出端
+ * @param buf 输出端缓冲区 RTT输出端为NULL
+ * @param size 输出端缓冲区大小
+ * @param attr 输出端属性 为NULL时接收全部日志且不限流
+ * @return int 输出端编号 失败返回-1
+ */
+static int sink_add(log_write f_write, bool rtt, void *buf, size_t size, const struct syslog_sink_attr *attr)
+{
+	if (!syslog.initialized || syslog.sink_cnt >= LOG_MAX_SINKS)
+		return -1;
+
+	struct syslog_sink *sink = &syslog.sinks[syslog.sink_cnt];
+
+	memset(sink, 0, sizeof(struct syslog_sink));
+
+	if (!rtt && (!f_write || !queue_init(&sink->queue, sizeof(uint8_t), buf, size)))
+		return -1;
+
+	sink->f_write = f_write;
+	sink->rtt = rtt;
+
+	if (attr) {
+		sink->level = attr->level;
+		sink->module_mask = attr->module_mask;
+		sink->rate = attr->rate;
+		sink->burst = attr->burst ? attr->burst : attr->rate;
+		sink->flush_bytes = attr->flush_bytes;
+		sink->async = attr->async;
+	}
+
+	sink->tokens = sink->burst;
+
+	return syslog.sink_cnt++;
+}
+
+/**
+ * @brief 添加输出端 在`syslog_init`之后调用
+ * 
+ * @param f_write 输出接口
+ * @param buf 输出端缓冲区
+ * @param size 输出端缓冲区大小
+ * @param attr 输出端属性 为NULL时接收全部日志且不限流
+ * @return int 输出端编号 失败返回-1
+ */
+int syslog_add_sink(log_write f_write, void *buf, size_t size, const struct syslog_sink_attr *attr)
+{
+	return sink_add(f_write, false, buf, size, attr);
 }
-/**************************API**************************/
 
 /**
  * @brief 日志初始化
@@ -324,13 +1444,63 @@ void syslog_init(log_write f_write, uint32_t period_ms)
 	if (!f_write)
 		return;
 
-	syslog.f_write = f_write;
-	syslog.current_log_level = LOG_LEVEL_INFO; // 默认日志等级为INFO
+	syslog_setup(period_ms);
+	sink_add(f_write, false, log_buffer, LOG_BUFFER_SIZE, NULL);
+}
+
+#if LOG_RTT_ENABLE
+/**
+ * @brief 添加RTT输出端 在`syslog_init`或`syslog_init_rtt`之后调用
+ * 
+ * @param attr 输出端属性 为NULL时接收全部日志且不限流
+ * @return int 输出端编号 失败返回-1
+ */
+int syslog_add_rtt_sink(const struct syslog_sink_attr *attr)
+{
+	SEGGER_RTT_Init();
+	SEGGER_RTT_SetFlagsUpBuffer(0, SEGGER_RTT_MODE_NO_BLOCK_SKIP);
 
-	queue_init(&syslog.log_queue, sizeof(uint8_t), log_buffer, LOG_BUFFER_SIZE);
+	return sink_add(NULL, true, NULL, 0, attr);
+}
 
-	syslog.initialized = true;
+/**
+ * @brief 使用RTT作为日志输出 替代`syslog_init`
+ * 
+ * @param period_ms 任务周期（毫秒）
+ */
+void syslog_init_rtt(uint32_t period_ms)
+{
+	syslog_setup(period_ms);
+	syslog_add_rtt_sink(NULL);
+}
+
+/**
+ * @brief 将模块的日志输出到指定的RTT上行通道
+ * 
+ * @param mask 模块掩码 可以包含多个模块
+ * @param channel RTT上行通道 默认为0
+ * @param buf 通道缓冲区 为NULL时使用已配置的通道(通道0由RTT默认配置)
+ * @param size 通道缓冲区大小
+ * @return bool 成功返回true，失败返回false
+ */
+bool syslog_rtt_channel(uint32_t mask, unsigned channel, void *buf, unsigned size)
+{
+	if (channel >= SEGGER_RTT_MAX_NUM_UP_BUFFERS)
+		return false;
+
+	if (buf && size) {
+		if (SEGGER_RTT_ConfigUpBuffer(channel, "syslog", buf, size, SEGGER_RTT_MODE_NO_BLOCK_SKIP) < 0)
+			return false;
+	}
+
+	for (uint8_t i = 0; i < 32; i++) {
+		if (mask & (1UL << i))
+			syslog.rtt_channel[i] = (uint8_t)channel;
+	}
+
+	return true;
 }
+#endif /* LOG_RTT_ENABLE */
 
 /**
   * @brief 日志任务
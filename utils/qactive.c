@@ -0,0 +1,121 @@
+/**
+ * @file qactive.c
+ * @author wenshuyu (wsy2161826815@163.com)
+ * @brief 主动对象 层次状态机 + 事件队列 + 定时事件
+ * @version 0.1
+ * @date 2026-10-14
+ * 
+ * @copyright Copyright (c) 2024-2025
+ * @see repository: https://github.com/i-tesetd-it-no-problem/VirtualOS.git
+ * 
+ * The MIT License (MIT)
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+#include "utils/qactive.h"
+
+static const qevent_t qactive_init_evt = { (qsignal_t)Q_INIT_SIG };
+
+// 事件任务 依次分发队列中的所有事件 事件在缓冲区中原地分发不拷贝
+static void qactive_run(void *arg)
+{
+	struct qactive *ao = arg;
+	const qevent_t *e;
+
+	while ((e = evt_queue_peek(&ao->eq)) != NULL) {
+		qhsm_dispatch(&ao->hsm, e);
+		evt_queue_release(&ao->eq);
+	}
+}
+
+bool qactive_init(struct qactive *ao, qstate_handler f_initial, size_t evt_bytes, void *buf, size_t evts)
+{
+	if (!ao || !f_initial || evt_bytes < sizeof(qevent_t))
+		return false;
+
+	ao->run = stimer_event_task_create(qactive_run, ao);
+	if (!ao->run)
+		return false;
+
+	if (!evt_queue_init(&ao->eq, evt_bytes, buf, evts, ao->run)) {
+		stimer_event_task_delete(ao->run);
+		ao->run = NULL;
+		return false;
+	}
+
+	if (!qhsm_init(&ao->hsm, f_initial, &qactive_init_evt)) {
+		stimer_event_task_delete(ao->run);
+		ao->run = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+bool qactive_post(struct qactive *ao, const void *evt)
+{
+	if (!ao)
+		return false;
+
+	return evt_queue_post(&ao->eq, evt);
+}
+
+// 定时事件到期 投递到所属主动对象的事件队列, 与其他事件按投递顺序分发
+static void qtime_evt_expire(void *arg)
+{
+	struct qtime_evt *te = arg;
+
+	if (te->interval_ms)
+		stimer_timer_start(te->timer, te->interval_ms);
+
+	(void)evt_queue_post_short(&te->ao->eq, &te->evt, sizeof(te->evt)); // 队列已满时计入丢弃
+}
+
+bool qtime_evt_init(struct qtime_evt *te, struct qactive *ao, qsignal_t sig)
+{
+	if (!te || !ao)
+		return false;
+
+	te->evt.sig = sig;
+	te->ao = ao;
+	te->interval_ms = 0;
+	te->timer = stimer_timer_create(qtime_evt_expire, te);
+
+	return te->timer != NULL;
+}
+
+bool qtime_evt_arm(struct qtime_evt *te, uint32_t ms, uint32_t interval_ms)
+{
+	if (!te || !te->timer)
+		return false;
+
+	te->interval_ms = interval_ms;
+	return stimer_timer_start(te->timer, ms);
+}
+
+bool qtime_evt_disarm(struct qtime_evt *te)
+{
+	if (!te || !te->timer)
+		return false;
+
+	te->interval_ms = 0;
+	return stimer_timer_stop(te->timer);
+}
@@ -31,6 +31,7 @@
  */
 
 #include "utils/qfsm.h"
+#include "core/virtual_os_defines.h"
 
 static const qevent_t q_reserve_ev[] = {
 	{ (qsignal_t)Q_EMPTY_SIG },
@@ -56,4 +57,165 @@ void qfsm_dispatch(qfsm_t *const me, qevent_t const *e)
 		(void)(*s)(me, &q_reserve_ev[Q_EXIT_SIG]);
 		(void)(*me->state)(me, &q_reserve_ev[Q_ENTRY_SIG]);
 	}
-}
\ No newline at end of file
+}
+
+/**************************************层次状态机**************************************/
+
+#define QHSM_TRIG(me_, s_, sig_) ((*(s_))((qfsm_t *)(me_), &q_reserve_ev[sig_]))
+
+qstate qhsm_top(qfsm_t *me, qevent_t const *e)
+{
+	(void)me;
+	(void)e;
+
+	return Q_IGNORED();
+}
+
+// 获取父状态 会覆盖`temp`
+static qstate_handler qhsm_super(qhsm_t *me, qstate_handler s)
+{
+	(void)QHSM_TRIG(me, s, Q_EMPTY_SIG);
+	return me->temp;
+}
+
+/**
+ * @brief 记录从`from`向上到`to`(不包括)的路径
+ * 
+ * @param me 状态机实例
+ * @param from 起始状态
+ * @param to 祖先状态
+ * @param path 路径 path[0]为起始状态
+ * @return int 路径长度 超过`QHSM_MAX_DEPTH`返回-1
+ */
+static int qhsm_path(qhsm_t *me, qstate_handler from, qstate_handler to, qstate_handler path[QHSM_MAX_DEPTH])
+{
+	int depth = 0;
+
+	for (qstate_handler s = from; s != to && s != qhsm_top; s = qhsm_super(me, s)) {
+		if (depth == QHSM_MAX_DEPTH)
+			return -1;
+		path[depth++] = s;
+	}
+
+	return depth;
+}
+
+// 记录路径 嵌套层数超过`QHSM_MAX_DEPTH`时断言 初始状态已在`qhsm_init`中检查, 之后的转换目标由用户保证
+static int qhsm_path_checked(qhsm_t *me, qstate_handler from, qstate_handler to, qstate_handler path[QHSM_MAX_DEPTH])
+{
+	int depth = qhsm_path(me, from, to, path);
+
+	virtual_os_assert(depth >= 0);
+	return depth;
+}
+
+// 从外到内依次进入路径上的状态
+static void qhsm_enter(qhsm_t *me, qstate_handler path[QHSM_MAX_DEPTH], int depth)
+{
+	while (depth > 0)
+		(void)QHSM_TRIG(me, path[--depth], Q_ENTRY_SIG);
+}
+
+// 执行初始转换 直到叶子状态
+static void qhsm_drill(qhsm_t *me, qstate_handler target)
+{
+	qstate_handler path[QHSM_MAX_DEPTH];
+
+	while (QHSM_TRIG(me, target, Q_INIT_SIG) == Q_EVENT_TRAN) {
+		int depth = qhsm_path_checked(me, me->temp, target, path);
+		if (!depth)
+			break; // 初始转换的目标必须是子状态
+
+		target = path[0];
+		qhsm_enter(me, path, depth);
+	}
+
+	me->state = target;
+}
+
+bool qhsm_init(qhsm_t *me, qstate_handler f_initial, qevent_t const *e)
+{
+	qstate_handler path[QHSM_MAX_DEPTH];
+
+	me->state = qhsm_top;
+	if ((*f_initial)((qfsm_t *)me, e) != Q_EVENT_TRAN)
+		return false;
+
+	qstate_handler target = me->temp;
+
+	int depth = qhsm_path(me, target, qhsm_top, path);
+	if (depth < 0)
+		return false; // 嵌套过深 不进入任何状态
+
+	qhsm_enter(me, path, depth);
+	qhsm_drill(me, target);
+
+	// 初始转换深入后的叶子状态也不能超过最大层数 否则之后的转换无法记录完整路径
+	return qhsm_path(me, me->state, qhsm_top, path) >= 0;
+}
+
+void qhsm_dispatch(qhsm_t *me, qevent_t const *e)
+{
+	qstate_handler path[QHSM_MAX_DEPTH];
+	qstate_handler s = me->state;
+	qstate r;
+
+	// 从叶子状态向上冒泡 直到事件被处理
+	while ((r = (*s)((qfsm_t *)me, e)) == Q_EVENT_SUPER)
+		s = me->temp;
+
+	if (r != Q_EVENT_TRAN)
+		return;
+
+	qstate_handler target = me->temp;
+
+	// 退出到处理事件的源状态
+	for (qstate_handler t = me->state; t != s; t = qhsm_super(me, t))
+		(void)QHSM_TRIG(me, t, Q_EXIT_SIG);
+
+	int depth;
+
+	if (s == target) {
+		// 自转换 退出后重新进入
+		(void)QHSM_TRIG(me, s, Q_EXIT_SIG);
+		path[0] = target;
+		depth = 1;
+	} else {
+		// 从源状态向上退出 直到最近公共祖先 只进入公共祖先以下的目标路径
+		int len = qhsm_path_checked(me, target, qhsm_top, path);
+
+		depth = len;
+		for (qstate_handler t = s; t != qhsm_top; t = qhsm_super(me, t)) {
+			int k = 0;
+
+			while (k < len && path[k] != t)
+				k++;
+
+			if (k < len) {
+				depth = k;
+				break;
+			}
+
+			(void)QHSM_TRIG(me, t, Q_EXIT_SIG);
+		}
+	}
+
+	qhsm_enter(me, path, depth);
+	qhsm_drill(me, target);
+}
+
+bool qhsm_is_in(qhsm_t *me, qstate_handler state)
+{
+	qstate_handler saved = me->temp;
+	bool in = false;
+
+	for (qstate_handler s = me->state; s != qhsm_top; s = qhsm_super(me, s)) {
+		if (s == state) {
+			in = true;
+			break;
+		}
+	}
+
+	me->temp = saved;
+	return in;
+}
@@ -35,12 +35,74 @@
 #include <stddef.h>
 #include "utils/queue.h"
 
+/* 单生产者单消费者(例如中断写,主循环读)时保证数据与索引的访问顺序 */
+#define queue_barrier() __sync_synchronize()
+
 /* 获取较小的值 */
 static inline size_t q_min(size_t a, size_t b)
 {
 	return (a <= b) ? a : b;
 }
 
+/* 实际索引 容量为2的幂时使用掩码 避免除法 */
+static inline size_t q_index(struct queue_info *q, size_t idx)
+{
+	return q->mask ? (idx & q->mask) : (idx % q->buf_size);
+}
+
+/* 拷贝单个单元 常见单元大小使用定长拷贝, 编译为单条读写指令 */
+static inline void q_unit_copy(void *dst, const void *src, size_t unit_bytes)
+{
+	switch (unit_bytes) {
+	case 1:
+		*(uint8_t *)dst = *(const uint8_t *)src;
+		break;
+	case 2:
+		memcpy(dst, src, 2);
+		break;
+	case 4:
+		memcpy(dst, src, 4);
+		break;
+	default:
+		memcpy(dst, src, unit_bytes);
+		break;
+	}
+}
+
+/* 从 index 处写入 units 个单元 处理回绕 */
+static inline void q_copy_in(struct queue_info *q, size_t index, const uint8_t *data, size_t units)
+{
+	uint8_t *buf = q->buf;
+
+	if (units == 1) {
+		q_unit_copy(buf + (index * q->unit_bytes), data, q->unit_bytes);
+		return;
+	}
+
+	size_t tail_cnt = q_min(units, q->buf_size - index);
+
+	memcpy(buf + (index * q->unit_bytes), data, tail_cnt * q->unit_bytes);
+	if (units > tail_cnt)
+		memcpy(buf, data + (tail_cnt * q->unit_bytes), (units - tail_cnt) * q->unit_bytes);
+}
+
+/* 从 index 处读出 units 个单元 处理回绕 */
+static inline void q_copy_out(struct queue_info *q, size_t index, uint8_t *data, size_t units)
+{
+	const uint8_t *buf = q->buf;
+
+	if (units == 1) {
+		q_unit_copy(data, buf + (index * q->unit_bytes), q->unit_bytes);
+		return;
+	}
+
+	size_t tail_cnt = q_min(units, q->buf_size - index);
+
+	memcpy(data, buf + (index * q->unit_bytes), tail_cnt * q->unit_bytes);
+	if (units > tail_cnt)
+		memcpy(data + (tail_cnt * q->unit_bytes), buf, (units - tail_cnt) * q->unit_bytes);
+}
+
 /* 初始化队列 */
 bool queue_init(struct queue_info *q, size_t unit_bytes, void *buf, size_t units)
 {
@@ -50,6 +112,7 @@ bool queue_init(struct queue_info *q, size_t unit_bytes, void *buf, size_t units
 	q->unit_bytes = unit_bytes;
 	q->buf = buf;
 	q->buf_size = units;
+	q->mask = ((units & (units - 1)) == 0) ? (units - 1) : 0;
 	q->rd = 0;
 	q->wr = 0;
 
@@ -122,14 +185,10 @@ size_t queue_add(struct queue_info *q, void *data, size_t units)
 	if (units > remain)
 		units = remain; // 限制写入的单元数
 
-	size_t index = q->wr % q->buf_size; // 实际写索引
-	size_t tail_cnt = q_min(units, q->buf_size - index);
-
-	memcpy(q->buf + (index * q->unit_bytes), data, tail_cnt * q->unit_bytes);
-	if (units > tail_cnt) {
-		memcpy(q->buf, data + (tail_cnt * q->unit_bytes), (units - tail_cnt) * q->unit_bytes);
-	}
+	queue_barrier(); // 读到读索引之后再覆盖数据
+	q_copy_in(q, q_index(q, q->wr), data, units);
 
+	queue_barrier(); // 数据写完后再发布写索引
 	q->wr += units;
 
 	return units;
@@ -145,13 +204,10 @@ size_t queue_get(struct queue_info *q, void *data, size_t units)
 	if (units > used)
 		units = used;
 
-	size_t index = q->rd % q->buf_size; // 实例读索引
-	size_t tail_cnt = q_min(units, q->buf_size - index);
-
-	memcpy(data, q->buf + (index * q->unit_bytes), tail_cnt * q->unit_bytes);
-	if (units > tail_cnt)
-		memcpy(data + (tail_cnt * q->unit_bytes), q->buf, (units - tail_cnt) * q->unit_bytes);
+	queue_barrier(); // 读到写索引之后再读取数据
+	q_copy_out(q, q_index(q, q->rd), data, units);
 
+	queue_barrier(); // 数据读完后再释放空间
 	q->rd += units;
 
 	return units;
@@ -167,12 +223,8 @@ size_t queue_peek(struct queue_info *q, void *data, size_t units)
 	if (units > used)
 		units = used;
 
-	size_t index = q->rd % q->buf_size; // 实例读索引
-	size_t tail_cnt = q_min(units, q->buf_size - index);
-
-	memcpy(data, q->buf + (index * q->unit_bytes), tail_cnt * q->unit_bytes);
-	if (units > tail_cnt)
-		memcpy(data + (tail_cnt * q->unit_bytes), q->buf, (units - tail_cnt) * q->unit_bytes);
+	queue_barrier(); // 读到写索引之后再读取数据
+	q_copy_out(q, q_index(q, q->rd), data, units);
 
 	return units;
 }
@@ -184,6 +236,7 @@ void queue_advance_rd(struct queue_info *q, size_t units)
 		return;
 
 	size_t count = q_min(units, queue_used(q));
+	queue_barrier();
 	q->rd += count;
 }
 
@@ -194,5 +247,73 @@ void queue_advance_wr(struct queue_info *q, size_t units)
 		return;
 
 	size_t count = q_min(units, queue_remain_space(q));
+	queue_barrier();
 	q->wr += count;
 }
+
+/* 获取可直接写入的连续空间 */
+size_t queue_reserve_contig(struct queue_info *q, void **ptr)
+{
+	if (!q || !ptr)
+		return 0;
+
+	size_t remain = queue_remain_space(q);
+	queue_barrier(); // 读到读索引之后再写数据
+
+	size_t index = q_index(q, q->wr);
+	*ptr = (uint8_t *)q->buf + (index * q->unit_bytes);
+
+	return q_min(remain, q->buf_size - index);
+}
+
+/* 提交已写入的单元 */
+void queue_commit(struct queue_info *q, size_t units)
+{
+	queue_advance_wr(q, units);
+}
+
+/* 获取可直接读取的连续数据 */
+size_t queue_peek_contig(struct queue_info *q, void **ptr)
+{
+	if (!q || !ptr)
+		return 0;
+
+	size_t used = queue_used(q);
+	queue_barrier(); // 读到写索引之后再读数据
+
+	size_t index = q_index(q, q->rd);
+	*ptr = (uint8_t *)q->buf + (index * q->unit_bytes);
+
+	return q_min(used, q->buf_size - index);
+}
+
+/* 释放已读取的单元 */
+void queue_release(struct queue_info *q, size_t units)
+{
+	queue_advance_rd(q, units);
+}
+
+/* 通过读函数直接填充队列 */
+size_t queue_fill(struct queue_info *q, queue_read_f f_read, size_t units)
+{
+	size_t total = 0;
+	void *ptr;
+
+	if (!q || !f_read)
+		return 0;
+
+	while (total < units) {
+		size_t want = q_min(queue_reserve_contig(q, &ptr), units - total);
+		if (!want)
+			break; // 队列已满
+
+		size_t got = f_read(ptr, want * q->unit_bytes) / q->unit_bytes;
+		queue_commit(q, got);
+		total += got;
+
+		if (got < want)
+			break; // 没有更多数据
+	}
+
+	return total;
+}
@@ -40,9 +40,10 @@
 
 #include "utils/simple_shell.h"
 #include "utils/queue.h"
-#include "utils/string_hash.h"
 
-#include "core/virtual_os_mm.h"
+#if SPS_ENABLE_BINARY
+#include "utils/crc.h"
+#endif
 
 #ifndef MIN
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
@@ -56,13 +57,29 @@
 #define TIPS "You can type `list` to get all available commands." NEW_LINE NEW_LINE PROMPT
 #define DEFAULT_MSG WELCOME TIPS
 
+#if SPS_STATIC_CMD_TABLE
+// 链接脚本中按命令名排序的命令表
+extern const struct sp_shell_cmd_t __start_shell_cmd[];
+extern const struct sp_shell_cmd_t __stop_shell_cmd[];
+#else
 // 全局命令缓存
 const struct sp_shell_cmd_t *command_list[MAX_COMMANDS];
 int command_count = 0;
+#endif
 
 // 队列大小
 #define RX_QUEUE_SIZE (SPS_CMD_MAX * 2)
-#define TX_QUEUE_SIZE MAX_OUT_LEN
+#define TX_QUEUE_SIZE (MAX_OUT_LEN * 2) // 一段命令输出发送期间可以生成下一段
+
+// 执行一次命令回调需要的发送缓冲空间 命令输出 + 提示符(二进制模式下为帧头和校验)
+#define CMD_OUT_SPACE (MAX_OUT_LEN + sizeof(NEW_LINE_PROMPT))
+
+#if SPS_ENABLE_BINARY
+#define BIN_RSP_HEAD_LEN (5) // 响应帧头 帧头 + 编号 + 状态 + 2字节长度
+#define BIN_CRC_LEN (2)		 // CRC16-MODBUS 低字节在前
+
+_Static_assert(BIN_RSP_HEAD_LEN + BIN_CRC_LEN <= sizeof(NEW_LINE_PROMPT), "binary frame overhead exceeds prompt");
+#endif
 
 // 历史记录
 #if SPS_ENABLE_HISTORY
@@ -71,8 +88,6 @@ static int history_count = 0;
 static int history_index = -1; // -1表示不在历史回放模式
 #endif
 
-static struct hash_table shell_cmd_table; // 命令哈希表
-
 // 上下文
 struct shell_context {
 	struct sp_shell_opts *opts;
@@ -81,12 +96,57 @@ struct shell_context {
 	size_t cmd_len;
 	uint8_t cmd_buf[SPS_CMD_MAX];
 	bool is_active;
-	bool hash_initialized;
+	bool cmd_sorted;
+
+	// 正在执行的命令 流式输出时跨越多次调度
+	const struct sp_shell_cmd_t *running;
+	char run_buf[SPS_CMD_MAX];	  // 命令行副本 argv指向其中
+	char *argv[SPS_CMD_MAX_ARGS]; // 命令参数
+	int argc;					  // 参数数量
+	uint32_t step;				  // 流式输出进度
+	bool more;					  // 命令请求继续输出
+	uint8_t out_buf[MAX_OUT_LEN]; // 命令输出缓冲区
+
+#if SPS_ENABLE_BINARY
+	uint8_t bin_buf[SPS_BIN_MAX_PAYLOAD + 4]; // 请求帧 帧头 + 长度 + 负载 + 校验
+	size_t bin_pos;							  // 已接收的请求帧字节数
+	uint8_t bin_idle;						  // 请求帧未收完时没有收到数据的调度次数
+	bool binary;							  // 正在执行的命令来自二进制请求
+	uint8_t bin_id;							  // 正在执行的命令编号
+#endif
 };
 
 // 全局上下文
 static struct shell_context shell_ctx;
 
+#if SPS_STATIC_CMD_TABLE
+// 命令数量
+static int cmd_num(void)
+{
+	return (int)(__stop_shell_cmd - __start_shell_cmd);
+}
+
+// 按索引获取命令
+static const struct sp_shell_cmd_t *cmd_at(int idx)
+{
+	return &__start_shell_cmd[idx];
+}
+
+// 静态命令表在链接时已排序
+static void cmd_sort_once(void)
+{
+}
+#else
+static int cmd_num(void)
+{
+	return command_count;
+}
+
+static const struct sp_shell_cmd_t *cmd_at(int idx)
+{
+	return command_list[idx];
+}
+
 // 按字母排序
 static int cmd_compare(const void *p1, const void *p2)
 {
@@ -101,37 +161,60 @@ static int cmd_compare(const void *p1, const void *p2)
 	return strcmp(cmdA->name, cmdB->name);
 }
 
-// 按字母排序后插入哈希表
-static void hash_save_cmd_once(void)
+// 只在第一次调度时按字母排序 之后通过二分查找命令
+static void cmd_sort_once(void)
 {
-	if (shell_ctx.hash_initialized) {
+	if (shell_ctx.cmd_sorted)
 		return;
-	}
 
 	qsort((void *)command_list, command_count, sizeof(struct sp_shell_cmd_t *), cmd_compare);
 
-	for (int i = 0; i < command_count; i++) {
-		if (!command_list[i])
-			continue;
-		hash_insert(&shell_cmd_table, command_list[i]->name, (void *)command_list[i]);
+	shell_ctx.cmd_sorted = true;
+}
+#endif /* SPS_STATIC_CMD_TABLE */
+
+/**
+ * @brief 在有序命令表中二分查找第一个前`len`个字符不小于`name`的命令
+ * 
+ * @param name 命令名或前缀
+ * @param len 比较长度 包含结束符时为精确查找
+ * @return int 命令索引 不存在时返回命令数量
+ */
+static int cmd_lower_bound(const char *name, size_t len)
+{
+	int lo = 0;
+	int hi = cmd_num();
+
+	while (lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+
+		if (strncmp(cmd_at(mid)->name, name, len) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
 	}
 
-	shell_ctx.hash_initialized = true;
+	return lo;
 }
 
-// 添加发送消息
-static void add_msg(uint8_t *msg, size_t len)
+// 按命令名查找命令
+static const struct sp_shell_cmd_t *cmd_find(const char *name)
 {
-	if (!len || !msg)
-		return;
+	int idx = cmd_lower_bound(name, strlen(name) + 1);
+
+	if (idx < cmd_num() && strcmp(cmd_at(idx)->name, name) == 0)
+		return cmd_at(idx);
 
-	// 先写入长度
-	if (queue_add(&shell_ctx.tx_queue, &len, sizeof(len)) != sizeof(len)) {
+	return NULL;
+}
+
+// 写入发送缓冲 空间不足时丢弃超出的部分
+static void shell_out(const void *data, size_t len)
+{
+	if (!len || !data)
 		return;
-	}
 
-	// 再写入数据
-	(void)queue_add(&shell_ctx.tx_queue, (void *)msg, len);
+	(void)queue_add(&shell_ctx.tx_queue, (void *)data, len);
 }
 
 // 加入历史记录
@@ -215,30 +298,199 @@ static void parse_command(char *input, char *argv[], int *argc)
 	argv[*argc] = NULL;
 }
 
-// 处理用户输入命令
-static void process_command(char *cmd_str, uint8_t *output, size_t out_buf_size, size_t *usr_out_len)
+// 解析命令行 找到命令后等待发送缓冲空间足够时执行
+static void start_command(struct shell_context *sh_ctx)
 {
-	if (!cmd_str || !output || !out_buf_size)
-		return;
+	memcpy(sh_ctx->run_buf, sh_ctx->cmd_buf, SPS_CMD_MAX);
+	sh_ctx->run_buf[SPS_CMD_MAX - 1] = '\0';
 
-	char *argv[SPS_CMD_MAX_ARGS] = { 0 };
-	int argc = 0;
-	parse_command(cmd_str, argv, &argc); // 解析命令
-	if (argc == 0)
+	sh_ctx->argc = 0;
+	parse_command(sh_ctx->run_buf, sh_ctx->argv, &sh_ctx->argc); // 解析命令
+	if (sh_ctx->argc == 0) {
+		shell_out(NEW_LINE_PROMPT, strlen(NEW_LINE_PROMPT));
 		return;
+	}
 
-	enum hash_error err;
-	struct sp_shell_cmd_t *cmd = (struct sp_shell_cmd_t *)hash_find(&shell_cmd_table, argv[0], &err);
+	const struct sp_shell_cmd_t *cmd = cmd_find(sh_ctx->argv[0]);
 
-	if (cmd && cmd->cb) {
-		// 存在命令
-		cmd->cb(argc, argv, output, out_buf_size, usr_out_len);
-	} else {
+	if (!cmd || !cmd->cb) {
 		// 不存在命令
-		static const char *err_msg = "command not found\r\n";
-		memcpy(output, err_msg, strlen(err_msg));
-		*usr_out_len = strlen(err_msg);
+		static const char err_msg[] = "command not found\r\n" NEW_LINE_PROMPT;
+		shell_out(err_msg, sizeof(err_msg) - 1);
+		return;
+	}
+
+	sh_ctx->running = cmd;
+	sh_ctx->step = 0;
+}
+
+#if SPS_ENABLE_BINARY
+/**
+ * @brief 输出一个二进制响应帧 发送缓冲空间不足时丢弃整帧
+ * 
+ * 帧格式: SOF(0x5A) | 编号 | 状态 | 长度(2字节 低字节在前) | 数据 | CRC16(编号到数据)
+ * 
+ * @param id 命令编号
+ * @param status 状态 `enum sps_bin_status`
+ * @param data 数据
+ * @param len 数据长度
+ */
+static void bin_reply(uint8_t id, uint8_t status, uint8_t *data, size_t len)
+{
+	if (queue_remain_space(&shell_ctx.tx_queue) < BIN_RSP_HEAD_LEN + len + BIN_CRC_LEN)
+		return;
+
+	uint8_t head[BIN_RSP_HEAD_LEN] = { SPS_BIN_SOF_RSP, id, status, (uint8_t)len, (uint8_t)(len >> 8) };
+	uint16_t crc = crc16_update_bytes(0xFFFF, &head[1], BIN_RSP_HEAD_LEN - 1);
+	if (len)
+		crc = crc16_update_bytes(crc, data, len);
+
+	uint8_t tail[BIN_CRC_LEN] = { (uint8_t)crc, (uint8_t)(crc >> 8) };
+
+	shell_out(head, sizeof(head));
+	shell_out(data, len);
+	shell_out(tail, sizeof(tail));
+}
+
+// 二进制模式的命令编号表 按编号顺序输出以'\0'分隔的命令名
+static void bin_list_cmd(int argc, char *argv[], uint8_t *out, size_t buf_size, size_t *out_len)
+{
+	int i = (int)sps_cmd_step();
+	size_t pos = 0;
+
+	for (; i < cmd_num(); i++) {
+		size_t len = strlen(cmd_at(i)->name) + 1;
+
+		if (pos + len > buf_size) {
+			sps_cmd_continue(i);
+			break;
+		}
+
+		memcpy(out + pos, cmd_at(i)->name, len);
+		pos += len;
+	}
+
+	*out_len = pos;
+}
+
+static const struct sp_shell_cmd_t bin_list = { .name = "", .cb = bin_list_cmd };
+
+/**
+ * @brief 执行二进制请求 argv[0]为命令名, 参数在负载中以'\0'分隔
+ * 
+ * @param sh_ctx 上下文
+ * @param id 命令编号 即命令在有序命令表中的索引
+ * @param args 参数
+ * @param args_len 参数长度
+ */
+static void bin_start(struct shell_context *sh_ctx, uint8_t id, const uint8_t *args, size_t args_len)
+{
+	const struct sp_shell_cmd_t *cmd = NULL;
+
+	if (id == SPS_BIN_ID_LIST)
+		cmd = &bin_list;
+	else if (id < cmd_num())
+		cmd = cmd_at(id);
+
+	if (!cmd || !cmd->cb) {
+		bin_reply(id, SPS_BIN_NO_CMD, NULL, 0);
+		return;
+	}
+
+	size_t name_len = strlen(cmd->name) + 1;
+	if (name_len + args_len + 1 > sizeof(sh_ctx->run_buf)) {
+		bin_reply(id, SPS_BIN_BAD_ARGS, NULL, 0);
+		return;
 	}
+
+	memcpy(sh_ctx->run_buf, cmd->name, name_len);
+	memcpy(sh_ctx->run_buf + name_len, args, args_len);
+	sh_ctx->run_buf[name_len + args_len] = '\0';
+
+	char *p = sh_ctx->run_buf + name_len;
+	char *end = p + args_len;
+
+	sh_ctx->argv[0] = sh_ctx->run_buf;
+	sh_ctx->argc = 1;
+
+	while (p < end && sh_ctx->argc < SPS_CMD_MAX_ARGS - 1) {
+		sh_ctx->argv[sh_ctx->argc++] = p;
+		p += strlen(p) + 1;
+	}
+	sh_ctx->argv[sh_ctx->argc] = NULL;
+
+	sh_ctx->running = cmd;
+	sh_ctx->step = 0;
+	sh_ctx->binary = true;
+	sh_ctx->bin_id = id;
+}
+
+/**
+ * @brief 接收二进制请求帧 收到完整的帧后开始执行命令
+ * 
+ * 帧格式: SOF(0xA5) | 长度 | 编号 | 参数 | CRC16(长度到参数) 长度为编号和参数的字节数
+ * 
+ * @param sh_ctx 上下文
+ * @param ch 接收的字节
+ */
+static void bin_receive(struct shell_context *sh_ctx, uint8_t ch)
+{
+	uint8_t *frame = sh_ctx->bin_buf;
+
+	sh_ctx->bin_idle = 0;
+	frame[sh_ctx->bin_pos++] = ch;
+	if (sh_ctx->bin_pos < 2)
+		return;
+
+	size_t len = frame[1];
+	if (len == 0 || len > SPS_BIN_MAX_PAYLOAD) {
+		sh_ctx->bin_pos = 0; // 长度错误 丢弃后重新同步
+		return;
+	}
+
+	if (sh_ctx->bin_pos < len + 2 + BIN_CRC_LEN)
+		return;
+
+	sh_ctx->bin_pos = 0;
+
+	uint16_t crc = crc16_update_bytes(0xFFFF, &frame[1], len + 1);
+	if (frame[len + 2] != (uint8_t)crc || frame[len + 3] != (uint8_t)(crc >> 8)) {
+		bin_reply(frame[2], SPS_BIN_BAD_CRC, NULL, 0);
+		return;
+	}
+
+	bin_start(sh_ctx, frame[2], &frame[3], len - 1);
+}
+#endif /* SPS_ENABLE_BINARY */
+
+// 执行一次命令回调 命令没有请求继续输出时结束并显示提示符
+static void run_command(struct shell_context *sh_ctx)
+{
+	size_t out_len = 0;
+
+	sh_ctx->more = false;
+	sh_ctx->running->cb(sh_ctx->argc, sh_ctx->argv, sh_ctx->out_buf, sizeof(sh_ctx->out_buf), &out_len);
+	out_len = MIN(out_len, sizeof(sh_ctx->out_buf));
+
+#if SPS_ENABLE_BINARY
+	if (sh_ctx->binary) {
+		// 每段输出一个响应帧 不显示提示符
+		bin_reply(sh_ctx->bin_id, sh_ctx->more ? SPS_BIN_MORE : SPS_BIN_OK, sh_ctx->out_buf, out_len);
+		if (!sh_ctx->more) {
+			sh_ctx->running = NULL;
+			sh_ctx->binary = false;
+		}
+		return;
+	}
+#endif
+
+	shell_out(sh_ctx->out_buf, out_len);
+
+	if (sh_ctx->more)
+		return;
+
+	sh_ctx->running = NULL;
+	shell_out(NEW_LINE_PROMPT, strlen(NEW_LINE_PROMPT));
 }
 
 // 重新命令 用于切换历史记录
@@ -264,7 +516,7 @@ static void rewrite_cmdline(struct shell_context *sh_ctx, size_t del_cnt, uint8_
 	}
 
 	// 回显
-	sh_ctx->opts->write(send_buf, pos);
+	shell_out(send_buf, pos);
 }
 
 // 处理换行
@@ -273,33 +525,24 @@ static void handle_newline(struct shell_context *sh_ctx)
 	if (!sh_ctx)
 		return;
 
-	// 查找命令并执行
-	uint8_t output[MAX_OUT_LEN] = { NEW_LINE[0], NEW_LINE[1] };
-	uint8_t new_line_len = strlen(NEW_LINE);
-
-	size_t usr_out_len = 0;
-
-	if (sh_ctx->cmd_len > 0) {
-		sh_ctx->cmd_buf[sh_ctx->cmd_len] = '\0';
-
-		add_to_history((const char *)sh_ctx->cmd_buf); // 加入历史记录
-
-		// 执行命令
-		process_command((char *)sh_ctx->cmd_buf, output + new_line_len, MAX_OUT_LEN - new_line_len, &usr_out_len);
+	shell_out(NEW_LINE, strlen(NEW_LINE));
+	history_index = -1;
 
-		// 清空输入
-		memset(sh_ctx->cmd_buf, 0, SPS_CMD_MAX);
-		sh_ctx->cmd_len = 0;
+	if (sh_ctx->cmd_len == 0) {
+		shell_out(NEW_LINE_PROMPT, strlen(NEW_LINE_PROMPT));
+		return;
 	}
 
-	size_t remain_len = MAX_OUT_LEN - new_line_len - usr_out_len;
-	size_t cpy_len = MIN(remain_len, strlen(NEW_LINE_PROMPT));
+	sh_ctx->cmd_buf[sh_ctx->cmd_len] = '\0';
 
-	history_index = -1;
-	memcpy(output + new_line_len + usr_out_len, NEW_LINE_PROMPT, cpy_len);
+	add_to_history((const char *)sh_ctx->cmd_buf); // 加入历史记录
+
+	// 执行命令
+	start_command(sh_ctx);
 
-	// 加入新行
-	add_msg(output, usr_out_len + new_line_len + strlen(NEW_LINE_PROMPT));
+	// 清空输入
+	memset(sh_ctx->cmd_buf, 0, SPS_CMD_MAX);
+	sh_ctx->cmd_len = 0;
 }
 
 // 删除键
@@ -311,7 +554,7 @@ static void handle_backspace(struct shell_context *sh_ctx)
 	if (sh_ctx->cmd_len > 0) {
 		// 输出退格序列覆盖
 		static const char bs_seq[] = "\b \b";
-		sh_ctx->opts->write((uint8_t *)bs_seq, sizeof(bs_seq) - 1);
+		shell_out(bs_seq, sizeof(bs_seq) - 1);
 		sh_ctx->cmd_len--;
 		sh_ctx->cmd_buf[sh_ctx->cmd_len] = '\0';
 	}
@@ -384,14 +627,12 @@ static void handle_tab_completion(struct shell_context *sh_ctx)
 	const char *matches[MAX_COMMANDS];
 	int max_matches = MAX_COMMANDS;
 
-	for (int i = 0; i < command_count; i++) {
-		const struct sp_shell_cmd_t *cmd = command_list[i];
-		if (!cmd)
-			continue;
-		if (strncmp(cmd->name, prefix, prefix_len) == 0) {
-			if (match_count < max_matches)
-				matches[match_count++] = cmd->name;
-		}
+	// 有序表中前缀相同的命令是连续的
+	for (int i = cmd_lower_bound(prefix, prefix_len); i < cmd_num() && match_count < max_matches; i++) {
+		const struct sp_shell_cmd_t *cmd = cmd_at(i);
+		if (strncmp(cmd->name, prefix, prefix_len) != 0)
+			break;
+		matches[match_count++] = cmd->name;
 	}
 
 	if (match_count == 0) {
@@ -409,36 +650,19 @@ static void handle_tab_completion(struct shell_context *sh_ctx)
 		sh_ctx->cmd_buf[cmd_len] = '\0';
 		size_t suffix_len = cmd_len - prefix_len;
 		if (suffix_len > 0)
-			sh_ctx->opts->write((uint8_t *)(cmd_name + prefix_len), suffix_len); // 输出补全部分
+			shell_out(cmd_name + prefix_len, suffix_len); // 输出补全部分
 	} else {
 		// 多个匹配，显示所有候选
-		uint8_t tmp_buf[TX_QUEUE_SIZE];
-		size_t pos = 0;
-
-		memcpy(tmp_buf + pos, NEW_LINE, strlen(NEW_LINE));
-		pos += strlen(NEW_LINE);
+		shell_out(NEW_LINE, strlen(NEW_LINE));
 
 		for (int i = 0; i < match_count; i++) {
-			const char *name = matches[i];
-			size_t name_len = strlen(name);
-			if (pos + name_len + 1 > sizeof(tmp_buf))
-				break;
-
-			memcpy(tmp_buf + pos, name, name_len);
-			pos += name_len;
+			shell_out(matches[i], strlen(matches[i]));
 			if (i < match_count - 1)
-				tmp_buf[pos++] = ' ';
+				shell_out(" ", 1);
 		}
 
-		memcpy(tmp_buf + pos, NEW_LINE, strlen(NEW_LINE));
-		pos += strlen(NEW_LINE);
-		memcpy(tmp_buf + pos, NEW_LINE_PROMPT, strlen(NEW_LINE_PROMPT));
-		pos += strlen(NEW_LINE_PROMPT);
-		memcpy(tmp_buf + pos, sh_ctx->cmd_buf, sh_ctx->cmd_len);
-		pos += sh_ctx->cmd_len;
-
-		sh_ctx->opts->write((uint8_t *)tmp_buf, pos); // 输出补全部分
-													  // add_msg(tmp_buf, pos);
+		shell_out(NEW_LINE NEW_LINE_PROMPT, strlen(NEW_LINE NEW_LINE_PROMPT));
+		shell_out(sh_ctx->cmd_buf, sh_ctx->cmd_len);
 	}
 #endif
 }
@@ -452,11 +676,11 @@ static void handle_regular_char(struct shell_context *sh_ctx, uint8_t ch)
 	if (sh_ctx->cmd_len < (SPS_CMD_MAX - 1)) {
 		sh_ctx->cmd_buf[sh_ctx->cmd_len++] = ch;
 		// 回显
-		sh_ctx->opts->write(&ch, 1);
+		shell_out(&ch, 1);
 	} else {
 		// 指令太长
 		static const uint8_t err_msg[] = "\r\n!command too long!\r\n";
-		sh_ctx->opts->write((uint8_t *)err_msg, sizeof(err_msg) - 1);
+		shell_out(err_msg, sizeof(err_msg) - 1);
 		sh_ctx->cmd_len = 0;
 		memset(sh_ctx->cmd_buf, 0, SPS_CMD_MAX);
 	}
@@ -469,10 +693,20 @@ static void shell_parser(struct shell_context *sh_ctx)
 		return;
 
 	uint8_t ch;
-	while (!is_queue_empty(&sh_ctx->rx_queue)) {
+
+	// 开始执行命令后停止解析 剩余输入在命令结束后处理
+	while (!sh_ctx->running && !is_queue_empty(&sh_ctx->rx_queue)) {
 		if (queue_get(&sh_ctx->rx_queue, &ch, 1) != 1)
 			break;
 
+#if SPS_ENABLE_BINARY
+		// 输入行为空时收到请求帧头进入二进制模式 直到收完整帧
+		if (sh_ctx->bin_pos || (ch == SPS_BIN_SOF_REQ && sh_ctx->cmd_len == 0)) {
+			bin_receive(sh_ctx, ch);
+			continue;
+		}
+#endif
+
 		if (ch == '\r' || ch == '\n') {
 			// 换行
 			handle_newline(sh_ctx);
@@ -507,66 +741,75 @@ static void shell_parser(struct shell_context *sh_ctx)
 	}
 }
 
-// 刷新发送缓冲
+/**
+ * @brief 刷新发送缓冲 直接发送环形缓冲区中的连续数据, 不拷贝
+ * 输出接口未全部接收时剩余部分在下次调度时继续发送
+ * 
+ * @param sh_ctx 上下文
+ */
 static void flush_tx_buffer(struct shell_context *sh_ctx)
 {
 	if (!sh_ctx || !sh_ctx->opts->write)
 		return;
 
-	size_t flush_len = 0;
-
-	// 读取长度
-	if (queue_get(&sh_ctx->tx_queue, (uint8_t *)&flush_len, sizeof(size_t)) != sizeof(size_t))
-		return;
+	void *ptr;
+	size_t len;
 
-	if (flush_len == 0 || flush_len > TX_QUEUE_SIZE)
-		return;
+	while ((len = queue_peek_contig(&sh_ctx->tx_queue, &ptr)) != 0) {
+		size_t sent = sh_ctx->opts->write(ptr, len);
+		if (sent > len)
+			sent = len;
 
-	// 读取消息
-	uint8_t tmp_buf[TX_QUEUE_SIZE];
-	if (queue_get(&sh_ctx->tx_queue, tmp_buf, flush_len) != flush_len)
-		return;
+		queue_release(&sh_ctx->tx_queue, sent);
 
-	// 发送
-	sh_ctx->opts->write(tmp_buf, flush_len);
+		if (sent < len)
+			return; // 输出接口忙 下次继续
+	}
 }
 
 /* ====================== 内置命令: list ====================== */
 static void list_cmd(int argc, char *argv[], uint8_t *out, size_t buf_size, size_t *out_len)
 {
-	const char *header = "Available commands:\r\n";
+	int i = (int)sps_cmd_step(); // 本次从第i个命令开始输出
 	size_t pos = 0;
 
-	size_t header_len = strlen(header);
-	size_t copy_len = MIN(header_len, buf_size - pos);
-	if (copy_len > 0) {
-		memcpy(out + pos, header, copy_len);
+	if (i == 0) {
+		const char *header = "Available commands:\r\n";
+		size_t copy_len = MIN(strlen(header), buf_size);
+		memcpy(out, header, copy_len);
 		pos += copy_len;
 	}
 
-	for (int i = 0; i < command_count && pos < buf_size; i++) {
-		if (!command_list[i])
-			continue;
-		const char *desc = command_list[i]->description ? command_list[i]->description : "";
-		int available = buf_size - pos;
-		if (available <= 0)
-			break;
+	for (; i < cmd_num(); i++) {
+		const struct sp_shell_cmd_t *cmd = cmd_at(i);
+		const char *desc = cmd->description ? cmd->description : "";
+		size_t available = buf_size - pos;
 
-		int line_len = snprintf(NULL, 0, "  %-20s - %s\r\n", command_list[i]->name, desc);
+		int line_len = snprintf(NULL, 0, "  %-20s - %s\r\n", cmd->name, desc);
 		if (line_len < 0)
 			break;
-		if (line_len > available)
-			break;
 
-		snprintf((char *)(out + pos), available, "  %-20s - %s\r\n", command_list[i]->name, desc);
+		if ((size_t)line_len >= available) {
+			if (pos == 0) {
+				// 单行超过输出缓冲区 截断输出
+				snprintf((char *)out, buf_size, "  %-20s - %s\r\n", cmd->name, desc);
+				pos = buf_size - 1;
+				i++;
+			}
+			sps_cmd_continue(i); // 剩余的命令下次输出
+			*out_len = pos;
+			return;
+		}
+
+		snprintf((char *)(out + pos), available, "  %-20s - %s\r\n", cmd->name, desc);
 		pos += line_len;
 	}
 
 	if (pos + 2 <= buf_size) {
 		out[pos++] = '\r';
 		out[pos++] = '\n';
-	} else if (pos + 1 <= buf_size) {
-		out[pos++] = '\r';
+	} else {
+		sps_cmd_continue(i);
 	}
 
 	*out_len = pos;
@@ -644,10 +887,6 @@ bool simple_shell_init(struct sp_shell_opts *opts, const char *welcome)
 	memset(&shell_ctx, 0, sizeof(shell_ctx));
 	shell_ctx.opts = opts;
 
-	// 初始化哈希表（容量 = MAX_COMMANDS * 2）减少碰撞
-	if (init_hash_table(&shell_cmd_table, MAX_COMMANDS * 2) != HASH_SUCCESS)
-		return false;
-
 	static uint8_t rx_buffer[RX_QUEUE_SIZE];
 	static uint8_t tx_buffer[TX_QUEUE_SIZE];
 
@@ -663,18 +902,10 @@ bool simple_shell_init(struct sp_shell_opts *opts, const char *welcome)
 
 	// 启动信息
 	if (!welcome)
-		add_msg((uint8_t *)DEFAULT_MSG, strlen(DEFAULT_MSG));
+		shell_out(DEFAULT_MSG, strlen(DEFAULT_MSG));
 	else {
-		size_t tip_len = strlen(TIPS);
-		size_t welcome_len = strlen(welcome);
-		uint8_t *msg = virtual_os_malloc(tip_len + welcome_len);
-		if (!msg)
-			return false;
-
-		memcpy(msg, welcome, welcome_len);
-		memcpy(msg + welcome_len, TIPS, tip_len);
-		add_msg(msg, tip_len + welcome_len);
-		virtual_os_free(msg);
+		shell_out(welcome, strlen(welcome));
+		shell_out(TIPS, strlen(TIPS));
 	}
 
 	return true;
@@ -689,18 +920,52 @@ void shell_dispatch(void)
 	if (!shell_ctx.is_active)
 		return;
 
-	// 只在第一次时把命令插入哈希表
-	hash_save_cmd_once();
+	// 只在第一次时排序命令表
+	cmd_sort_once();
+
+	// 一次调度最多读取一个接收队列的数据 持续输入时不会一直占用调度, 剩余输入在下次调度处理
+	size_t budget = RX_QUEUE_SIZE;
+	size_t got;
+	bool ran = false;
+
+	// 处理已接收的命令 每次调度最多执行一次命令回调(一段输出), 流式输出的命令分多次调度完成
+	do {
+		// 读取 直接读入接收队列
+		got = queue_fill(&shell_ctx.rx_queue, shell_ctx.opts->read, budget);
+		budget -= got;
 
-	// 读取
-	uint8_t tmp_buf[RX_QUEUE_SIZE];
-	size_t bytes_read = shell_ctx.opts->read(tmp_buf, RX_QUEUE_SIZE);
-	if (bytes_read > 0)
-		queue_add(&shell_ctx.rx_queue, tmp_buf, bytes_read);
+		// 解析
+		shell_parser(&shell_ctx);
+
+		// 执行命令 发送缓冲空间不足时等待下次调度
+		if (shell_ctx.running && queue_remain_space(&shell_ctx.tx_queue) >= CMD_OUT_SPACE) {
+			run_command(&shell_ctx);
+			ran = true;
+		}
+	} while (!ran && !shell_ctx.running && got && budget);
 
-	// 解析
-	shell_parser(&shell_ctx);
+#if SPS_ENABLE_BINARY && SPS_BIN_TIMEOUT
+	// 请求帧中途断开时丢弃 否则之后的文本输入都会被当作请求帧
+	if (shell_ctx.bin_pos && budget == RX_QUEUE_SIZE && ++shell_ctx.bin_idle >= SPS_BIN_TIMEOUT) {
+		shell_ctx.bin_pos = 0;
+		shell_ctx.bin_idle = 0;
+	}
+#endif
 
 	// 刷新
 	flush_tx_buffer(&shell_ctx);
-}
\ No newline at end of file
+}
+
+void sps_cmd_continue(uint32_t step)
+{
+	if (!shell_ctx.running)
+		return;
+
+	shell_ctx.more = true;
+	shell_ctx.step = step;
+}
+
+uint32_t sps_cmd_step(void)
+{
+	return shell_ctx.step;
+}
@@ -241,3 +241,293 @@ uint8_t soft_iic_read_bytes(uint8_t addr, uint8_t reg, uint8_t len, uint8_t *buf
 	soft_iic_stop();
 	return 0;
 }
+
+/**************************************异步接口**************************************/
+
+// 异步状态机的位级操作
+enum iic_async_op {
+	IIC_OP_IDLE = 0, /* 空闲 */
+	IIC_OP_START,	 /* (重复)起始条件 */
+	IIC_OP_TX,		 /* 发送一个字节 */
+	IIC_OP_RX_ACK,	 /* 接收应答 */
+	IIC_OP_RX,		 /* 接收一个字节 */
+	IIC_OP_TX_ACK,	 /* 发送应答 */
+	IIC_OP_STOP,	 /* 停止条件 */
+};
+
+struct iic_async {
+	volatile uint8_t op; /* 当前操作 参考`enum iic_async_op` */
+	uint8_t phase;		 /* 当前操作内的半周期序号 */
+	uint8_t bit;		 /* 当前字节的位序号 */
+	uint8_t byte;		 /* 正在收发的字节 */
+	bool addr_phase;	 /* 正在发送地址 */
+	bool ack;			 /* 接收时是否回复应答 */
+	uint8_t err;		 /* 1:从机无应答 */
+
+	struct i2c_msg *msgs; /* 消息数组 */
+	size_t num;			  /* 消息数量 */
+	size_t idx;			  /* 当前消息 */
+	size_t pos;			  /* 当前消息内的字节位置 */
+
+	soft_iic_done_f done; /* 完成回调 */
+	void *arg;			  /* 回调参数 */
+
+	uint8_t reg;			/* 兼容接口的寄存器地址 */
+	uint8_t data;			/* 兼容接口的单字节数据 */
+	struct i2c_msg wrap[2]; /* 兼容接口的消息 */
+};
+
+static struct iic_async iic_async;
+
+static inline void iic_op_set(struct iic_async *s, uint8_t op)
+{
+	s->op = op;
+	s->phase = 0;
+	s->bit = 0;
+}
+
+// 当前消息的下一个数据操作 消息结束后进入下一条消息或停止条件
+static void iic_data_next(struct iic_async *s)
+{
+	struct i2c_msg *msg;
+
+	while (s->idx < s->num) {
+		msg = &(s->msgs[s->idx]);
+		if (s->pos < msg->len) {
+			if (msg->flags & I2C_FLAG_READ) {
+				s->ack = (s->pos + 1 < msg->len); // 每条读消息的最后一个字节回复无应答
+				iic_op_set(s, IIC_OP_RX);
+			} else {
+				s->byte = msg->buf[s->pos];
+				iic_op_set(s, IIC_OP_TX);
+			}
+			return;
+		}
+
+		s->idx++;
+		s->pos = 0;
+		if (s->idx < s->num && !(s->msgs[s->idx].flags & I2C_FLAG_NOSTART)) {
+			iic_op_set(s, IIC_OP_START);
+			return;
+		}
+	}
+
+	iic_op_set(s, IIC_OP_STOP);
+}
+
+// 一个位级操作完成 决定下一个操作
+static void iic_op_done(struct iic_async *s)
+{
+	struct i2c_msg *msg = &(s->msgs[s->idx]);
+
+	switch (s->op) {
+	case IIC_OP_START:
+		s->byte = (msg->addr << 1) | (msg->flags & I2C_FLAG_READ);
+		s->addr_phase = true;
+		iic_op_set(s, IIC_OP_TX);
+		break;
+
+	case IIC_OP_TX:
+		iic_op_set(s, IIC_OP_RX_ACK);
+		break;
+
+	case IIC_OP_RX_ACK:
+		if (s->err) {
+			iic_op_set(s, IIC_OP_STOP);
+			break;
+		}
+		if (s->addr_phase)
+			s->addr_phase = false;
+		else
+			s->pos++;
+		iic_data_next(s);
+		break;
+
+	case IIC_OP_RX:
+		msg->buf[s->pos] = s->byte;
+		iic_op_set(s, IIC_OP_TX_ACK);
+		break;
+
+	case IIC_OP_TX_ACK:
+		s->pos++;
+		iic_data_next(s);
+		break;
+
+	case IIC_OP_STOP:
+	default:
+		// 先置为空闲 回调中可以启动下一次传输
+		iic_op_set(s, IIC_OP_IDLE);
+		if (s->done)
+			s->done(s->err, s->idx, s->arg);
+		break;
+	}
+}
+
+// 推进半个时钟周期 时序与同步接口一致
+static void iic_async_step(struct iic_async *s)
+{
+	switch (s->op) {
+	case IIC_OP_START:
+		if (s->phase == 0) {
+			sda_out(iic_high);
+			scl_out(iic_high);
+		} else if (s->phase == 1) {
+			sda_out(iic_low);
+		} else {
+			scl_out(iic_low);
+			iic_op_done(s);
+			return;
+		}
+		break;
+
+	case IIC_OP_TX:
+		if (s->phase == 0) {
+			sda_out((s->byte & 0x80) >> 7);
+			s->byte <<= 1;
+			scl_out(iic_high);
+		} else {
+			scl_out(iic_low);
+			if (++(s->bit) == 8) {
+				iic_op_done(s);
+				return;
+			}
+			s->phase = 0;
+			return;
+		}
+		break;
+
+	case IIC_OP_RX_ACK:
+		if (s->phase == 0) {
+			sda_out(iic_high);
+		} else if (s->phase == 1) {
+			scl_out(iic_high);
+		} else {
+			s->err = sda_in() ? 1 : 0;
+			scl_out(iic_low);
+			iic_op_done(s);
+			return;
+		}
+		break;
+
+	case IIC_OP_RX:
+		if (s->phase == 0) {
+			scl_out(iic_high);
+		} else {
+			s->byte = (s->byte << 1) | (sda_in() ? 1 : 0);
+			scl_out(iic_low);
+			if (++(s->bit) == 8) {
+				iic_op_done(s);
+				return;
+			}
+			s->phase = 0;
+			return;
+		}
+		break;
+
+	case IIC_OP_TX_ACK:
+		if (s->phase == 0) {
+			sda_out(s->ack ? iic_low : iic_high);
+		} else if (s->phase == 1) {
+			scl_out(iic_high);
+		} else {
+			scl_out(iic_low);
+			sda_out(iic_high); // 释放数据线 供从机发送下一个字节
+			iic_op_done(s);
+			return;
+		}
+		break;
+
+	case IIC_OP_STOP:
+		if (s->phase == 0) {
+			scl_out(iic_low);
+			sda_out(iic_low);
+		} else if (s->phase == 1) {
+			scl_out(iic_high);
+		} else {
+			sda_out(iic_high);
+			iic_op_done(s);
+			return;
+		}
+		break;
+
+	default:
+		return;
+	}
+
+	s->phase++;
+}
+
+uint8_t soft_iic_xfer_async(struct i2c_msg *msgs, size_t num, soft_iic_done_f done, void *arg)
+{
+	struct iic_async *s = &iic_async;
+
+	if (!scl_out || !msgs || !num || (msgs[0].flags & I2C_FLAG_NOSTART) || s->op != IIC_OP_IDLE)
+		return 1;
+
+	s->msgs = msgs;
+	s->num = num;
+	s->idx = 0;
+	s->pos = 0;
+	s->err = 0;
+	s->addr_phase = false;
+	s->done = done;
+	s->arg = arg;
+	__sync_synchronize(); // 参数先于状态可见 防止定时器中断读到未初始化的参数
+	iic_op_set(s, IIC_OP_START);
+
+	return 0;
+}
+
+uint8_t soft_iic_write_one_byte_async(uint8_t addr, uint8_t reg, uint8_t data, soft_iic_done_f done, void *arg)
+{
+	if (soft_iic_async_busy())
+		return 1;
+
+	iic_async.data = data;
+	return soft_iic_write_bytes_async(addr, reg, 1, &(iic_async.data), done, arg);
+}
+
+uint8_t soft_iic_write_bytes_async(
+	uint8_t addr, uint8_t reg, uint8_t len, uint8_t *buf, soft_iic_done_f done, void *arg)
+{
+	struct iic_async *s = &iic_async;
+
+	if (soft_iic_async_busy())
+		return 1;
+
+	s->reg = reg;
+	s->wrap[0] = (struct i2c_msg){ 1, &(s->reg), addr, I2C_FLAG_WRITE };
+	s->wrap[1] = (struct i2c_msg){ len, buf, addr, I2C_FLAG_WRITE | I2C_FLAG_NOSTART };
+	return soft_iic_xfer_async(s->wrap, 2, done, arg);
+}
+
+uint8_t soft_iic_read_bytes_async(uint8_t addr, uint8_t reg, uint8_t len, uint8_t *buf, soft_iic_done_f done, void *arg)
+{
+	struct iic_async *s = &iic_async;
+
+	if (soft_iic_async_busy())
+		return 1;
+
+	s->reg = reg;
+	s->wrap[0] = (struct i2c_msg){ 1, &(s->reg), addr, I2C_FLAG_WRITE };
+	s->wrap[1] = (struct i2c_msg){ len, buf, addr, I2C_FLAG_READ };
+	return soft_iic_xfer_async(s->wrap, 2, done, arg);
+}
+
+bool soft_iic_async_poll(void)
+{
+	struct iic_async *s = &iic_async;
+
+	for (uint32_t i = 0; i < SOFT_IIC_ASYNC_STEPS_PER_POLL && s->op != IIC_OP_IDLE; i++) {
+		if (i)
+			iic_delay(2);
+		iic_async_step(s);
+	}
+
+	return s->op != IIC_OP_IDLE;
+}
+
+bool soft_iic_async_busy(void)
+{
+	return iic_async.op != IIC_OP_IDLE;
+}
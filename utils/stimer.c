@@ -36,21 +36,61 @@
 #include "utils/stimer.h"
 
 #include "core/virtual_os_mm.h"
+#include "core/virtual_os_defines.h"
 
-#define HIT_LIST_MASK (STIMER_TASK_HIT_LIST_MAX - 1)
-#define HIT_LIST_IDX(t) ((m_timer.pre_tick + (t)) & HIT_LIST_MASK)
+#if STIMER_PROFILE_ENABLE
+#include <stdio.h>
+#include "utils/simple_shell.h"
+#endif
 
-#define STIMER_TASK_HIT_LIST_MAX (32)
-#define MAX_DEFER_TASK (16)
+#if (STIMER_WHEEL_BITS * STIMER_WHEEL_LEVELS) > 32
+#error "STIMER_WHEEL_BITS * STIMER_WHEEL_LEVELS must not exceed 32"
+#endif
+
+#define WHEEL_SLOTS (1U << STIMER_WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_SHIFT(l) ((l) * STIMER_WHEEL_BITS)
+#define WHEEL_SLOT(t, l) (((t) >> WHEEL_SHIFT(l)) & WHEEL_MASK)
+#define WHEEL_MAX_TICKS ((uint32_t)(((uint64_t)1 << WHEEL_SHIFT(STIMER_WHEEL_LEVELS)) - 1)) // 时间轮可直接表示的最大节拍数
+
+#define MAX_DEFER_TASK (16) // 预留的单次定时器节点数, 同时也是中断中待处理的延时任务队列深度 必须为2的幂
+#define DEFER_MASK (MAX_DEFER_TASK - 1)
+
+#define STIMER_FLAG_ONESHOT (1U << 0)	// 单次定时器
+#define STIMER_FLAG_AUTO_FREE (1U << 1) // 执行后自动释放 用于`defer_task_create`
+#define STIMER_FLAG_EVENT (1U << 2)		// 事件任务
 
 #define Period_to_Tick(p) (((p) >= STIMER_PERIOD_PER_TICK_MS) ? ((p) / STIMER_PERIOD_PER_TICK_MS) : 1U)
 
+#if STIMER_PROFILE_ENABLE
+// 任务执行时间统计 单位为`f_get_cycle`的计数值
+struct stimer_profile {
+	uint64_t total; // 累计执行时间
+	uint32_t min;	// 最短执行时间
+	uint32_t max;	// 最长执行时间
+	uint32_t calls; // 执行次数
+	uint32_t miss;	// 晚于到期节拍执行的次数
+};
+#endif
+
 struct stimer_task {
 	stimer_f task_f;
+	stimer_timer_cb timer_f; // 单次定时器回调
+	void *arg;				 // 单次定时器回调参数
 	uint32_t period;
-	uint32_t arrive;
-	list_item item;
-	uint8_t reserved;
+	uint32_t expires; // 到期的绝对节拍
+	uint32_t overrun; // 错过的周期数
+	list_item item;	  // 挂入时间轮时有效, 未启动时为空
+	uint8_t flags;	  // STIMER_FLAG_*
+	uint8_t catchup;  // 补偿策略 参考`enum stimer_catchup`
+	int8_t prio;	 // 优先级 参考`enum stimer_prio`
+	uint32_t slip;	 // 因节拍预算耗尽被推迟的节拍数, 执行或重新启动时清零
+	volatile uint8_t pending; // 事件任务: 有待处理的事件
+#if STIMER_PROFILE_ENABLE
+	const char *name;		  // 任务名
+	struct stimer_task *next; // 统计链表
+	struct stimer_profile prof;
+#endif
 };
 
 struct timer {
@@ -58,11 +98,29 @@ struct timer {
 	volatile uint32_t cur_tick;
 	volatile int run_flag;
 	stimer_base_start f_start;
-	list_item long_tick_list;
-	list_item hit_task_list[STIMER_TASK_HIT_LIST_MAX];
-	list_item defer_task_list;
+	stimer_base_set_alarm f_set_alarm; // tickless 设置唤醒
+	stimer_base_sleep f_sleep;		   // tickless 休眠钩子
+	uint32_t alarm_tick;			   // tickless 已设置的唤醒节拍
+	stimer_base_get_cycle f_get_cycle; // 高精度计数
+#if STIMER_PROFILE_ENABLE
+	struct stimer_task *prof_list; // 所有周期任务
+#endif
+	list_item wheel[STIMER_WHEEL_LEVELS][WHEEL_SLOTS]; // 分级时间轮 第0级每槽1个节拍, 第n级每槽为第n-1级一圈
+	list_item free_list;			// 空闲的单次定时器节点
+	list_item event_list;			// 事件任务
+	volatile uint8_t event_pending; // 有事件任务被触发
+
+	volatile uint32_t defer_wr; // 中断写入 在临界区中预留并写入请求
+	volatile uint32_t defer_rd; // 调度器读取
+};
+
+// 中断中创建的延时任务 由调度器取出后挂入时间轮
+struct defer_req {
+	stimer_f task_f;
+	uint32_t expires;
 };
 
+static struct defer_req defer_ring[MAX_DEFER_TASK];
 static struct stimer_task defer_pool[MAX_DEFER_TASK];
 static struct timer m_timer = { 0 };
 
@@ -76,33 +134,169 @@ static inline void _timer_update(void)
 	++m_timer.cur_tick;
 }
 
-static struct stimer_task *defer_task_allocate(void)
+static inline bool is_tickless(void)
+{
+	return m_timer.f_set_alarm && m_timer.f_sleep;
+}
+
+// 申请单次定时器节点 空闲链表为空时从堆中扩充
+static struct stimer_task *stimer_timer_alloc(void)
+{
+	list_item *head = &(m_timer.free_list);
+	struct stimer_task *task;
+
+	if (head->next == head)
+		return (struct stimer_task *)virtual_os_calloc(1, sizeof(struct stimer_task));
+
+	task = container_of(head->next, struct stimer_task, item);
+	list_delete_item(&(task->item));
+	*task = (struct stimer_task){ 0 };
+	return task;
+}
+
+// 节点只回收到空闲链表 不归还堆
+static void stimer_timer_free(struct stimer_task *task)
+{
+	list_delete_item(&(task->item));
+	task->flags = 0;
+	list_add_tail(&(m_timer.free_list), &(task->item));
+}
+
+// 按优先级插入槽位 同优先级保持加入顺序
+static inline void _add_slot(list_item *head, struct stimer_task *task)
 {
-	for (int i = 0; i < MAX_DEFER_TASK; i++) {
-		if (defer_pool[i].reserved == 1)
-			return &defer_pool[i];
+	list_item *pos = head;
+
+	while (pos->pre != head && container_of(pos->pre, struct stimer_task, item)->prio < task->prio)
+		pos = pos->pre;
+
+	list_insert_before(pos, &(task->item));
+}
+
+/**
+ * @brief 按到期节拍挂入时间轮
+ * 
+ * 距离到期的节拍数小于第n级一圈的节拍数时挂入第n级, 槽位由到期节拍的对应位段决定
+ * 超出时间轮表示范围的任务先挂入最高级, 级联时再按实际到期节拍重新挂载
+ * 
+ * @param task 任务
+ */
+static inline void _wheel_insert(struct stimer_task *task)
+{
+	uint32_t diff = task->expires - m_timer.pre_tick;
+	uint32_t expires = task->expires;
+	uint8_t level = 0;
+
+	if (diff > WHEEL_MAX_TICKS) {
+		diff = WHEEL_MAX_TICKS;
+		expires = m_timer.pre_tick + diff;
 	}
-	return NULL;
+
+	while (level < STIMER_WHEEL_LEVELS - 1 && diff >= (WHEEL_SLOTS << WHEEL_SHIFT(level)))
+		level++;
+
+	list_item *head = &(m_timer.wheel[level][WHEEL_SLOT(expires, level)]);
+
+	// 只有第0级的任务会被执行 高级槽位在级联时再排序
+	if (level == 0)
+		_add_slot(head, task);
+	else
+		list_add_tail(head, &(task->item));
 }
 
-static void defer_task_free(struct stimer_task *task)
+static inline void _add_timer(struct stimer_task *task, uint32_t delay)
 {
-	if (task) {
-		task->task_f = NULL;
-		task->reserved = 1;
-		task->arrive = 0;
-		task->period = 0;
+	list_delete_item(&(task->item));
+
+	task->expires = m_timer.pre_tick + delay;
+	_wheel_insert(task);
+}
+
+/**
+ * @brief 第0级转完一圈时 将高级时间轮当前槽位的任务下移
+ * 
+ * 第n级只有在第0~n-1级全部回到0号槽位时才需要级联
+ */
+static void stimer_wheel_cascade(void)
+{
+	struct list_item *cur_item, *next_item;
+
+	for (uint8_t level = 1; level < STIMER_WHEEL_LEVELS; level++) {
+		uint32_t slot = WHEEL_SLOT(m_timer.pre_tick, level);
+
+		list_for_each_safe(cur_item, next_item, &(m_timer.wheel[level][slot]))
+		{
+			list_delete_item(cur_item);
+			_wheel_insert(container_of(cur_item, struct stimer_task, item));
+		}
+
+		if (slot)
+			break;
 	}
 }
 
-static inline void _add_timer(uint32_t period, list_item *item)
+// 将中断中创建的延时任务挂入时间轮 只在调度器上下文调用
+// 申请节点失败时请求保留在队列中, 下次调度时重试, 已经返回成功的请求不会丢失
+static void stimer_defer_drain(void)
 {
-	list_delete_item(item);
+	while (m_timer.defer_rd != m_timer.defer_wr) {
+		struct defer_req *req = &defer_ring[m_timer.defer_rd & DEFER_MASK];
+		struct stimer_task *task = stimer_timer_alloc();
 
-	if (period > STIMER_TASK_HIT_LIST_MAX)
-		list_add_tail(&(m_timer.long_tick_list), item);
-	else
-		list_add_tail(&(m_timer.hit_task_list[HIT_LIST_IDX(period)]), item);
+		if (!task)
+			return;
+
+		task->task_f = req->task_f;
+		task->flags = STIMER_FLAG_ONESHOT | STIMER_FLAG_AUTO_FREE;
+		task->expires = req->expires;
+
+		// 重试时可能已经到期 在下一个节拍执行
+		if ((int32_t)(task->expires - m_timer.pre_tick) <= 0)
+			task->expires = m_timer.pre_tick + 1;
+		_wheel_insert(task);
+
+		__sync_synchronize(); // 读完请求后再释放队列位置
+		m_timer.defer_rd++;
+	}
+}
+
+// 执行到期的单次定时器 回调中可以重新启动或删除自身
+static void stimer_timer_run(struct stimer_task *task)
+{
+	list_delete_item(&(task->item));
+	task->slip = 0;
+
+	if (task->timer_f)
+		task->timer_f(task->arg);
+	else if (task->task_f)
+		task->task_f();
+
+	if (task->flags & STIMER_FLAG_AUTO_FREE)
+		stimer_timer_free(task);
+}
+
+// 执行所有被触发的事件任务
+static void stimer_event_dispatch(void)
+{
+	struct list_item *cur_item, *next_item;
+	struct stimer_task *task;
+
+	while (m_timer.event_pending) {
+		// 先清除总标志再检查各任务 处理期间新触发的事件会在下一轮处理
+		m_timer.event_pending = 0;
+		__sync_synchronize();
+
+		list_for_each_safe(cur_item, next_item, &(m_timer.event_list))
+		{
+			task = container_of(cur_item, struct stimer_task, item);
+			if (!task->pending)
+				continue;
+
+			task->pending = 0;
+			__sync_synchronize();
+			task->timer_f(task->arg);
+		}
+	}
 }
 
 static bool stimer_task_add(struct stimer_task *p_task)
@@ -110,8 +304,7 @@ static bool stimer_task_add(struct stimer_task *p_task)
 	if (!p_task)
 		return false;
 
-	p_task->arrive = 0;
-	_add_timer(p_task->period, &(p_task->item));
+	_add_timer(p_task, p_task->period);
 	return true;
 }
 
@@ -120,54 +313,168 @@ static uint32_t inline stimer_get_tick(void)
 	return m_timer.cur_tick;
 }
 
+/**
+ * @brief 执行到期的周期任务并计算下一次到期时间
+ * 
+ * 调度落后于实际节拍时(某个任务执行时间过长), 根据任务的补偿策略决定下一次到期时间:
+ * STIMER_CATCHUP_ALL  按原周期重新加入, 错过的周期会在后续节拍中被逐个补齐
+ * STIMER_CATCHUP_SKIP 跳过已错过的周期, 下一次到期时间仍对齐到原周期的相位上
+ * 
+ * @param task 任务
+ * @return uint32_t 距离下一次到期的节拍数
+ */
+static uint32_t stimer_task_run(struct stimer_task *task)
+{
+	uint32_t lag = m_timer.cur_tick - m_timer.pre_tick; // 调度落后的节拍数
+	uint32_t missed = lag / task->period;				// 错过的周期数
+
+#if STIMER_PROFILE_ENABLE
+	uint32_t start = m_timer.f_get_cycle ? m_timer.f_get_cycle() : 0;
+#endif
+
+	if (task->task_f)
+		task->task_f();
+
+#if STIMER_PROFILE_ENABLE
+	uint32_t cost = m_timer.f_get_cycle ? (m_timer.f_get_cycle() - start) : 0;
+	struct stimer_profile *prof = &(task->prof);
+
+	if (!prof->calls || cost < prof->min)
+		prof->min = cost;
+	if (cost > prof->max)
+		prof->max = cost;
+	prof->total += cost;
+	prof->calls++;
+	if (lag || task->slip)
+		prof->miss++;
+#endif
+
+	uint32_t delay = task->period;
+	uint32_t slip = task->slip;
+
+	task->slip = 0;
+
+	if (task->catchup == STIMER_CATCHUP_SKIP) {
+		task->overrun += missed;
+		delay = task->period * (missed + 1);
+	} else if (missed) {
+		// 补齐模式下每次落后超过一个周期的执行都记为一次错过
+		task->overrun++;
+	}
+
+	// 扣除被推迟的节拍 保持原周期相位
+	return (delay > slip) ? (delay - slip) : 1U;
+}
+
+// 当前节拍的执行时间预算是否耗尽
+static inline bool stimer_budget_exhausted(uint32_t start)
+{
+#if STIMER_TICK_BUDGET_CYCLES
+	return m_timer.f_get_cycle && (m_timer.f_get_cycle() - start) >= STIMER_TICK_BUDGET_CYCLES;
+#else
+	(void)start;
+	return false;
+#endif
+}
+
 static void stimer_task_dispatch(void)
 {
-	uint32_t idx, remain;
-	struct list_item *cur_item, *next_item;
+	uint32_t idx;
+	list_item expired;
 	struct stimer_task *task;
 
+	stimer_defer_drain();
+
 	if (!is_timer_run() || (m_timer.pre_tick == m_timer.cur_tick))
 		return;
 
 	++m_timer.pre_tick;
-	idx = HIT_LIST_IDX(0);
-
-	if (idx == 0) {
-		list_for_each_safe(cur_item, next_item, &(m_timer.long_tick_list))
-		{
-			task = container_of(cur_item, struct stimer_task, item);
-			task->arrive += STIMER_TASK_HIT_LIST_MAX;
-			remain = task->period - task->arrive;
-
-			if (remain == 0) {
-				if (task->task_f)
-					task->task_f();
-				task->arrive = 0;
-			} else if (remain < STIMER_TASK_HIT_LIST_MAX) {
-				_add_timer(remain, cur_item);
-			}
+	idx = WHEEL_SLOT(m_timer.pre_tick, 0);
+
+	// 级联下来的到期任务进入当前槽位 与其他任务按优先级一起执行
+	if (idx == 0)
+		stimer_wheel_cascade();
+
+#if STIMER_TICK_BUDGET_CYCLES
+	uint32_t start = m_timer.f_get_cycle ? m_timer.f_get_cycle() : 0;
+#else
+	uint32_t start = 0;
+#endif
+
+	// 先摘下当前槽位 回调中启动或停止其他定时器不会破坏遍历
+	list_init(&expired);
+	list_splice_tail(&expired, &(m_timer.wheel[0][idx]));
+
+	while (expired.next != &expired) {
+		task = container_of(expired.next, struct stimer_task, item);
+
+		// 预算耗尽 低优先级任务推迟到下一个节拍
+		if (task->prio < STIMER_PRIO_HIGH && stimer_budget_exhausted(start)) {
+			task->slip++;
+			_add_timer(task, 1);
+			continue;
 		}
+
+		if (task->flags & STIMER_FLAG_ONESHOT)
+			stimer_timer_run(task);
+		else
+			_add_timer(task, stimer_task_run(task));
 	}
+}
 
-	list_for_each_safe(cur_item, next_item, &(m_timer.hit_task_list[idx]))
-	{
-		task = container_of(cur_item, struct stimer_task, item);
-		if (task->task_f)
-			task->task_f();
-		task->arrive = -idx;
-		_add_timer(task->period, &(task->item));
+/**
+ * @brief 计算距离最近到期任务的节拍数
+ * 
+ * @return uint32_t 节拍数 无任务时返回`STIMER_TICKLESS_MAX_IDLE_TICKS`
+ */
+static uint32_t stimer_next_due_ticks(void)
+{
+	uint32_t ticks = STIMER_TICKLESS_MAX_IDLE_TICKS;
+	uint32_t remain;
+
+	// 第0级中最近的非空槽位
+	for (uint32_t t = 1; t <= WHEEL_SLOTS && t < ticks; t++) {
+		list_item *head = &(m_timer.wheel[0][WHEEL_SLOT(m_timer.pre_tick + t, 0)]);
+		if (head->next != head) {
+			ticks = t;
+			break;
+		}
 	}
 
-	list_for_each_safe(cur_item, next_item, &(m_timer.defer_task_list))
-	{
-		task = container_of(cur_item, struct stimer_task, item);
-		if (++task->arrive >= task->period) {
-			if (task->task_f)
-				task->task_f();
-			list_delete_item(cur_item);
-			defer_task_free(task);
+	// 高级时间轮中最近一个非空槽位的级联节拍
+	for (uint8_t level = 1; level < STIMER_WHEEL_LEVELS; level++) {
+		uint32_t pos = m_timer.pre_tick >> WHEEL_SHIFT(level);
+
+		for (uint32_t k = 1; k <= WHEEL_SLOTS; k++) {
+			list_item *head = &(m_timer.wheel[level][(pos + k) & WHEEL_MASK]);
+			if (head->next != head) {
+				remain = ((pos + k) << WHEEL_SHIFT(level)) - m_timer.pre_tick;
+				if (remain < ticks)
+					ticks = remain;
+				break;
+			}
 		}
 	}
+
+	return ticks;
+}
+
+/**
+ * @brief 空闲处理 tickless模式下设置下一次唤醒并进入休眠
+ * 
+ */
+static void stimer_idle(void)
+{
+	if (!is_tickless())
+		return;
+
+	uint32_t wake_tick = m_timer.cur_tick + stimer_next_due_ticks();
+	if (wake_tick != m_timer.alarm_tick) {
+		m_timer.alarm_tick = wake_tick;
+		m_timer.f_set_alarm(wake_tick - m_timer.cur_tick);
+	}
+
+	m_timer.f_sleep();
 }
 
 /*************************************API*************************************/
@@ -177,73 +484,247 @@ bool stimer_init(struct timer_port *port)
 	if (!port || !port->f_init || !port->f_start)
 		return false;
 
-	list_init(&(m_timer.long_tick_list));
-	list_init(&(m_timer.defer_task_list));
+	list_init(&(m_timer.free_list));
+	list_init(&(m_timer.event_list));
 
 	for (int i = 0; i < MAX_DEFER_TASK; i++)
-		defer_pool[i] = (struct stimer_task){ .reserved = 1 };
+		list_add_tail(&(m_timer.free_list), &(defer_pool[i].item));
 
-	for (uint8_t i = 0; i < STIMER_TASK_HIT_LIST_MAX; i++)
-		list_init(&(m_timer.hit_task_list[i]));
+	for (uint8_t level = 0; level < STIMER_WHEEL_LEVELS; level++) {
+		for (uint32_t i = 0; i < WHEEL_SLOTS; i++)
+			list_init(&(m_timer.wheel[level][i]));
+	}
 
 	port->f_init(STIMER_PERIOD_PER_TICK_MS, _timer_update);
 	m_timer.f_start = port->f_start;
+	m_timer.f_set_alarm = port->f_set_alarm;
+	m_timer.f_sleep = port->f_sleep;
+	m_timer.f_get_cycle = port->f_get_cycle;
 	return true;
 }
 
+void stimer_tick_announce(uint32_t ticks)
+{
+	m_timer.cur_tick += ticks;
+}
+
+bool stimer_wakeup_pending(void)
+{
+	return (m_timer.pre_tick != m_timer.cur_tick) || (m_timer.defer_rd != m_timer.defer_wr) || m_timer.event_pending;
+}
+
+uint32_t stimer_get_cycle(void)
+{
+	return m_timer.f_get_cycle ? m_timer.f_get_cycle() : 0;
+}
+
 bool stimer_task_create(stimer_f init_f, stimer_f task_f, uint32_t period_ms)
+{
+	return stimer_task_create_ex(init_f, task_f, period_ms, NULL) != NULL;
+}
+
+stimer_task_handle stimer_task_create_ex(
+	stimer_f init_f, stimer_f task_f, uint32_t period_ms, const struct stimer_task_attr *attr)
 {
 	if (init_f)
 		init_f();
 
 	if (!task_f || !period_ms)
-		return false;
+		return NULL;
 
 	struct stimer_task *task = (struct stimer_task *)virtual_os_calloc(1, sizeof(struct stimer_task));
 	if (task) {
 		task->period = Period_to_Tick(period_ms);
-		task->reserved = 1;
 		task->task_f = task_f;
+		task->catchup = attr ? attr->catchup : STIMER_CATCHUP_ALL;
+		task->prio = attr ? attr->prio : STIMER_PRIO_NORMAL;
 		list_init(&(task->item));
 
-		return stimer_task_add(task);
+		if (stimer_task_add(task)) {
+#if STIMER_PROFILE_ENABLE
+			task->name = attr ? attr->name : NULL;
+			task->next = m_timer.prof_list;
+			m_timer.prof_list = task;
+#endif
+			return task;
+		}
+
+		virtual_os_free(task);
 	}
-	return false;
+	return NULL;
+}
+
+uint32_t stimer_task_get_overrun(stimer_task_handle task)
+{
+	return task ? task->overrun : 0;
 }
 
 bool defer_task_create(stimer_f task_f, uint32_t ms)
 {
-	if (!is_timer_run())
+	if (!task_f)
 		return false;
 
-	struct stimer_task *p_task = defer_task_allocate();
-	if (!p_task)
+	// 不同优先级的中断和调度器可能同时创建 预留位置和发布在同一个临界区中完成
+	uint32_t state = virtual_os_enter_critical();
+	uint32_t wr = m_timer.defer_wr;
+	bool ret = (wr - m_timer.defer_rd) < MAX_DEFER_TASK;
+
+	if (ret) {
+		defer_ring[wr & DEFER_MASK] = (struct defer_req){
+			.task_f = task_f,
+			.expires = m_timer.cur_tick + Period_to_Tick(ms),
+		};
+		m_timer.defer_wr = wr + 1;
+	}
+
+	virtual_os_exit_critical(state);
+	return ret;
+}
+
+stimer_timer_handle stimer_timer_create(stimer_timer_cb cb, void *arg)
+{
+	if (!cb)
+		return NULL;
+
+	struct stimer_task *task = stimer_timer_alloc();
+	if (task) {
+		task->timer_f = cb;
+		task->arg = arg;
+		task->flags = STIMER_FLAG_ONESHOT;
+		task->prio = STIMER_PRIO_NORMAL;
+	}
+	return task;
+}
+
+bool stimer_timer_start(stimer_timer_handle timer, uint32_t ms)
+{
+	if (!timer || !(timer->flags & STIMER_FLAG_ONESHOT))
 		return false;
 
-	p_task->task_f = task_f;
-	p_task->period = Period_to_Tick(ms);
-	p_task->arrive = 0;
-	p_task->reserved = 0;
-	list_add_tail(&(m_timer.defer_task_list), &(p_task->item));
+	list_delete_item(&(timer->item));
+	timer->slip = 0;
+	timer->expires = m_timer.cur_tick + Period_to_Tick(ms);
+	_wheel_insert(timer);
 	return true;
 }
 
+bool stimer_timer_stop(stimer_timer_handle timer)
+{
+	if (!timer || !(timer->flags & STIMER_FLAG_ONESHOT))
+		return false;
+
+	return list_delete_item(&(timer->item)) == 0;
+}
+
+bool stimer_timer_is_active(stimer_timer_handle timer)
+{
+	return timer && (timer->flags & STIMER_FLAG_ONESHOT) && timer->item.next;
+}
+
+void stimer_timer_delete(stimer_timer_handle timer)
+{
+	if (timer && (timer->flags & STIMER_FLAG_ONESHOT))
+		stimer_timer_free(timer);
+}
+
+stimer_event_handle stimer_event_task_create(stimer_timer_cb task_f, void *arg)
+{
+	if (!task_f)
+		return NULL;
+
+	struct stimer_task *task = (struct stimer_task *)virtual_os_calloc(1, sizeof(struct stimer_task));
+	if (task) {
+		task->timer_f = task_f;
+		task->arg = arg;
+		task->flags = STIMER_FLAG_EVENT;
+		list_add_tail(&(m_timer.event_list), &(task->item));
+	}
+	return task;
+}
+
+void stimer_event_post(stimer_event_handle event)
+{
+	if (!event || !(event->flags & STIMER_FLAG_EVENT))
+		return;
+
+	event->pending = 1;
+	__sync_synchronize(); // 任务标志先于总标志可见
+	m_timer.event_pending = 1;
+}
+
+void stimer_event_task_delete(stimer_event_handle event)
+{
+	if (!event || !(event->flags & STIMER_FLAG_EVENT))
+		return;
+
+	list_delete_item(&(event->item));
+	virtual_os_free(event);
+}
+
 void stimer_start(void)
 {
 	if (!m_timer.f_start)
 		return;
 
+	m_timer.alarm_tick = stimer_get_tick();
 	m_timer.f_start();
 	m_timer.run_flag = 1;
 
-	uint32_t pre_tick = stimer_get_tick();
-	uint32_t cur_tick;
-
 	while (1) {
-		cur_tick = stimer_get_tick();
-		if (cur_tick != pre_tick) {
-			pre_tick = cur_tick;
+		// 事件任务在每次循环中优先处理 不等待节拍
+		stimer_event_dispatch();
+
+		// 每次处理一个节拍 休眠期间经过的多个节拍会被逐个补齐
+		if (stimer_wakeup_pending())
 			stimer_task_dispatch();
-		}
+		else
+			stimer_idle();
 	}
 }
+
+#if STIMER_PROFILE_ENABLE
+
+/* ====================== 内置命令: top ====================== */
+static void stimer_top_cmd(int argc, char *argv[], uint8_t *out, size_t buf_size, size_t *out_len)
+{
+	size_t pos = 0;
+	int len;
+	struct stimer_task *task;
+
+	// top reset 清空统计
+	if (argc == 2 && argv[1][0] == 'r') {
+		for (task = m_timer.prof_list; task; task = task->next)
+			task->prof = (struct stimer_profile){ 0 };
+	}
+
+	len = snprintf((char *)out, buf_size, "%-12s %8s %8s %8s %8s %6s %6s\r\n", "task", "calls", "min", "avg", "max",
+		"miss", "over");
+	if (len < 0 || (size_t)len >= buf_size) {
+		*out_len = 0;
+		return;
+	}
+	pos = len;
+
+	for (task = m_timer.prof_list; task; task = task->next) {
+		struct stimer_profile *prof = &(task->prof);
+		uint32_t avg = prof->calls ? (uint32_t)(prof->total / prof->calls) : 0;
+		char name[16];
+
+		if (task->name)
+			snprintf(name, sizeof(name), "%s", task->name);
+		else
+			snprintf(name, sizeof(name), "%p", (void *)task->task_f);
+
+		len = snprintf((char *)(out + pos), buf_size - pos, "%-12s %8lu %8lu %8lu %8lu %6lu %6lu\r\n", name,
+			(unsigned long)prof->calls, (unsigned long)prof->min, (unsigned long)avg, (unsigned long)prof->max,
+			(unsigned long)prof->miss, (unsigned long)task->overrun);
+		if (len < 0 || (size_t)len >= buf_size - pos)
+			break;
+		pos += len;
+	}
+
+	*out_len = pos;
+}
+SPS_EXPORT_CMD(top, stimer_top_cmd, "show stimer task profile, `top reset` to clear")
+
+#endif /* STIMER_PROFILE_ENABLE */
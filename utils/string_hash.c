@@ -36,8 +36,17 @@
 
 #include "core/virtual_os_mm.h"
 
+#define HASH_MIN_SIZE (4) /* 最小槽位个数 */
+
+// 槽位状态
+enum hash_slot_state {
+	HASH_SLOT_EMPTY = 0, // 空
+	HASH_SLOT_USED,		 // 已使用
+	HASH_SLOT_DELETED,	 // 已删除 查找时需要跳过
+};
+
 // FNV-1a hash
-static uint32_t hash(const char *key, size_t table_size)
+static uint32_t hash(const char *key)
 {
 	uint32_t hash = 2166136261u;
 
@@ -46,7 +55,62 @@ static uint32_t hash(const char *key, size_t table_size)
 		hash *= 16777619;
 	}
 
-	return hash % table_size;
+	return hash;
+}
+
+// 不小于 size 的2的幂
+static size_t hash_round_size(size_t size)
+{
+	size_t n = HASH_MIN_SIZE;
+
+	while (n < size)
+		n <<= 1;
+
+	return n;
+}
+
+/**
+ * @brief 查找键所在的槽位
+ * 
+ * @param hash_table 表实例
+ * @param key 字符串
+ * @param h 键的哈希值
+ * @return struct string_hash_node* 不存在返回NULL
+ */
+static struct string_hash_node *hash_lookup(struct hash_table *hash_table, const char *key, uint32_t h)
+{
+	size_t mask = hash_table->table_size - 1;
+
+	for (size_t i = h & mask, n = 0; n < hash_table->table_size; i = (i + 1) & mask, n++) {
+		struct string_hash_node *node = &hash_table->table[i];
+
+		if (node->state == HASH_SLOT_EMPTY)
+			return NULL;
+
+		if (node->state == HASH_SLOT_USED && node->hash == h && strcmp(node->key, key) == 0)
+			return node;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief 查找可放置新键的槽位 优先复用已删除的槽位
+ * 
+ * @param table 槽位数组
+ * @param table_size 槽位个数
+ * @param h 键的哈希值
+ * @return struct string_hash_node* 
+ */
+static struct string_hash_node *hash_free_slot(struct string_hash_node *table, size_t table_size, uint32_t h)
+{
+	size_t mask = table_size - 1;
+	size_t i = h & mask;
+
+	while (table[i].state == HASH_SLOT_USED)
+		i = (i + 1) & mask;
+
+	return &table[i];
 }
 
 enum hash_error init_hash_table(struct hash_table *hash_table, size_t table_size)
@@ -54,110 +118,145 @@ enum hash_error init_hash_table(struct hash_table *hash_table, size_t table_size
 	if (!hash_table)
 		return HASH_POINT_ERROR;
 
-	hash_table->table = (list_item *)virtual_os_calloc(table_size, sizeof(list_item));
+	table_size = hash_round_size(table_size);
+	hash_table->table = (struct string_hash_node *)virtual_os_calloc(table_size, sizeof(struct string_hash_node));
 
 	if (!hash_table->table)
 		return HASH_POINT_ERROR;
 
-	for (size_t i = 0; i < table_size; i++)
-		list_init(&hash_table->table[i]);
-
 	hash_table->table_size = table_size;
+	hash_table->count = 0;
+	hash_table->used = 0;
 	return HASH_SUCCESS;
 }
 
-enum hash_error hash_insert(struct hash_table *hash_table, const char *key, void *private)
+enum hash_error hash_resize(struct hash_table *hash_table, size_t table_size)
 {
-	if (!hash_table || !key)
+	if (!hash_table || !hash_table->table)
 		return HASH_POINT_ERROR;
 
-	uint32_t index = hash(key, hash_table->table_size);
+	table_size = hash_round_size(table_size);
+	if (table_size <= hash_table->count)
+		return HASH_POINT_ERROR;
 
-	list_item *pos, *tmp;
-	list_for_each_safe(pos, tmp, &hash_table->table[index])
-	{
-		struct string_hash_node *node = container_of(pos, struct string_hash_node, list);
+	struct string_hash_node *table =
+		(struct string_hash_node *)virtual_os_calloc(table_size, sizeof(struct string_hash_node));
+	if (!table)
+		return HASH_POINT_ERROR;
 
-		if (strcmp(node->key, key) == 0) {
-			node->private = private;
+	// 使用保存的哈希值重新放置 同时丢弃已删除的槽位
+	for (size_t i = 0; i < hash_table->table_size; i++) {
+		struct string_hash_node *node = &hash_table->table[i];
 
-			return HASH_SUCCESS;
-		}
+		if (node->state == HASH_SLOT_USED)
+			*hash_free_slot(table, table_size, node->hash) = *node;
 	}
 
-	struct string_hash_node *new_node =
-		(struct string_hash_node *)virtual_os_calloc(1, sizeof(struct string_hash_node));
-	list_init(&new_node->list);
+	virtual_os_free(hash_table->table);
+	hash_table->table = table;
+	hash_table->table_size = table_size;
+	hash_table->used = hash_table->count;
+
+	return HASH_SUCCESS;
+}
 
-	if (!new_node)
+/**
+ * @brief 插入键 键已存在时更新数据
+ * 
+ * @param hash_table 表实例
+ * @param key 字符串
+ * @param private 需要存储数据的指针
+ * @param copy 是否拷贝键
+ * @return enum hash_error 错误码
+ */
+static enum hash_error hash_put(struct hash_table *hash_table, const char *key, void *private, bool copy)
+{
+	if (!hash_table || !hash_table->table || !key)
 		return HASH_POINT_ERROR;
 
-	new_node->key = (char *)virtual_os_calloc(1, strlen(key) + 1);
-	if (!new_node->key) {
-		virtual_os_free(new_node);
+	uint32_t h = hash(key);
+	struct string_hash_node *node = hash_lookup(hash_table, key, h);
 
-		return HASH_POINT_ERROR;
+	if (node) {
+		node->private = private;
+		return HASH_SUCCESS;
+	}
+
+	// 使用超过3/4时扩容 保证探测链较短且总有空槽位
+	if ((hash_table->used + 1) * 4 > hash_table->table_size * 3) {
+		size_t size = (hash_table->count + 1) * 4 > hash_table->table_size * 3 ? hash_table->table_size * 2
+																				 : hash_table->table_size;
+		if (hash_resize(hash_table, size) != HASH_SUCCESS)
+			return HASH_POINT_ERROR;
 	}
-	strcpy(new_node->key, key);
 
-	new_node->private = private;
-	list_add_tail(&hash_table->table[index], &new_node->list);
+	char *new_key = NULL;
+	if (copy) {
+		new_key = (char *)virtual_os_malloc(strlen(key) + 1);
+		if (!new_key)
+			return HASH_POINT_ERROR;
+		strcpy(new_key, key);
+	}
+
+	node = hash_free_slot(hash_table->table, hash_table->table_size, h);
+	if (node->state == HASH_SLOT_EMPTY)
+		hash_table->used++;
+
+	node->key = copy ? new_key : key;
+	node->private = private;
+	node->hash = h;
+	node->state = HASH_SLOT_USED;
+	node->owned = copy;
+	hash_table->count++;
 
 	return HASH_SUCCESS;
 }
 
+enum hash_error hash_insert(struct hash_table *hash_table, const char *key, void *private)
+{
+	return hash_put(hash_table, key, private, true);
+}
+
+enum hash_error hash_insert_static(struct hash_table *hash_table, const char *key, void *private)
+{
+	return hash_put(hash_table, key, private, false);
+}
+
 void *hash_find(struct hash_table *hash_table, const char *key, enum hash_error *error)
 {
-	if (!hash_table || !key) {
+	if (!hash_table || !hash_table->table || !key) {
 		if (error)
 			*error = HASH_POINT_ERROR;
 
 		return NULL;
 	}
 
-	uint32_t index = hash(key, hash_table->table_size);
-
-	list_item *pos, *tmp;
-	list_for_each_safe(pos, tmp, &hash_table->table[index])
-	{
-		struct string_hash_node *node = container_of(pos, struct string_hash_node, list);
-
-		if (strcmp(node->key, key) == 0) {
-			if (error)
-				*error = HASH_SUCCESS;
-
-			return node->private;
-		}
-	}
+	struct string_hash_node *node = hash_lookup(hash_table, key, hash(key));
 
 	if (error)
-		*error = HASH_KEY_NOT_FOUND;
+		*error = node ? HASH_SUCCESS : HASH_KEY_NOT_FOUND;
 
-	return NULL;
+	return node ? node->private : NULL;
 }
 
 enum hash_error hash_delete(struct hash_table *hash_table, const char *key)
 {
-	if (!hash_table || !key)
+	if (!hash_table || !hash_table->table || !key)
 		return HASH_POINT_ERROR;
 
-	uint32_t index = hash(key, hash_table->table_size);
+	struct string_hash_node *node = hash_lookup(hash_table, key, hash(key));
+	if (!node)
+		return HASH_KEY_NOT_FOUND;
 
-	list_item *pos, *tmp;
-	list_for_each_safe(pos, tmp, &hash_table->table[index])
-	{
-		struct string_hash_node *node = container_of(pos, struct string_hash_node, list);
+	if (node->owned)
+		virtual_os_free((void *)node->key);
 
-		if (strcmp(node->key, key) == 0) {
-			list_delete_item(pos);
-			virtual_os_free(node->key);
-			virtual_os_free(node);
-
-			return HASH_SUCCESS;
-		}
-	}
+	node->key = NULL;
+	node->private = NULL;
+	node->state = HASH_SLOT_DELETED;
+	hash_table->count--;
 
-	return HASH_KEY_NOT_FOUND;
+	return HASH_SUCCESS;
 }
 
 enum hash_error hash_get_all_keys(struct hash_table *hash_table, char ***keys, size_t *num_keys)
@@ -165,11 +264,7 @@ enum hash_error hash_get_all_keys(struct hash_table *hash_table, char ***keys, s
 	if (!hash_table || !keys || !num_keys)
 		return HASH_POINT_ERROR;
 
-	size_t total_keys = 0;
-	for (size_t i = 0; i < hash_table->table_size; ++i) {
-		list_item *pos, *n;
-		list_for_each_safe(pos, n, &hash_table->table[i]) total_keys++;
-	}
+	size_t total_keys = hash_table->count;
 
 	if (total_keys == 0) {
 		*keys = NULL;
@@ -182,25 +277,24 @@ enum hash_error hash_get_all_keys(struct hash_table *hash_table, char ***keys, s
 		return HASH_POINT_ERROR;
 
 	size_t index = 0;
-	for (size_t i = 0; i < hash_table->table_size; ++i) {
-		list_item *pos, *n;
-		list_for_each_safe(pos, n, &hash_table->table[i])
-		{
-			struct string_hash_node *node = container_of(pos, struct string_hash_node, list);
-
-			size_t key_len = strlen(node->key) + 1;
-			key_array[index] = (char *)virtual_os_calloc(1, key_len);
-			if (!key_array[index]) {
-				for (size_t j = 0; j < index; ++j)
-					virtual_os_free(key_array[j]);
-
-				virtual_os_free(key_array);
-				return HASH_POINT_ERROR;
-			}
-
-			strcpy(key_array[index], node->key);
-			index++;
+	for (size_t i = 0; i < hash_table->table_size && index < total_keys; ++i) {
+		struct string_hash_node *node = &hash_table->table[i];
+
+		if (node->state != HASH_SLOT_USED)
+			continue;
+
+		size_t key_len = strlen(node->key) + 1;
+		key_array[index] = (char *)virtual_os_calloc(1, key_len);
+		if (!key_array[index]) {
+			for (size_t j = 0; j < index; ++j)
+				virtual_os_free(key_array[j]);
+
+			virtual_os_free(key_array);
+			return HASH_POINT_ERROR;
 		}
+
+		strcpy(key_array[index], node->key);
+		index++;
 	}
 
 	*keys = key_array;
@@ -208,21 +302,43 @@ enum hash_error hash_get_all_keys(struct hash_table *hash_table, char ***keys, s
 	return HASH_SUCCESS;
 }
 
+bool hash_iter_next(struct hash_table *hash_table, struct hash_iter *iter, const char **key, void **private)
+{
+	if (!hash_table || !hash_table->table || !iter)
+		return false;
+
+	while (iter->index < hash_table->table_size) {
+		struct string_hash_node *node = &hash_table->table[iter->index++];
+
+		if (node->state != HASH_SLOT_USED)
+			continue;
+
+		if (key)
+			*key = node->key;
+		if (private)
+			*private = node->private;
+
+		return true;
+	}
+
+	return false;
+}
+
 void destroy_hash_table(struct hash_table *hash_table)
 {
-	if (!hash_table)
+	if (!hash_table || !hash_table->table)
 		return;
 
 	for (size_t i = 0; i < hash_table->table_size; ++i) {
-		list_item *pos, *tmp;
-		list_for_each_safe(pos, tmp, &hash_table->table[i])
-		{
-			struct string_hash_node *node = container_of(pos, struct string_hash_node, list);
-			list_delete_item(pos);
-			virtual_os_free(node->key);
-			virtual_os_free(node);
-		}
+		struct string_hash_node *node = &hash_table->table[i];
+
+		if (node->state == HASH_SLOT_USED && node->owned)
+			virtual_os_free((void *)node->key);
 	}
 
 	virtual_os_free(hash_table->table);
+	hash_table->table = NULL;
+	hash_table->table_size = 0;
+	hash_table->count = 0;
+	hash_table->used = 0;
 }
@@ -5,6 +5,7 @@ file(GLOB_RECURSE VIRTUALOS_SOURCES
     ${CMAKE_CURRENT_LIST_DIR}/protocol/modbus/*.c
     ${CMAKE_CURRENT_LIST_DIR}/utils/*.c
     ${CMAKE_CURRENT_LIST_DIR}/driver/*.c
+    ${CMAKE_CURRENT_LIST_DIR}/bus/*.c
 )
 
 set(VIRTUALOS_INCLUDE_DIRS